@@ -0,0 +1,245 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Endpoint stream microbenchmark. The library's endpoint stream template is compiled against a model of a single
+ *  endpoint bank, alongside the previous byte-at-a-time version of the template, and both are used to stream the
+ *  same data into and out of the model. The number of bank readiness checks made, the average number of bytes
+ *  moved per check and the build machine time per byte are reported for each.
+ *
+ *  The model stands in for the endpoint registers of the target, so that the counts reflect only the work done by
+ *  the stream loop itself; an IN bank is emptied and an OUT bank refilled each time the stream hands it over.
+ */
+
+#include <LUFA/Common/Common.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Size of the modelled endpoint bank, in bytes. */
+#define BANK_SIZE              64
+
+/** Number of bytes in each stream transfer. */
+#define STREAM_LENGTH          4096
+
+/** Number of stream transfers made in each direction by each template under test. */
+#define STREAM_ITERATIONS      4096
+
+/** Stream return codes used by the stream templates, matching those of the library. */
+enum Endpoint_Stream_RW_ErrorCodes_t
+{
+	ENDPOINT_RWSTREAM_NoError            = 0,
+	ENDPOINT_RWSTREAM_IncompleteTransfer = 5,
+};
+
+/** Direction of the modelled endpoint, which determines the meaning of the bank byte count. */
+static bool     BankIsIN;
+
+/** Number of bytes written into (for IN) or remaining to be read from (for OUT) the modelled endpoint bank. */
+static uint16_t BankBytes;
+
+/** Storage of the modelled endpoint bank. */
+static uint8_t  BankData[BANK_SIZE];
+
+/** Number of bank readiness checks made by the stream under test. */
+static uint32_t ReadinessChecks;
+
+
+static inline uint8_t Endpoint_WaitUntilReady(void)
+{
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+static inline bool Endpoint_IsReadWriteAllowed(void)
+{
+	ReadinessChecks++;
+	return (BankIsIN ? (BankBytes < BANK_SIZE) : (BankBytes != 0));
+}
+
+static inline uint16_t Endpoint_BytesRemainingInBank(void)
+{
+	return (BankIsIN ? (BANK_SIZE - BankBytes) : BankBytes);
+}
+
+static inline void Endpoint_Write_8(const uint8_t Data)
+{
+	BankData[BankBytes++] = Data;
+}
+
+static inline uint8_t Endpoint_Read_8(void)
+{
+	return BankData[BANK_SIZE - BankBytes--];
+}
+
+static inline void Endpoint_ClearIN(void)
+{
+	BankBytes = 0;
+}
+
+static inline void Endpoint_ClearOUT(void)
+{
+	BankBytes = BANK_SIZE;
+}
+
+static inline void USB_USBTask(void)
+{
+
+}
+
+#define USB_PROFILE_ENDPOINT(Counter, Amount)
+
+/* Current library stream template, with whole-bank transfers per readiness check */
+#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_Bank
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
+#include <LUFA/Drivers/USB/Core/SIM/Template/Template_Endpoint_RW.c>
+
+#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_Bank
+#define  TEMPLATE_BUFFER_TYPE                      void*
+#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
+#include <LUFA/Drivers/USB/Core/SIM/Template/Template_Endpoint_RW.c>
+
+/* Previous stream template, with a readiness check per byte */
+#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_PerByte
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
+#include "Template_Endpoint_RW_PerByte.c"
+
+#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_PerByte
+#define  TEMPLATE_BUFFER_TYPE                      void*
+#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
+#include "Template_Endpoint_RW_PerByte.c"
+
+/** Stream functions of a single template under test. */
+typedef struct
+{
+	const char* Name; /**< Name of the template, for the report. */
+	uint8_t (*Write)(const void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed); /**< IN stream function. */
+	uint8_t (*Read)(void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed); /**< OUT stream function. */
+} StreamTemplate_t;
+
+/** Templates under test, with the previous template first as the baseline. */
+static const StreamTemplate_t StreamTemplates[] =
+	{
+		{ .Name = "Per-byte (before)", .Write = Endpoint_Write_Stream_PerByte, .Read = Endpoint_Read_Stream_PerByte },
+		{ .Name = "Per-bank (after)",  .Write = Endpoint_Write_Stream_Bank,    .Read = Endpoint_Read_Stream_Bank    },
+	};
+
+
+/** Returns the time elapsed on the build machine's monotonic clock, in nanoseconds.
+ *
+ *  \return Current monotonic clock time in nanoseconds.
+ */
+static uint64_t GetTimeNS(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (((uint64_t)Now.tv_sec * 1000000000ULL) + Now.tv_nsec);
+}
+
+/** Prints the result of a single benchmark pass.
+ *
+ *  \param[in] TemplateName   Name of the template benchmarked.
+ *  \param[in] DirectionName  Name of the stream direction benchmarked.
+ *  \param[in] TimeNS         Time taken by the pass, in nanoseconds.
+ */
+static void PrintResult(const char* const TemplateName,
+                        const char* const DirectionName,
+                        const uint64_t TimeNS)
+{
+	uint64_t TotalBytes = ((uint64_t)STREAM_LENGTH * STREAM_ITERATIONS);
+
+	printf("%-18s %-5s %10lu checks, %6.2f bytes per check, %5.2f ns per byte.\n", TemplateName, DirectionName,
+	       (unsigned long)ReadinessChecks, ((double)TotalBytes / ReadinessChecks), ((double)TimeNS / TotalBytes));
+}
+
+/** Main program entry point. Exits with a non-zero exit code if any stream returned an error or corrupted data. */
+int main(void)
+{
+	static uint8_t SourceData[STREAM_LENGTH];
+	static uint8_t ReceivedData[STREAM_LENGTH];
+	bool           StreamFailed = false;
+
+	for (uint16_t i = 0; i < STREAM_LENGTH; i++)
+	  SourceData[i] = (uint8_t)(i * 13);
+
+	for (uint8_t Index = 0; Index < (sizeof(StreamTemplates) / sizeof(StreamTemplates[0])); Index++)
+	{
+		const StreamTemplate_t* Template = &StreamTemplates[Index];
+		uint64_t                StartTime;
+
+		BankIsIN        = true;
+		BankBytes       = 0;
+		ReadinessChecks = 0;
+		StartTime       = GetTimeNS();
+
+		for (uint16_t Iteration = 0; Iteration < STREAM_ITERATIONS; Iteration++)
+		  StreamFailed |= (Template->Write(SourceData, STREAM_LENGTH, NULL) != ENDPOINT_RWSTREAM_NoError);
+
+		PrintResult(Template->Name, "IN", (GetTimeNS() - StartTime));
+
+		/* The last bank of each stream is left in the endpoint unsent, holding the end of the source data */
+		StreamFailed |= ((BankBytes != BANK_SIZE) || memcmp(BankData, &SourceData[STREAM_LENGTH - BANK_SIZE], BANK_SIZE));
+
+		/* Preload the OUT bank with the same data that is expected in each bank of the stream */
+		memcpy(BankData, SourceData, BANK_SIZE);
+
+		BankIsIN        = false;
+		BankBytes       = BANK_SIZE;
+		ReadinessChecks = 0;
+		StartTime       = GetTimeNS();
+
+		for (uint16_t Iteration = 0; Iteration < STREAM_ITERATIONS; Iteration++)
+		  StreamFailed |= (Template->Read(ReceivedData, STREAM_LENGTH, NULL) != ENDPOINT_RWSTREAM_NoError);
+
+		PrintResult(Template->Name, "OUT", (GetTimeNS() - StartTime));
+
+		for (uint16_t i = 0; i < STREAM_LENGTH; i++)
+		  StreamFailed |= (ReceivedData[i] != SourceData[i % BANK_SIZE]);
+	}
+
+	return (StreamFailed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,277 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  CDC host loopback test. The device firmware given on the command line is loaded onto the simulated bus, enumerated
+ *  with the CDC host class driver, and sent a block of test data which it must echo back unchanged. A second block is
+ *  then echoed through the same data pipes using asynchronous pipe transfers, with the main loop only running the USB
+ *  management task. The number of simulated frames taken to enumerate the device and to complete each echo are
+ *  reported on exit.
+ */
+
+#include <LUFA/Drivers/USB/USB.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Total number of bytes sent to the device, and expected back from it. */
+#define ECHO_TOTAL_BYTES       4096
+
+/** Number of bytes sent to the device in each chunk, before waiting for the chunk to be echoed. */
+#define ECHO_CHUNK_BYTES       16
+
+/** Total number of bytes sent to the device in a single asynchronous transfer, and expected back from it. */
+#define ASYNC_ECHO_TOTAL_BYTES 1024
+
+/** Number of simulated frames after which the test is aborted if it has not completed. */
+#define TEST_TIMEOUT_FRAMES    20000
+
+/** LUFA CDC Class driver interface configuration and state information. */
+static USB_ClassInfo_CDC_Host_t VirtualSerial_CDC_Interface =
+	{
+		.Config =
+			{
+				.DataINPipe             =
+					{
+						.Address        = (PIPE_DIR_IN  | 1),
+						.Banks          = 1,
+					},
+				.DataOUTPipe            =
+					{
+						.Address        = (PIPE_DIR_OUT | 2),
+						.Banks          = 1,
+					},
+				.NotificationPipe       =
+					{
+						.Address        = (PIPE_DIR_IN  | 3),
+						.Banks          = 1,
+					},
+			},
+	};
+
+/** Simulated frame number at which the device finished enumerating. */
+static uint32_t EnumerationFrame;
+
+/** Number of bytes sent to and received from the device so far via asynchronous pipe transfers. */
+static uint16_t AsyncBytesSent, AsyncBytesReceived;
+
+
+/** Completion callback for the asynchronous pipe transfers, run from the simulated USB controller interrupt. */
+static void AsyncTransferComplete(const uint8_t Address,
+                                  const uint8_t Status,
+                                  const uint16_t BytesTransferred)
+{
+	if (Status != PIPE_ASYNC_Complete)
+	{
+		fprintf(stderr, "Asynchronous transfer on pipe 0x%02X ended with status %u.\n", Address, Status);
+		exit(EXIT_FAILURE);
+	}
+
+	if (Address & PIPE_DIR_IN)
+	  AsyncBytesReceived += BytesTransferred;
+	else
+	  AsyncBytesSent     += BytesTransferred;
+}
+
+/** Echoes a block of test data through the device using asynchronous pipe transfers. The whole block is submitted
+ *  on the data OUT pipe at once, while the data IN pipe is resubmitted for the remaining length each time a short
+ *  packet from the device ends the previous IN transfer.
+ *
+ *  \return Number of echoed bytes which did not match the sent data.
+ */
+static uint16_t EchoAsync(void)
+{
+	static uint8_t TestData[ASYNC_ECHO_TOTAL_BYTES];
+	static uint8_t ReceivedData[ASYNC_ECHO_TOTAL_BYTES];
+	uint8_t        OUTPipe    = VirtualSerial_CDC_Interface.Config.DataOUTPipe.Address;
+	uint8_t        INPipe     = VirtualSerial_CDC_Interface.Config.DataINPipe.Address;
+	uint16_t       Mismatches = 0;
+
+	for (uint16_t i = 0; i < ASYNC_ECHO_TOTAL_BYTES; i++)
+	  TestData[i] = (uint8_t)(i * 13);
+
+	if (!(Pipe_SubmitAsync(OUTPipe, TestData, ASYNC_ECHO_TOTAL_BYTES, PIPE_ASYNC_OPT_NONE, AsyncTransferComplete)))
+	{
+		fprintf(stderr, "Unable to submit the asynchronous OUT transfer.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	while (AsyncBytesReceived < ASYNC_ECHO_TOTAL_BYTES)
+	{
+		if (USB_Loopback_GetFrameCount() > (TEST_TIMEOUT_FRAMES * 2))
+		{
+			fprintf(stderr, "Timed out after asynchronously sending %u and receiving %u of %u bytes.\n",
+			        AsyncBytesSent, AsyncBytesReceived, ASYNC_ECHO_TOTAL_BYTES);
+			exit(EXIT_FAILURE);
+		}
+
+		if (Pipe_GetAsyncStatus(INPipe, NULL) != PIPE_ASYNC_InProgress)
+		{
+			Pipe_SubmitAsync(INPipe, &ReceivedData[AsyncBytesReceived], (ASYNC_ECHO_TOTAL_BYTES - AsyncBytesReceived),
+			                 PIPE_ASYNC_OPT_NONE, AsyncTransferComplete);
+		}
+
+		USB_USBTask();
+	}
+
+	if (AsyncBytesSent != ASYNC_ECHO_TOTAL_BYTES)
+	{
+		fprintf(stderr, "Echo completed after asynchronously sending only %u bytes.\n", AsyncBytesSent);
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint16_t i = 0; i < ASYNC_ECHO_TOTAL_BYTES; i++)
+	{
+		if (ReceivedData[i] != TestData[i])
+		  Mismatches++;
+	}
+
+	return Mismatches;
+}
+
+/** Main program entry point. The path of the device shared library to test must be given as the first argument. */
+int main(int argc, char** argv)
+{
+	static uint8_t TestData[ECHO_TOTAL_BYTES];
+	uint16_t       BytesSent     = 0;
+	uint16_t       BytesReceived = 0;
+	uint16_t       Mismatches    = 0;
+
+	if ((argc < 2) || !(USB_Loopback_AttachDevice(argv[1])))
+	{
+		fprintf(stderr, "Unable to load the device library.\n");
+		return EXIT_FAILURE;
+	}
+
+	for (uint16_t i = 0; i < ECHO_TOTAL_BYTES; i++)
+	  TestData[i] = (uint8_t)(i * 7);
+
+	USB_Init();
+	GlobalInterruptEnable();
+
+	while (BytesReceived < ECHO_TOTAL_BYTES)
+	{
+		if (USB_Loopback_GetFrameCount() > TEST_TIMEOUT_FRAMES)
+		{
+			fprintf(stderr, "Timed out after receiving %u of %u bytes.\n", BytesReceived, ECHO_TOTAL_BYTES);
+			return EXIT_FAILURE;
+		}
+
+		if (USB_HostState == HOST_STATE_Configured)
+		{
+			/* Send the next chunk once the previous one has been echoed back in full */
+			if ((BytesSent < ECHO_TOTAL_BYTES) && (BytesReceived == BytesSent))
+			{
+				if (CDC_Host_SendData(&VirtualSerial_CDC_Interface, &TestData[BytesSent], ECHO_CHUNK_BYTES) ||
+				    CDC_Host_Flush(&VirtualSerial_CDC_Interface))
+				{
+					fprintf(stderr, "Error sending data to the device.\n");
+					return EXIT_FAILURE;
+				}
+
+				BytesSent += ECHO_CHUNK_BYTES;
+			}
+
+			while (CDC_Host_BytesReceived(&VirtualSerial_CDC_Interface))
+			{
+				int16_t ReceivedByte = CDC_Host_ReceiveByte(&VirtualSerial_CDC_Interface);
+
+				if (ReceivedByte < 0)
+				  break;
+
+				if ((uint8_t)ReceivedByte != TestData[BytesReceived])
+				  Mismatches++;
+
+				BytesReceived++;
+			}
+		}
+
+		CDC_Host_USBTask(&VirtualSerial_CDC_Interface);
+		USB_USBTask();
+	}
+
+	uint32_t EchoFrames = (USB_Loopback_GetFrameCount() - EnumerationFrame);
+
+	printf("Enumerated in %lu frames, echoed %u bytes in %lu frames with %u mismatched bytes.\n",
+	       (unsigned long)EnumerationFrame, ECHO_TOTAL_BYTES, (unsigned long)EchoFrames, Mismatches);
+
+	uint32_t AsyncStartFrame = USB_Loopback_GetFrameCount();
+	uint16_t AsyncMismatches = EchoAsync();
+	uint32_t AsyncEchoFrames = (USB_Loopback_GetFrameCount() - AsyncStartFrame);
+
+	printf("Asynchronously echoed %u bytes in %lu frames with %u mismatched bytes.\n",
+	       ASYNC_ECHO_TOTAL_BYTES, (unsigned long)AsyncEchoFrames, AsyncMismatches);
+
+	return ((Mismatches || AsyncMismatches) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/** Event handler for the USB_DeviceEnumerationFailed event. This indicates that a problem occurred while
+ *  enumerating an attached USB device.
+ */
+void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
+                                            const uint8_t SubErrorCode)
+{
+	fprintf(stderr, "Enumeration failed, error code %d, sub error code %d.\n", ErrorCode, SubErrorCode);
+	exit(EXIT_FAILURE);
+}
+
+/** Event handler for the USB_DeviceEnumerationComplete event. This indicates that a device has been successfully
+ *  enumerated by the host and is now ready to be used by the application.
+ */
+void EVENT_USB_Host_DeviceEnumerationComplete(void)
+{
+	uint16_t ConfigDescriptorSize;
+	uint8_t  ConfigDescriptorData[512];
+
+	if ((USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
+	                                        sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful) ||
+	    (CDC_Host_ConfigurePipes(&VirtualSerial_CDC_Interface,
+	                             ConfigDescriptorSize, ConfigDescriptorData) != CDC_ENUMERROR_NoError) ||
+	    (USB_Host_SetDeviceConfiguration(1) != HOST_SENDCONTROL_Successful))
+	{
+		fprintf(stderr, "Device is not a CDC class device.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	VirtualSerial_CDC_Interface.State.LineEncoding.BaudRateBPS = 9600;
+	VirtualSerial_CDC_Interface.State.LineEncoding.CharFormat  = CDC_LINEENCODING_OneStopBit;
+	VirtualSerial_CDC_Interface.State.LineEncoding.ParityType  = CDC_PARITY_None;
+	VirtualSerial_CDC_Interface.State.LineEncoding.DataBits    = 8;
+
+	if (CDC_Host_SetLineEncoding(&VirtualSerial_CDC_Interface) != HOST_SENDCONTROL_Successful)
+	{
+		fprintf(stderr, "Unable to set the device line encoding.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	EnumerationFrame = USB_Loopback_GetFrameCount();
+	USB_HostState    = HOST_STATE_Configured;
+}
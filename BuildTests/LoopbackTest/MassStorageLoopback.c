@@ -0,0 +1,214 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Mass Storage host loopback benchmark. The device firmware given on the command line is loaded onto the simulated
+ *  bus and enumerated with the Mass Storage host class driver. A block of test data is then written sequentially to
+ *  the start of the device's medium and read back, and the data verified. The number of simulated frames taken by
+ *  each pass is reported on exit, along with the resulting throughput at the nominal full speed 1ms frame period.
+ */
+
+#include <LUFA/Drivers/USB/USB.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Size of each block on the device's medium, in bytes. */
+#define BENCHMARK_BLOCK_SIZE       512
+
+/** Number of blocks transferred in each SCSI READ or WRITE command. */
+#define BENCHMARK_BLOCKS_PER_CMD   32
+
+/** Total number of blocks written and read back in each pass of the benchmark. */
+#define BENCHMARK_TOTAL_BLOCKS     2048
+
+/** Number of simulated frames after which the device is abandoned if it has not finished enumerating. */
+#define ENUMERATION_TIMEOUT_FRAMES 5000
+
+/** LUFA Mass Storage Class driver interface configuration and state information. */
+static USB_ClassInfo_MS_Host_t FlashDisk_MS_Interface =
+	{
+		.Config =
+			{
+				.DataINPipe             =
+					{
+						.Address        = (PIPE_DIR_IN  | 1),
+						.Banks          = 1,
+					},
+				.DataOUTPipe            =
+					{
+						.Address        = (PIPE_DIR_OUT | 2),
+						.Banks          = 1,
+					},
+			},
+	};
+
+/** Test data written to the device, and the buffer the data read back from the device is stored into. */
+static uint8_t WriteData[BENCHMARK_TOTAL_BLOCKS][BENCHMARK_BLOCK_SIZE];
+static uint8_t ReadData[BENCHMARK_TOTAL_BLOCKS][BENCHMARK_BLOCK_SIZE];
+
+
+/** Prints the result of a single pass of the benchmark.
+ *
+ *  \param[in] PassName  Name of the benchmark pass.
+ *  \param[in] Frames    Number of simulated frames the pass took to complete.
+ */
+static void PrintResult(const char* const PassName,
+                        const uint32_t Frames)
+{
+	uint32_t TotalBytes = ((uint32_t)BENCHMARK_TOTAL_BLOCKS * BENCHMARK_BLOCK_SIZE);
+
+	printf("%s %lu bytes in %lu frames, %lu KB/s.\n", PassName, (unsigned long)TotalBytes, (unsigned long)Frames,
+	       (unsigned long)((TotalBytes * 1000ULL) / ((uint64_t)(Frames ? Frames : 1) * 1024)));
+}
+
+/** Runs the benchmark against the enumerated device.
+ *
+ *  \return Boolean \c true if all commands succeeded and the data read back matched, \c false otherwise.
+ */
+static bool RunBenchmark(void)
+{
+	SCSI_Capacity_t DiskCapacity;
+	uint32_t        StartFrame;
+
+	if (MS_Host_TestUnitReady(&FlashDisk_MS_Interface, 0) ||
+	    MS_Host_ReadDeviceCapacity(&FlashDisk_MS_Interface, 0, &DiskCapacity))
+	{
+		fprintf(stderr, "Device did not become ready.\n");
+		return false;
+	}
+
+	if ((DiskCapacity.BlockSize != BENCHMARK_BLOCK_SIZE) || (DiskCapacity.Blocks < (BENCHMARK_TOTAL_BLOCKS - 1)))
+	{
+		fprintf(stderr, "Device medium is too small for the benchmark.\n");
+		return false;
+	}
+
+	for (uint32_t Block = 0; Block < BENCHMARK_TOTAL_BLOCKS; Block++)
+	{
+		for (uint16_t i = 0; i < BENCHMARK_BLOCK_SIZE; i++)
+		  WriteData[Block][i] = (uint8_t)((Block * 31) + i);
+	}
+
+	StartFrame = USB_Loopback_GetFrameCount();
+
+	for (uint32_t Block = 0; Block < BENCHMARK_TOTAL_BLOCKS; Block += BENCHMARK_BLOCKS_PER_CMD)
+	{
+		if (MS_Host_WriteDeviceBlocks(&FlashDisk_MS_Interface, 0, Block, BENCHMARK_BLOCKS_PER_CMD,
+		                              BENCHMARK_BLOCK_SIZE, WriteData[Block]))
+		{
+			fprintf(stderr, "Error writing block %lu.\n", (unsigned long)Block);
+			return false;
+		}
+	}
+
+	PrintResult("Wrote", (USB_Loopback_GetFrameCount() - StartFrame));
+
+	StartFrame = USB_Loopback_GetFrameCount();
+
+	for (uint32_t Block = 0; Block < BENCHMARK_TOTAL_BLOCKS; Block += BENCHMARK_BLOCKS_PER_CMD)
+	{
+		if (MS_Host_ReadDeviceBlocks(&FlashDisk_MS_Interface, 0, Block, BENCHMARK_BLOCKS_PER_CMD,
+		                             BENCHMARK_BLOCK_SIZE, ReadData[Block]))
+		{
+			fprintf(stderr, "Error reading block %lu.\n", (unsigned long)Block);
+			return false;
+		}
+	}
+
+	PrintResult("Read", (USB_Loopback_GetFrameCount() - StartFrame));
+
+	if (memcmp(WriteData, ReadData, sizeof(WriteData)) != 0)
+	{
+		fprintf(stderr, "Data read back from the device does not match the data written.\n");
+		return false;
+	}
+
+	return true;
+}
+
+/** Main program entry point. The path of the device shared library to test must be given as the first argument. */
+int main(int argc, char** argv)
+{
+	if ((argc < 2) || !(USB_Loopback_AttachDevice(argv[1])))
+	{
+		fprintf(stderr, "Unable to load the device library.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_Init();
+	GlobalInterruptEnable();
+
+	while (USB_HostState != HOST_STATE_Configured)
+	{
+		if (USB_Loopback_GetFrameCount() > ENUMERATION_TIMEOUT_FRAMES)
+		{
+			fprintf(stderr, "Timed out waiting for the device to enumerate.\n");
+			return EXIT_FAILURE;
+		}
+
+		USB_USBTask();
+	}
+
+	return (RunBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/** Event handler for the USB_DeviceEnumerationFailed event. This indicates that a problem occurred while
+ *  enumerating an attached USB device.
+ */
+void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
+                                            const uint8_t SubErrorCode)
+{
+	fprintf(stderr, "Enumeration failed, error code %d, sub error code %d.\n", ErrorCode, SubErrorCode);
+	exit(EXIT_FAILURE);
+}
+
+/** Event handler for the USB_DeviceEnumerationComplete event. This indicates that a device has been successfully
+ *  enumerated by the host and is now ready to be used by the application.
+ */
+void EVENT_USB_Host_DeviceEnumerationComplete(void)
+{
+	uint16_t ConfigDescriptorSize;
+	uint8_t  ConfigDescriptorData[512];
+
+	if ((USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
+	                                        sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful) ||
+	    (MS_Host_ConfigurePipes(&FlashDisk_MS_Interface,
+	                            ConfigDescriptorSize, ConfigDescriptorData) != MS_ENUMERROR_NoError) ||
+	    (USB_Host_SetDeviceConfiguration(1) != HOST_SENDCONTROL_Successful))
+	{
+		fprintf(stderr, "Device is not a Mass Storage class device.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	USB_HostState = HOST_STATE_Configured;
+}
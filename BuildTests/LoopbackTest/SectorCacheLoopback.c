@@ -0,0 +1,353 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Mass Storage host loopback test of the sector cache of the USBStickLogger project. The device firmware given on the
+ *  command line is loaded onto the simulated bus and enumerated with the Mass Storage host class driver, and the sector
+ *  cache is attached to its medium. A sequence of sector accesses is then made through the cache, checking after each
+ *  step which sectors the cache has written to the medium and how many WRITE commands it took to do so. The steps cover
+ *  dirty sectors being held in the cache, the write-back of a run of consecutive dirty sectors in a single command once
+ *  one of them is evicted, the separation of the FAT region into its own cache pool, the coherence of multiple sector
+ *  accesses with the cached sectors, and the final flush of the cache.
+ */
+
+#include <LUFA/Drivers/USB/USB.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Projects/USBStickLogger/Lib/SectorCache.h"
+
+/** Number of sectors at the start of the device's medium used by the test. */
+#define TEST_TOTAL_SECTORS         64
+
+/** First sector of the FAT region given to the sector cache. */
+#define TEST_FAT_START_SECTOR      32
+
+/** Number of sectors in the FAT region given to the sector cache. */
+#define TEST_FAT_TOTAL_SECTORS     4
+
+/** Number of simulated frames after which the device is abandoned if it has not finished enumerating. */
+#define ENUMERATION_TIMEOUT_FRAMES 5000
+
+/** LUFA Mass Storage Class driver interface configuration and state information. */
+static USB_ClassInfo_MS_Host_t FlashDisk_MS_Interface =
+	{
+		.Config =
+			{
+				.DataINPipe             =
+					{
+						.Address        = (PIPE_DIR_IN  | 1),
+						.Banks          = 1,
+					},
+				.DataOUTPipe            =
+					{
+						.Address        = (PIPE_DIR_OUT | 2),
+						.Banks          = 1,
+					},
+			},
+	};
+
+/** Contents each test sector of the medium should hold once the cache has been flushed. */
+static uint8_t ExpectedData[TEST_TOTAL_SECTORS][SECTOR_CACHE_SECTOR_SIZE];
+
+/** Buffer the sectors read back through the cache or directly from the medium are stored into. */
+static uint8_t ReadData[TEST_FAT_TOTAL_SECTORS][SECTOR_CACHE_SECTOR_SIZE];
+
+
+/** Reports the result of a single check of the test.
+ *
+ *  \param[in] Passed       Indicates if the check passed.
+ *  \param[in] Description  Description of the checked condition.
+ *
+ *  \return Boolean \c true if the check passed, \c false otherwise.
+ */
+static bool Check(const bool Passed,
+                  const char* const Description)
+{
+	if (!(Passed))
+	  fprintf(stderr, "Check failed: %s.\n", Description);
+
+	return Passed;
+}
+
+/** Fills the expected contents of a test sector with a pattern unique to the sector and the given version.
+ *
+ *  \param[in] Sector   Test sector whose expected contents are to be filled.
+ *  \param[in] Version  Version of the sector's contents.
+ */
+static void FillSector(const uint32_t Sector,
+                       const uint8_t Version)
+{
+	for (uint16_t i = 0; i < SECTOR_CACHE_SECTOR_SIZE; i++)
+	  ExpectedData[Sector][i] = (uint8_t)((Sector * 31) + (Version * 97) + i);
+}
+
+/** Writes a new version of a single test sector through the cache.
+ *
+ *  \param[in] Sector   Test sector to write.
+ *  \param[in] Version  Version of the sector's contents to write.
+ *
+ *  \return Boolean \c true if the cache accepted the write, \c false otherwise.
+ */
+static bool WriteSector(const uint32_t Sector,
+                        const uint8_t Version)
+{
+	FillSector(Sector, Version);
+
+	return Check((SectorCache_Write(Sector, 1, ExpectedData[Sector]) == 0), "Single sector write through the cache");
+}
+
+/** Determines if the medium holds the expected contents of a test sector, by reading it directly from the device
+ *  rather than through the cache.
+ *
+ *  \param[in] Sector  Test sector to read from the medium.
+ *
+ *  \return Boolean \c true if the medium holds the sector's expected contents, \c false otherwise.
+ */
+static bool IsSectorOnMedium(const uint32_t Sector)
+{
+	if (MS_Host_ReadDeviceBlocks(&FlashDisk_MS_Interface, 0, Sector, 1, SECTOR_CACHE_SECTOR_SIZE, ReadData[0]))
+	{
+		fprintf(stderr, "Error reading sector %lu.\n", (unsigned long)Sector);
+		exit(EXIT_FAILURE);
+	}
+
+	return (memcmp(ReadData[0], ExpectedData[Sector], SECTOR_CACHE_SECTOR_SIZE) == 0);
+}
+
+/** Checks the number of sectors the cache has written to the medium, and the number of WRITE commands it has used.
+ *
+ *  \param[in] SectorsWritten  Expected total number of sectors written.
+ *  \param[in] WriteCommands   Expected total number of WRITE commands issued.
+ *  \param[in] Description     Description of the test step being checked.
+ *
+ *  \return Boolean \c true if the cache statistics match, \c false otherwise.
+ */
+static bool CheckWrites(const uint32_t SectorsWritten,
+                        const uint32_t WriteCommands,
+                        const char* const Description)
+{
+	if ((SectorCache_Stats.SectorsWritten == SectorsWritten) && (SectorCache_Stats.WriteCommands == WriteCommands))
+	  return true;
+
+	fprintf(stderr, "Check failed: %s, %lu sectors written in %lu commands where %lu in %lu were expected.\n", Description,
+	        (unsigned long)SectorCache_Stats.SectorsWritten, (unsigned long)SectorCache_Stats.WriteCommands,
+	        (unsigned long)SectorsWritten, (unsigned long)WriteCommands);
+	return false;
+}
+
+/** Runs the test against the enumerated device.
+ *
+ *  \return Boolean \c true if all the checks passed, \c false otherwise.
+ */
+static bool RunTest(void)
+{
+	SCSI_Capacity_t DiskCapacity;
+	uint32_t        ReadHits;
+
+	if (MS_Host_TestUnitReady(&FlashDisk_MS_Interface, 0) ||
+	    MS_Host_ReadDeviceCapacity(&FlashDisk_MS_Interface, 0, &DiskCapacity))
+	{
+		fprintf(stderr, "Device did not become ready.\n");
+		return false;
+	}
+
+	if ((DiskCapacity.BlockSize != SECTOR_CACHE_SECTOR_SIZE) || (DiskCapacity.Blocks < (TEST_TOTAL_SECTORS - 1)))
+	{
+		fprintf(stderr, "Device medium is too small for the test.\n");
+		return false;
+	}
+
+	/* Write the initial contents of the test sectors directly to the medium, bypassing the cache */
+	for (uint32_t Sector = 0; Sector < TEST_TOTAL_SECTORS; Sector++)
+	  FillSector(Sector, 0);
+
+	if (MS_Host_WriteDeviceBlocks(&FlashDisk_MS_Interface, 0, 0, TEST_TOTAL_SECTORS, SECTOR_CACHE_SECTOR_SIZE, ExpectedData))
+	{
+		fprintf(stderr, "Error writing the initial sector contents.\n");
+		return false;
+	}
+
+	SectorCache_Attach(&FlashDisk_MS_Interface, 0);
+	SectorCache_SetFATRegion(TEST_FAT_START_SECTOR, TEST_FAT_TOTAL_SECTORS);
+
+	/* Written sectors are held in the cache as dirty entries, and read back from the cache */
+	if (!(WriteSector(8, 1) && WriteSector(9, 1) && WriteSector(10, 1)))
+	  return false;
+
+	if (!(CheckWrites(0, 0, "Dirty sectors held in the cache") &&
+	      Check(!(IsSectorOnMedium(8) || IsSectorOnMedium(9) || IsSectorOnMedium(10)), "Dirty sectors not yet on the medium") &&
+	      Check((SectorCache_Read(9, 1, ReadData[1]) == 0), "Single sector read through the cache") &&
+	      Check((memcmp(ReadData[1], ExpectedData[9], SECTOR_CACHE_SECTOR_SIZE) == 0), "Dirty sector read back from the cache") &&
+	      Check((SectorCache_Stats.ReadHits == 1) && (SectorCache_Stats.ReadMisses == 0), "Dirty sector read as a cache hit")))
+	{
+		return false;
+	}
+
+	/* Filling the general pool evicts the least recently used sector 8, written back together with the following dirty
+	 * sectors 9 and 10 as a single command */
+	if (!(WriteSector(20, 1) && WriteSector(21, 1)))
+	  return false;
+
+	if (!(CheckWrites(3, 1, "Run of dirty sectors written back on eviction") &&
+	      Check((IsSectorOnMedium(8) && IsSectorOnMedium(9) && IsSectorOnMedium(10)), "Evicted run on the medium") &&
+	      Check(!(IsSectorOnMedium(20) || IsSectorOnMedium(21)), "Remaining dirty sectors not yet on the medium")))
+	{
+		return false;
+	}
+
+	/* Sectors of the FAT region are cached in their own pool, and are not evicted by reads of other sectors, which write
+	 * back the dirty sectors 20 and 21 as a single command as they are evicted from the general pool */
+	if (!(WriteSector(32, 1) && WriteSector(33, 1)))
+	  return false;
+
+	for (uint32_t Sector = 40; Sector < 48; Sector++)
+	{
+		if (!(Check((SectorCache_Read(Sector, 1, ReadData[0]) == 0), "Single sector read through the cache")))
+		  return false;
+	}
+
+	ReadHits = SectorCache_Stats.ReadHits;
+
+	if (!(CheckWrites(5, 2, "Run of dirty sectors written back on eviction by reads") &&
+	      Check((IsSectorOnMedium(20) && IsSectorOnMedium(21)), "Evicted run on the medium") &&
+	      Check(!(IsSectorOnMedium(32) || IsSectorOnMedium(33)), "Dirty FAT sectors not evicted") &&
+	      Check((SectorCache_Read(32, 1, ReadData[0]) == 0), "Single sector read through the cache") &&
+	      Check((SectorCache_Stats.ReadHits == (ReadHits + 1)), "FAT sector read as a cache hit")))
+	{
+		return false;
+	}
+
+	/* Multiple sector reads bypass the cache but return the newer cached contents, and multiple sector writes go directly
+	 * to the medium while updating and cleaning any cached copies */
+	if (!(Check((SectorCache_Read(30, 4, ReadData[0]) == 0), "Multiple sector read through the cache") &&
+	      Check((memcmp(ReadData, ExpectedData[30], sizeof(ReadData)) == 0), "Multiple sector read coherent with the cache")))
+	{
+		return false;
+	}
+
+	FillSector(33, 2);
+	FillSector(34, 2);
+
+	if (!(Check((SectorCache_Write(33, 2, ExpectedData[33]) == 0), "Multiple sector write through the cache") &&
+	      CheckWrites(7, 3, "Multiple sector write made directly") &&
+	      Check((IsSectorOnMedium(33) && IsSectorOnMedium(34)), "Multiple sector write on the medium") &&
+	      Check((SectorCache_Read(33, 1, ReadData[1]) == 0), "Single sector read through the cache") &&
+	      Check((memcmp(ReadData[1], ExpectedData[33], SECTOR_CACHE_SECTOR_SIZE) == 0), "Cached sector updated by the write")))
+	{
+		return false;
+	}
+
+	/* Flushing the cache writes back the one remaining dirty sector, as sector 33 was cleaned by the multiple sector write */
+	if (!(Check((SectorCache_Flush() == 0), "Cache flush") &&
+	      CheckWrites(8, 4, "Remaining dirty sector written back on flush") &&
+	      Check((SectorCache_Flush() == 0), "Cache flush") &&
+	      CheckWrites(8, 4, "Nothing written back on a second flush")))
+	{
+		return false;
+	}
+
+	for (uint32_t Sector = 0; Sector < TEST_TOTAL_SECTORS; Sector++)
+	{
+		if (!(IsSectorOnMedium(Sector)))
+		{
+			fprintf(stderr, "Sector %lu on the medium does not match the data written.\n", (unsigned long)Sector);
+			return false;
+		}
+	}
+
+	SectorCache_Detach();
+
+	printf("Sector cache: %lu sectors written in %lu commands, %lu/%lu cache hits.\n",
+	       (unsigned long)SectorCache_Stats.SectorsWritten, (unsigned long)SectorCache_Stats.WriteCommands,
+	       (unsigned long)SectorCache_Stats.ReadHits,
+	       (unsigned long)(SectorCache_Stats.ReadHits + SectorCache_Stats.ReadMisses));
+	return true;
+}
+
+/** Main program entry point. The path of the device shared library to test must be given as the first argument. */
+int main(int argc, char** argv)
+{
+	if ((argc < 2) || !(USB_Loopback_AttachDevice(argv[1])))
+	{
+		fprintf(stderr, "Unable to load the device library.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_Init();
+	GlobalInterruptEnable();
+
+	while (USB_HostState != HOST_STATE_Configured)
+	{
+		if (USB_Loopback_GetFrameCount() > ENUMERATION_TIMEOUT_FRAMES)
+		{
+			fprintf(stderr, "Timed out waiting for the device to enumerate.\n");
+			return EXIT_FAILURE;
+		}
+
+		USB_USBTask();
+	}
+
+	return (RunTest() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/** Event handler for the USB_DeviceEnumerationFailed event. This indicates that a problem occurred while
+ *  enumerating an attached USB device.
+ */
+void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
+                                            const uint8_t SubErrorCode)
+{
+	fprintf(stderr, "Enumeration failed, error code %d, sub error code %d.\n", ErrorCode, SubErrorCode);
+	exit(EXIT_FAILURE);
+}
+
+/** Event handler for the USB_DeviceEnumerationComplete event. This indicates that a device has been successfully
+ *  enumerated by the host and is now ready to be used by the application.
+ */
+void EVENT_USB_Host_DeviceEnumerationComplete(void)
+{
+	uint16_t ConfigDescriptorSize;
+	uint8_t  ConfigDescriptorData[512];
+
+	if ((USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
+	                                        sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful) ||
+	    (MS_Host_ConfigurePipes(&FlashDisk_MS_Interface,
+	                            ConfigDescriptorSize, ConfigDescriptorData) != MS_ENUMERROR_NoError) ||
+	    (USB_Host_SetDeviceConfiguration(1) != HOST_SENDCONTROL_Successful))
+	{
+		fprintf(stderr, "Device is not a Mass Storage class device.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	USB_HostState = HOST_STATE_Configured;
+}
@@ -34,6 +34,7 @@
 
 #include <LUFA/Drivers/USB/USB.h>
 #include <LUFA/Drivers/Misc/RingBuffer.h>
+#include <LUFA/Drivers/Misc/LockFreeRingBuffer.h>
 #include <LUFA/Drivers/Misc/TerminalCodes.h>
 
 #if (ARCH == ARCH_AVR8)
@@ -0,0 +1,228 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Lock-free ring buffer test. A producer thread and a consumer thread stream a sequence of bytes through a
+ *  \ref LockFreeRingBuffer_t, standing in for an ISR and the main program loop of the target, and the consumer
+ *  verifies that every byte arrives exactly once and in order. The single threaded insertion and removal rate of
+ *  the lock-free buffer and of the standard \ref RingBuffer_t are then measured and reported for comparison.
+ *
+ *  The lock-free buffer relies on its index stores becoming visible to the other thread in program order, which the
+ *  build machine must guarantee for plain stores (as x86 processors do) for the stress test to be meaningful.
+ */
+
+#include <LUFA/Drivers/Misc/RingBuffer.h>
+#include <LUFA/Drivers/Misc/LockFreeRingBuffer.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/** Size of the ring buffers under test, the largest size supported on the 8-bit architectures. */
+#define BUFFER_SIZE            128
+
+/** Total number of bytes streamed through the lock-free buffer by the stress test. */
+#define STRESS_TOTAL_BYTES     (2UL * 1024 * 1024)
+
+/** Total number of bytes inserted into and removed from each buffer by the throughput benchmark. */
+#define BENCHMARK_TOTAL_BYTES  (64UL * 1024 * 1024)
+
+/** Buffer shared between the producer and consumer threads of the stress test. */
+static LockFreeRingBuffer_t SharedBuffer;
+static uint8_t              SharedBufferData[BUFFER_SIZE];
+
+
+/** Returns the time elapsed on the build machine's monotonic clock, in nanoseconds.
+ *
+ *  \return Current monotonic clock time in nanoseconds.
+ */
+static uint64_t GetTimeNS(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (((uint64_t)Now.tv_sec * 1000000000ULL) + Now.tv_nsec);
+}
+
+/** Stress test producer thread, which inserts a counting sequence of bytes into the shared buffer whenever it has
+ *  free space.
+ *
+ *  \param[in] Param  Unused.
+ *
+ *  \return Always \c NULL.
+ */
+static void* ProducerThread(void* Param)
+{
+	(void)Param;
+
+	for (uint32_t BytesSent = 0; BytesSent < STRESS_TOTAL_BYTES; )
+	{
+		/* Give up the processor while waiting, so that the test also completes quickly on a single core machine */
+		if (LockFreeRingBuffer_IsFull(&SharedBuffer))
+		{
+			sched_yield();
+			continue;
+		}
+
+		LockFreeRingBuffer_Insert(&SharedBuffer, (uint8_t)(BytesSent ^ (BytesSent >> 8)));
+		BytesSent++;
+	}
+
+	return NULL;
+}
+
+/** Runs the stress test, streaming \ref STRESS_TOTAL_BYTES bytes from a producer thread to the calling thread.
+ *
+ *  \return Number of bytes which were received out of sequence.
+ */
+static uint32_t RunStressTest(void)
+{
+	pthread_t Producer;
+	uint32_t  Errors = 0;
+
+	LockFreeRingBuffer_InitBuffer(&SharedBuffer, SharedBufferData, sizeof(SharedBufferData));
+
+	if (pthread_create(&Producer, NULL, ProducerThread, NULL) != 0)
+	{
+		fprintf(stderr, "Unable to create the producer thread.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint32_t BytesReceived = 0; BytesReceived < STRESS_TOTAL_BYTES; )
+	{
+		uint16_t BytesAvailable = LockFreeRingBuffer_GetCount(&SharedBuffer);
+
+		if (!(BytesAvailable))
+		  sched_yield();
+		else if (BytesAvailable > BUFFER_SIZE)
+		  Errors++;
+
+		while (BytesAvailable--)
+		{
+			if (LockFreeRingBuffer_Remove(&SharedBuffer) != (uint8_t)(BytesReceived ^ (BytesReceived >> 8)))
+			  Errors++;
+
+			BytesReceived++;
+		}
+	}
+
+	pthread_join(Producer, NULL);
+
+	if (!(LockFreeRingBuffer_IsEmpty(&SharedBuffer)))
+	  Errors++;
+
+	return Errors;
+}
+
+/** Measures the single threaded throughput of the lock-free ring buffer.
+ *
+ *  \return Time taken to pass \ref BENCHMARK_TOTAL_BYTES bytes through the buffer, in nanoseconds.
+ */
+static uint64_t BenchmarkLockFreeRingBuffer(void)
+{
+	static LockFreeRingBuffer_t Buffer;
+	static uint8_t              BufferData[BUFFER_SIZE];
+	volatile uint8_t            Checksum = 0;
+
+	LockFreeRingBuffer_InitBuffer(&Buffer, BufferData, sizeof(BufferData));
+
+	uint64_t StartTime = GetTimeNS();
+
+	for (uint32_t BytesMoved = 0; BytesMoved < BENCHMARK_TOTAL_BYTES; BytesMoved += (BUFFER_SIZE / 2))
+	{
+		for (uint8_t i = 0; i < (BUFFER_SIZE / 2); i++)
+		{
+			if (!(LockFreeRingBuffer_IsFull(&Buffer)))
+			  LockFreeRingBuffer_Insert(&Buffer, i);
+		}
+
+		while (!(LockFreeRingBuffer_IsEmpty(&Buffer)))
+		  Checksum += LockFreeRingBuffer_Remove(&Buffer);
+	}
+
+	return (GetTimeNS() - StartTime);
+}
+
+/** Measures the single threaded throughput of the standard ring buffer.
+ *
+ *  \return Time taken to pass \ref BENCHMARK_TOTAL_BYTES bytes through the buffer, in nanoseconds.
+ */
+static uint64_t BenchmarkRingBuffer(void)
+{
+	static RingBuffer_t Buffer;
+	static uint8_t      BufferData[BUFFER_SIZE];
+	volatile uint8_t    Checksum = 0;
+
+	RingBuffer_InitBuffer(&Buffer, BufferData, sizeof(BufferData));
+
+	uint64_t StartTime = GetTimeNS();
+
+	for (uint32_t BytesMoved = 0; BytesMoved < BENCHMARK_TOTAL_BYTES; BytesMoved += (BUFFER_SIZE / 2))
+	{
+		for (uint8_t i = 0; i < (BUFFER_SIZE / 2); i++)
+		{
+			if (!(RingBuffer_IsFull(&Buffer)))
+			  RingBuffer_Insert(&Buffer, i);
+		}
+
+		while (!(RingBuffer_IsEmpty(&Buffer)))
+		  Checksum += RingBuffer_Remove(&Buffer);
+	}
+
+	return (GetTimeNS() - StartTime);
+}
+
+/** Prints the result of a throughput benchmark.
+ *
+ *  \param[in] BufferName  Name of the ring buffer implementation benchmarked.
+ *  \param[in] TimeNS      Time taken to pass \ref BENCHMARK_TOTAL_BYTES bytes through the buffer, in nanoseconds.
+ */
+static void PrintBenchmarkResult(const char* const BufferName,
+                                 const uint64_t TimeNS)
+{
+	printf("%-20s %lu bytes in %lu us, %.2f ns per byte.\n", BufferName, BENCHMARK_TOTAL_BYTES,
+	       (unsigned long)(TimeNS / 1000), ((double)TimeNS / BENCHMARK_TOTAL_BYTES));
+}
+
+/** Main program entry point. Exits with a non-zero exit code if the stress test detected any errors. */
+int main(void)
+{
+	uint32_t Errors = RunStressTest();
+
+	printf("Stress test streamed %lu bytes between threads with %lu errors.\n", STRESS_TOTAL_BYTES, (unsigned long)Errors);
+
+	PrintBenchmarkResult("LockFreeRingBuffer_t", BenchmarkLockFreeRingBuffer());
+	PrintBenchmarkResult("RingBuffer_t", BenchmarkRingBuffer());
+
+	return (Errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -34,15 +34,114 @@
  *  blocks of data. These functions are called by the SCSI layer when data must be stored
  *  or retrieved to/from the physical storage media. If a different media is used (such
  *  as a SD card or EEPROM), functions similar to these will need to be generated.
+ *
+ *  An identical copy of this file is kept in each of the Dataflash based Mass Storage demos and projects, rather than
+ *  a single shared copy, so that each application remains self-contained and can be copied out of the LUFA tree and
+ *  built on its own; the application specific includes and definitions are confined to DataflashManager.h. Only the
+ *  copy in the LowLevel MassStorage demo differs, as that demo has its own SCSI command handler in place of the library
+ *  SCSI command engine, and so has no SCSI backend functions or bank read state, and no class driver interface
+ *  parameter. A change made to one copy should be made to all of them.
  */
 
 #define  INCLUDE_FROM_DATAFLASHMANAGER_C
 #include "DataflashManager.h"
 
+/** Structure to hold the SCSI response data to a SCSI INQUIRY command, for the logical units stored in the Dataflash.
+ *  This gives information about the device's features and capabilities.
+ */
+const SCSI_Inquiry_Response_t DataflashManager_InquiryData =
+	{
+		.DeviceType          = DEVICE_TYPE_BLOCK,
+		.PeripheralQualifier = 0,
+
+		.Removable           = true,
+
+		.Version             = 0,
+
+		.ResponseDataFormat  = 2,
+		.NormACA             = false,
+		.TrmTsk              = false,
+		.AERC                = false,
+
+		.AdditionalLength    = 0x1F,
+
+		.SoftReset           = false,
+		.CmdQue              = false,
+		.Linked              = false,
+		.Sync                = false,
+		.WideBus16Bit        = false,
+		.WideBus32Bit        = false,
+		.RelAddr             = false,
+
+		.VendorID            = "LUFA",
+		.ProductID           = "Dataflash Disk",
+		.RevisionID          = {'0','.','0','0'},
+	};
+
+/** Library SCSI command engine backend for the Dataflash storage medium, for the logical unit table of the Mass Storage
+ *  interface.
+ */
+const MS_SCSI_Backend_t DataflashManager_SCSIBackend =
+	{
+		.ReadBlocks          = DataflashManager_SCSIReadBlocks,
+		.WriteBlocks         = DataflashManager_SCSIWriteBlocks,
+		.ReadBank            = DataflashManager_SCSIReadBank,
+		.WriteBank           = DataflashManager_SCSIWriteBank,
+		.SynchronizeCache    = DataflashManager_SCSISynchronizeCache,
+		.SelfTest            = DataflashManager_SCSISelfTest,
+	};
+
+/** Dataflash page currently held in the write-back cache, within one of the internal buffers of its Dataflash IC. */
+static uint16_t CachedDFPage;
+
+/** Indicates if the write-back cache page is held in the second Dataflash buffer of its Dataflash IC, rather than the first. */
+static bool     CacheInSecondBuffer;
+
+/** Indicates if the write-back cache currently holds a Dataflash page. */
+static bool     CacheValid;
+
+/** Indicates if the write-back cache page holds data which has not yet been committed to the Dataflash main memory. */
+static bool     CacheDirty;
+
+/** USB frame number of the last write into the write-back cache page, for committing the page once writes have ceased. */
+static uint16_t CacheLastWriteFrame;
+
+/** Dataflash page currently being read out by the bank read backend function, within one of the internal buffers of its
+ *  Dataflash IC.
+ */
+static uint16_t ReadDFPage;
+
+/** Indicates if the bank read page is held in the second Dataflash buffer of its Dataflash IC, rather than the first. */
+static bool     ReadInSecondBuffer;
+
+/** Indicates if the Dataflash buffers currently hold the bank read page. */
+static bool     ReadBufferValid;
+
+/** Indicates if the page following the bank read page is being loaded into the other Dataflash buffer, ready for the
+ *  next bank read.
+ */
+static bool     ReadNextPageLoaded;
+
+#if defined(DATAFLASH_READ_BENCHMARK)
+/** Number of bytes read from the Dataflash by the host since the last read benchmark report. */
+static uint32_t BenchmarkBytes;
+
+/** Number of USB frames spent reading the Dataflash since the last read benchmark report, excluding idle periods. */
+static uint32_t BenchmarkFrames;
+
+/** USB frame number at the end of the last read of the Dataflash by the host. */
+static uint16_t BenchmarkLastFrame;
+#endif
+
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
  *  the pre-selected data OUT endpoint. This routine reads in OS sized blocks from the endpoint and writes
  *  them to the Dataflash in Dataflash page sized blocks.
  *
+ *  The last page written is not committed to the Dataflash main memory immediately, but is kept in its Dataflash
+ *  buffer as a write-back cache. Following writes starting within the same page are merged into the cached page,
+ *  avoiding a read-modify-write cycle of the page for each one; the page is committed once a write starts in
+ *  a different page, the Dataflash is read, or \ref DataflashManager_CommitCache() is called.
+ *
  *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
  *  \param[in] BlockAddress  Data block starting address for the write sequence
  *  \param[in] TotalBlocks   Number of blocks of data to write
@@ -55,19 +154,30 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 	bool     UsingSecondBuffer   = false;
+	bool     CacheHit            = (CacheValid && (CachedDFPage == CurrDFPage));
+
+	/* Merge the new data into the cached page if the write starts within it, otherwise commit the cached page */
+	if (CacheHit)
+	  UsingSecondBuffer = CacheInSecondBuffer;
+	else
+	  DataflashManager_InvalidateCache();
 
 	/* Select the correct starting Dataflash IC for the block requested */
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
+	/* Copy selected dataflash's current page contents to the Dataflash buffer, unless it is already cached there */
+	if (!(CacheHit))
+	{
+		Dataflash_WaitWhileBusy();
+		Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(CurrDFPage, 0);
+		Dataflash_WaitWhileBusy();
+	}
 #endif
 
 	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
 	Dataflash_SendAddressBytes(0, CurrDFPageByte);
 
 	/* Wait until endpoint is ready before continuing */
@@ -96,9 +206,11 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
 				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				DataflashManager_ProgramPage(CurrDFPage, UsingSecondBuffer);
+
+				/* Any cached page has now been committed, and its buffer will be reused */
+				CacheValid = false;
+				CacheDirty = false;
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
@@ -111,6 +223,11 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 				/* Select the next Dataflash chip based on the new Dataflash page index */
 				Dataflash_SelectChipFromPage(CurrDFPage);
 
+#if (DATAFLASH_TOTALCHIPS > 1)
+				/* Wait until the Dataflash IC has finished committing any page from the buffer about to be written */
+				Dataflash_WaitWhileBusy();
+#endif
+
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
 				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
 				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
@@ -161,11 +278,12 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 		TotalBlocks--;
 	}
 
-	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
-	Dataflash_WaitWhileBusy();
+	/* Keep the last page in its Dataflash buffer as the write-back cache, rather than committing it immediately */
+	CachedDFPage        = CurrDFPage;
+	CacheInSecondBuffer = UsingSecondBuffer;
+	CacheValid          = true;
+	CacheDirty          = true;
+	CacheLastWriteFrame = USB_Device_GetFrameNumber();
 
 	/* If the endpoint is empty, clear it ready for the next packet from the host */
 	if (!(Endpoint_IsReadWriteAllowed()))
@@ -179,6 +297,10 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
  *  the pre-selected data IN endpoint. This routine reads in Dataflash page sized blocks from the Dataflash
  *  and writes them in OS sized blocks to the endpoint.
  *
+ *  Pages are read through the Dataflash's two internal SRAM buffers in turn, with the next page of the sequence
+ *  copied into one buffer while the current page is read out of the other. This allows the Dataflash to fetch
+ *  the next page while the host is draining the endpoint, rather than the page fetch stalling the transfer.
+ *
  *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
  *  \param[in] BlockAddress  Data block starting address for the read sequence
  *  \param[in] TotalBlocks   Number of blocks of data to read
@@ -187,20 +309,24 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
                                  const uint32_t BlockAddress,
                                  uint16_t TotalBlocks)
 {
+	#if defined(DATAFLASH_READ_BENCHMARK)
+	uint32_t TotalBytes          = ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	#endif
+
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+	uint16_t EndDFPage           = ((((BlockAddress + TotalBlocks) * VIRTUAL_MEMORY_BLOCK_SIZE) + (DATAFLASH_PAGE_SIZE - 1)) / DATAFLASH_PAGE_SIZE);
+	bool     UsingSecondBuffer   = false;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	/* Commit any cached page, as the Dataflash buffers are about to be reused */
+	DataflashManager_InvalidateCache();
 
-	/* Send the Dataflash main memory page read command */
-	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
+	/* Copy the first Dataflash page to be read into the first Dataflash buffer */
+	DataflashManager_LoadPage(CurrDFPage, UsingSecondBuffer);
+
+	/* Start reading the first page from its buffer, loading the next page into the second buffer in the background */
+	DataflashManager_StartBufferRead(CurrDFPage, CurrDFPageByte, UsingSecondBuffer, ((CurrDFPage + 1) < EndDFPage));
 
 	/* Wait until endpoint is ready before continuing */
 	if (Endpoint_WaitUntilReady())
@@ -231,16 +357,11 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
+				/* The new page was loaded into the other Dataflash buffer while the previous page was being read */
+				UsingSecondBuffer = !(UsingSecondBuffer);
 
-				/* Send the Dataflash main memory page read command */
-				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
+				/* Start reading the new page from its buffer, loading the next page into the other buffer in the background */
+				DataflashManager_StartBufferRead(CurrDFPage, 0, UsingSecondBuffer, ((CurrDFPage + 1) < EndDFPage));
 			}
 
 			/* Read one 16-byte chunk of data from the Dataflash */
@@ -282,6 +403,10 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 
 	/* Deselect all Dataflash chips */
 	Dataflash_DeselectChip();
+
+	#if defined(DATAFLASH_READ_BENCHMARK)
+	DataflashManager_RecordRead(TotalBytes);
+	#endif
 }
 
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
@@ -295,18 +420,22 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
  */
 void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
                                       uint16_t TotalBlocks,
-                                      uint8_t* BufferPtr)
+                                      const uint8_t* BufferPtr)
 {
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 	bool     UsingSecondBuffer   = false;
 
+	/* Commit any cached page, as the Dataflash buffers are about to be reused */
+	DataflashManager_InvalidateCache();
+
 	/* Select the correct starting Dataflash IC for the block requested */
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
 	/* Copy selected dataflash's current page contents to the Dataflash buffer */
+	Dataflash_WaitWhileBusy();
 	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
 	Dataflash_SendAddressBytes(CurrDFPage, 0);
 	Dataflash_WaitWhileBusy();
@@ -327,9 +456,7 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
 				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				DataflashManager_ProgramPage(CurrDFPage, UsingSecondBuffer);
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
@@ -342,6 +469,11 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 				/* Select the next Dataflash chip based on the new Dataflash page index */
 				Dataflash_SelectChipFromPage(CurrDFPage);
 
+#if (DATAFLASH_TOTALCHIPS > 1)
+				/* Wait until the Dataflash IC has finished committing any page from the buffer about to be written */
+				Dataflash_WaitWhileBusy();
+#endif
+
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
 				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
 				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
@@ -376,9 +508,7 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	}
 
 	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
+	DataflashManager_ProgramPage(CurrDFPage, UsingSecondBuffer);
 	Dataflash_WaitWhileBusy();
 
 	/* Deselect all Dataflash chips */
@@ -402,9 +532,15 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 
+	/* Commit any cached page, so that its new contents are read back from the Dataflash main memory */
+	DataflashManager_CommitCache();
+
 	/* Select the correct starting Dataflash IC for the block requested */
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
+	/* Wait until the Dataflash IC has finished committing any previously written page */
+	Dataflash_WaitWhileBusy();
+
 	/* Send the Dataflash main memory page read command */
 	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
 	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
@@ -430,6 +566,9 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 				/* Select the next Dataflash chip based on the new Dataflash page index */
 				Dataflash_SelectChipFromPage(CurrDFPage);
 
+				/* Wait until the Dataflash IC has finished committing any previously written page */
+				Dataflash_WaitWhileBusy();
+
 				/* Send the Dataflash main memory page read command */
 				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
 				Dataflash_SendAddressBytes(CurrDFPage, 0);
@@ -458,6 +597,206 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	Dataflash_DeselectChip();
 }
 
+/** Commits the page held in the write-back cache to the Dataflash main memory, if it holds data which has not
+ *  yet been committed, and waits until the page has been programmed. The page remains in the cache, so that
+ *  further writes to it can still be merged.
+ */
+void DataflashManager_CommitCache(void)
+{
+	if (!(CacheDirty))
+	  return;
+
+	/* Write the cached Dataflash buffer contents back to the Dataflash page */
+	DataflashManager_ProgramPage(CachedDFPage, CacheInSecondBuffer);
+	Dataflash_WaitWhileBusy();
+
+	/* Deselect all Dataflash chips */
+	Dataflash_DeselectChip();
+
+	CacheDirty = false;
+}
+
+/** Commits the page held in the write-back cache once no further writes have been made to it for
+ *  \ref DATAFLASH_CACHE_TIMEOUT_MS milliseconds, so that its data is not held in the volatile Dataflash buffer
+ *  indefinitely. The page is committed immediately once the device leaves the configured state, as the host will
+ *  not flush the disk after a disconnection, bus reset or suspension, and the USB frame number the timeout is
+ *  measured against no longer advances. This should be called frequently in the main program loop.
+ */
+void DataflashManager_CacheTask(void)
+{
+	if (!(CacheDirty))
+	  return;
+
+	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
+	    (((USB_Device_GetFrameNumber() - CacheLastWriteFrame) & DATAFLASH_FRAME_NUMBER_MASK) >= DATAFLASH_CACHE_TIMEOUT_MS))
+	{
+		DataflashManager_CommitCache();
+	}
+}
+
+/** Retrieves the number of times the given Dataflash page has been programmed by the Dataflash manager. The count is
+ *  stored in the unused bytes following the page's data, inverted so that a blank page reads back as a count of zero.
+ *
+ *  \param[in] PageAddress  Dataflash page whose wear count is to be retrieved
+ *
+ *  \return Number of times the page has been programmed
+ */
+uint32_t DataflashManager_GetPageWearCount(const uint16_t PageAddress)
+{
+	uint32_t StoredWearCount = 0;
+
+	/* Select the Dataflash chip holding the page, and wait until any operation in progress has completed */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the Dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PageAddress, DATAFLASH_WEAR_COUNTER_OFFSET);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+
+	/* Read in the stored wear counter, in little endian format */
+	for (uint8_t ByteNum = 0; ByteNum < sizeof(uint32_t); ByteNum++)
+	  StoredWearCount |= ((uint32_t)Dataflash_ReceiveByte() << (ByteNum * 8));
+
+	/* Deselect all Dataflash chips */
+	Dataflash_DeselectChip();
+
+	return ~StoredWearCount;
+}
+
+#if defined(DATAFLASH_READ_BENCHMARK)
+/** Prints the throughput of the host's reads from the Dataflash since the last report to the given stream, and
+ *  restarts the measurement. Only the time spent in sequences of reads is counted, so that the figure gives the
+ *  sustained rate of a sequential read such as a large file copy from the disk. The measurement is only made when the
+ *  DATAFLASH_READ_BENCHMARK token is defined in the application configuration, and the report is left to applications
+ *  with a character stream to print it over, such as the VirtualSerialMassStorage demo.
+ *
+ *  \param[in,out] Stream  Stream to print the benchmark report to
+ */
+void DataflashManager_ReportReadBenchmark(FILE* const Stream)
+{
+	uint32_t BytesPerFrame = (BenchmarkFrames ? (BenchmarkBytes / BenchmarkFrames) : 0);
+
+	/* Each full speed USB frame lasts one millisecond, so the bytes per frame need only be scaled to KB/s */
+	fprintf_P(Stream, PSTR("Read %lu KB in %lu ms, %lu KB/s\r\n"), (unsigned long)(BenchmarkBytes >> 10),
+	          (unsigned long)BenchmarkFrames, (unsigned long)((BytesPerFrame * 125) / 128));
+
+	BenchmarkBytes  = 0;
+	BenchmarkFrames = 0;
+}
+#endif
+
+/** Programs the contents of one of the Dataflash buffers into the given Dataflash page, incrementing the page's
+ *  wear counter. The page is programmed in the background once the chip is deselected.
+ *
+ *  \param[in] PageAddress      Dataflash page to program
+ *  \param[in] UseSecondBuffer  Boolean \c true to program the page from the second Dataflash buffer, \c false for the first
+ */
+static void DataflashManager_ProgramPage(const uint16_t PageAddress,
+                                         const bool UseSecondBuffer)
+{
+	uint32_t StoredWearCount = ~(DataflashManager_GetPageWearCount(PageAddress) + 1);
+
+	/* Select the Dataflash chip holding the page */
+	Dataflash_SelectChipFromPage(PageAddress);
+
+	/* Store the new wear counter after the page data in the Dataflash buffer */
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, DATAFLASH_WEAR_COUNTER_OFFSET);
+
+	for (uint8_t ByteNum = 0; ByteNum < sizeof(uint32_t); ByteNum++)
+	  Dataflash_SendByte(StoredWearCount >> (ByteNum * 8));
+
+	/* Send the Dataflash buffer to main memory page program command */
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(PageAddress, 0);
+}
+
+/** Commits the page held in the write-back cache and marks the cache as empty, before the Dataflash buffers are
+ *  reused for another page. Any pages held in the buffers for the bank read backend function are also discarded.
+ */
+static void DataflashManager_InvalidateCache(void)
+{
+	DataflashManager_CommitCache();
+
+	CacheValid      = false;
+	ReadBufferValid = false;
+}
+
+/** Starts copying the given Dataflash page into one of the Dataflash's internal SRAM buffers. This does not
+ *  wait for the copy to complete, which occurs in the background once the chip is deselected.
+ *
+ *  \param[in] PageAddress      Dataflash page to copy into the buffer
+ *  \param[in] UseSecondBuffer  Boolean \c true to copy the page into the second Dataflash buffer, \c false for the first
+ */
+static void DataflashManager_LoadPage(const uint16_t PageAddress,
+                                      const bool UseSecondBuffer)
+{
+	/* Select the Dataflash chip holding the page, and wait until any operation in progress has completed */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the Dataflash main memory to buffer transfer command */
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
+	Dataflash_SendAddressBytes(PageAddress, 0);
+
+	/* Deselect the chip to start the transfer */
+	Dataflash_DeselectChip();
+}
+
+/** Waits until the given Dataflash page has been copied into its Dataflash buffer, and starts reading from the
+ *  buffer at the given byte offset. The following page may also be loaded into the other buffer before the read
+ *  is started, so that it can be fetched from the main memory while the current page is being read out.
+ *
+ *  \param[in] PageAddress      Dataflash page previously loaded into the buffer via \ref DataflashManager_LoadPage()
+ *  \param[in] PageByte         Byte offset within the page to start reading from
+ *  \param[in] UseSecondBuffer  Boolean \c true if the page was loaded into the second Dataflash buffer, \c false for the first
+ *  \param[in] LoadNextPage     Boolean \c true if the following page should be loaded into the other Dataflash buffer
+ */
+static void DataflashManager_StartBufferRead(const uint16_t PageAddress,
+                                             const uint16_t PageByte,
+                                             const bool UseSecondBuffer,
+                                             const bool LoadNextPage)
+{
+	/* Wait until the page has been copied into its Dataflash buffer */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Start copying the next page into the other buffer, while the current page is read out */
+	if (LoadNextPage)
+	  DataflashManager_LoadPage((PageAddress + 1), !(UseSecondBuffer));
+
+	/* Send the Dataflash buffer read command */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2READ : DF_CMD_BUFF1READ);
+	Dataflash_SendAddressBytes(0, PageByte);
+	Dataflash_SendByte(0x00);
+}
+
+#if defined(DATAFLASH_READ_BENCHMARK)
+/** Adds a completed read of the Dataflash by the host to the read benchmark. The time since the end of the previous
+ *  read is counted as part of the read, unless it exceeds \ref DATAFLASH_BENCHMARK_IDLE_MS and so marks the start of
+ *  a new sequence of reads.
+ *
+ *  \param[in] TotalBytes  Number of bytes read
+ */
+static void DataflashManager_RecordRead(const uint32_t TotalBytes)
+{
+	uint16_t CurrentFrame  = USB_Device_GetFrameNumber();
+	uint16_t ElapsedFrames = ((CurrentFrame - BenchmarkLastFrame) & DATAFLASH_FRAME_NUMBER_MASK);
+
+	if (ElapsedFrames < DATAFLASH_BENCHMARK_IDLE_MS)
+	  BenchmarkFrames += ElapsedFrames;
+
+	BenchmarkBytes    += TotalBytes;
+	BenchmarkLastFrame = CurrentFrame;
+}
+#endif
+
 /** Disables the Dataflash memory write protection bits on the board Dataflash ICs, if enabled. */
 void DataflashManager_ResetDataflashProtections(void)
 {
@@ -532,3 +871,222 @@ bool DataflashManager_CheckDataflashOperation(void)
 	return true;
 }
 
+/** SCSI command engine backend function to read blocks from the Dataflash to the pre-selected data IN endpoint, via
+ *  \ref DataflashManager_ReadBlocks().
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Logical unit the blocks are read from
+ *  \param[in] BlockAddress     Data block starting address for the read sequence
+ *  \param[in] TotalBlocks      Number of blocks of data to read
+ *
+ *  \return Boolean \c true if the blocks were read, \c false if the transfer was aborted
+ */
+static bool DataflashManager_SCSIReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                            const MS_SCSI_LUN_t* const LUN,
+                                            const uint32_t BlockAddress,
+                                            const uint16_t TotalBlocks)
+{
+	DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+
+	return !(MSInterfaceInfo->State.IsMassStoreReset);
+}
+
+/** SCSI command engine backend function to write blocks from the pre-selected data OUT endpoint to the Dataflash, via
+ *  \ref DataflashManager_WriteBlocks().
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Logical unit the blocks are written to
+ *  \param[in] BlockAddress     Data block starting address for the write sequence
+ *  \param[in] TotalBlocks      Number of blocks of data to write
+ *
+ *  \return Boolean \c true if the blocks were written, \c false if the transfer was aborted
+ */
+static bool DataflashManager_SCSIWriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                             const MS_SCSI_LUN_t* const LUN,
+                                             const uint32_t BlockAddress,
+                                             const uint16_t TotalBlocks)
+{
+	DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+
+	return !(MSInterfaceInfo->State.IsMassStoreReset);
+}
+
+/** SCSI command engine backend function to read part of a block from the Dataflash to the pre-selected data IN
+ *  endpoint. This allows the SCSI command engine to transfer blocks one endpoint bank at a time from the main program
+ *  loop, so that the other interfaces of the device are not starved while the host reads from the disk.
+ *
+ *  As in \ref DataflashManager_ReadBlocks(), pages are read through the Dataflash's two internal SRAM buffers in turn.
+ *  The page being read is kept in its buffer between calls, and the following page is loaded into the other buffer
+ *  as soon as the page is first read, so that a sequential read only waits on the Dataflash main memory for its first
+ *  page rather than for each bank.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Logical unit the bytes are read from
+ *  \param[in] BlockAddress     Data block containing the bytes to read
+ *  \param[in] BlockOffset      Byte offset within the block of the first byte to read
+ *  \param[in] Length           Number of bytes to read
+ *
+ *  \return Boolean \c true, as reading the Dataflash cannot fail
+ */
+static bool DataflashManager_SCSIReadBank(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_SCSI_LUN_t* const LUN,
+                                          const uint32_t BlockAddress,
+                                          const uint16_t BlockOffset,
+                                          uint16_t Length)
+{
+	#if defined(DATAFLASH_READ_BENCHMARK)
+	uint16_t TotalBytes     = Length;
+	#endif
+
+	uint32_t ByteAddress    = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) + BlockOffset);
+	uint16_t CurrDFPage     = (ByteAddress / DATAFLASH_PAGE_SIZE);
+	uint16_t CurrDFPageByte = (ByteAddress % DATAFLASH_PAGE_SIZE);
+
+	while (Length)
+	{
+		uint16_t BytesInPage  = MIN(Length, (DATAFLASH_PAGE_SIZE - CurrDFPageByte));
+		bool     LoadNextPage = ((CurrDFPage + 1) < (VIRTUAL_MEMORY_BYTES / DATAFLASH_PAGE_SIZE));
+
+		if (ReadBufferValid && (ReadDFPage == CurrDFPage))
+		{
+			/* Continue reading the page from its buffer, which has already been waited on by the previous read */
+			Dataflash_SelectChipFromPage(CurrDFPage);
+			Dataflash_SendByte(ReadInSecondBuffer ? DF_CMD_BUFF2READ : DF_CMD_BUFF1READ);
+			Dataflash_SendAddressBytes(0, CurrDFPageByte);
+			Dataflash_SendByte(0x00);
+		}
+		else
+		{
+			if (ReadBufferValid && ReadNextPageLoaded && ((ReadDFPage + 1) == CurrDFPage))
+			{
+				/* The new page was loaded into the other Dataflash buffer while the previous page was being read */
+				ReadInSecondBuffer = !(ReadInSecondBuffer);
+			}
+			else
+			{
+				/* Commit any cached page, as the Dataflash buffers are about to be reused, and load the new page */
+				DataflashManager_InvalidateCache();
+				DataflashManager_LoadPage(CurrDFPage, false);
+
+				ReadInSecondBuffer = false;
+				ReadBufferValid    = true;
+			}
+
+			/* Start reading the new page from its buffer, loading the next page into the other buffer in the background */
+			DataflashManager_StartBufferRead(CurrDFPage, CurrDFPageByte, ReadInSecondBuffer, LoadNextPage);
+
+			ReadDFPage         = CurrDFPage;
+			ReadNextPageLoaded = LoadNextPage;
+		}
+
+		Length -= BytesInPage;
+
+		while (BytesInPage--)
+		  Endpoint_Write_8(Dataflash_ReceiveByte());
+
+		/* Continue from the start of the next page, if the bytes cross a page boundary */
+		CurrDFPageByte = 0;
+		CurrDFPage++;
+	}
+
+	/* Deselect all Dataflash chips */
+	Dataflash_DeselectChip();
+
+	#if defined(DATAFLASH_READ_BENCHMARK)
+	DataflashManager_RecordRead(TotalBytes);
+	#endif
+
+	return true;
+}
+
+/** SCSI command engine backend function to write part of a block from the pre-selected data OUT endpoint to the
+ *  Dataflash, as for \ref DataflashManager_SCSIReadBank(). The bytes are merged into the page held in the write-back
+ *  cache, which is committed to the Dataflash main memory once a write is made to a different page.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Logical unit the bytes are written to
+ *  \param[in] BlockAddress     Data block containing the bytes to write
+ *  \param[in] BlockOffset      Byte offset within the block of the first byte to write
+ *  \param[in] Length           Number of bytes to write
+ *
+ *  \return Boolean \c true, as writing the Dataflash cannot fail
+ */
+static bool DataflashManager_SCSIWriteBank(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                           const MS_SCSI_LUN_t* const LUN,
+                                           const uint32_t BlockAddress,
+                                           const uint16_t BlockOffset,
+                                           uint16_t Length)
+{
+	uint32_t ByteAddress    = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) + BlockOffset);
+	uint16_t CurrDFPage     = (ByteAddress / DATAFLASH_PAGE_SIZE);
+	uint16_t CurrDFPageByte = (ByteAddress % DATAFLASH_PAGE_SIZE);
+
+	while (Length)
+	{
+		uint16_t BytesInPage = MIN(Length, (DATAFLASH_PAGE_SIZE - CurrDFPageByte));
+
+		/* Commit the cached page if the bytes lie in a different page, and load the new page into the other buffer */
+		if (!(CacheValid) || (CachedDFPage != CurrDFPage))
+		{
+			bool UseSecondBuffer = (CacheValid && !(CacheInSecondBuffer));
+
+			DataflashManager_InvalidateCache();
+			DataflashManager_LoadPage(CurrDFPage, UseSecondBuffer);
+
+			CachedDFPage        = CurrDFPage;
+			CacheInSecondBuffer = UseSecondBuffer;
+			CacheValid          = true;
+		}
+
+		/* Wait until the page has been copied into its Dataflash buffer */
+		Dataflash_SelectChipFromPage(CurrDFPage);
+		Dataflash_WaitWhileBusy();
+
+		/* Send the Dataflash buffer write command */
+		Dataflash_SendByte(CacheInSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+		Dataflash_SendAddressBytes(0, CurrDFPageByte);
+
+		Length -= BytesInPage;
+
+		while (BytesInPage--)
+		  Dataflash_SendByte(Endpoint_Read_8());
+
+		Dataflash_DeselectChip();
+
+		CacheDirty          = true;
+		CacheLastWriteFrame = USB_Device_GetFrameNumber();
+
+		/* Continue from the start of the next page, if the bytes cross a page boundary */
+		CurrDFPageByte = 0;
+		CurrDFPage++;
+	}
+
+	return true;
+}
+
+/** SCSI command engine backend function to commit the write-back cache page to the Dataflash, on a SYNCHRONIZE CACHE
+ *  or START STOP UNIT command from the host.
+ *
+ *  \param[in] LUN  Logical unit whose cached data is to be committed
+ *
+ *  \return Boolean \c true, as committing the cache cannot fail
+ */
+static bool DataflashManager_SCSISynchronizeCache(const MS_SCSI_LUN_t* const LUN)
+{
+	DataflashManager_CommitCache();
+
+	return true;
+}
+
+/** SCSI command engine backend function to check that the Dataflash ICs are functioning, on a SEND DIAGNOSTIC command
+ *  from the host.
+ *
+ *  \param[in] LUN  Logical unit to check
+ *
+ *  \return Boolean \c true if all the Dataflash ICs are present and functioning, \c false otherwise
+ */
+static bool DataflashManager_SCSISelfTest(const MS_SCSI_LUN_t* const LUN)
+{
+	return DataflashManager_CheckDataflashOperation();
+}
+
@@ -61,6 +61,11 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 			},
 	};
 
+/** SCSI logical units of the Mass Storage interface, each mapped to an equal sized partition of the board Dataflash.
+ *  This table is passed to the library SCSI command engine, which dispatches each SCSI command to its logical unit.
+ */
+static MS_SCSI_LUN_t Disk_LUNs[TOTAL_LUNS];
+
 
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
@@ -75,6 +80,7 @@ int main(void)
 	for (;;)
 	{
 		MS_Device_USBTask(&Disk_MS_Interface);
+		DataflashManager_CacheTask();
 		USB_USBTask();
 	}
 }
@@ -115,6 +121,17 @@ void SetupHardware(void)
 
 	/* Clear Dataflash sector protections, if enabled */
 	DataflashManager_ResetDataflashProtections();
+
+	/* Map each logical unit of the disk to its own partition of the Dataflash */
+	for (uint8_t LUNIndex = 0; LUNIndex < TOTAL_LUNS; LUNIndex++)
+	{
+		Disk_LUNs[LUNIndex].Backend     = &DataflashManager_SCSIBackend;
+		Disk_LUNs[LUNIndex].InquiryData = &DataflashManager_InquiryData;
+		Disk_LUNs[LUNIndex].FirstBlock  = ((uint32_t)LUNIndex * LUN_MEDIA_BLOCKS);
+		Disk_LUNs[LUNIndex].TotalBlocks = LUN_MEDIA_BLOCKS;
+		Disk_LUNs[LUNIndex].BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE;
+		Disk_LUNs[LUNIndex].ReadOnly    = DISK_READ_ONLY;
+	}
 }
 
 /** Event handler for the library USB Connection event. */
@@ -154,7 +171,7 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo, Disk_LUNs);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
 	return CommandSuccess;
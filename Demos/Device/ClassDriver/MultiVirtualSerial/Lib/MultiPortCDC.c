@@ -0,0 +1,333 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Multiple port CDC layer. This manages a configurable number of CDC ACM virtual serial ports within a single
+ *  composite device, buffering the data to be sent to the host on each port and scheduling the transmission of
+ *  the buffered data across all ports fairly.
+ *
+ *  Transmission is scheduled by Deficit Round Robin: in each call to \ref MultiCDC_USBTask(), every port with
+ *  queued data is credited with \ref MULTICDC_QUANTUM_BYTES bytes, and may then send packets to the host for as
+ *  long as its credit lasts and its IN endpoint has a free bank. Ports never wait on the host, so a port whose
+ *  host application is not reading data, or which has far more data queued than the others, cannot delay the
+ *  remaining ports.
+ */
+
+#define  INCLUDE_FROM_MULTIPORTCDC_C
+#include "MultiPortCDC.h"
+
+/** State and CDC class driver interface of each CDC port within the device. */
+MultiCDC_Port_t MultiCDC_Ports[CDC_PORT_COUNT];
+
+/** Index of the port the next scheduling round starts from, rotated each round so that no port is favoured. */
+static uint8_t MultiCDC_NextRoundStart;
+
+
+/** Initializes the multiple port CDC layer, setting up the CDC class driver configuration of each port from the
+ *  port's endpoint and interface numbers and clearing its transmit buffer. This must be called before the USB
+ *  interface is enumerated.
+ */
+void MultiCDC_Init(void)
+{
+	for (uint8_t Port = 0; Port < CDC_PORT_COUNT; Port++)
+	{
+		MultiCDC_Port_t* CDCPort = &MultiCDC_Ports[Port];
+
+		memset(CDCPort, 0x00, sizeof(MultiCDC_Port_t));
+
+		CDCPort->CDCInterface.Config.ControlInterfaceNumber       = INTERFACE_ID_CDC_CCI(Port);
+		CDCPort->CDCInterface.Config.DataINEndpoint.Address       = CDC_TX_EPADDR(Port);
+		CDCPort->CDCInterface.Config.DataINEndpoint.Size          = CDC_TXRX_EPSIZE;
+		CDCPort->CDCInterface.Config.DataINEndpoint.Banks         = 1;
+		CDCPort->CDCInterface.Config.DataOUTEndpoint.Address      = CDC_RX_EPADDR(Port);
+		CDCPort->CDCInterface.Config.DataOUTEndpoint.Size         = CDC_TXRX_EPSIZE;
+		CDCPort->CDCInterface.Config.DataOUTEndpoint.Banks        = 1;
+		CDCPort->CDCInterface.Config.NotificationEndpoint.Address = CDC_NOTIFICATION_EPADDR(Port);
+		CDCPort->CDCInterface.Config.NotificationEndpoint.Size    = CDC_NOTIFICATION_EPSIZE;
+		CDCPort->CDCInterface.Config.NotificationEndpoint.Banks   = 1;
+
+		RingBuffer_InitBuffer(&CDCPort->TxBuffer, CDCPort->TxBufferData, sizeof(CDCPort->TxBufferData));
+	}
+}
+
+/** Configures the endpoints of all CDC ports. This should be called from the library's
+ *  \ref EVENT_USB_Device_ConfigurationChanged() event handler.
+ *
+ *  \return Boolean \c true if the endpoints of all ports were successfully configured, \c false otherwise.
+ */
+bool MultiCDC_ConfigureEndpoints(void)
+{
+	bool ConfigSuccess = true;
+
+	for (uint8_t Port = 0; Port < CDC_PORT_COUNT; Port++)
+	{
+		ConfigSuccess &= CDC_Device_ConfigureEndpoints(&MultiCDC_Ports[Port].CDCInterface);
+		MultiCDC_Ports[Port].Deficit = 0;
+	}
+
+	return ConfigSuccess;
+}
+
+/** Processes CDC class control requests directed to any of the CDC ports. This should be called from the
+ *  library's \ref EVENT_USB_Device_ControlRequest() event handler.
+ */
+void MultiCDC_ProcessControlRequest(void)
+{
+	for (uint8_t Port = 0; Port < CDC_PORT_COUNT; Port++)
+	  CDC_Device_ProcessControlRequest(&MultiCDC_Ports[Port].CDCInterface);
+}
+
+/** Runs a single scheduling round, sending the queued data of each port to the host as its credit and the
+ *  availability of its IN endpoint allow. This should be called frequently in the main program loop, in place
+ *  of \ref CDC_Device_USBTask() for each port.
+ */
+void MultiCDC_USBTask(void)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return;
+
+	uint8_t Port = MultiCDC_NextRoundStart;
+
+	for (uint8_t PortsServiced = 0; PortsServiced < CDC_PORT_COUNT; PortsServiced++)
+	{
+		MultiCDC_ServicePort(&MultiCDC_Ports[Port]);
+
+		if (++Port == CDC_PORT_COUNT)
+		  Port = 0;
+	}
+
+	if (++MultiCDC_NextRoundStart == CDC_PORT_COUNT)
+	  MultiCDC_NextRoundStart = 0;
+}
+
+/** Queues data for transmission to the host on the given CDC port. Data which does not fit into the port's
+ *  transmit buffer is discarded, and counted in the port's statistics.
+ *
+ *  \param[in] Port    Zero-based index of the CDC port to send data on.
+ *  \param[in] Buffer  Pointer to the data to send.
+ *  \param[in] Length  Number of bytes to send.
+ *
+ *  \return Number of bytes queued for transmission.
+ */
+uint16_t MultiCDC_SendData(const uint8_t Port,
+                           const void* const Buffer,
+                           const uint16_t Length)
+{
+	MultiCDC_Port_t* CDCPort = &MultiCDC_Ports[Port];
+
+	uint16_t BytesQueued = RingBuffer_InsertBlock(&CDCPort->TxBuffer, (const uint8_t*)Buffer, Length);
+
+	MultiCDC_AddQueueMark(CDCPort, BytesQueued);
+	CDCPort->Statistics.BytesDropped += (Length - BytesQueued);
+
+	return BytesQueued;
+}
+
+/** Reads data received from the host on the given CDC port, without blocking.
+ *
+ *  \param[in]  Port    Zero-based index of the CDC port to read data from.
+ *  \param[out] Buffer  Pointer to a buffer where the received data is to be stored.
+ *  \param[in]  Length  Maximum number of bytes to read.
+ *
+ *  \return Number of bytes read from the host.
+ */
+uint16_t MultiCDC_ReceiveData(const uint8_t Port,
+                              void* const Buffer,
+                              const uint16_t Length)
+{
+	return CDC_Device_ReceiveData(&MultiCDC_Ports[Port].CDCInterface, Buffer, Length);
+}
+
+/** Retrieves the amount of free space in the transmit buffer of the given CDC port.
+ *
+ *  \param[in] Port  Zero-based index of the CDC port to check.
+ *
+ *  \return Number of bytes which may be queued via \ref MultiCDC_SendData() without any being discarded.
+ */
+uint16_t MultiCDC_GetFreeSpace(const uint8_t Port)
+{
+	return RingBuffer_GetFreeCount(&MultiCDC_Ports[Port].TxBuffer);
+}
+
+/** Resets the latency and throughput statistics of the given CDC port.
+ *
+ *  \param[in] Port  Zero-based index of the CDC port to reset.
+ */
+void MultiCDC_ResetStatistics(const uint8_t Port)
+{
+	memset(&MultiCDC_Ports[Port].Statistics, 0x00, sizeof(MultiCDC_PortStatistics_t));
+}
+
+/** Services a single CDC port within a scheduling round, crediting it with a quantum of bytes if it has data
+ *  queued and sending as many packets to the host as its credit allows.
+ *
+ *  \param[in,out] CDCPort  Pointer to the state of the CDC port to service.
+ */
+static void MultiCDC_ServicePort(MultiCDC_Port_t* const CDCPort)
+{
+	/* Idle ports do not accumulate credit, so that they cannot later burst ahead of the other ports */
+	if (RingBuffer_IsEmpty(&CDCPort->TxBuffer))
+	{
+		CDCPort->Deficit = 0;
+		return;
+	}
+
+	/* Hold data back until the host has opened the port, as nothing may be listening for it */
+	if (!(CDCPort->CDCInterface.State.LineEncoding.BaudRateBPS))
+	  return;
+
+	/* Ports blocked by the host keep at most one unused quantum of credit */
+	if (CDCPort->Deficit < MULTICDC_QUANTUM_BYTES)
+	  CDCPort->Deficit += MULTICDC_QUANTUM_BYTES;
+
+	Endpoint_SelectEndpoint(CDCPort->CDCInterface.Config.DataINEndpoint.Address);
+
+	while (Endpoint_IsINReady())
+	{
+		uint16_t BufferCount = RingBuffer_GetCount(&CDCPort->TxBuffer);
+
+		if (!(BufferCount))
+		{
+			CDCPort->Deficit = 0;
+			break;
+		}
+
+		/* Only send a full packet if more data follows it, so that each transfer ends in a short packet and the
+		 * host never needs to wait for a Zero Length Packet to complete its read */
+		uint16_t PacketLength = (BufferCount > CDC_TXRX_EPSIZE) ? CDC_TXRX_EPSIZE : MIN(BufferCount, (CDC_TXRX_EPSIZE - 1));
+
+		if (PacketLength > CDCPort->Deficit)
+		  break;
+
+		MultiCDC_SendPacket(CDCPort, PacketLength);
+		CDCPort->Deficit -= PacketLength;
+	}
+}
+
+/** Sends a single packet of queued data to the host from the given CDC port, whose IN endpoint must be selected
+ *  and ready, and updates the port's statistics.
+ *
+ *  \param[in,out] CDCPort  Pointer to the state of the CDC port to send from.
+ *  \param[in]     Length   Number of queued bytes to send in the packet.
+ */
+static void MultiCDC_SendPacket(MultiCDC_Port_t* const CDCPort,
+                                const uint16_t Length)
+{
+	uint16_t BytesRemaining = Length;
+
+	while (BytesRemaining)
+	{
+		uint8_t* SpanData;
+		uint16_t SpanLength = MIN(RingBuffer_GetReadSpan(&CDCPort->TxBuffer, &SpanData), BytesRemaining);
+
+		Endpoint_Write_Bank(SpanData, SpanLength);
+		RingBuffer_AdvanceRead(&CDCPort->TxBuffer, SpanLength);
+
+		BytesRemaining -= SpanLength;
+	}
+
+	Endpoint_ClearIN();
+
+	uint16_t Latency = MultiCDC_RemoveQueueMarks(CDCPort, Length);
+
+	CDCPort->Statistics.BytesSent    += Length;
+	CDCPort->Statistics.PacketsSent  += 1;
+	CDCPort->Statistics.TotalLatency += Latency;
+
+	if (Latency > CDCPort->Statistics.MaxLatency)
+	  CDCPort->Statistics.MaxLatency = Latency;
+}
+
+/** Records the queuing of data into the transmit buffer of the given CDC port in the port's queue time marks,
+ *  so that the time the data waits in the buffer can later be measured.
+ *
+ *  \param[in,out] CDCPort  Pointer to the state of the CDC port the data was queued on.
+ *  \param[in]     Length   Number of bytes queued.
+ */
+static void MultiCDC_AddQueueMark(MultiCDC_Port_t* const CDCPort,
+                                  const uint16_t Length)
+{
+	if (!(Length))
+	  return;
+
+	uint16_t CurrentFrameNumber = USB_Device_GetFrameNumber();
+
+	/* Merge data queued in the same frame as the newest mark, or once all marks are in use, into the newest mark */
+	if (CDCPort->QueueMarkCount)
+	{
+		MultiCDC_QueueMark_t* NewestMark = &CDCPort->QueueMarks[CDCPort->QueueMarkCount - 1];
+
+		if ((NewestMark->Frame == CurrentFrameNumber) || (CDCPort->QueueMarkCount == MULTICDC_QUEUE_MARKS))
+		{
+			NewestMark->Bytes += Length;
+			return;
+		}
+	}
+
+	MultiCDC_QueueMark_t* NewMark = &CDCPort->QueueMarks[CDCPort->QueueMarkCount++];
+
+	NewMark->Bytes = Length;
+	NewMark->Frame = CurrentFrameNumber;
+}
+
+/** Removes sent data from the queue time marks of the given CDC port, in the order it was queued.
+ *
+ *  \param[in,out] CDCPort  Pointer to the state of the CDC port the data was sent from.
+ *  \param[in]     Length   Number of bytes sent.
+ *
+ *  \return Number of frames the oldest of the sent bytes waited in the port's transmit buffer.
+ */
+static uint16_t MultiCDC_RemoveQueueMarks(MultiCDC_Port_t* const CDCPort,
+                                          uint16_t Length)
+{
+	uint16_t Latency = 0;
+
+	if (CDCPort->QueueMarkCount)
+	  Latency = ((USB_Device_GetFrameNumber() - CDCPort->QueueMarks[0].Frame) & MULTICDC_FRAME_NUMBER_MASK);
+
+	while (Length && CDCPort->QueueMarkCount)
+	{
+		MultiCDC_QueueMark_t* OldestMark = &CDCPort->QueueMarks[0];
+
+		if (OldestMark->Bytes > Length)
+		{
+			OldestMark->Bytes -= Length;
+			break;
+		}
+
+		Length -= OldestMark->Bytes;
+
+		/* Shift the remaining marks down, so that the oldest mark is always the first */
+		memmove(&CDCPort->QueueMarks[0], &CDCPort->QueueMarks[1], (--CDCPort->QueueMarkCount * sizeof(MultiCDC_QueueMark_t)));
+	}
+
+	return Latency;
+}
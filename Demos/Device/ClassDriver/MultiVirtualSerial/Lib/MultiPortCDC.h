@@ -0,0 +1,123 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for MultiPortCDC.c.
+ */
+
+#ifndef _MULTI_PORT_CDC_H_
+#define _MULTI_PORT_CDC_H_
+
+	/* Includes: */
+		#include <LUFA/Drivers/USB/USB.h>
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+
+		#include "../Descriptors.h"
+		#include "../Config/AppConfig.h"
+
+	/* Macros: */
+		/** Number of bytes each backlogged CDC port is allowed to send to the host in each scheduling round. */
+		#define MULTICDC_QUANTUM_BYTES         CDC_TXRX_EPSIZE
+
+		/** Mask for the 11-bit USB frame number, used when calculating port latencies. */
+		#define MULTICDC_FRAME_NUMBER_MASK     0x07FF
+
+		/** Number of queue time marks kept for each port, each recording the frame in which a run of the port's
+		 *  queued bytes was queued. Once all marks are in use, further data is added to the newest mark, so its
+		 *  latency is measured from the time of the newest mark's first byte.
+		 */
+		#define MULTICDC_QUEUE_MARKS           4
+
+	/* Type Defines: */
+		/** Type define for a queue time mark of a CDC port, recording when a run of the port's queued bytes was
+		 *  queued via \ref MultiCDC_SendData().
+		 */
+		typedef struct
+		{
+			uint16_t Bytes; /**< Number of bytes of the run still waiting in the port's transmit buffer. */
+			uint16_t Frame; /**< Frame number in which the first byte of the run was queued. */
+		} MultiCDC_QueueMark_t;
+
+		/** Type define for the latency and throughput statistics of a single CDC port. All latencies are given in
+		 *  USB frames (milliseconds), and give the time the oldest byte of each packet waited in the port's transmit
+		 *  buffer, from when it was queued via \ref MultiCDC_SendData() until the packet was handed to the USB
+		 *  controller.
+		 */
+		typedef struct
+		{
+			uint32_t BytesSent; /**< Total number of bytes sent to the host from the port. */
+			uint32_t PacketsSent; /**< Total number of packets sent to the host from the port. */
+			uint32_t TotalLatency; /**< Sum of the latencies of all packets sent, for calculating the average latency. */
+			uint16_t MaxLatency; /**< Longest latency of any packet sent. */
+			uint16_t BytesDropped; /**< Number of bytes discarded by \ref MultiCDC_SendData() due to a full transmit buffer. */
+		} MultiCDC_PortStatistics_t;
+
+		/** Type define for the state of a single CDC port managed by the multiple port CDC layer. */
+		typedef struct
+		{
+			USB_ClassInfo_CDC_Device_t CDCInterface; /**< CDC class driver interface of the port. */
+			RingBuffer_t              TxBuffer; /**< Buffer of data queued for transmission to the host. */
+			uint8_t                   TxBufferData[MULTICDC_TX_BUFFER_SIZE]; /**< Underlying storage of \c TxBuffer. */
+			uint16_t                  Deficit; /**< Number of bytes the port may still send in the current scheduling round. */
+			MultiCDC_QueueMark_t      QueueMarks[MULTICDC_QUEUE_MARKS]; /**< Queue time marks of the buffered data, oldest first. */
+			uint8_t                   QueueMarkCount; /**< Number of entries of \c QueueMarks in use. */
+			MultiCDC_PortStatistics_t Statistics; /**< Latency and throughput statistics of the port. */
+		} MultiCDC_Port_t;
+
+	/* External Variables: */
+		extern MultiCDC_Port_t MultiCDC_Ports[CDC_PORT_COUNT];
+
+	/* Function Prototypes: */
+		void     MultiCDC_Init(void);
+		bool     MultiCDC_ConfigureEndpoints(void);
+		void     MultiCDC_ProcessControlRequest(void);
+		void     MultiCDC_USBTask(void);
+		uint16_t MultiCDC_SendData(const uint8_t Port,
+		                           const void* const Buffer,
+		                           const uint16_t Length);
+		uint16_t MultiCDC_ReceiveData(const uint8_t Port,
+		                              void* const Buffer,
+		                              const uint16_t Length);
+		uint16_t MultiCDC_GetFreeSpace(const uint8_t Port);
+		void     MultiCDC_ResetStatistics(const uint8_t Port);
+
+		#if defined(INCLUDE_FROM_MULTIPORTCDC_C)
+			static void MultiCDC_ServicePort(MultiCDC_Port_t* const CDCPort);
+			static void MultiCDC_SendPacket(MultiCDC_Port_t* const CDCPort,
+			                                const uint16_t Length);
+			static void MultiCDC_AddQueueMark(MultiCDC_Port_t* const CDCPort,
+			                                  const uint16_t Length);
+			static uint16_t MultiCDC_RemoveQueueMarks(MultiCDC_Port_t* const CDCPort,
+			                                          uint16_t Length);
+		#endif
+
+#endif
+
@@ -47,4 +47,6 @@
 
 	#define DISK_READ_ONLY            false
 
+//	#define DATAFLASH_READ_BENCHMARK
+
 #endif
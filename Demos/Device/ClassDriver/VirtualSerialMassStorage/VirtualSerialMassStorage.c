@@ -91,6 +91,11 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 			},
 	};
 
+/** SCSI logical units of the Mass Storage interface, each mapped to an equal sized partition of the board Dataflash.
+ *  This table is passed to the library SCSI command engine, which dispatches each SCSI command to its logical unit.
+ */
+static MS_SCSI_LUN_t Disk_LUNs[TOTAL_LUNS];
+
 /** Standard file stream for the CDC interface when set up, so that the virtual CDC COM port can be
  *  used like any regular character stream in the C APIs.
  */
@@ -115,10 +120,16 @@ int main(void)
 		CheckJoystickMovement();
 
 		/* Must throw away unused bytes from the host, or it will lock up while waiting for the device */
+		#if defined(DATAFLASH_READ_BENCHMARK)
+		if (CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface) >= 0)
+		  DataflashManager_ReportReadBenchmark(&USBSerialStream);
+		#else
 		CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
+		#endif
 
 		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
 		MS_Device_USBTask(&Disk_MS_Interface);
+		DataflashManager_CacheTask();
 		USB_USBTask();
 	}
 }
@@ -160,6 +171,17 @@ void SetupHardware(void)
 
 	/* Clear Dataflash sector protections, if enabled */
 	DataflashManager_ResetDataflashProtections();
+
+	/* Map each logical unit of the disk to its own partition of the Dataflash */
+	for (uint8_t LUNIndex = 0; LUNIndex < TOTAL_LUNS; LUNIndex++)
+	{
+		Disk_LUNs[LUNIndex].Backend     = &DataflashManager_SCSIBackend;
+		Disk_LUNs[LUNIndex].InquiryData = &DataflashManager_InquiryData;
+		Disk_LUNs[LUNIndex].FirstBlock  = ((uint32_t)LUNIndex * LUN_MEDIA_BLOCKS);
+		Disk_LUNs[LUNIndex].TotalBlocks = LUN_MEDIA_BLOCKS;
+		Disk_LUNs[LUNIndex].BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE;
+		Disk_LUNs[LUNIndex].ReadOnly    = DISK_READ_ONLY;
+	}
 }
 
 /** Checks for changes in the position of the board joystick, sending strings to the host upon each change. */
@@ -251,7 +273,7 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo, Disk_LUNs);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
 	return CommandSuccess;
@@ -34,15 +34,53 @@
  *  blocks of data. These functions are called by the SCSI layer when data must be stored
  *  or retrieved to/from the physical storage media. If a different media is used (such
  *  as a SD card or EEPROM), functions similar to these will need to be generated.
+ *
+ *  An identical copy of this file is kept in each of the Dataflash based Mass Storage demos and projects, rather than
+ *  a single shared copy, so that each application remains self-contained and can be copied out of the LUFA tree and
+ *  built on its own; the application specific includes and definitions are confined to DataflashManager.h. Only the
+ *  copy in the LowLevel MassStorage demo differs, as that demo has its own SCSI command handler in place of the library
+ *  SCSI command engine, and so has no SCSI backend functions or bank read state, and no class driver interface
+ *  parameter. A change made to one copy should be made to all of them.
  */
 
 #define  INCLUDE_FROM_DATAFLASHMANAGER_C
 #include "DataflashManager.h"
 
+/** Dataflash page currently held in the write-back cache, within one of the internal buffers of its Dataflash IC. */
+static uint16_t CachedDFPage;
+
+/** Indicates if the write-back cache page is held in the second Dataflash buffer of its Dataflash IC, rather than the first. */
+static bool     CacheInSecondBuffer;
+
+/** Indicates if the write-back cache currently holds a Dataflash page. */
+static bool     CacheValid;
+
+/** Indicates if the write-back cache page holds data which has not yet been committed to the Dataflash main memory. */
+static bool     CacheDirty;
+
+/** USB frame number of the last write into the write-back cache page, for committing the page once writes have ceased. */
+static uint16_t CacheLastWriteFrame;
+
+#if defined(DATAFLASH_READ_BENCHMARK)
+/** Number of bytes read from the Dataflash by the host since the last read benchmark report. */
+static uint32_t BenchmarkBytes;
+
+/** Number of USB frames spent reading the Dataflash since the last read benchmark report, excluding idle periods. */
+static uint32_t BenchmarkFrames;
+
+/** USB frame number at the end of the last read of the Dataflash by the host. */
+static uint16_t BenchmarkLastFrame;
+#endif
+
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
  *  the pre-selected data OUT endpoint. This routine reads in OS sized blocks from the endpoint and writes
  *  them to the Dataflash in Dataflash page sized blocks.
  *
+ *  The last page written is not committed to the Dataflash main memory immediately, but is kept in its Dataflash
+ *  buffer as a write-back cache. Following writes starting within the same page are merged into the cached page,
+ *  avoiding a read-modify-write cycle of the page for each one; the page is committed once a write starts in
+ *  a different page, the Dataflash is read, or \ref DataflashManager_CommitCache() is called.
+ *
  *  \param[in] BlockAddress  Data block starting address for the write sequence
  *  \param[in] TotalBlocks   Number of blocks of data to write
  */
@@ -53,19 +91,30 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 	bool     UsingSecondBuffer   = false;
+	bool     CacheHit            = (CacheValid && (CachedDFPage == CurrDFPage));
+
+	/* Merge the new data into the cached page if the write starts within it, otherwise commit the cached page */
+	if (CacheHit)
+	  UsingSecondBuffer = CacheInSecondBuffer;
+	else
+	  DataflashManager_InvalidateCache();
 
 	/* Select the correct starting Dataflash IC for the block requested */
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
+	/* Copy selected dataflash's current page contents to the Dataflash buffer, unless it is already cached there */
+	if (!(CacheHit))
+	{
+		Dataflash_WaitWhileBusy();
+		Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(CurrDFPage, 0);
+		Dataflash_WaitWhileBusy();
+	}
 #endif
 
 	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
 	Dataflash_SendAddressBytes(0, CurrDFPageByte);
 
 	/* Wait until endpoint is ready before continuing */
@@ -94,9 +143,11 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
 				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				DataflashManager_ProgramPage(CurrDFPage, UsingSecondBuffer);
+
+				/* Any cached page has now been committed, and its buffer will be reused */
+				CacheValid = false;
+				CacheDirty = false;
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
@@ -109,6 +160,11 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 				/* Select the next Dataflash chip based on the new Dataflash page index */
 				Dataflash_SelectChipFromPage(CurrDFPage);
 
+#if (DATAFLASH_TOTALCHIPS > 1)
+				/* Wait until the Dataflash IC has finished committing any page from the buffer about to be written */
+				Dataflash_WaitWhileBusy();
+#endif
+
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
 				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
 				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
@@ -159,11 +215,12 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 		TotalBlocks--;
 	}
 
-	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
-	Dataflash_WaitWhileBusy();
+	/* Keep the last page in its Dataflash buffer as the write-back cache, rather than committing it immediately */
+	CachedDFPage        = CurrDFPage;
+	CacheInSecondBuffer = UsingSecondBuffer;
+	CacheValid          = true;
+	CacheDirty          = true;
+	CacheLastWriteFrame = USB_Device_GetFrameNumber();
 
 	/* If the endpoint is empty, clear it ready for the next packet from the host */
 	if (!(Endpoint_IsReadWriteAllowed()))
@@ -177,26 +234,34 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
  *  the pre-selected data IN endpoint. This routine reads in Dataflash page sized blocks from the Dataflash
  *  and writes them in OS sized blocks to the endpoint.
  *
+ *  Pages are read through the Dataflash's two internal SRAM buffers in turn, with the next page of the sequence
+ *  copied into one buffer while the current page is read out of the other. This allows the Dataflash to fetch
+ *  the next page while the host is draining the endpoint, rather than the page fetch stalling the transfer.
+ *
  *  \param[in] BlockAddress  Data block starting address for the read sequence
  *  \param[in] TotalBlocks   Number of blocks of data to read
  */
 void DataflashManager_ReadBlocks(const uint32_t BlockAddress,
                                  uint16_t TotalBlocks)
 {
+	#if defined(DATAFLASH_READ_BENCHMARK)
+	uint32_t TotalBytes          = ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	#endif
+
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+	uint16_t EndDFPage           = ((((BlockAddress + TotalBlocks) * VIRTUAL_MEMORY_BLOCK_SIZE) + (DATAFLASH_PAGE_SIZE - 1)) / DATAFLASH_PAGE_SIZE);
+	bool     UsingSecondBuffer   = false;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	/* Commit any cached page, as the Dataflash buffers are about to be reused */
+	DataflashManager_InvalidateCache();
 
-	/* Send the Dataflash main memory page read command */
-	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
+	/* Copy the first Dataflash page to be read into the first Dataflash buffer */
+	DataflashManager_LoadPage(CurrDFPage, UsingSecondBuffer);
+
+	/* Start reading the first page from its buffer, loading the next page into the second buffer in the background */
+	DataflashManager_StartBufferRead(CurrDFPage, CurrDFPageByte, UsingSecondBuffer, ((CurrDFPage + 1) < EndDFPage));
 
 	/* Wait until endpoint is ready before continuing */
 	if (Endpoint_WaitUntilReady())
@@ -227,16 +292,11 @@ void DataflashManager_ReadBlocks(const uint32_t BlockAddress,
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
+				/* The new page was loaded into the other Dataflash buffer while the previous page was being read */
+				UsingSecondBuffer = !(UsingSecondBuffer);
 
-				/* Send the Dataflash main memory page read command */
-				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
+				/* Start reading the new page from its buffer, loading the next page into the other buffer in the background */
+				DataflashManager_StartBufferRead(CurrDFPage, 0, UsingSecondBuffer, ((CurrDFPage + 1) < EndDFPage));
 			}
 
 			/* Read one 16-byte chunk of data from the Dataflash */
@@ -278,6 +338,10 @@ void DataflashManager_ReadBlocks(const uint32_t BlockAddress,
 
 	/* Deselect all Dataflash chips */
 	Dataflash_DeselectChip();
+
+	#if defined(DATAFLASH_READ_BENCHMARK)
+	DataflashManager_RecordRead(TotalBytes);
+	#endif
 }
 
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
@@ -291,18 +355,22 @@ void DataflashManager_ReadBlocks(const uint32_t BlockAddress,
  */
 void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
                                       uint16_t TotalBlocks,
-                                      uint8_t* BufferPtr)
+                                      const uint8_t* BufferPtr)
 {
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 	bool     UsingSecondBuffer   = false;
 
+	/* Commit any cached page, as the Dataflash buffers are about to be reused */
+	DataflashManager_InvalidateCache();
+
 	/* Select the correct starting Dataflash IC for the block requested */
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
 	/* Copy selected dataflash's current page contents to the Dataflash buffer */
+	Dataflash_WaitWhileBusy();
 	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
 	Dataflash_SendAddressBytes(CurrDFPage, 0);
 	Dataflash_WaitWhileBusy();
@@ -323,9 +391,7 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
 				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				DataflashManager_ProgramPage(CurrDFPage, UsingSecondBuffer);
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
@@ -338,6 +404,11 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 				/* Select the next Dataflash chip based on the new Dataflash page index */
 				Dataflash_SelectChipFromPage(CurrDFPage);
 
+#if (DATAFLASH_TOTALCHIPS > 1)
+				/* Wait until the Dataflash IC has finished committing any page from the buffer about to be written */
+				Dataflash_WaitWhileBusy();
+#endif
+
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
 				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
 				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
@@ -372,9 +443,7 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	}
 
 	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
+	DataflashManager_ProgramPage(CurrDFPage, UsingSecondBuffer);
 	Dataflash_WaitWhileBusy();
 
 	/* Deselect all Dataflash chips */
@@ -398,9 +467,15 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 
+	/* Commit any cached page, so that its new contents are read back from the Dataflash main memory */
+	DataflashManager_CommitCache();
+
 	/* Select the correct starting Dataflash IC for the block requested */
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
+	/* Wait until the Dataflash IC has finished committing any previously written page */
+	Dataflash_WaitWhileBusy();
+
 	/* Send the Dataflash main memory page read command */
 	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
 	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
@@ -426,6 +501,9 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 				/* Select the next Dataflash chip based on the new Dataflash page index */
 				Dataflash_SelectChipFromPage(CurrDFPage);
 
+				/* Wait until the Dataflash IC has finished committing any previously written page */
+				Dataflash_WaitWhileBusy();
+
 				/* Send the Dataflash main memory page read command */
 				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
 				Dataflash_SendAddressBytes(CurrDFPage, 0);
@@ -454,6 +532,205 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	Dataflash_DeselectChip();
 }
 
+/** Commits the page held in the write-back cache to the Dataflash main memory, if it holds data which has not
+ *  yet been committed, and waits until the page has been programmed. The page remains in the cache, so that
+ *  further writes to it can still be merged.
+ */
+void DataflashManager_CommitCache(void)
+{
+	if (!(CacheDirty))
+	  return;
+
+	/* Write the cached Dataflash buffer contents back to the Dataflash page */
+	DataflashManager_ProgramPage(CachedDFPage, CacheInSecondBuffer);
+	Dataflash_WaitWhileBusy();
+
+	/* Deselect all Dataflash chips */
+	Dataflash_DeselectChip();
+
+	CacheDirty = false;
+}
+
+/** Commits the page held in the write-back cache once no further writes have been made to it for
+ *  \ref DATAFLASH_CACHE_TIMEOUT_MS milliseconds, so that its data is not held in the volatile Dataflash buffer
+ *  indefinitely. The page is committed immediately once the device leaves the configured state, as the host will
+ *  not flush the disk after a disconnection, bus reset or suspension, and the USB frame number the timeout is
+ *  measured against no longer advances. This should be called frequently in the main program loop.
+ */
+void DataflashManager_CacheTask(void)
+{
+	if (!(CacheDirty))
+	  return;
+
+	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
+	    (((USB_Device_GetFrameNumber() - CacheLastWriteFrame) & DATAFLASH_FRAME_NUMBER_MASK) >= DATAFLASH_CACHE_TIMEOUT_MS))
+	{
+		DataflashManager_CommitCache();
+	}
+}
+
+/** Retrieves the number of times the given Dataflash page has been programmed by the Dataflash manager. The count is
+ *  stored in the unused bytes following the page's data, inverted so that a blank page reads back as a count of zero.
+ *
+ *  \param[in] PageAddress  Dataflash page whose wear count is to be retrieved
+ *
+ *  \return Number of times the page has been programmed
+ */
+uint32_t DataflashManager_GetPageWearCount(const uint16_t PageAddress)
+{
+	uint32_t StoredWearCount = 0;
+
+	/* Select the Dataflash chip holding the page, and wait until any operation in progress has completed */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the Dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PageAddress, DATAFLASH_WEAR_COUNTER_OFFSET);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+
+	/* Read in the stored wear counter, in little endian format */
+	for (uint8_t ByteNum = 0; ByteNum < sizeof(uint32_t); ByteNum++)
+	  StoredWearCount |= ((uint32_t)Dataflash_ReceiveByte() << (ByteNum * 8));
+
+	/* Deselect all Dataflash chips */
+	Dataflash_DeselectChip();
+
+	return ~StoredWearCount;
+}
+
+#if defined(DATAFLASH_READ_BENCHMARK)
+/** Prints the throughput of the host's reads from the Dataflash since the last report to the given stream, and
+ *  restarts the measurement. Only the time spent in sequences of reads is counted, so that the figure gives the
+ *  sustained rate of a sequential read such as a large file copy from the disk. The measurement is only made when the
+ *  DATAFLASH_READ_BENCHMARK token is defined in the application configuration, and the report is left to applications
+ *  with a character stream to print it over, such as the VirtualSerialMassStorage demo.
+ *
+ *  \param[in,out] Stream  Stream to print the benchmark report to
+ */
+void DataflashManager_ReportReadBenchmark(FILE* const Stream)
+{
+	uint32_t BytesPerFrame = (BenchmarkFrames ? (BenchmarkBytes / BenchmarkFrames) : 0);
+
+	/* Each full speed USB frame lasts one millisecond, so the bytes per frame need only be scaled to KB/s */
+	fprintf_P(Stream, PSTR("Read %lu KB in %lu ms, %lu KB/s\r\n"), (unsigned long)(BenchmarkBytes >> 10),
+	          (unsigned long)BenchmarkFrames, (unsigned long)((BytesPerFrame * 125) / 128));
+
+	BenchmarkBytes  = 0;
+	BenchmarkFrames = 0;
+}
+#endif
+
+/** Programs the contents of one of the Dataflash buffers into the given Dataflash page, incrementing the page's
+ *  wear counter. The page is programmed in the background once the chip is deselected.
+ *
+ *  \param[in] PageAddress      Dataflash page to program
+ *  \param[in] UseSecondBuffer  Boolean \c true to program the page from the second Dataflash buffer, \c false for the first
+ */
+static void DataflashManager_ProgramPage(const uint16_t PageAddress,
+                                         const bool UseSecondBuffer)
+{
+	uint32_t StoredWearCount = ~(DataflashManager_GetPageWearCount(PageAddress) + 1);
+
+	/* Select the Dataflash chip holding the page */
+	Dataflash_SelectChipFromPage(PageAddress);
+
+	/* Store the new wear counter after the page data in the Dataflash buffer */
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, DATAFLASH_WEAR_COUNTER_OFFSET);
+
+	for (uint8_t ByteNum = 0; ByteNum < sizeof(uint32_t); ByteNum++)
+	  Dataflash_SendByte(StoredWearCount >> (ByteNum * 8));
+
+	/* Send the Dataflash buffer to main memory page program command */
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(PageAddress, 0);
+}
+
+/** Commits the page held in the write-back cache and marks the cache as empty, before the Dataflash buffers are
+ *  reused for another page.
+ */
+static void DataflashManager_InvalidateCache(void)
+{
+	DataflashManager_CommitCache();
+
+	CacheValid = false;
+}
+
+/** Starts copying the given Dataflash page into one of the Dataflash's internal SRAM buffers. This does not
+ *  wait for the copy to complete, which occurs in the background once the chip is deselected.
+ *
+ *  \param[in] PageAddress      Dataflash page to copy into the buffer
+ *  \param[in] UseSecondBuffer  Boolean \c true to copy the page into the second Dataflash buffer, \c false for the first
+ */
+static void DataflashManager_LoadPage(const uint16_t PageAddress,
+                                      const bool UseSecondBuffer)
+{
+	/* Select the Dataflash chip holding the page, and wait until any operation in progress has completed */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the Dataflash main memory to buffer transfer command */
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
+	Dataflash_SendAddressBytes(PageAddress, 0);
+
+	/* Deselect the chip to start the transfer */
+	Dataflash_DeselectChip();
+}
+
+/** Waits until the given Dataflash page has been copied into its Dataflash buffer, and starts reading from the
+ *  buffer at the given byte offset. The following page may also be loaded into the other buffer before the read
+ *  is started, so that it can be fetched from the main memory while the current page is being read out.
+ *
+ *  \param[in] PageAddress      Dataflash page previously loaded into the buffer via \ref DataflashManager_LoadPage()
+ *  \param[in] PageByte         Byte offset within the page to start reading from
+ *  \param[in] UseSecondBuffer  Boolean \c true if the page was loaded into the second Dataflash buffer, \c false for the first
+ *  \param[in] LoadNextPage     Boolean \c true if the following page should be loaded into the other Dataflash buffer
+ */
+static void DataflashManager_StartBufferRead(const uint16_t PageAddress,
+                                             const uint16_t PageByte,
+                                             const bool UseSecondBuffer,
+                                             const bool LoadNextPage)
+{
+	/* Wait until the page has been copied into its Dataflash buffer */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Start copying the next page into the other buffer, while the current page is read out */
+	if (LoadNextPage)
+	  DataflashManager_LoadPage((PageAddress + 1), !(UseSecondBuffer));
+
+	/* Send the Dataflash buffer read command */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2READ : DF_CMD_BUFF1READ);
+	Dataflash_SendAddressBytes(0, PageByte);
+	Dataflash_SendByte(0x00);
+}
+
+#if defined(DATAFLASH_READ_BENCHMARK)
+/** Adds a completed read of the Dataflash by the host to the read benchmark. The time since the end of the previous
+ *  read is counted as part of the read, unless it exceeds \ref DATAFLASH_BENCHMARK_IDLE_MS and so marks the start of
+ *  a new sequence of reads.
+ *
+ *  \param[in] TotalBytes  Number of bytes read
+ */
+static void DataflashManager_RecordRead(const uint32_t TotalBytes)
+{
+	uint16_t CurrentFrame  = USB_Device_GetFrameNumber();
+	uint16_t ElapsedFrames = ((CurrentFrame - BenchmarkLastFrame) & DATAFLASH_FRAME_NUMBER_MASK);
+
+	if (ElapsedFrames < DATAFLASH_BENCHMARK_IDLE_MS)
+	  BenchmarkFrames += ElapsedFrames;
+
+	BenchmarkBytes    += TotalBytes;
+	BenchmarkLastFrame = CurrentFrame;
+}
+#endif
+
 /** Disables the Dataflash memory write protection bits on the board Dataflash ICs, if enabled. */
 void DataflashManager_ResetDataflashProtections(void)
 {
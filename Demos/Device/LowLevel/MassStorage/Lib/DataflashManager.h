@@ -41,11 +41,14 @@
 
 		#include "../MassStorage.h"
 		#include "../Descriptors.h"
+		#include "Config/AppConfig.h"
 
 		#include <LUFA/Common/Common.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/Board/Dataflash.h>
 
+		#include <stdio.h>
+
 	/* Preprocessor Checks: */
 		#if (DATAFLASH_PAGE_SIZE % 16)
 			#error Dataflash page size must be a multiple of 16 bytes.
@@ -68,6 +71,24 @@
 		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
 		#define LUN_MEDIA_BLOCKS                    (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)
 
+		/** Time in milliseconds after the last write to the write-back cache page before it is committed to the Dataflash
+		 *  main memory. This must be less than 2048, the range of the USB frame number used to time it.
+		 */
+		#define DATAFLASH_CACHE_TIMEOUT_MS          100
+
+		/** Byte offset within each Dataflash page of the page's wear counter. This lies within the unused bytes the
+		 *  Dataflash provides after the data area of each page.
+		 */
+		#define DATAFLASH_WEAR_COUNTER_OFFSET       DATAFLASH_PAGE_SIZE
+
+		/** Mask for the 11-bit USB frame number, used when timing the write-back cache. */
+		#define DATAFLASH_FRAME_NUMBER_MASK         0x07FF
+
+		/** Gap in milliseconds between two reads of the Dataflash beyond which the second read is taken to start a new
+		 *  sequence, so that the idle time between sequences is excluded from the read benchmark.
+		 */
+		#define DATAFLASH_BENCHMARK_IDLE_MS         50
+
 	/* Function Prototypes: */
 		void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 		                                  uint16_t TotalBlocks);
@@ -75,12 +96,35 @@
 		                                 uint16_t TotalBlocks);
 		void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 		                                      uint16_t TotalBlocks,
-		                                      uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
+		                                      const uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
 		void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 		                                     uint16_t TotalBlocks,
 		                                     uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
 		void DataflashManager_ResetDataflashProtections(void);
 		bool DataflashManager_CheckDataflashOperation(void);
+		void DataflashManager_CommitCache(void);
+		void DataflashManager_CacheTask(void);
+		uint32_t DataflashManager_GetPageWearCount(const uint16_t PageAddress);
+
+		#if defined(DATAFLASH_READ_BENCHMARK)
+			void DataflashManager_ReportReadBenchmark(FILE* const Stream) ATTR_NON_NULL_PTR_ARG(1);
+		#endif
+
+		#if defined(INCLUDE_FROM_DATAFLASHMANAGER_C)
+			static void DataflashManager_ProgramPage(const uint16_t PageAddress,
+			                                         const bool UseSecondBuffer);
+			static void DataflashManager_InvalidateCache(void);
+			static void DataflashManager_LoadPage(const uint16_t PageAddress,
+			                                      const bool UseSecondBuffer);
+			static void DataflashManager_StartBufferRead(const uint16_t PageAddress,
+			                                             const uint16_t PageByte,
+			                                             const bool UseSecondBuffer,
+			                                             const bool LoadNextPage);
+
+			#if defined(DATAFLASH_READ_BENCHMARK)
+				static void DataflashManager_RecordRead(const uint32_t TotalBytes);
+			#endif
+		#endif
 
 #endif
 
@@ -115,6 +115,13 @@ bool SCSI_DecodeSCSICommand(void)
 			CommandSuccess = SCSI_Command_ModeSense_6();
 			break;
 		case SCSI_CMD_START_STOP_UNIT:
+		case SCSI_CMD_SYNCHRONIZE_CACHE_10:
+			/* Commit any cached write data to the Dataflash before the host detaches or powers down the medium */
+			DataflashManager_CommitCache();
+
+			CommandSuccess = true;
+			CommandBlock.DataTransferLength = 0;
+			break;
 		case SCSI_CMD_TEST_UNIT_READY:
 		case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
 		case SCSI_CMD_VERIFY_10:
@@ -60,6 +60,7 @@ int main(void)
 	for (;;)
 	{
 		MassStorage_Task();
+		DataflashManager_CacheTask();
 		USB_USBTask();
 	}
 }
@@ -0,0 +1,12 @@
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2021.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+#
+
+# Stand-in for the DMBS CORE module when a project makefile is built for the
+# simulated architecture through lufa-sim-project.mk. The module does not
+# depend on the target architecture, so the DMBS module itself is used.
+include $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))/../../DMBS/DMBS/core.mk
@@ -0,0 +1,12 @@
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2021.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+#
+
+# Stand-in for the DMBS GCC module when a project makefile is built for the
+# simulated architecture through lufa-sim-project.mk. The project is built
+# with the build machine's own toolchain by the LUFA SIM module instead.
+include $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))/../lufa-sim.mk
@@ -0,0 +1,11 @@
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2021.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+#
+
+# Stand-in for the DMBS HID module when a project makefile is built for the
+# simulated architecture through lufa-sim-project.mk. A native build has no
+# target to program, so the module provides no targets.
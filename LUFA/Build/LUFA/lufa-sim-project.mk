@@ -0,0 +1,34 @@
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2021.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+#
+
+# Builds an unmodified LUFA project makefile for the simulated architecture. Run
+# from the project directory as "make -f <LUFA_PATH>/Build/LUFA/lufa-sim-project.mk"
+# followed by any target of the LUFA SIM module, e.g. "so" for a loopback device
+# library. The DMBS modules included by the project makefile are replaced by the
+# stand-ins in the SIM directory beside this file, which build the project with
+# the LUFA SIM module and its default simulated architecture configuration.
+
+# Directory of the DMBS module stand-ins, which must be absolute as the project makefile is included
+# from the project directory
+LUFA_SIM_MODULE_PATH := $(abspath $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))/SIM)
+
+# Override the project's target architecture and board, which are assigned unconditionally by the project makefile
+override ARCH        := SIM
+override BOARD       := NONE
+
+# Project makefile to build, and the DMBS module path it includes the DMBS modules from
+PROJECT_MAKEFILE     ?= makefile
+DMBS_PATH            := $(LUFA_SIM_MODULE_PATH)
+
+# Default simulated architecture LUFA configuration, used in place of the project's own
+SIM_CONFIG_PATH      ?= $(abspath $(LUFA_SIM_MODULE_PATH)/../../../Platform/SIM/Config)
+
+# Default target
+all:
+
+include $(PROJECT_MAKEFILE)
@@ -0,0 +1,204 @@
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2021.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+#
+
+# Include Guard
+ifeq ($(filter LUFA_SIM, $(DMBS_BUILD_MODULES)),)
+
+DMBS_BUILD_MODULES         += LUFA_SIM
+DMBS_BUILD_TARGETS         += size symbol-sizes all exe so run clean mostlyclean
+DMBS_BUILD_MANDATORY_VARS  += TARGET ARCH SRC LUFA_PATH
+DMBS_BUILD_OPTIONAL_VARS   += COMPILER_PATH OPTIMIZATION C_STANDARD CPP_STANDARD F_CPU C_FLAGS CPP_FLAGS CC_FLAGS
+DMBS_BUILD_OPTIONAL_VARS   += LD_FLAGS OBJDIR OBJECT_FILES DEBUG_LEVEL RUN_ARGS SIM_CONFIG_PATH
+DMBS_BUILD_PROVIDED_VARS   +=
+DMBS_BUILD_PROVIDED_MACROS +=
+
+SHELL = /bin/sh
+
+ERROR_IF_UNSET   ?= $(if $(filter undefined, $(origin $(strip $(1)))), $(error Makefile $(strip $(1)) value not set))
+ERROR_IF_EMPTY   ?= $(if $(strip $($(strip $(1)))), , $(error Makefile $(strip $(1)) option cannot be blank))
+ERROR_IF_NONBOOL ?= $(if $(filter Y N, $($(strip $(1)))), , $(error Makefile $(strip $(1)) option must be Y or N))
+
+# Default values of optionally user-supplied variables
+COMPILER_PATH      ?=
+OPTIMIZATION       ?= 2
+F_CPU              ?=
+C_STANDARD         ?= gnu99
+CPP_STANDARD       ?= gnu++11
+C_FLAGS            ?=
+CPP_FLAGS          ?=
+CC_FLAGS           ?=
+OBJDIR             ?= obj/sim
+OBJECT_FILES       ?=
+DEBUG_LEVEL        ?= 2
+RUN_ARGS           ?=
+SIM_CONFIG_PATH    ?=
+
+# Sanity check user supplied values
+$(foreach MANDATORY_VAR, $(DMBS_BUILD_MANDATORY_VARS), $(call ERROR_IF_UNSET, $(MANDATORY_VAR)))
+$(call ERROR_IF_EMPTY, TARGET)
+$(call ERROR_IF_EMPTY, ARCH)
+$(call ERROR_IF_EMPTY, LUFA_PATH)
+$(call ERROR_IF_EMPTY, OPTIMIZATION)
+$(call ERROR_IF_EMPTY, C_STANDARD)
+$(call ERROR_IF_EMPTY, CPP_STANDARD)
+$(call ERROR_IF_EMPTY, OBJDIR)
+$(call ERROR_IF_EMPTY, DEBUG_LEVEL)
+
+# The simulated architecture is always built with the build machine's own toolchain
+ifneq ($(ARCH), SIM)
+   $(error The LUFA SIM build module can only be used with ARCH=SIM)
+endif
+
+# Output Messages
+MSG_INFO_MESSAGE := ' [INFO]    :'
+MSG_COMPILE_CMD  := ' [GCC]     :'
+MSG_NM_CMD       := ' [NM]      :'
+MSG_REMOVE_CMD   := ' [RM]      :'
+MSG_LINK_CMD     := ' [LNK]     :'
+MSG_SIZE_CMD     := ' [SIZE]    :'
+MSG_RUN_CMD      := ' [RUN]     :'
+
+# The simulated platform support is always required, so add the platform sources if the application did not list them
+SRC        := $(SRC) $(filter-out $(SRC), $(LUFA_SRC_PLATFORM))
+
+# Convert input source file list to differentiate them by type
+C_SOURCE   := $(filter %.c, $(SRC))
+CPP_SOURCE := $(filter %.cpp, $(SRC))
+
+# Create a list of unknown source file types, if any are found throw an error
+UNKNOWN_SOURCE := $(filter-out $(C_SOURCE) $(CPP_SOURCE), $(SRC))
+ifneq ($(UNKNOWN_SOURCE),)
+   $(error Unknown input source file formats for the simulated architecture: $(UNKNOWN_SOURCE))
+endif
+
+# Convert input source filenames into a list of required output object files, always in a separate
+# object file directory so that the native objects never mix with those of an on-target build
+OBJECT_FILES += $(addsuffix .o, $(basename $(SRC)))
+OBJECT_FILES := $(addprefix $(patsubst %/,%,$(OBJDIR))/, $(notdir $(OBJECT_FILES)))
+
+# Check if any object file (without path) appears more than once in the object file list
+ifneq ($(words $(sort $(OBJECT_FILES))), $(words $(OBJECT_FILES)))
+   $(error Cannot build for the simulated architecture - one or more object file name is not unique)
+endif
+
+# Create the output object file directory if it does not exist and add it to the virtual path list
+$(shell mkdir -p $(OBJDIR) 2> /dev/null)
+VPATH += $(dir $(SRC))
+
+# Create a list of dependency files from the list of object files
+DEPENDENCY_FILES := $(OBJECT_FILES:%.o=%.d)
+
+# Create a list of common flags to pass to the compiler/linker; all objects are position independent
+# so that a device mode build may also be linked as a shared library for the host to device loopback
+BASE_CC_FLAGS  := -pipe -g$(DEBUG_LEVEL) -fPIC -fshort-wchar
+BASE_CC_FLAGS  += -Wall -fno-strict-aliasing -funsigned-char -funsigned-bitfields -ffunction-sections
+BASE_CC_FLAGS  += -I. -I$(patsubst %/,%,$(LUFA_PATH))/Platform/SIM/Compat
+BASE_CC_FLAGS  += -DARCH=ARCH_SIM -DDMBS_ARCH_SIM
+
+# A given simulated architecture LUFA configuration header directory is searched before the application's
+# own include paths, so that its LUFA configuration header is used in place of the application's
+ifneq ($(SIM_CONFIG_PATH),)
+   BASE_CC_FLAGS += -I$(patsubst %/,%,$(SIM_CONFIG_PATH))
+endif
+
+# Additional language specific compiler flags
+BASE_C_FLAGS   := -x c -O$(OPTIMIZATION) -std=$(C_STANDARD) -Wstrict-prototypes
+BASE_CPP_FLAGS := -x c++ -O$(OPTIMIZATION) -std=$(CPP_STANDARD)
+
+# The target clock speed has no meaning when simulated, but is passed on for applications which derive values from it
+ifneq ($(F_CPU),)
+   BASE_C_FLAGS   += -DF_CPU=$(F_CPU)UL
+   BASE_CPP_FLAGS += -DF_CPU=$(F_CPU)UL
+endif
+
+# Create a list of flags to pass to the linker; the dynamic loader library is required by the host to
+# device loopback, which loads the device firmware as a shared library
+BASE_LD_FLAGS  := -lm -ldl -Wl,--gc-sections
+
+# Pre-build informational target, to give compiler and project name information when building
+build_begin:
+	@echo $(MSG_INFO_MESSAGE) Begin compilation of project \"$(TARGET)\" for the simulated architecture...
+	@echo ""
+	@$(COMPILER_PATH)gcc --version
+
+# Post-build informational target, to project name information when building has completed
+build_end:
+	@echo $(MSG_INFO_MESSAGE) Finished building project \"$(TARGET)\".
+
+# Prints size information of a compiled application
+size: $(TARGET)
+	@echo $(MSG_SIZE_CMD) Determining size of \"$<\"
+	@echo ""
+	$(COMPILER_PATH)size $<
+
+# Prints size information on the symbols within a compiled application in decimal bytes
+symbol-sizes: $(TARGET)
+	@echo $(MSG_NM_CMD) Extracting \"$<\" symbols with decimal byte sizes
+	$(COMPILER_PATH)nm --size-sort --demangle --radix=d $<
+
+# Cleans intermediary build files, leaving only the compiled application files
+mostlyclean:
+	@echo $(MSG_REMOVE_CMD) Removing object files of \"$(TARGET)\"
+	rm -f $(OBJECT_FILES)
+	@echo $(MSG_REMOVE_CMD) Removing dependency files of \"$(TARGET)\"
+	rm -f $(DEPENDENCY_FILES)
+	rm -f $(OBJDIR)/$(TARGET).map
+
+# Cleans all build files, leaving only the original source code
+clean: mostlyclean
+	@echo $(MSG_REMOVE_CMD) Removing output files of \"$(TARGET)\"
+	rm -f $(TARGET) $(TARGET).so
+
+# Performs a complete build of the user application as a native executable
+all: build_begin exe build_end
+
+# Helper targets, to build a specific type of output file without having to know the project target name
+exe: $(TARGET)
+so: $(TARGET).so
+
+# Builds and runs the native executable, passing it the arguments given in RUN_ARGS
+run: $(TARGET)
+	@echo $(MSG_RUN_CMD) Running \"$<\"
+	./$< $(RUN_ARGS)
+
+# Default target to *create* the user application's specified source files; if this rule is executed by
+# make, the input source file doesn't exist and an error needs to be presented to the user
+$(SRC):
+	$(error Source file does not exist: $@)
+
+# Compiles an input C source file and generates a linkable object file for it
+$(OBJDIR)/%.o: %.c $(MAKEFILE_LIST)
+	@echo $(MSG_COMPILE_CMD) Compiling C file \"$(notdir $<)\"
+	$(COMPILER_PATH)gcc -c $(BASE_CC_FLAGS) $(BASE_C_FLAGS) $(CC_FLAGS) $(C_FLAGS) $($(notdir $<)_FLAGS) -MMD -MP -MF $(@:%.o=%.d) $< -o $@
+
+# Compiles an input C++ source file and generates a linkable object file for it
+$(OBJDIR)/%.o: %.cpp $(MAKEFILE_LIST)
+	@echo $(MSG_COMPILE_CMD) Compiling C++ file \"$(notdir $<)\"
+	$(COMPILER_PATH)gcc -c $(BASE_CC_FLAGS) $(BASE_CPP_FLAGS) $(CC_FLAGS) $(CPP_FLAGS) $($(notdir $<)_FLAGS) -MMD -MP -MF $(@:%.o=%.d) $< -o $@
+
+# Links the user application into a native executable for the build machine
+.PRECIOUS  : $(OBJECT_FILES)
+$(TARGET): $(OBJECT_FILES)
+	@echo $(MSG_LINK_CMD) Linking object files into \"$@\"
+	$(COMPILER_PATH)gcc $^ -o $@ $(BASE_LD_FLAGS) $(LD_FLAGS)
+
+# Links the user application into a native shared library, which can be loaded into a host mode build as
+# a loopback device via USB_Loopback_AttachDevice(); only the entry points used by the loopback are exported,
+# so that unused library code is discarded in the same way as for an executable
+$(TARGET).so: $(OBJECT_FILES)
+	@echo $(MSG_LINK_CMD) Linking object files into \"$@\"
+	echo "{ global: main; USB_VirtualHost_LoopbackPort; local: *; };" > $(OBJDIR)/$(TARGET).map
+	$(COMPILER_PATH)gcc -shared -Wl,--version-script=$(OBJDIR)/$(TARGET).map -Wl,--no-undefined $^ -o $@ $(BASE_LD_FLAGS) $(LD_FLAGS)
+
+# Include build dependency files
+-include $(DEPENDENCY_FILES)
+
+# Phony build targets for this module
+.PHONY: build_begin build_end $(DMBS_BUILD_TARGETS)
+
+endif
@@ -39,6 +39,7 @@ LUFA_SRC_USB_COMMON      := $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/USBContro
                             $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/USBInterrupt_$(ARCH).c    \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Core/ConfigDescriptors.c               \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Core/Events.c                          \
+                            $(LUFA_ROOT_PATH)/Drivers/USB/Core/Profiling.c                       \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Core/USBTask.c                         \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Common/HIDParser.c               \
 
@@ -54,11 +55,17 @@ LUFA_SRC_USB_DEVICE      := $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/Device_$(
                             $(LUFA_ROOT_PATH)/Drivers/USB/Core/DeviceStandardReq.c               \
                             $(LUFA_SRC_USB_COMMON)
 
+ifeq ($(ARCH), SIM)
+   LUFA_SRC_USB_DEVICE   += $(LUFA_ROOT_PATH)/Drivers/USB/Core/SIM/VirtualHost_SIM.c
+   LUFA_SRC_USB_HOST     += $(LUFA_ROOT_PATH)/Drivers/USB/Core/SIM/Loopback_SIM.c
+endif
+
 LUFA_SRC_USBCLASS_DEVICE := $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/AudioClassDevice.c        \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/CCIDClassDevice.c         \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/CDCClassDevice.c          \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/HIDClassDevice.c          \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/MassStorageClassDevice.c  \
+                            $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/MassStorageSCSI.c         \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/MIDIClassDevice.c         \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/PrinterClassDevice.c      \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/RNDISClassDevice.c        \
@@ -86,6 +93,10 @@ LUFA_SRC_TWI             := $(LUFA_ROOT_PATH)/Drivers/Peripheral/$(ARCH)/TWI_$(A
 ifeq ($(ARCH), UC3)
    LUFA_SRC_PLATFORM     := $(LUFA_ROOT_PATH)/Platform/UC3/Exception.S   \
                             $(LUFA_ROOT_PATH)/Platform/UC3/InterruptManagement.c
+else ifeq ($(ARCH), SIM)
+   LUFA_SRC_PLATFORM     := $(LUFA_ROOT_PATH)/Platform/SIM/InterruptManagement.c \
+                            $(LUFA_ROOT_PATH)/Platform/SIM/Streams.c             \
+                            $(LUFA_ROOT_PATH)/Drivers/Board/SIM/Dataflash_SIM.c
 else
    LUFA_SRC_PLATFORM     :=
 endif
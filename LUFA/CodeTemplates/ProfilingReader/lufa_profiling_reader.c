@@ -0,0 +1,220 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/*
+ *  Host side reader for the USB profiling counters of a LUFA device built with the
+ *  LUFA_ENABLE_PROFILING compile time option. The counters are fetched via the library's
+ *  profiling vendor control request and printed as a table, optionally repeatedly along
+ *  with the transfer rate of each endpoint since the previous sample.
+ *
+ *  Usage: lufa_profiling_reader VID:PID [-r] [-w seconds] [-q request]
+ *      -r          Reset the device's counters after reading them
+ *      -w seconds  Re-read the counters every given number of seconds until interrupted
+ *      -q request  Vendor request number, if USB_PROFILING_VENDOR_REQUEST was overridden
+ *
+ *  Requires libusb-1.0. The device must not have a kernel driver bound to interface 0 that
+ *  rejects vendor requests; all standard LUFA class drivers accept them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <libusb.h>
+
+#define PROFILING_DEFAULT_REQUEST   0xF0
+#define PROFILING_TABLE_SUMMARY     0
+#define PROFILING_TABLE_ENDPOINTS   1
+#define PROFILING_TABLE_PIPES       2
+#define PROFILING_MAX_ENTRIES       32
+#define CONTROL_TIMEOUT_MS          1000
+
+typedef struct
+{
+	uint32_t bytes;
+	uint32_t packets;
+	uint32_t busy_waits;
+	uint32_t stalls;
+} counters_t;
+
+static libusb_device_handle *handle;
+static uint8_t vendor_request = PROFILING_DEFAULT_REQUEST;
+
+static uint32_t get_le32(const uint8_t *buf)
+{
+	return ((uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));
+}
+
+static int read_table(uint16_t table, uint16_t index, uint8_t *buf, uint16_t len)
+{
+	int r = libusb_control_transfer(handle,
+	                                LIBUSB_ENDPOINT_IN | LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE,
+	                                vendor_request, table, index, buf, len, CONTROL_TIMEOUT_MS);
+
+	return (r == len) ? 0 : -1;
+}
+
+static int read_counters(uint16_t table, uint8_t count, counters_t *counters)
+{
+	uint8_t buf[16];
+
+	for (uint8_t i = 0; i < count; i++) {
+		if (read_table(table, i, buf, sizeof(buf)))
+			return -1;
+
+		counters[i].bytes      = get_le32(&buf[0]);
+		counters[i].packets    = get_le32(&buf[4]);
+		counters[i].busy_waits = get_le32(&buf[8]);
+		counters[i].stalls     = get_le32(&buf[12]);
+	}
+
+	return 0;
+}
+
+static void print_table(const char *name, uint8_t count, const counters_t *now,
+                        const counters_t *prev, double interval)
+{
+	printf("%-5s %12s %10s %12s %8s", name, "bytes", "packets", "busy-waits", "stalls");
+	if (prev)
+		printf(" %12s", "bytes/s");
+	printf("\n");
+
+	for (uint8_t i = 0; i < count; i++) {
+		if (!now[i].packets && !now[i].bytes && !now[i].busy_waits && !now[i].stalls)
+			continue;
+
+		printf("%-5u %12u %10u %12u %8u", i, now[i].bytes, now[i].packets,
+		       now[i].busy_waits, now[i].stalls);
+		if (prev)
+			printf(" %12.0f", (uint32_t)(now[i].bytes - prev[i].bytes) / interval);
+		printf("\n");
+	}
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s VID:PID [-r] [-w seconds] [-q request]\n", prog);
+	fprintf(stderr, "  -r          Reset the counters after reading them\n");
+	fprintf(stderr, "  -w seconds  Repeat every given number of seconds\n");
+	fprintf(stderr, "  -q request  Vendor request number (default 0x%02X)\n", PROFILING_DEFAULT_REQUEST);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int vid, pid;
+	int reset = 0, watch = 0, opt;
+	counters_t endpoints[2][PROFILING_MAX_ENTRIES], pipes[2][PROFILING_MAX_ENTRIES];
+	int sample = 0;
+
+	if (argc < 2 || sscanf(argv[1], "%x:%x", &vid, &pid) != 2)
+		usage(argv[0]);
+
+	optind = 2;
+	while ((opt = getopt(argc, argv, "rw:q:")) != -1) {
+		switch (opt) {
+		case 'r':
+			reset = 1;
+			break;
+		case 'w':
+			watch = atoi(optarg);
+			break;
+		case 'q':
+			vendor_request = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if (libusb_init(NULL)) {
+		fprintf(stderr, "Unable to initialize libusb\n");
+		return 1;
+	}
+
+	handle = libusb_open_device_with_vid_pid(NULL, vid, pid);
+	if (!handle) {
+		fprintf(stderr, "Unable to open device %04X:%04X\n", vid, pid);
+		libusb_exit(NULL);
+		return 1;
+	}
+
+	for (;;) {
+		uint8_t summary[4];
+		uint8_t total_endpoints, total_pipes;
+		counters_t *prev_endpoints = (sample ? endpoints[(sample - 1) & 1] : NULL);
+		counters_t *prev_pipes     = (sample ? pipes[(sample - 1) & 1] : NULL);
+
+		if (read_table(PROFILING_TABLE_SUMMARY, 0, summary, sizeof(summary))) {
+			fprintf(stderr, "Device did not respond to the profiling request; "
+			                "was it built with LUFA_ENABLE_PROFILING?\n");
+			break;
+		}
+
+		total_endpoints = summary[0];
+		total_pipes     = summary[1];
+		if (total_endpoints > PROFILING_MAX_ENTRIES)
+			total_endpoints = PROFILING_MAX_ENTRIES;
+		if (total_pipes > PROFILING_MAX_ENTRIES)
+			total_pipes = PROFILING_MAX_ENTRIES;
+
+		if (read_counters(PROFILING_TABLE_ENDPOINTS, total_endpoints, endpoints[sample & 1]) ||
+		    read_counters(PROFILING_TABLE_PIPES, total_pipes, pipes[sample & 1])) {
+			fprintf(stderr, "Failed to read counters\n");
+			break;
+		}
+
+		printf("Longest USB_USBTask() interval: %u ms\n", summary[2] | (summary[3] << 8));
+		print_table("EP", total_endpoints, endpoints[sample & 1], prev_endpoints, watch);
+		if (total_pipes)
+			print_table("Pipe", total_pipes, pipes[sample & 1], prev_pipes, watch);
+
+		if (reset) {
+			libusb_control_transfer(handle,
+			                        LIBUSB_ENDPOINT_OUT | LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE,
+			                        vendor_request, 0, 0, NULL, 0, CONTROL_TIMEOUT_MS);
+			memset(endpoints[sample & 1], 0, sizeof(endpoints[0]));
+			memset(pipes[sample & 1], 0, sizeof(pipes[0]));
+		}
+
+		if (!watch)
+			break;
+
+		printf("\n");
+		fflush(stdout);
+		sleep(watch);
+		sample++;
+	}
+
+	libusb_close(handle);
+	libusb_exit(NULL);
+	return 0;
+}
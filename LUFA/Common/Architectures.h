@@ -70,6 +70,11 @@
 			/** Selects the Atmel XMEGA AVR (ATXMEGA* chips) architecture. */
 			#define ARCH_XMEGA          2
 
+			/** Selects the host-native simulated architecture, for running the USB stack in a regular process on the
+			 *  build machine against an in-memory USB controller and scripted virtual host.
+			 */
+			#define ARCH_SIM            3
+
 			#if !defined(__DOXYGEN__)
 				#define ARCH_           ARCH_AVR8
 
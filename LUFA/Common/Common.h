@@ -139,6 +139,38 @@
 			#define ARCH_HAS_MULTI_ADDRESS_SPACE
 			#define ARCH_LITTLE_ENDIAN
 
+			#include "Endianness.h"
+		#elif (ARCH == ARCH_SIM)
+			#include <stdio.h>
+			#include <time.h>
+			#include <math.h>
+
+			#define PROGMEM
+			#define PSTR(s)                  (s)
+			#define pgm_read_byte(x)         (*(const uint8_t*)(x))
+			#define pgm_read_word(x)         (*(const uint16_t*)(x))
+			#define pgm_read_dword(x)        (*(const uint32_t*)(x))
+			#define pgm_read_ptr(x)          (*(void* const*)(x))
+			#define memcmp_P(...)            memcmp(__VA_ARGS__)
+			#define memcpy_P(...)            memcpy(__VA_ARGS__)
+			#define strlen_P(...)            strlen(__VA_ARGS__)
+			#define printf_P(...)            printf(__VA_ARGS__)
+			#define fprintf_P(...)           fprintf(__VA_ARGS__)
+			#define fputs_P(...)             fputs(__VA_ARGS__)
+			#define puts_P(...)              puts(__VA_ARGS__)
+
+			#define ISR(Name, ...)           void Name (void) __VA_ARGS__; void Name (void)
+
+			typedef uint8_t uint_reg_t;
+
+			/* Simulated global interrupt enable flag, see LUFA/Platform/SIM/InterruptManagement.h */
+			extern volatile uint_reg_t SIM_GlobalInterruptMask;
+
+			/* Program space data is held in RAM, but accessed through the program space macros above so that the
+			 * FLASH variants of the library functions can be provided */
+			#define ARCH_HAS_FLASH_ADDRESS_SPACE
+			#define ARCH_LITTLE_ENDIAN
+
 			#include "Endianness.h"
 		#else
 			#error Unknown device architecture specified.
@@ -291,6 +323,9 @@
 					while (Milliseconds--)
 					  _delay_ms(1);
 				}
+				#elif (ARCH == ARCH_SIM)
+				struct timespec Delay = {.tv_sec = (Milliseconds / 1000), .tv_nsec = ((Milliseconds % 1000) * 1000000L)};
+				nanosleep(&Delay, NULL);
 				#endif
 			}
 
@@ -313,6 +348,8 @@
 				return __builtin_mfsr(AVR32_SR);
 				#elif (ARCH == ARCH_XMEGA)
 				return SREG;
+				#elif (ARCH == ARCH_SIM)
+				return SIM_GlobalInterruptMask;
 				#endif
 			}
 
@@ -338,6 +375,8 @@
 				  __builtin_csrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				SREG = GlobalIntState;
+				#elif (ARCH == ARCH_SIM)
+				SIM_GlobalInterruptMask = GlobalIntState;
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -358,6 +397,8 @@
 				__builtin_csrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				sei();
+				#elif (ARCH == ARCH_SIM)
+				SIM_GlobalInterruptMask = 1;
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -378,6 +419,8 @@
 				__builtin_ssrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				cli();
+				#elif (ARCH == ARCH_SIM)
+				SIM_GlobalInterruptMask = 0;
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -50,12 +50,16 @@
  *
  *  \section Sec_Dataflash_Dependencies Module Source Dependencies
  *  The following files must be built with any user project that uses this module:
- *    - None
+ *    - None, except on the host-native simulated architecture:
+ *      - LUFA/Drivers/Board/SIM/Dataflash_SIM.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
  *
  *  \section Sec_Dataflash_ModDescription Module Description
  *  Dataflash driver. This module provides an easy to use interface for the Dataflash ICs located on many boards,
  *  for the storage of large amounts of data into the Dataflash's non-volatile memory.
  *
+ *  If the \c BOARD value is set to \c BOARD_NONE on the host-native simulated architecture, a simulated Dataflash
+ *  IC is provided, see \ref Group_Dataflash_SIM.
+ *
  *  If the \c BOARD value is set to \c BOARD_USER, this will include the \c /Board/Dataflash.h file in the user project
  *  directory. Otherwise, it will include the appropriate built-in board driver header file.
  *
@@ -223,7 +227,9 @@
 			static inline uint8_t Dataflash_ReceiveByte(void);
 
 		/* Includes: */
-			#if (BOARD == BOARD_NONE)
+			#if (BOARD == BOARD_NONE) && (ARCH == ARCH_SIM)
+				#include "SIM/Dataflash.h"
+			#elif (BOARD == BOARD_NONE)
 				#define DATAFLASH_TOTALCHIPS  0
 				#define DATAFLASH_NO_CHIP     0
 				#define DATAFLASH_CHIP1       0
@@ -0,0 +1,210 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../Common/Common.h"
+#if (ARCH == ARCH_SIM) && (BOARD == BOARD_NONE)
+
+#include <string.h>
+
+#include "../Dataflash.h"
+
+/* Geometry of the simulated AT45DB321C, whose pages and buffers each hold 16 bytes beyond DATAFLASH_PAGE_SIZE */
+#define DATAFLASH_SIM_PAGE_BYTES      528
+#define DATAFLASH_SIM_BLOCK_PAGES     8
+
+/* Status register value of the simulated AT45DB321C, always ready with sector protection disabled */
+#define DATAFLASH_SIM_STATUS          (DF_STATUS_READY | (0x0D << 2))
+
+/** Page array, buffers and command state of the simulated Dataflash IC. */
+static struct
+{
+	bool     PoweredUp; /**< Indicates if the memory array has been erased after start-up */
+	uint8_t  SelectedChip; /**< Currently selected chip mask, either \ref DATAFLASH_NO_CHIP or \ref DATAFLASH_CHIP1 */
+	uint8_t  Command; /**< Command of the current transaction, valid once \c CommandBytes is nonzero */
+	uint8_t  CommandBytes; /**< Number of command, address and dummy bytes received in the current transaction */
+	uint32_t Address; /**< 24-bit address sent with the current transaction's command */
+	uint16_t DataByte; /**< Byte offset of the current transaction's next data byte */
+
+	uint8_t  Buffers[2][DATAFLASH_SIM_PAGE_BYTES];
+	uint8_t  Pages[DATAFLASH_PAGES][DATAFLASH_SIM_PAGE_BYTES];
+} Dataflash_SIM;
+
+static void Dataflash_SIM_PowerUp(void)
+{
+	if (Dataflash_SIM.PoweredUp)
+	  return;
+
+	memset(Dataflash_SIM.Pages, 0xFF, sizeof(Dataflash_SIM.Pages));
+	Dataflash_SIM.PoweredUp = true;
+}
+
+static uint8_t Dataflash_SIM_HeaderBytes(const uint8_t Command)
+{
+	/* Number of command, address and dummy bytes which precede the data bytes of each command */
+	switch (Command)
+	{
+		case DF_CMD_MAINMEMPAGEREAD:
+			return (1 + 3 + 4);
+		case DF_CMD_BUFF1READ:
+		case DF_CMD_BUFF2READ:
+			return (1 + 3 + 1);
+		case DF_CMD_GETSTATUS:
+		case DF_CMD_READMANUFACTURERDEVICEINFO:
+		case DF_CMD_SECTORPROTECTIONOFF_BYTE1:
+			return 1;
+		default:
+			return (1 + 3);
+	}
+}
+
+static uint16_t Dataflash_SIM_PageAddress(void)
+{
+	return ((Dataflash_SIM.Address >> 10) % DATAFLASH_PAGES);
+}
+
+static void Dataflash_SIM_Execute(void)
+{
+	uint16_t PageAddress = Dataflash_SIM_PageAddress();
+	uint8_t* Page        = Dataflash_SIM.Pages[PageAddress];
+
+	/* Commands which transfer or program whole pages start once the chip is deselected, completing immediately */
+	switch (Dataflash_SIM.Command)
+	{
+		case DF_CMD_MAINMEMTOBUFF1:
+		case DF_CMD_MAINMEMTOBUFF2:
+			memcpy(Dataflash_SIM.Buffers[Dataflash_SIM.Command == DF_CMD_MAINMEMTOBUFF2], Page, DATAFLASH_SIM_PAGE_BYTES);
+			break;
+		case DF_CMD_BUFF1TOMAINMEMWITHERASE:
+		case DF_CMD_BUFF2TOMAINMEMWITHERASE:
+			memcpy(Page, Dataflash_SIM.Buffers[Dataflash_SIM.Command == DF_CMD_BUFF2TOMAINMEMWITHERASE], DATAFLASH_SIM_PAGE_BYTES);
+			break;
+		case DF_CMD_MAINMEMPAGETHROUGHBUFF1:
+		case DF_CMD_MAINMEMPAGETHROUGHBUFF2:
+			memcpy(Page, Dataflash_SIM.Buffers[Dataflash_SIM.Command == DF_CMD_MAINMEMPAGETHROUGHBUFF2], DATAFLASH_SIM_PAGE_BYTES);
+			break;
+		case DF_CMD_BUFF1TOMAINMEM:
+		case DF_CMD_BUFF2TOMAINMEM:
+		{
+			/* Programming without an erase can only clear bits of the page */
+			uint8_t* Buffer = Dataflash_SIM.Buffers[Dataflash_SIM.Command == DF_CMD_BUFF2TOMAINMEM];
+
+			for (uint16_t PageByte = 0; PageByte < DATAFLASH_SIM_PAGE_BYTES; PageByte++)
+			  Page[PageByte] &= Buffer[PageByte];
+
+			break;
+		}
+		case DF_CMD_PAGEERASE:
+			memset(Page, 0xFF, DATAFLASH_SIM_PAGE_BYTES);
+			break;
+		case DF_CMD_BLOCKERASE:
+			PageAddress &= ~(DATAFLASH_SIM_BLOCK_PAGES - 1);
+			memset(Dataflash_SIM.Pages[PageAddress], 0xFF, (DATAFLASH_SIM_BLOCK_PAGES * DATAFLASH_SIM_PAGE_BYTES));
+			break;
+	}
+}
+
+void Dataflash_SIM_Init(void)
+{
+	Dataflash_SIM_PowerUp();
+	Dataflash_SIM_SelectChip(DATAFLASH_NO_CHIP);
+}
+
+uint8_t Dataflash_SIM_GetSelectedChip(void)
+{
+	return Dataflash_SIM.SelectedChip;
+}
+
+void Dataflash_SIM_SelectChip(const uint8_t ChipMask)
+{
+	Dataflash_SIM_PowerUp();
+
+	/* Deselecting the chip ends the current transaction, starting any page operation it has fully addressed */
+	if ((Dataflash_SIM.SelectedChip != DATAFLASH_NO_CHIP) &&
+	    (Dataflash_SIM.CommandBytes >= Dataflash_SIM_HeaderBytes(Dataflash_SIM.Command)))
+	{
+		Dataflash_SIM_Execute();
+	}
+
+	Dataflash_SIM.SelectedChip = (ChipMask & DATAFLASH_CHIP1);
+	Dataflash_SIM.CommandBytes = 0;
+	Dataflash_SIM.Address      = 0;
+	Dataflash_SIM.DataByte     = 0;
+}
+
+uint8_t Dataflash_SIM_TransferByte(const uint8_t Byte)
+{
+	if (Dataflash_SIM.SelectedChip == DATAFLASH_NO_CHIP)
+	  return 0xFF;
+
+	/* Collect the command, address and dummy bytes of the transaction */
+	if (!(Dataflash_SIM.CommandBytes) || (Dataflash_SIM.CommandBytes < Dataflash_SIM_HeaderBytes(Dataflash_SIM.Command)))
+	{
+		if (!(Dataflash_SIM.CommandBytes))
+		  Dataflash_SIM.Command = Byte;
+		else if (Dataflash_SIM.CommandBytes <= 3)
+		  Dataflash_SIM.Address = ((Dataflash_SIM.Address << 8) | Byte);
+
+		if (++Dataflash_SIM.CommandBytes == Dataflash_SIM_HeaderBytes(Dataflash_SIM.Command))
+		  Dataflash_SIM.DataByte = (Dataflash_SIM.Address & 0x3FF) % DATAFLASH_SIM_PAGE_BYTES;
+
+		return 0xFF;
+	}
+
+	uint16_t DataByte = Dataflash_SIM.DataByte;
+	Dataflash_SIM.DataByte = ((DataByte + 1) % DATAFLASH_SIM_PAGE_BYTES);
+
+	switch (Dataflash_SIM.Command)
+	{
+		case DF_CMD_GETSTATUS:
+			return DATAFLASH_SIM_STATUS;
+		case DF_CMD_READMANUFACTURERDEVICEINFO:
+			return ((const uint8_t[]){DF_MANUFACTURER_ATMEL, 0x27, 0x01, 0x00})[MIN(DataByte, 3)];
+		case DF_CMD_MAINMEMPAGEREAD:
+			return Dataflash_SIM.Pages[Dataflash_SIM_PageAddress()][DataByte];
+		case DF_CMD_BUFF1READ:
+		case DF_CMD_BUFF2READ:
+			return Dataflash_SIM.Buffers[Dataflash_SIM.Command == DF_CMD_BUFF2READ][DataByte];
+		case DF_CMD_BUFF1WRITE:
+		case DF_CMD_BUFF2WRITE:
+		case DF_CMD_MAINMEMPAGETHROUGHBUFF1:
+		case DF_CMD_MAINMEMPAGETHROUGHBUFF2:
+		{
+			bool SecondBuffer = ((Dataflash_SIM.Command == DF_CMD_BUFF2WRITE) ||
+			                     (Dataflash_SIM.Command == DF_CMD_MAINMEMPAGETHROUGHBUFF2));
+
+			Dataflash_SIM.Buffers[SecondBuffer][DataByte] = Byte;
+			return 0xFF;
+		}
+		default:
+			return 0xFF;
+	}
+}
+
+#endif
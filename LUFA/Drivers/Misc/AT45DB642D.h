@@ -72,6 +72,8 @@
 			#define DF_CMD_CONTARRAYREAD_LF                 0x03
 			#define DF_CMD_BUFF1READ_LF                     0xD1
 			#define DF_CMD_BUFF2READ_LF                     0xD3
+			#define DF_CMD_BUFF1READ                        0xD4
+			#define DF_CMD_BUFF2READ                        0xD6
 
 			#define DF_CMD_BUFF1WRITE                       0x84
 			#define DF_CMD_BUFF2WRITE                       0x87
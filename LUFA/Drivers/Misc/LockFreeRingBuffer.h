@@ -0,0 +1,285 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Lock-free single producer, single consumer ring (circular) buffer of bytes.
+ *
+ *  Lock-free ring buffer for the common case of a single producer and a single consumer, such as an
+ *  ISR filling a buffer which is drained from the main program loop. Multiple buffers can be created
+ *  of different sizes to suit different needs.
+ */
+
+/** \ingroup Group_MiscDrivers
+ *  \defgroup Group_LockFreeRingBuff Lock-Free Byte Ring Buffer - LUFA/Drivers/Misc/LockFreeRingBuffer.h
+ *  \brief Lock-free single producer, single consumer ring buffer of bytes.
+ *
+ *  \section Sec_LockFreeRingBuff_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - None
+ *
+ *  \section Sec_LockFreeRingBuff_ModDescription Module Description
+ *  Lock-free variant of the \ref Group_RingBuff driver, with the same API shape. Rather than maintaining a
+ *  shared byte count that must be updated inside an atomic section, each buffer keeps separate free-running
+ *  insertion and removal indexes, each of which is only ever written by one side of the buffer. The number of
+ *  stored bytes is derived from the difference of the two indexes, and the storage location of each byte from
+ *  the index masked to the buffer size. As each index is exactly one machine register wide, it is read and
+ *  written atomically, and no global interrupt disable is needed on the insertion, removal or count paths.
+ *  This makes this buffer type well suited to high rate ISR producers, such as a USART receive interrupt,
+ *  where the interrupt latency added by the atomic sections of \ref RingBuffer_t is undesirable.
+ *
+ *  In exchange, the size of the buffer's underlying storage array must be a power of two, and may not exceed
+ *  half the range of the architecture's \c uint_reg_t type; i.e. the maximum buffer size is 128 bytes on the
+ *  8-bit AVR8, XMEGA and SIM architectures.
+ *
+ *  Only a single execution thread (main program thread or an ISR) may insert into a given buffer, and only a
+ *  single (other) execution thread may remove from it. If more than one producer or consumer is required,
+ *  use the \ref Group_RingBuff driver instead.
+ *
+ *  \section Sec_LockFreeRingBuff_ExampleUsage Example Usage
+ *  The following snippet is an example of how this module may be used within a typical
+ *  application.
+ *
+ *  \code
+ *      // Create the buffer structure and its underlying storage array
+ *      LockFreeRingBuffer_t Buffer;
+ *      uint8_t              BufferData[128];
+ *
+ *      // Initialize the buffer with the created storage array
+ *      LockFreeRingBuffer_InitBuffer(&Buffer, BufferData, sizeof(BufferData));
+ *
+ *      // Insert a received byte into the buffer from the USART receive ISR
+ *      ISR(USART1_RX_vect, ISR_BLOCK)
+ *      {
+ *          if (!(LockFreeRingBuffer_IsFull(&Buffer)))
+ *            LockFreeRingBuffer_Insert(&Buffer, UDR1);
+ *      }
+ *
+ *      // Cache the number of stored bytes in the buffer from the main program loop
+ *      uint16_t BufferCount = LockFreeRingBuffer_GetCount(&Buffer);
+ *
+ *      // Print contents of the buffer one character at a time
+ *      while (BufferCount--)
+ *        putc(LockFreeRingBuffer_Remove(&Buffer));
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __LOCKFREE_RING_BUFFER_H__
+#define __LOCKFREE_RING_BUFFER_H__
+
+	/* Includes: */
+		#include "../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Type Defines: */
+		/** \brief Lock-Free Ring Buffer Management Structure.
+		 *
+		 *  Type define for a new lock-free ring buffer object. Buffers should be initialized via a call to
+		 *  \ref LockFreeRingBuffer_InitBuffer() before use.
+		 */
+		typedef struct
+		{
+			uint8_t*            Start; /**< Pointer to the start of the buffer's underlying storage array. */
+			volatile uint_reg_t In; /**< Free-running insertion index, only written by the producer. */
+			volatile uint_reg_t Out; /**< Free-running removal index, only written by the consumer. */
+			uint_reg_t          Mask; /**< Mask applied to the indexes to obtain a storage location, one less than the buffer size. */
+		} LockFreeRingBuffer_t;
+
+	/* Inline Functions: */
+		/** Initializes a lock-free ring buffer ready for use. Buffers must be initialized via this function
+		 *  before any operations are called upon them. Already initialized buffers may be reset by
+		 *  re-initializing them using this function.
+		 *
+		 *  \pre The size of the buffer must be a power of two, no larger than half the range of \c uint_reg_t.
+		 *
+		 *  \param[out] Buffer   Pointer to a ring buffer structure to initialize.
+		 *  \param[out] DataPtr  Pointer to a global array that will hold the data stored into the ring buffer.
+		 *  \param[out] Size     Maximum number of bytes that can be stored in the underlying data array.
+		 */
+		static inline void LockFreeRingBuffer_InitBuffer(LockFreeRingBuffer_t* Buffer,
+		                                                 uint8_t* const DataPtr,
+		                                                 const uint16_t Size) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline void LockFreeRingBuffer_InitBuffer(LockFreeRingBuffer_t* Buffer,
+		                                                 uint8_t* const DataPtr,
+		                                                 const uint16_t Size)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+			GlobalInterruptDisable();
+
+			Buffer->Start = DataPtr;
+			Buffer->In    = 0;
+			Buffer->Out   = 0;
+			Buffer->Mask  = (Size - 1);
+
+			SetGlobalInterruptMask(CurrentGlobalInt);
+		}
+
+		/** Retrieves the current number of bytes stored in a particular buffer. The count is computed from
+		 *  the buffer indexes without entering an atomic lock.
+		 *
+		 *  \note The value returned by this function is guaranteed to only be the minimum number of bytes
+		 *        stored in the given buffer when called from the consumer; this value may change as the producer
+		 *        writes new data, thus the returned number should be used only to determine how many successive
+		 *        reads may safely be performed on the buffer.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose count is to be computed.
+		 *
+		 *  \return Number of bytes currently stored in the buffer.
+		 */
+		ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
+		static inline uint16_t LockFreeRingBuffer_GetCount(LockFreeRingBuffer_t* const Buffer)
+		{
+			return (uint_reg_t)(Buffer->In - Buffer->Out);
+		}
+
+		/** Retrieves the free space in a particular buffer. The count is computed from the buffer indexes
+		 *  without entering an atomic lock.
+		 *
+		 *  \note The value returned by this function is guaranteed to only be the minimum number of bytes
+		 *        free in the given buffer when called from the producer; this value may change as the consumer
+		 *        removes data, thus the returned number should be used only to determine how many successive
+		 *        writes may safely be performed on the buffer.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose free count is to be computed.
+		 *
+		 *  \return Number of free bytes in the buffer.
+		 */
+		ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
+		static inline uint16_t LockFreeRingBuffer_GetFreeCount(LockFreeRingBuffer_t* const Buffer)
+		{
+			return ((uint16_t)Buffer->Mask + 1 - LockFreeRingBuffer_GetCount(Buffer));
+		}
+
+		/** Determines if the specified ring buffer contains any data. This should be tested before removing
+		 *  data from the buffer, to ensure that the buffer does not underflow.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to test.
+		 *
+		 *  \return Boolean \c true if the buffer contains no data, \c false otherwise.
+		 */
+		ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
+		static inline bool LockFreeRingBuffer_IsEmpty(LockFreeRingBuffer_t* const Buffer)
+		{
+			return (Buffer->In == Buffer->Out);
+		}
+
+		/** Determines if the specified ring buffer contains any free space. This should be tested before
+		 *  storing data to the buffer, to ensure that no data is lost due to a buffer overrun.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to test.
+		 *
+		 *  \return Boolean \c true if the buffer contains no free space, \c false otherwise.
+		 */
+		ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
+		static inline bool LockFreeRingBuffer_IsFull(LockFreeRingBuffer_t* const Buffer)
+		{
+			return (LockFreeRingBuffer_GetCount(Buffer) > Buffer->Mask);
+		}
+
+		/** Inserts an element into the ring buffer.
+		 *
+		 *  \warning Only one execution thread (main program thread or an ISR) may insert into a single buffer
+		 *           otherwise data corruption may occur. Insertion and removal may occur from different execution
+		 *           threads.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Data    Data element to insert into the buffer.
+		 */
+		static inline void LockFreeRingBuffer_Insert(LockFreeRingBuffer_t* Buffer,
+		                                             const uint8_t Data) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void LockFreeRingBuffer_Insert(LockFreeRingBuffer_t* Buffer,
+		                                             const uint8_t Data)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			uint_reg_t In = Buffer->In;
+
+			GCC_MEMORY_BARRIER();
+			Buffer->Start[In & Buffer->Mask] = Data;
+			GCC_MEMORY_BARRIER();
+
+			Buffer->In = (In + 1);
+		}
+
+		/** Removes an element from the ring buffer.
+		 *
+		 *  \warning Only one execution thread (main program thread or an ISR) may remove from a single buffer
+		 *           otherwise data corruption may occur. Insertion and removal may occur from different execution
+		 *           threads.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *
+		 *  \return Next data element stored in the buffer.
+		 */
+		ATTR_NON_NULL_PTR_ARG(1)
+		static inline uint8_t LockFreeRingBuffer_Remove(LockFreeRingBuffer_t* Buffer)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			uint_reg_t Out = Buffer->Out;
+
+			GCC_MEMORY_BARRIER();
+			uint8_t Data = Buffer->Start[Out & Buffer->Mask];
+			GCC_MEMORY_BARRIER();
+
+			Buffer->Out = (Out + 1);
+
+			return Data;
+		}
+
+		/** Returns the next element stored in the ring buffer, without removing it.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *
+		 *  \return Next data element stored in the buffer.
+		 */
+		ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
+		static inline uint8_t LockFreeRingBuffer_Peek(LockFreeRingBuffer_t* const Buffer)
+		{
+			GCC_MEMORY_BARRIER();
+			return Buffer->Start[Buffer->Out & Buffer->Mask];
+		}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
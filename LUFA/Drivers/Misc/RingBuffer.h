@@ -57,6 +57,11 @@
  *  or deletions) must not overlap. If there is possibility of two or more of the same kind of
  *  operating occurring at the same point in time, atomic (mutex) locking should be used.
  *
+ *  As well as single byte insertion and removal, blocks of bytes may be transferred with a single call via
+ *  \ref RingBuffer_InsertBlock() and \ref RingBuffer_RemoveBlock(), or accessed in place in the buffer's
+ *  underlying storage via \ref RingBuffer_GetReadSpan() and \ref RingBuffer_GetWriteSpan(), to avoid the
+ *  overhead of an atomic section per byte.
+ *
  *  \section Sec_RingBuff_ExampleUsage Example Usage
  *  The following snippet is an example of how this module may be used within a typical
  *  application.
@@ -297,6 +302,200 @@
 			return *Buffer->Out;
 		}
 
+		/** Retrieves the longest contiguous run of stored bytes in a particular buffer, starting at the next
+		 *  element to be removed and ending at either the last stored element or the end of the buffer's underlying
+		 *  storage array, whichever comes first. This allows the stored data to be read out directly from the buffer
+		 *  storage, for example via an endpoint stream write, before it is released with \ref RingBuffer_AdvanceRead().
+		 *
+		 *  \note If the stored data wraps around the end of the underlying storage array, the returned length will be
+		 *        less than the total number of stored bytes; the remainder will be returned by a subsequent call once
+		 *        the first run has been released.
+		 *
+		 *  \param[in]  Buffer   Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out] DataPtr  Location where a pointer to the start of the contiguous run is to be stored.
+		 *
+		 *  \return Number of contiguous bytes that may be read from the returned location.
+		 */
+		static inline uint16_t RingBuffer_GetReadSpan(RingBuffer_t* const Buffer,
+		                                              uint8_t** const DataPtr) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBuffer_GetReadSpan(RingBuffer_t* const Buffer,
+		                                              uint8_t** const DataPtr)
+		{
+			uint16_t Count      = RingBuffer_GetCount(Buffer);
+			uint16_t SpanLength = (Buffer->End - Buffer->Out);
+
+			*DataPtr = Buffer->Out;
+
+			return MIN(Count, SpanLength);
+		}
+
+		/** Releases a number of bytes from the front of the ring buffer, after they have been read out directly
+		 *  from a span previously returned by \ref RingBuffer_GetReadSpan(). The buffer count is updated in a single
+		 *  atomic operation, regardless of the number of bytes released.
+		 *
+		 *  \warning Only one execution thread (main program thread or an ISR) may remove from a single buffer
+		 *           otherwise data corruption may occur. Insertion and removal may occur from different execution
+		 *           threads.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to release from.
+		 *  \param[in]     Length  Number of bytes to release, no larger than the length of the last returned read span.
+		 */
+		static inline void RingBuffer_AdvanceRead(RingBuffer_t* Buffer,
+		                                          const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBuffer_AdvanceRead(RingBuffer_t* Buffer,
+		                                          const uint16_t Length)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			Buffer->Out += Length;
+
+			if (Buffer->Out == Buffer->End)
+			  Buffer->Out = Buffer->Start;
+
+			uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+			GlobalInterruptDisable();
+
+			Buffer->Count -= Length;
+
+			SetGlobalInterruptMask(CurrentGlobalInt);
+		}
+
+		/** Retrieves the longest contiguous run of free space in a particular buffer, starting at the next storage
+		 *  location and ending at either the last free location or the end of the buffer's underlying storage array,
+		 *  whichever comes first. This allows data to be written directly into the buffer storage, for example via an
+		 *  endpoint stream read, before it is committed with \ref RingBuffer_AdvanceWrite().
+		 *
+		 *  \param[in]  Buffer   Pointer to a ring buffer structure to insert into.
+		 *  \param[out] DataPtr  Location where a pointer to the start of the contiguous run is to be stored.
+		 *
+		 *  \return Number of contiguous bytes that may be written to the returned location.
+		 */
+		static inline uint16_t RingBuffer_GetWriteSpan(RingBuffer_t* const Buffer,
+		                                               uint8_t** const DataPtr) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBuffer_GetWriteSpan(RingBuffer_t* const Buffer,
+		                                               uint8_t** const DataPtr)
+		{
+			uint16_t FreeCount  = RingBuffer_GetFreeCount(Buffer);
+			uint16_t SpanLength = (Buffer->End - Buffer->In);
+
+			*DataPtr = Buffer->In;
+
+			return MIN(FreeCount, SpanLength);
+		}
+
+		/** Commits a number of bytes to the end of the ring buffer, after they have been written directly into a
+		 *  span previously returned by \ref RingBuffer_GetWriteSpan(). The buffer count is updated in a single atomic
+		 *  operation, regardless of the number of bytes committed.
+		 *
+		 *  \warning Only one execution thread (main program thread or an ISR) may insert into a single buffer
+		 *           otherwise data corruption may occur. Insertion and removal may occur from different execution
+		 *           threads.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to commit to.
+		 *  \param[in]     Length  Number of bytes to commit, no larger than the length of the last returned write span.
+		 */
+		static inline void RingBuffer_AdvanceWrite(RingBuffer_t* Buffer,
+		                                           const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBuffer_AdvanceWrite(RingBuffer_t* Buffer,
+		                                           const uint16_t Length)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			Buffer->In += Length;
+
+			if (Buffer->In == Buffer->End)
+			  Buffer->In = Buffer->Start;
+
+			uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+			GlobalInterruptDisable();
+
+			Buffer->Count += Length;
+
+			SetGlobalInterruptMask(CurrentGlobalInt);
+		}
+
+		/** Inserts a block of elements into the ring buffer, copying as many bytes as will fit into the free space of
+		 *  the buffer. At most two copies and two atomic count updates are performed, regardless of the block length.
+		 *
+		 *  \warning Only one execution thread (main program thread or an ISR) may insert into a single buffer
+		 *           otherwise data corruption may occur. Insertion and removal may occur from different execution
+		 *           threads.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Data    Pointer to the block of data elements to insert into the buffer.
+		 *  \param[in]     Length  Number of bytes in the data block.
+		 *
+		 *  \return Number of bytes inserted into the buffer, which may be less than \c Length if the buffer became full.
+		 */
+		static inline uint16_t RingBuffer_InsertBlock(RingBuffer_t* Buffer,
+		                                              const uint8_t* Data,
+		                                              uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBuffer_InsertBlock(RingBuffer_t* Buffer,
+		                                              const uint8_t* Data,
+		                                              uint16_t Length)
+		{
+			uint16_t BytesInserted = 0;
+
+			while (Length)
+			{
+				uint8_t* SpanData;
+				uint16_t SpanLength = MIN(RingBuffer_GetWriteSpan(Buffer, &SpanData), Length);
+
+				if (!(SpanLength))
+				  break;
+
+				memcpy(SpanData, Data, SpanLength);
+				RingBuffer_AdvanceWrite(Buffer, SpanLength);
+
+				Data          += SpanLength;
+				Length        -= SpanLength;
+				BytesInserted += SpanLength;
+			}
+
+			return BytesInserted;
+		}
+
+		/** Removes a block of elements from the ring buffer, copying as many bytes as are stored in the buffer up to
+		 *  the given length. At most two copies and two atomic count updates are performed, regardless of the block length.
+		 *
+		 *  \warning Only one execution thread (main program thread or an ISR) may remove from a single buffer
+		 *           otherwise data corruption may occur. Insertion and removal may occur from different execution
+		 *           threads.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out]    Data    Pointer to the destination for the removed data elements.
+		 *  \param[in]     Length  Maximum number of bytes to remove from the buffer.
+		 *
+		 *  \return Number of bytes removed from the buffer, which may be less than \c Length if the buffer became empty.
+		 */
+		static inline uint16_t RingBuffer_RemoveBlock(RingBuffer_t* Buffer,
+		                                              uint8_t* Data,
+		                                              uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBuffer_RemoveBlock(RingBuffer_t* Buffer,
+		                                              uint8_t* Data,
+		                                              uint16_t Length)
+		{
+			uint16_t BytesRemoved = 0;
+
+			while (Length)
+			{
+				uint8_t* SpanData;
+				uint16_t SpanLength = MIN(RingBuffer_GetReadSpan(Buffer, &SpanData), Length);
+
+				if (!(SpanLength))
+				  break;
+
+				memcpy(Data, SpanData, SpanLength);
+				RingBuffer_AdvanceRead(Buffer, SpanLength);
+
+				Data         += SpanLength;
+				Length       -= SpanLength;
+				BytesRemoved += SpanLength;
+			}
+
+			return BytesRemoved;
+		}
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -67,6 +67,8 @@
 	/* Includes: */
 		#if (ARCH == ARCH_AVR8)
 			#include "AVR8/ADC_AVR8.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/ADC_SIM.h"
 		#else
 			#error The ADC peripheral driver is not currently available for your selected architecture.
 		#endif
@@ -0,0 +1,286 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief ADC Peripheral Driver (SIM)
+ *
+ *  Analogue-to-Digital converter (ADC) driver for the host-native simulated architecture, with the interface of the
+ *  AVR8 ADC driver. There is no analogue input to sample, so conversions complete immediately with a mid-scale result.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the ADC driver
+ *        dispatch header located in LUFA/Drivers/Peripheral/ADC.h.
+ */
+
+/** \ingroup Group_ADC
+ *  \defgroup Group_ADC_SIM ADC Peripheral Driver (SIM)
+ *
+ *  \section Sec_ADC_SIM_ModDescription Module Description
+ *  Analogue-to-Digital converter (ADC) driver for the host-native simulated architecture, with the interface of the
+ *  AVR8 ADC driver so that applications written for it can be built for the simulated architecture unmodified. There
+ *  is no analogue input to sample, so each conversion completes immediately with a mid-scale result.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the ADC driver
+ *        dispatch header located in LUFA/Drivers/Peripheral/ADC.h.
+ *
+ *  @{
+ */
+
+#ifndef __ADC_SIM_H__
+#define __ADC_SIM_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_ADC_H)
+			#error Do not include this file directly. Include LUFA/Drivers/Peripheral/ADC.h instead.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define ADC_SIM_LEFT_ADJUST_MASK        (1 << 5)
+			#define ADC_SIM_MIDSCALE_RESULT         0x0200
+
+		/* Global Variables: */
+			static uint16_t ADC_SIM_MUXMask;
+	#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** \name ADC Reference Configuration Masks */
+			//@{
+			/** Reference mask, for using the voltage present at the AREF pin for the ADC reference. */
+			#define ADC_REFERENCE_AREF              0
+
+			/** Reference mask, for using the voltage present at the AVCC pin for the ADC reference. */
+			#define ADC_REFERENCE_AVCC              (1 << 6)
+
+			/** Reference mask, for using the internally generated 2.56V reference voltage as the ADC reference. */
+			#define ADC_REFERENCE_INT2560MV         ((1 << 7) | (1 << 6))
+			//@}
+
+			/** \name ADC Result Adjustment Configuration Masks */
+			//@{
+			/** Left-adjusts the 10-bit ADC result, so that the upper 8 bits of the value returned by the
+			 *  \ref ADC_GetResult() macro contain the 8 most significant bits of the result.
+			 */
+			#define ADC_LEFT_ADJUSTED               ADC_SIM_LEFT_ADJUST_MASK
+
+			/** Right-adjusts the 10-bit ADC result, so that the lower 8 bits of the value returned by the
+			 *  \ref ADC_GetResult() macro contain the 8 least significant bits of the result.
+			 */
+			#define ADC_RIGHT_ADJUSTED              0
+			//@}
+
+			/** \name ADC Mode Configuration Masks */
+			//@{
+			/** Sets the ADC mode to free running, so that conversions take place continuously. */
+			#define ADC_FREE_RUNNING                (1 << 5)
+
+			/** Sets the ADC mode to single conversion, so that only a single conversion will take place before
+			 *  the ADC returns to idle.
+			 */
+			#define ADC_SINGLE_CONVERSION           0
+			//@}
+
+			/** \name ADC Prescaler Configuration Masks */
+			//@{
+			/** Sets the ADC input clock to prescale by a factor of 2 the system clock. */
+			#define ADC_PRESCALE_2                  1
+
+			/** Sets the ADC input clock to prescale by a factor of 4 the system clock. */
+			#define ADC_PRESCALE_4                  2
+
+			/** Sets the ADC input clock to prescale by a factor of 8 the system clock. */
+			#define ADC_PRESCALE_8                  3
+
+			/** Sets the ADC input clock to prescale by a factor of 16 the system clock. */
+			#define ADC_PRESCALE_16                 4
+
+			/** Sets the ADC input clock to prescale by a factor of 32 the system clock. */
+			#define ADC_PRESCALE_32                 5
+
+			/** Sets the ADC input clock to prescale by a factor of 64 the system clock. */
+			#define ADC_PRESCALE_64                 6
+
+			/** Sets the ADC input clock to prescale by a factor of 128 the system clock. */
+			#define ADC_PRESCALE_128                7
+			//@}
+
+			/** \name ADC MUX Masks */
+			//@{
+			/** MUX mask define for the ADC0 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL0                    0x00
+
+			/** MUX mask define for the ADC1 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL1                    0x01
+
+			/** MUX mask define for the ADC2 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL2                    0x02
+
+			/** MUX mask define for the ADC3 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL3                    0x03
+
+			/** MUX mask define for the ADC4 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL4                    0x04
+
+			/** MUX mask define for the ADC5 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL5                    0x05
+
+			/** MUX mask define for the ADC6 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL6                    0x06
+
+			/** MUX mask define for the ADC7 channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_CHANNEL7                    0x07
+
+			/** MUX mask define for the internal 1.1V band-gap channel of the ADC. See \ref ADC_StartReading() and \ref ADC_GetChannelReading(). */
+			#define ADC_1100MV_BANDGAP              0x1E
+
+			/** Retrieves the ADC MUX mask for the given ADC channel number.
+			 *
+			 *  \attention This macro will only work correctly on channel numbers that are compile-time
+			 *             constants defined by the preprocessor.
+			 *
+			 *  \param[in] Channel  Index of the ADC channel whose MUX mask is to be retrieved.
+			 *
+			 *  \return Bit mask of the given ADC channel, for use in \ref ADC_StartReading() or \ref ADC_GetChannelReading().
+			 */
+			#define ADC_GET_CHANNEL_MASK(Channel)   CONCAT_EXPANDED(ADC_CHANNEL, Channel)
+			//@}
+
+		/* Inline Functions: */
+			/** Configures the given ADC channel, ready for ADC conversions. The simulated ADC channels need no
+			 *  configuration, so this function has no effect.
+			 *
+			 *  \param[in] ChannelIndex  ADC channel number to set up for conversions.
+			 */
+			static inline void ADC_SetupChannel(const uint8_t ChannelIndex) {}
+
+			/** De-configures the given ADC channel. The simulated ADC channels need no configuration, so this
+			 *  function has no effect.
+			 *
+			 *  \param[in] ChannelIndex  ADC channel number to change from analogue to digital I/O mode.
+			 */
+			static inline void ADC_DisableChannel(const uint8_t ChannelIndex) {}
+
+			/** Starts the reading of the given channel. The simulated conversion completes immediately.
+			 *
+			 *  \param[in] MUXMask  ADC channel mask, reference mask and adjustment mask.
+			 */
+			static inline void ADC_StartReading(const uint16_t MUXMask)
+			{
+				ADC_SIM_MUXMask = MUXMask;
+			}
+
+			/** Indicates if the current ADC conversion is completed, or still in progress. Simulated conversions
+			 *  complete immediately, so this always indicates a completed conversion.
+			 *
+			 *  \return Boolean \c false if the reading is still taking place, or true if the conversion is
+			 *          complete and ready to be read out with \ref ADC_GetResult().
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline bool ADC_IsReadingComplete(void)
+			{
+				return true;
+			}
+
+			/** Retrieves the conversion value of the last completed ADC conversion, which is always the mid-scale
+			 *  value of the 10-bit converter, adjusted as requested in the last call to \ref ADC_StartReading().
+			 *
+			 *  \return The result of the last ADC conversion as an unsigned value.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint16_t ADC_GetResult(void)
+			{
+				if (ADC_SIM_MUXMask & ADC_SIM_LEFT_ADJUST_MASK)
+				  return (ADC_SIM_MIDSCALE_RESULT << 6);
+				else
+				  return ADC_SIM_MIDSCALE_RESULT;
+			}
+
+			/** Performs a complete single reading from channel, including a polling spin-loop to wait for the
+			 *  conversion to complete, and the retrieval of the converted value.
+			 *
+			 *  \param[in] MUXMask  ADC channel mask, reference mask and adjustment mask.
+			 *
+			 *  \return Converted ADC result for the given ADC channel.
+			 */
+			ATTR_WARN_UNUSED_RESULT
+			static inline uint16_t ADC_GetChannelReading(const uint16_t MUXMask)
+			{
+				ADC_StartReading(MUXMask);
+
+				while (!(ADC_IsReadingComplete()));
+
+				return ADC_GetResult();
+			}
+
+			/** Initializes the ADC, ready for conversions. This must be called before any other ADC operations.
+			 *  The simulated ADC needs no initialization, so this function has no effect.
+			 *
+			 *  \param[in] Mode  Mask of ADC prescale and mode settings.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void ADC_Init(const uint8_t Mode)
+			{
+				ADC_SIM_MUXMask = 0;
+			}
+
+			/** Turns off the ADC. If this is called, any further ADC operations will require a call to
+			 *  \ref ADC_Init() before the ADC can be used again.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void ADC_Disable(void) {}
+
+			/** Indicates if the ADC is currently enabled.
+			 *
+			 *  \return Boolean \c true if the ADC subsystem is currently enabled, \c false otherwise.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline bool ADC_GetStatus(void)
+			{
+				return true;
+			}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
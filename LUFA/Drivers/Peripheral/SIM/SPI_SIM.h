@@ -0,0 +1,215 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief SPI Peripheral Driver (SIM)
+ *
+ *  Serial Peripheral Interface (SPI) driver for the host-native simulated architecture, with the interface of the
+ *  AVR8 SPI driver. No SPI device is attached, so each transfer completes immediately with an idle bus response.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the SPI driver
+ *        dispatch header located in LUFA/Drivers/Peripheral/SPI.h.
+ */
+
+/** \ingroup Group_SPI
+ *  \defgroup Group_SPI_SIM SPI Peripheral Driver (SIM)
+ *
+ *  \section Sec_SPI_SIM_ModDescription Module Description
+ *  Serial Peripheral Interface (SPI) driver for the host-native simulated architecture, with the interface of the
+ *  AVR8 SPI driver so that applications written for it can be built for the simulated architecture unmodified. No
+ *  SPI device is attached, so each transfer completes immediately and reads back the idle bus level of 0xFF.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the SPI driver
+ *        dispatch header located in LUFA/Drivers/Peripheral/SPI.h.
+ *
+ *  @{
+ */
+
+#ifndef __SPI_SIM_H__
+#define __SPI_SIM_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_SPI_H)
+			#error Do not include this file directly. Include LUFA/Drivers/Peripheral/SPI.h instead.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define SPI_USE_DOUBLESPEED            (1 << 6)
+			#define SPI_SIM_IDLE_BUS_RESPONSE      0xFF
+
+		/* Global Variables: */
+			static uint8_t SPI_SIM_Options;
+	#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** \name SPI Prescaler Configuration Masks */
+			//@{
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 2. */
+			#define SPI_SPEED_FCPU_DIV_2           SPI_USE_DOUBLESPEED
+
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 4. */
+			#define SPI_SPEED_FCPU_DIV_4           0
+
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 8. */
+			#define SPI_SPEED_FCPU_DIV_8           (SPI_USE_DOUBLESPEED | (1 << 0))
+
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 16. */
+			#define SPI_SPEED_FCPU_DIV_16          (1 << 0)
+
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 32. */
+			#define SPI_SPEED_FCPU_DIV_32          (SPI_USE_DOUBLESPEED | (1 << 1))
+
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 64. */
+			#define SPI_SPEED_FCPU_DIV_64          (SPI_USE_DOUBLESPEED | (1 << 1) | (1 << 0))
+
+			/** SPI prescaler mask for \ref SPI_Init(). Divides the system clock by a factor of 128. */
+			#define SPI_SPEED_FCPU_DIV_128         ((1 << 1) | (1 << 0))
+			//@}
+
+			/** \name SPI SCK Polarity Configuration Masks */
+			//@{
+			/** SPI clock polarity mask for \ref SPI_Init(). Indicates that the SCK should lead on the rising edge. */
+			#define SPI_SCK_LEAD_RISING            (0 << 3)
+
+			/** SPI clock polarity mask for \ref SPI_Init(). Indicates that the SCK should lead on the falling edge. */
+			#define SPI_SCK_LEAD_FALLING           (1 << 3)
+			//@}
+
+			/** \name SPI Sample Edge Configuration Masks */
+			//@{
+			/** SPI data sample mode mask for \ref SPI_Init(). Indicates that the data should sampled on the leading edge. */
+			#define SPI_SAMPLE_LEADING             (0 << 2)
+
+			/** SPI data sample mode mask for \ref SPI_Init(). Indicates that the data should be sampled on the trailing edge. */
+			#define SPI_SAMPLE_TRAILING            (1 << 2)
+			//@}
+
+			/** \name SPI Data Ordering Configuration Masks */
+			//@{
+			/** SPI data order mask for \ref SPI_Init(). Indicates that data should be shifted out MSB first. */
+			#define SPI_ORDER_MSB_FIRST            (0 << 5)
+
+			/** SPI data order mask for \ref SPI_Init(). Indicates that data should be shifted out LSB first. */
+			#define SPI_ORDER_LSB_FIRST            (1 << 5)
+			//@}
+
+			/** \name SPI Mode Configuration Masks */
+			//@{
+			/** SPI mode mask for \ref SPI_Init(). Indicates that the SPI interface should be initialized into slave mode. */
+			#define SPI_MODE_SLAVE                 (0 << 4)
+
+			/** SPI mode mask for \ref SPI_Init(). Indicates that the SPI interface should be initialized into master mode. */
+			#define SPI_MODE_MASTER                (1 << 4)
+			//@}
+
+		/* Inline Functions: */
+			/** Initializes the SPI subsystem, ready for transfers. Must be called before calling any other
+			 *  SPI routines.
+			 *
+			 *  \param[in] SPIOptions  SPI Options, a mask consisting of one of each of the \c SPI_SPEED_*,
+			 *                         \c SPI_SCK_*, \c SPI_SAMPLE_*, \c SPI_ORDER_* and \c SPI_MODE_* masks.
+			 */
+			static inline void SPI_Init(const uint8_t SPIOptions)
+			{
+				SPI_SIM_Options = SPIOptions;
+			}
+
+			/** Turns off the SPI driver, returning it to its default configuration. */
+			static inline void SPI_Disable(void)
+			{
+				SPI_SIM_Options = 0;
+			}
+
+			/** Retrieves the currently selected SPI mode, once the SPI interface has been configured.
+			 *
+			 *  \return \ref SPI_MODE_MASTER if the interface is currently in SPI Master mode, \ref SPI_MODE_SLAVE otherwise
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline uint8_t SPI_GetCurrentMode(void)
+			{
+				return (SPI_SIM_Options & SPI_MODE_MASTER);
+			}
+
+			/** Sends and receives a byte through the SPI interface. With no simulated SPI device attached, the
+			 *  transfer completes immediately.
+			 *
+			 *  \param[in] Byte  Byte to send through the SPI interface.
+			 *
+			 *  \return Idle bus level of 0xFF, as no device drives the bus.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline uint8_t SPI_TransferByte(const uint8_t Byte)
+			{
+				(void)Byte;
+
+				return SPI_SIM_IDLE_BUS_RESPONSE;
+			}
+
+			/** Sends a byte through the SPI interface. With no simulated SPI device attached, the byte is discarded.
+			 *
+			 *  \param[in] Byte  Byte to send through the SPI interface.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void SPI_SendByte(const uint8_t Byte)
+			{
+				(void)Byte;
+			}
+
+			/** Sends a dummy byte through the SPI interface. With no simulated SPI device attached, the transfer
+			 *  completes immediately.
+			 *
+			 *  \return Idle bus level of 0xFF, as no device drives the bus.
+			 */
+			ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT
+			static inline uint8_t SPI_ReceiveByte(void)
+			{
+				return SPI_SIM_IDLE_BUS_RESPONSE;
+			}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -0,0 +1,226 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Serial USART Peripheral Driver (SIM)
+ *
+ *  Serial USART driver for the host-native simulated architecture, with the interface of the AVR8 USART driver.
+ *  There is no serial line to simulate, so sent bytes are discarded and no bytes are ever received.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USART driver
+ *        dispatch header located in LUFA/Drivers/Peripheral/Serial.h.
+ */
+
+/** \ingroup Group_Serial
+ *  \defgroup Group_Serial_SIM Serial USART Peripheral Driver (SIM)
+ *
+ *  \section Sec_Serial_SIM_ModDescription Module Description
+ *  Serial USART driver for the host-native simulated architecture, with the interface of the AVR8 USART driver so
+ *  that applications written for it can be built for the simulated architecture unmodified. There is no serial line
+ *  to simulate, so each sent byte completes immediately and is discarded, and no bytes are ever received.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USART driver
+ *        dispatch header located in LUFA/Drivers/Peripheral/Serial.h.
+ *
+ *  @{
+ */
+
+#ifndef __SERIAL_SIM_H__
+#define __SERIAL_SIM_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+		#include "../../Misc/TerminalCodes.h"
+
+		#include <stdio.h>
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_SERIAL_H) && !defined(__INCLUDE_FROM_SERIAL_C)
+			#error Do not include this file directly. Include LUFA/Drivers/Peripheral/Serial.h instead.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* External Variables: */
+			extern FILE USARTSerialStream;
+
+		/* Function Prototypes: */
+			int Serial_putchar(char DataByte,
+			                   FILE *Stream);
+			int Serial_getchar(FILE *Stream);
+			int Serial_getchar_Blocking(FILE *Stream);
+	#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Macro for calculating the baud value from a given baud rate when the \c U2X (double speed) bit is
+			 *  not set, as for the AVR8 USART driver.
+			 *
+			 *  \param[in] Baud  Target serial UART baud rate.
+			 *
+			 *  \return Closest UBRR register value for the given UART frequency.
+			 */
+			#define SERIAL_UBBRVAL(Baud)    ((((F_CPU / 16) + (Baud / 2)) / (Baud)) - 1)
+
+			/** Macro for calculating the baud value from a given baud rate when the \c U2X (double speed) bit is
+			 *  set, as for the AVR8 USART driver.
+			 *
+			 *  \param[in] Baud  Target serial UART baud rate.
+			 *
+			 *  \return Closest UBRR register value for the given UART frequency.
+			 */
+			#define SERIAL_2X_UBBRVAL(Baud) ((((F_CPU / 8) + (Baud / 2)) / (Baud)) - 1)
+
+		/* Function Prototypes: */
+			/** Transmits a given NUL terminated string located in program space (FLASH) through the USART.
+			 *
+			 *  \param[in] FlashStringPtr  Pointer to a string located in program space.
+			 */
+			void Serial_SendString_P(const char* FlashStringPtr) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Transmits a given NUL terminated string located in SRAM memory through the USART.
+			 *
+			 *  \param[in] StringPtr  Pointer to a string located in SRAM space.
+			 */
+			void Serial_SendString(const char* StringPtr) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Transmits a given buffer located in SRAM memory through the USART.
+			 *
+			 *  \param[in] Buffer  Pointer to a buffer containing the data to send.
+			 *  \param[in] Length  Length of the data to send, in bytes.
+			 */
+			void Serial_SendData(const void* Buffer, uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Creates a standard character stream from the USART so that it can be used with all the regular functions
+			 *  in the \c <stdio.h> library that accept a \c FILE stream as a destination (e.g. \c fprintf). The created
+			 *  stream is bidirectional and can be used for both input and output functions.
+			 *
+			 *  \param[in,out] Stream  Pointer to a FILE structure where the created stream should be placed, if \c NULL, \c stdout
+			 *                         and \c stdin will be configured to use the USART.
+			 *
+			 *  \pre The USART must first be configured via a call to \ref Serial_Init() before the stream is used.
+			 */
+			void Serial_CreateStream(FILE* Stream);
+
+			/** Identical to \ref Serial_CreateStream(), except that reads are blocking until the calling stream function terminates
+			 *  the transfer. As no bytes are ever received, a blocking read never completes.
+			 *
+			 *  \param[in,out] Stream  Pointer to a FILE structure where the created stream should be placed, if \c NULL, \c stdout
+			 *                         and \c stdin will be configured to use the USART.
+			 *
+			 *  \pre The USART must first be configured via a call to \ref Serial_Init() before the stream is used.
+			 */
+			void Serial_CreateBlockingStream(FILE* Stream);
+
+		/* Inline Functions: */
+			/** Initializes the USART, ready for serial data transmission and reception.
+			 *
+			 *  \param[in] BaudRate     Serial baud rate, in bits per second.
+			 *  \param[in] DoubleSpeed  Enables double speed mode when set, halving the sample time to double the baud rate.
+			 */
+			static inline void Serial_Init(const uint32_t BaudRate,
+			                               const bool DoubleSpeed)
+			{
+				(void)BaudRate;
+				(void)DoubleSpeed;
+			}
+
+			/** Turns off the USART driver, disabling and returning used hardware to their default configuration. */
+			static inline void Serial_Disable(void)
+			{
+
+			}
+
+			/** Indicates whether a character has been received through the USART.
+			 *
+			 *  \return Boolean \c true if a character has been received, \c false otherwise.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline bool Serial_IsCharReceived(void)
+			{
+				return false;
+			}
+
+			/** Indicates whether there is hardware buffer space for a new transmit on the USART. This
+			 *  function can be used to determine if a call to \ref Serial_SendByte() will block in advance.
+			 *
+			 *  \return Boolean \c true if a character can be queued for transmission immediately, \c false otherwise.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline bool Serial_IsSendReady(void)
+			{
+				return true;
+			}
+
+			/** Indicates whether the hardware USART transmit buffer is completely empty, indicating all
+			 *  pending transmissions have completed.
+			 *
+			 *  \return Boolean \c true if no characters are buffered for transmission, \c false otherwise.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline bool Serial_IsSendComplete(void)
+			{
+				return true;
+			}
+
+			/** Transmits a given byte through the USART.
+			 *
+			 *  \param[in] DataByte  Byte to transmit through the USART.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void Serial_SendByte(const char DataByte)
+			{
+				(void)DataByte;
+			}
+
+			/** Receives the next byte from the USART.
+			 *
+			 *  \return Next byte received from the USART, or a negative value if no byte has been received.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline int16_t Serial_ReceiveByte(void)
+			{
+				return -1;
+			}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
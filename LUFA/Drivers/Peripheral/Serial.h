@@ -68,6 +68,8 @@
 			#include "AVR8/Serial_AVR8.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/Serial_XMEGA.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/Serial_SIM.h"
 		#else
 			#error The Serial peripheral driver is not currently available for your selected architecture.
 		#endif
@@ -119,6 +119,21 @@
 
 		/** SCSI Command Code for a MODE SENSE (10) command. */
 		#define SCSI_CMD_MODE_SENSE_10                         0x5A
+
+		/** SCSI Command Code for a SYNCHRONIZE CACHE (10) command. */
+		#define SCSI_CMD_SYNCHRONIZE_CACHE_10                  0x35
+
+		/** SCSI Command Code for a WRITE (16) command. */
+		#define SCSI_CMD_WRITE_16                              0x8A
+
+		/** SCSI Command Code for a READ (16) command. */
+		#define SCSI_CMD_READ_16                               0x88
+
+		/** SCSI Command Code for a SERVICE ACTION IN (16) command, whose service action is given in the second command byte. */
+		#define SCSI_CMD_SERVICE_ACTION_IN_16                  0x9E
+
+		/** SCSI Service Action for a READ CAPACITY (16) command, issued via a \ref SCSI_CMD_SERVICE_ACTION_IN_16 command. */
+		#define SCSI_SERVICE_ACTION_READ_CAPACITY_16           0x10
 		/**@}*/
 
 		/** \name SCSI Sense Key Values */
@@ -47,6 +47,33 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 
 	switch (USB_ControlRequest.bRequest)
 	{
+		case CDC_DEVICE_REQ_SET_LATENCY_TIMER:
+			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_VENDOR | REQREC_INTERFACE))
+			{
+				if (USB_ControlRequest.wValue > 0xFF)
+				  return;
+
+				Endpoint_ClearSETUP();
+				Endpoint_ClearStatusStage();
+
+				CDCInterfaceInfo->State.LatencyTimerMS = USB_ControlRequest.wValue;
+			}
+
+			break;
+		case CDC_DEVICE_REQ_GET_LATENCY_TIMER:
+			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_INTERFACE))
+			{
+				Endpoint_ClearSETUP();
+
+				while (!(Endpoint_IsINReady()));
+
+				Endpoint_Write_8(CDCInterfaceInfo->State.LatencyTimerMS);
+
+				Endpoint_ClearIN();
+				Endpoint_ClearStatusStage();
+			}
+
+			break;
 		case CDC_REQ_GetLineEncoding:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
@@ -115,6 +142,7 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 bool CDC_Device_ConfigureEndpoints(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 {
 	memset(&CDCInterfaceInfo->State, 0x00, sizeof(CDCInterfaceInfo->State));
+	CDCInterfaceInfo->State.LatencyTimerMS = CDCInterfaceInfo->Config.LatencyTimerMS;
 
 	CDCInterfaceInfo->Config.DataINEndpoint.Type       = EP_TYPE_BULK;
 	CDCInterfaceInfo->Config.DataOUTEndpoint.Type      = EP_TYPE_BULK;
@@ -138,10 +166,41 @@ void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 	  return;
 
 	#if !defined(NO_CLASS_DRIVER_AUTOFLUSH)
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	if (Endpoint_GetAsyncStatus(CDCInterfaceInfo->Config.DataINEndpoint.Address, NULL) == ENDPOINT_ASYNC_InProgress)
+	  return;
+	#endif
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 
-	if (Endpoint_IsINReady())
-	  CDC_Device_Flush(CDCInterfaceInfo);
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	if (!(Endpoint_BytesInEndpoint()))
+	{
+		CDCInterfaceInfo->State.LatencyTimerRunning = false;
+		return;
+	}
+
+	if (CDCInterfaceInfo->State.LatencyTimerMS && Endpoint_IsReadWriteAllowed())
+	{
+		uint16_t CurrentFrameNumber = USB_Device_GetFrameNumber();
+
+		if (!(CDCInterfaceInfo->State.LatencyTimerRunning))
+		{
+			CDCInterfaceInfo->State.LatencyTimerStartFrame = CurrentFrameNumber;
+			CDCInterfaceInfo->State.LatencyTimerRunning    = true;
+			return;
+		}
+
+		uint16_t ElapsedFrames = ((CurrentFrameNumber - CDCInterfaceInfo->State.LatencyTimerStartFrame) & CDC_DEVICE_FRAME_NUMBER_MASK);
+
+		if (ElapsedFrames < CDCInterfaceInfo->State.LatencyTimerMS)
+		  return;
+	}
+
+	CDCInterfaceInfo->State.LatencyTimerRunning = false;
+	CDC_Device_Flush(CDCInterfaceInfo);
 	#endif
 }
 
@@ -166,6 +225,32 @@ uint8_t CDC_Device_SendData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	return Endpoint_Write_Stream_LE(Buffer, Length, NULL);
 }
 
+#if defined(ASYNC_ENDPOINT_TRANSFERS)
+bool CDC_Device_SendDataAsync(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                              const void* const Buffer,
+                              const uint16_t Length,
+                              const Endpoint_AsyncCallback_t Callback)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return false;
+
+	return Endpoint_SubmitAsync(CDCInterfaceInfo->Config.DataINEndpoint.Address, (void*)Buffer, Length,
+	                            ENDPOINT_ASYNC_OPT_SEND_ZLP, Callback);
+}
+
+bool CDC_Device_ReceiveDataAsync(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                                 void* const Buffer,
+                                 const uint16_t Length,
+                                 const Endpoint_AsyncCallback_t Callback)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return false;
+
+	return Endpoint_SubmitAsync(CDCInterfaceInfo->Config.DataOUTEndpoint.Address, Buffer, Length,
+	                            ENDPOINT_ASYNC_OPT_NONE, Callback);
+}
+#endif
+
 #if defined(ARCH_HAS_FLASH_ADDRESS_SPACE)
 	uint8_t CDC_Device_SendString_P(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	                                const char* const String)
@@ -284,6 +369,61 @@ int16_t CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInf
 	return ReceivedByte;
 }
 
+uint16_t CDC_Device_ReceiveData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                                void* const Buffer,
+                                const uint16_t Length)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return 0;
+
+	uint8_t* DataStream     = (uint8_t*)Buffer;
+	uint16_t BytesRemaining = Length;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	while (BytesRemaining && Endpoint_IsOUTReceived())
+	{
+		uint16_t BytesInBank = Endpoint_Read_Bank(DataStream, BytesRemaining);
+
+		DataStream     += BytesInBank;
+		BytesRemaining -= BytesInBank;
+
+		if (!(Endpoint_BytesInEndpoint()))
+		  Endpoint_ClearOUT();
+	}
+
+	return (Length - BytesRemaining);
+}
+
+uint8_t CDC_Device_ReceivePackets(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                                  void* const Buffer,
+                                  const CDC_Device_PacketCallback_t Callback)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return 0;
+
+	uint8_t PacketsDelivered = 0;
+
+	for (;;)
+	{
+		Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+		if (!(Endpoint_IsOUTReceived()))
+		  break;
+
+		uint16_t PacketLength = Endpoint_Read_Bank(Buffer, CDCInterfaceInfo->Config.DataOUTEndpoint.Size);
+		Endpoint_ClearOUT();
+
+		if (!(PacketLength))
+		  continue;
+
+		Callback(CDCInterfaceInfo, (const uint8_t*)Buffer, PacketLength);
+		PacketsDelivered++;
+	}
+
+	return PacketsDelivered;
+}
+
 void CDC_Device_SendControlLineStateChange(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 {
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
@@ -307,18 +447,26 @@ void CDC_Device_SendControlLineStateChange(USB_ClassInfo_CDC_Device_t* const CDC
 	Endpoint_ClearIN();
 }
 
-#if defined(FDEV_SETUP_STREAM)
+#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 	void CDC_Device_CreateStream(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	                             FILE* const Stream)
 	{
+	#if (ARCH == ARCH_SIM)
+		fdev_setup_stream(Stream, CDC_Device_putchar, CDC_Device_getchar, _FDEV_SETUP_RW);
+	#else
 		*Stream = (FILE)FDEV_SETUP_STREAM(CDC_Device_putchar, CDC_Device_getchar, _FDEV_SETUP_RW);
+	#endif
 		fdev_set_udata(Stream, CDCInterfaceInfo);
 	}
 
 	void CDC_Device_CreateBlockingStream(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	                                     FILE* const Stream)
 	{
+	#if (ARCH == ARCH_SIM)
+		fdev_setup_stream(Stream, CDC_Device_putchar, CDC_Device_getchar_Blocking, _FDEV_SETUP_RW);
+	#else
 		*Stream = (FILE)FDEV_SETUP_STREAM(CDC_Device_putchar, CDC_Device_getchar_Blocking, _FDEV_SETUP_RW);
+	#endif
 		fdev_set_udata(Stream, CDCInterfaceInfo);
 	}
 
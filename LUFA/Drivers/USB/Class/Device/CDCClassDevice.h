@@ -88,6 +88,24 @@
 		#endif
 
 	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if !defined(CDC_DEVICE_REQ_SET_LATENCY_TIMER) || defined(__DOXYGEN__)
+				/** Vendor specific, interface directed control request \c bRequest value used by the host to set the transmit
+				 *  latency timer of a CDC interface, in milliseconds, given in the request's \c wValue field. This value can be
+				 *  overridden by defining the \c CDC_DEVICE_REQ_SET_LATENCY_TIMER token in the project makefile, if it conflicts
+				 *  with a vendor request already used by the application.
+				 */
+				#define CDC_DEVICE_REQ_SET_LATENCY_TIMER   0x09
+			#endif
+
+			#if !defined(CDC_DEVICE_REQ_GET_LATENCY_TIMER) || defined(__DOXYGEN__)
+				/** Vendor specific, interface directed control request \c bRequest value used by the host to read back the
+				 *  transmit latency timer of a CDC interface, returned as a single byte. This value can be overridden by defining
+				 *  the \c CDC_DEVICE_REQ_GET_LATENCY_TIMER token in the project makefile.
+				 */
+				#define CDC_DEVICE_REQ_GET_LATENCY_TIMER   0x0A
+			#endif
+
 		/* Type Defines: */
 			/** \brief CDC Class Device Mode Configuration and State Structure.
 			 *
@@ -104,6 +122,13 @@
 					USB_Endpoint_Table_t DataINEndpoint; /**< Data IN endpoint configuration table. */
 					USB_Endpoint_Table_t DataOUTEndpoint; /**< Data OUT endpoint configuration table. */
 					USB_Endpoint_Table_t NotificationEndpoint; /**< Notification IN Endpoint configuration table. */
+
+					uint8_t LatencyTimerMS; /**< Initial transmit latency timer, in milliseconds. When non-zero, partially filled
+					                         *   packets are held back by \ref CDC_Device_USBTask() until either the packet is full,
+					                         *   or this many milliseconds have elapsed since the unsent data was queued. When zero,
+					                         *   queued data is sent as soon as the IN endpoint is ready. The host may change the
+					                         *   timer at runtime via the \ref CDC_DEVICE_REQ_SET_LATENCY_TIMER vendor request.
+					                         */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -124,11 +149,29 @@
 					                                  *   This is generally only used if the virtual serial port data is to be
 					                                  *   reconstructed on a physical UART.
 					                                  */
+
+					uint8_t  LatencyTimerMS; /**< Current transmit latency timer, in milliseconds. This is initialized from the
+					                          *   \c LatencyTimerMS configuration value when the interface is enumerated, and may
+					                          *   be changed by the host or the user application at any time.
+					                          */
+					bool     LatencyTimerRunning; /**< Indicates if unsent data is being held back by the latency timer. */
+					uint16_t LatencyTimerStartFrame; /**< USB frame number at which the latency timer was started. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
 			} USB_ClassInfo_CDC_Device_t;
 
+			/** Type define for a CDC packet reception callback function, used by \ref CDC_Device_ReceivePackets() to
+			 *  deliver each packet received from the host to the user application as a whole.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *  \param[in]     Data              Pointer to the packet data received from the host.
+			 *  \param[in]     Length            Length of the received packet, in bytes.
+			 */
+			typedef void (*CDC_Device_PacketCallback_t)(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+			                                            const uint8_t* const Data,
+			                                            const uint16_t Length);
+
 		/* Function Prototypes: */
 			/** Configures the endpoints of a given CDC interface, ready for use. This should be linked to the library
 			 *  \ref EVENT_USB_Device_ConfigurationChanged() event so that the endpoints are configured when the configuration containing
@@ -150,6 +193,10 @@
 			/** General management task for a given CDC class interface, required for the correct operation of the interface. This should
 			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
 			 *
+			 *  Unless the \c NO_CLASS_DRIVER_AUTOFLUSH token is defined, this automatically flushes any data queued for the host
+			 *  once the latency timer of the interface has expired or the current packet is full (see the \c LatencyTimerMS
+			 *  configuration value).
+			 *
 			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
 			 */
 			void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
@@ -216,6 +263,56 @@
 			                            const void* const Buffer,
 			                            const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
+			#if defined(ASYNC_ENDPOINT_TRANSFERS) || defined(__DOXYGEN__)
+				/** Queues a given data buffer for asynchronous transmission to the attached USB host, if connected. Unlike
+				 *  \ref CDC_Device_SendData(), this function returns immediately and the data is sent from the USB controller
+				 *  interrupt one packet at a time; the buffer must remain valid until the transfer completes. No other data
+				 *  should be written to the interface's IN endpoint while the transfer is pending. If the length of the data
+				 *  is an exact multiple of the endpoint size, a zero length packet is sent after it so that the host sees the
+				 *  end of the transfer straight away.
+				 *
+				 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+				 *       the call will fail.
+				 *
+				 *  \note This function is only available when the \c ASYNC_ENDPOINT_TRANSFERS token is defined.
+				 *
+				 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+				 *  \param[in]     Buffer            Pointer to a buffer containing the data to send to the host.
+				 *  \param[in]     Length            Length of the data to send to the host.
+				 *  \param[in]     Callback          Optional transfer completion callback, or \c NULL to poll the transfer status
+				 *                                   via \ref Endpoint_GetAsyncStatus().
+				 *
+				 *  \return Boolean \c true if the transfer was queued, \c false otherwise.
+				 */
+				bool CDC_Device_SendDataAsync(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+				                              const void* const Buffer,
+				                              const uint16_t Length,
+				                              const Endpoint_AsyncCallback_t Callback) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+				/** Queues a given data buffer for asynchronous reception of data from the attached USB host, if connected. The
+				 *  transfer completes once the buffer is full, or the host sends a short packet; the buffer must remain valid
+				 *  until the transfer completes, and the interface should not be read via \ref CDC_Device_ReceiveByte() while
+				 *  the transfer is pending.
+				 *
+				 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+				 *       the call will fail.
+				 *
+				 *  \note This function is only available when the \c ASYNC_ENDPOINT_TRANSFERS token is defined.
+				 *
+				 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+				 *  \param[out]    Buffer            Pointer to a buffer where the received data is to be stored.
+				 *  \param[in]     Length            Maximum length of the data to receive from the host.
+				 *  \param[in]     Callback          Optional transfer completion callback, or \c NULL to poll the transfer status
+				 *                                   via \ref Endpoint_GetAsyncStatus().
+				 *
+				 *  \return Boolean \c true if the transfer was queued, \c false otherwise.
+				 */
+				bool CDC_Device_ReceiveDataAsync(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+				                                 void* const Buffer,
+				                                 const uint16_t Length,
+				                                 const Endpoint_AsyncCallback_t Callback) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+			#endif
+
 			#if defined(ARCH_HAS_FLASH_ADDRESS_SPACE)
 				/** Sends a given null terminated string from PROGMEM space to the attached USB host, if connected. If a host is not connected
 				 *  when the function is called, the string is discarded. Bytes will be queued for transmission to the host until either
@@ -302,6 +399,45 @@
 			 */
 			int16_t CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** Reads a block of data from the host, up to the given maximum length. All data waiting in the CDC interface's data
+			 *  receive endpoint is copied into the given buffer in a single burst per endpoint bank, releasing each bank back to the
+			 *  USB controller once emptied, until either the buffer is full or no further data is waiting. This function does not
+			 *  block waiting for data from the host, and is considerably faster than repeated calls to \ref CDC_Device_ReceiveByte().
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *  \param[out]    Buffer            Pointer to a buffer where the received data is to be stored.
+			 *  \param[in]     Length            Maximum number of bytes to read from the host.
+			 *
+			 *  \return Number of bytes read from the host, or zero if no data was waiting or the host is not connected.
+			 */
+			uint16_t CDC_Device_ReceiveData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+			                                void* const Buffer,
+			                                const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Delivers each packet received from the host to the given callback function as a whole, until no further packets are
+			 *  waiting in the CDC interface's data receive endpoint. Each packet is copied into the given buffer and its endpoint
+			 *  bank released back to the USB controller before the callback is run, so that the host may send the next packet while
+			 *  the current one is being processed. If the current bank has already been partially read via
+			 *  \ref CDC_Device_ReceiveByte(), the remainder of the bank is delivered as a packet.
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *  \param[out]    Buffer            Pointer to a buffer used to hold each packet, at least as large as the CDC
+			 *                                   interface's data OUT endpoint.
+			 *  \param[in]     Callback          Callback function to run for each received packet.
+			 *
+			 *  \return Number of packets delivered to the callback function.
+			 */
+			uint8_t CDC_Device_ReceivePackets(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+			                                  void* const Buffer,
+			                                  const CDC_Device_PacketCallback_t Callback) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2)
+			                                  ATTR_NON_NULL_PTR_ARG(3);
+
 			/** Flushes any data waiting to be sent, ensuring that the send buffer is cleared.
 			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
@@ -325,7 +461,7 @@
 			 */
 			void CDC_Device_SendControlLineStateChange(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
-			#if defined(FDEV_SETUP_STREAM) || defined(__DOXYGEN__)
+			#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM) || defined(__DOXYGEN__)
 			/** Creates a standard character stream for the given CDC Device instance so that it can be used with all the regular
 			 *  functions in the standard <stdio.h> library that accept a \c FILE stream as a destination (e.g. \c fprintf()). The created
 			 *  stream is bidirectional and can be used for both input and output functions.
@@ -361,9 +497,12 @@
 
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define CDC_DEVICE_FRAME_NUMBER_MASK   0x07FF
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_CDC_DEVICE_C)
-				#if defined(FDEV_SETUP_STREAM)
+				#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 				static int CDC_Device_putchar(char c,
 				                              FILE* Stream) ATTR_NON_NULL_PTR_ARG(2);
 				static int CDC_Device_getchar(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
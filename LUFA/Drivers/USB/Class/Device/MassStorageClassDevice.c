@@ -92,31 +92,55 @@ void MS_Device_USBTask(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 	if (USB_DeviceState != DEVICE_STATE_Configured)
 	  return;
 
-	Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
-
-	if (Endpoint_IsOUTReceived())
+	switch (MSInterfaceInfo->State.TaskState)
 	{
-		if (MS_Device_ReadInCommandBlock(MSInterfaceInfo))
+		case MS_TASK_WaitForCommand:
 		{
-			if (MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN)
-			  Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
+			#if defined(ASYNC_ENDPOINT_TRANSFERS)
+			bool CommandStatusPending = (Endpoint_GetAsyncStatus(MSInterfaceInfo->Config.DataINEndpoint.Address, NULL) == ENDPOINT_ASYNC_InProgress);
+			#else
+			bool CommandStatusPending = false;
+			#endif
+
+			Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
 
-			bool SCSICommandResult = CALLBACK_MS_Device_SCSICommandReceived(MSInterfaceInfo);
+			if (!(CommandStatusPending) && Endpoint_IsOUTReceived())
+			{
+				if (MS_Device_ReadInCommandBlock(MSInterfaceInfo))
+				{
+					if (MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN)
+					  Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
 
-			MSInterfaceInfo->State.CommandStatus.Status              = (SCSICommandResult) ? MS_SCSI_COMMAND_Pass : MS_SCSI_COMMAND_Fail;
-			MSInterfaceInfo->State.CommandStatus.Signature           = CPU_TO_LE32(MS_CSW_SIGNATURE);
-			MSInterfaceInfo->State.CommandStatus.Tag                 = MSInterfaceInfo->State.CommandBlock.Tag;
-			MSInterfaceInfo->State.CommandStatus.DataTransferResidue = MSInterfaceInfo->State.CommandBlock.DataTransferLength;
+					MSInterfaceInfo->State.DataStageHandler = NULL;
 
-			if (!(SCSICommandResult) && (le32_to_cpu(MSInterfaceInfo->State.CommandStatus.DataTransferResidue)))
-			  Endpoint_StallTransaction();
+					bool SCSICommandResult = CALLBACK_MS_Device_SCSICommandReceived(MSInterfaceInfo);
 
-			MS_Device_ReturnCommandStatus(MSInterfaceInfo);
+					if (SCSICommandResult && (MSInterfaceInfo->State.DataStageHandler != NULL))
+					  MSInterfaceInfo->State.TaskState = MS_TASK_DataStage;
+					else
+					  MS_Device_CompleteCommand(MSInterfaceInfo, SCSICommandResult);
+				}
+			}
+
+			break;
 		}
+		case MS_TASK_DataStage:
+			MS_Device_ProcessDataStage(MSInterfaceInfo);
+			break;
+		case MS_TASK_SendStatus:
+			MS_Device_ReturnCommandStatus(MSInterfaceInfo);
+			break;
 	}
 
 	if (MSInterfaceInfo->State.IsMassStoreReset)
 	{
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_CancelAsync(MSInterfaceInfo->Config.DataINEndpoint.Address);
+		Endpoint_CancelAsync(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+		MSInterfaceInfo->State.DataStageAsyncLength = 0;
+		#endif
+
 		Endpoint_ResetEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
 		Endpoint_ResetEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
 
@@ -127,10 +151,41 @@ void MS_Device_USBTask(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 		Endpoint_ClearStall();
 		Endpoint_ResetDataToggle();
 
+		MSInterfaceInfo->State.TaskState        = MS_TASK_WaitForCommand;
+		MSInterfaceInfo->State.DataStageHandler = NULL;
 		MSInterfaceInfo->State.IsMassStoreReset = false;
 	}
 }
 
+void MS_Device_DeferDataStage(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                              const MS_Device_DataStageHandler_t Handler)
+{
+	MSInterfaceInfo->State.DataStageHandler = Handler;
+}
+
+#if defined(ASYNC_ENDPOINT_TRANSFERS)
+bool MS_Device_SubmitDataAsync(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                               void* const Buffer,
+                               const uint16_t Length)
+{
+	uint8_t DataEndpointAddress;
+
+	if (MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN)
+	  DataEndpointAddress = MSInterfaceInfo->Config.DataINEndpoint.Address;
+	else
+	  DataEndpointAddress = MSInterfaceInfo->Config.DataOUTEndpoint.Address;
+
+	if (!(Length) || MSInterfaceInfo->State.DataStageAsyncLength)
+	  return false;
+
+	if (!(Endpoint_SubmitAsync(DataEndpointAddress, Buffer, Length, ENDPOINT_ASYNC_OPT_NONE, NULL)))
+	  return false;
+
+	MSInterfaceInfo->State.DataStageAsyncLength = Length;
+	return true;
+}
+#endif
+
 static bool MS_Device_ReadInCommandBlock(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 {
 	uint16_t BytesProcessed;
@@ -173,32 +228,129 @@ static bool MS_Device_ReadInCommandBlock(USB_ClassInfo_MS_Device_t* const MSInte
 	return true;
 }
 
-static void MS_Device_ReturnCommandStatus(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+static void MS_Device_ProcessDataStage(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 {
-	Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
+	bool IsDataIN = (MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN);
 
-	while (Endpoint_IsStalled())
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	/* Wait for any data stage transfer submitted by the handler to finish, before calling the handler again */
+	if (MSInterfaceInfo->State.DataStageAsyncLength)
 	{
-		#if !defined(INTERRUPT_CONTROL_ENDPOINT)
-		USB_USBTask();
-		#endif
+		uint16_t BytesTransferred;
+		uint8_t  AsyncStatus = Endpoint_GetAsyncStatus(IsDataIN ? MSInterfaceInfo->Config.DataINEndpoint.Address :
+		                                                          MSInterfaceInfo->Config.DataOUTEndpoint.Address, &BytesTransferred);
 
-		if (MSInterfaceInfo->State.IsMassStoreReset)
+		if (AsyncStatus == ENDPOINT_ASYNC_InProgress)
 		  return;
+
+		MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+
+		bool TransferComplete = ((AsyncStatus == ENDPOINT_ASYNC_Complete) &&
+		                         (BytesTransferred == MSInterfaceInfo->State.DataStageAsyncLength));
+
+		MSInterfaceInfo->State.DataStageAsyncLength = 0;
+
+		if (!(TransferComplete))
+		  MS_Device_CompleteCommand(MSInterfaceInfo, false);
+		else if (MSInterfaceInfo->State.DataStageAsyncStatus == MS_DATASTAGE_Complete)
+		  MS_Device_CompleteCommand(MSInterfaceInfo, true);
+
+		return;
 	}
+	#endif
 
-	Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
+	if (IsDataIN)
+	{
+		Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
 
-	while (Endpoint_IsStalled())
+		if (!(Endpoint_IsINReady()))
+		  return;
+	}
+	else
 	{
-		#if !defined(INTERRUPT_CONTROL_ENDPOINT)
-		USB_USBTask();
-		#endif
+		Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
 
-		if (MSInterfaceInfo->State.IsMassStoreReset)
+		if (!(Endpoint_IsOUTReceived()))
 		  return;
 	}
 
+	uint8_t DataStageStatus = MSInterfaceInfo->State.DataStageHandler(MSInterfaceInfo);
+
+	if (DataStageStatus == MS_DATASTAGE_Failed)
+	{
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		if (MSInterfaceInfo->State.DataStageAsyncLength)
+		{
+			Endpoint_CancelAsync(IsDataIN ? MSInterfaceInfo->Config.DataINEndpoint.Address :
+			                                MSInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+			MSInterfaceInfo->State.DataStageAsyncLength = 0;
+		}
+		#endif
+
+		MS_Device_CompleteCommand(MSInterfaceInfo, false);
+		return;
+	}
+
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	/* The endpoint is now serviced by the asynchronous transfer engine if the handler submitted a transfer */
+	if (MSInterfaceInfo->State.DataStageAsyncLength)
+	{
+		MSInterfaceInfo->State.DataStageAsyncStatus = DataStageStatus;
+		return;
+	}
+	#endif
+
+	if (IsDataIN)
+	  Endpoint_ClearIN();
+	else
+	  Endpoint_ClearOUT();
+
+	if (DataStageStatus == MS_DATASTAGE_Complete)
+	  MS_Device_CompleteCommand(MSInterfaceInfo, true);
+}
+
+static void MS_Device_CompleteCommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                      const bool CommandSuccess)
+{
+	MSInterfaceInfo->State.CommandStatus.Status              = (CommandSuccess) ? MS_SCSI_COMMAND_Pass : MS_SCSI_COMMAND_Fail;
+	MSInterfaceInfo->State.CommandStatus.Signature           = CPU_TO_LE32(MS_CSW_SIGNATURE);
+	MSInterfaceInfo->State.CommandStatus.Tag                 = MSInterfaceInfo->State.CommandBlock.Tag;
+	MSInterfaceInfo->State.CommandStatus.DataTransferResidue = MSInterfaceInfo->State.CommandBlock.DataTransferLength;
+
+	if (!(CommandSuccess) && (le32_to_cpu(MSInterfaceInfo->State.CommandStatus.DataTransferResidue)))
+	{
+		if (MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN)
+		  Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
+		else
+		  Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+		Endpoint_StallTransaction();
+	}
+
+	MSInterfaceInfo->State.DataStageHandler = NULL;
+	MSInterfaceInfo->State.TaskState        = MS_TASK_SendStatus;
+
+	MS_Device_ReturnCommandStatus(MSInterfaceInfo);
+}
+
+static void MS_Device_ReturnCommandStatus(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	/* Wait until the host has cleared any stalled data endpoint before sending the command status */
+	Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	if (Endpoint_IsStalled())
+	  return;
+
+	Endpoint_SelectEndpoint(MSInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if (Endpoint_IsStalled() || !(Endpoint_IsINReady()))
+	  return;
+
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	Endpoint_SubmitAsync(MSInterfaceInfo->Config.DataINEndpoint.Address, &MSInterfaceInfo->State.CommandStatus,
+	                     sizeof(MS_CommandStatusWrapper_t), ENDPOINT_ASYNC_OPT_NONE, NULL);
+	#else
 	uint16_t BytesProcessed = 0;
 	while (Endpoint_Write_Stream_LE(&MSInterfaceInfo->State.CommandStatus,
 	                                sizeof(MS_CommandStatusWrapper_t), &BytesProcessed) ==
@@ -209,6 +361,9 @@ static void MS_Device_ReturnCommandStatus(USB_ClassInfo_MS_Device_t* const MSInt
 	}
 
 	Endpoint_ClearIN();
+	#endif
+
+	MSInterfaceInfo->State.TaskState = MS_TASK_WaitForCommand;
 }
 
 #endif
@@ -47,6 +47,12 @@
  *  \section Sec_USBClassMSDevice_ModDescription Module Description
  *  Device Mode USB Class driver framework interface, for the Mass Storage USB Class driver.
  *
+ *  The driver processes the Bulk-Only transport as a state machine within \ref MS_Device_USBTask(), returning to the
+ *  main program loop between the command, data and status stages of each transfer. Applications which need to keep
+ *  other interfaces serviced during long data transfers, such as composite devices, may defer the data stage of a
+ *  command from within the \ref CALLBACK_MS_Device_SCSICommandReceived() callback via \ref MS_Device_DeferDataStage(),
+ *  so that the data is produced or consumed one endpoint bank at a time from subsequent calls to the task.
+ *
  *  @{
  */
 
@@ -68,14 +74,41 @@
 		#endif
 
 	/* Public Interface - May be used in end-application: */
+		/* Enums: */
+			/** Enum for the possible return values of a deferred data stage handler, see \ref MS_Device_DeferDataStage(). */
+			enum MS_Device_DataStageStatus_t
+			{
+				MS_DATASTAGE_InProgress = 0, /**< The endpoint bank was processed, and more data remains in the data stage. */
+				MS_DATASTAGE_Complete   = 1, /**< The endpoint bank was processed, and the data stage is complete. */
+				MS_DATASTAGE_Failed     = 2, /**< The command failed, and the remainder of the data stage should be aborted. */
+			};
+
 		/* Type Defines: */
+			/** Type define for a Mass Storage Class device interface, see \ref USB_ClassInfo_MS_Device. */
+			typedef struct USB_ClassInfo_MS_Device USB_ClassInfo_MS_Device_t;
+
+			/** Type define for a logical unit of the SCSI command engine, see \ref MS_SCSI_LUN. */
+			typedef struct MS_SCSI_LUN MS_SCSI_LUN_t;
+
+			/** Type define for a deferred data stage handler, see \ref MS_Device_DeferDataStage(). The handler must process
+			 *  a single bank of the currently selected data endpoint, and decrement the command block's \c DataTransferLength
+			 *  by the number of bytes processed. Alternatively, the handler may hand a buffer of data stage bytes to the
+			 *  asynchronous transfer engine via \ref MS_Device_SubmitDataAsync(), in which case the class driver decrements
+			 *  the \c DataTransferLength once the transfer has completed.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state.
+			 *
+			 *  \return A value from the \ref MS_Device_DataStageStatus_t enum.
+			 */
+			typedef uint8_t (*MS_Device_DataStageHandler_t)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
+
 			/** \brief Mass Storage Class Device Mode Configuration and State Structure.
 			 *
 			 *  Class state structure. An instance of this structure should be made for each Mass Storage interface
 			 *  within the user application, and passed to each of the Mass Storage class driver functions as the
 			 *  \c MSInterfaceInfo parameter. This stores each Mass Storage interface's configuration and state information.
 			 */
-			typedef struct
+			struct USB_ClassInfo_MS_Device
 			{
 				struct
 				{
@@ -99,10 +132,36 @@
 					volatile bool IsMassStoreReset; /**< Flag indicating that the host has requested that the Mass Storage interface be reset
 											         *   and that all current Mass Storage operations should immediately abort.
 											         */
+
+					uint8_t SenseKey; /**< SCSI sense key of the last processed command, returned to the host by the
+					                   *   \ref MS_Device_ProcessSCSICommand() SCSI command engine on a REQUEST SENSE command.
+					                   */
+					uint8_t AdditionalSenseCode; /**< SCSI additional sense code of the last processed command. */
+					uint8_t AdditionalSenseQualifier; /**< SCSI additional sense code qualifier of the last processed command. */
+
+					uint8_t TaskState; /**< Current stage of the Bulk-Only transport, for use by the class driver only. */
+					MS_Device_DataStageHandler_t DataStageHandler; /**< Handler for the deferred data stage of the current
+					                                                *   command, or \c NULL if the data stage is not deferred.
+					                                                */
+
+					const MS_SCSI_LUN_t* TransferLUN; /**< Logical unit of the deferred block transfer in progress, for use by
+					                                   *   the \ref MS_Device_ProcessSCSICommand() SCSI command engine only.
+					                                   */
+					uint32_t TransferBlockAddress; /**< Medium address of the current block of the deferred block transfer. */
+					uint32_t TransferBlocksRemaining; /**< Number of blocks remaining in the deferred block transfer. */
+					uint16_t TransferBlockOffset; /**< Byte offset within the current block of the deferred block transfer. */
+					bool     TransferIsRead; /**< Indicates if the deferred block transfer reads from the medium to the host. */
+
+					uint16_t DataStageAsyncLength; /**< Length of the pending asynchronous data stage transfer, or zero if none is
+					                                *   pending, for use by the class driver only.
+					                                */
+					uint8_t  DataStageAsyncStatus; /**< Status returned by the data stage handler which submitted the pending
+					                                *   asynchronous data stage transfer, for use by the class driver only.
+					                                */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
-			} USB_ClassInfo_MS_Device_t;
+			};
 
 		/* Function Prototypes: */
 			/** Configures the endpoints of a given Mass Storage interface, ready for use. This should be linked to the library
@@ -132,7 +191,8 @@
 			/** Mass Storage class driver callback for the user processing of a received SCSI command. This callback will fire each time the
 			 *  host sends a SCSI command which requires processing by the user application. Inside this callback the user is responsible
 			 *  for the processing of the received SCSI command from the host. The SCSI command is available in the CommandBlock structure
-			 *  inside the Mass Storage class state structure passed as a parameter to the callback function.
+			 *  inside the Mass Storage class state structure passed as a parameter to the callback function. Applications may pass
+			 *  the command on to the library's SCSI command engine for processing, see \ref Group_USBClassMSDeviceSCSI.
 			 *
 			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state.
 			 *
@@ -140,12 +200,61 @@
 			 */
 			bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** Defers the data stage of the SCSI command currently being processed. This may be called from within the
+			 *  \ref CALLBACK_MS_Device_SCSICommandReceived() callback instead of transferring the command's data before the
+			 *  callback returns; the given handler is then called from \ref MS_Device_USBTask() each time the data endpoint
+			 *  of the command has a bank ready to be filled or read, until it indicates that the data stage is complete
+			 *  or has failed. The command status is returned to the host once the data stage ends.
+			 *
+			 *  The return value of the callback is still used to indicate the command's success; if the callback returns
+			 *  \c false the deferred data stage is discarded.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state.
+			 *  \param[in]     Handler          Data stage handler to process each endpoint bank of the command's data stage.
+			 */
+			void MS_Device_DeferDataStage(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                              const MS_Device_DataStageHandler_t Handler) ATTR_NON_NULL_PTR_ARG(1, 2);
+
+			#if defined(ASYNC_ENDPOINT_TRANSFERS) || defined(__DOXYGEN__)
+				/** Submits a buffer holding part of the data stage of the SCSI command currently being processed to the
+				 *  asynchronous endpoint transfer engine. This may be called from within a deferred data stage handler
+				 *  instead of accessing the data endpoint directly; the buffer is then sent to or received from the host
+				 *  from the USB controller interrupt. The handler is next called once the transfer has completed, unless
+				 *  it returned \ref MS_DATASTAGE_Complete, in which case the command status is returned to the host once
+				 *  the transfer has completed. The command fails if the host sends a short packet before the end of the
+				 *  buffer.
+				 *
+				 *  \note This function is only available when the \c ASYNC_ENDPOINT_TRANSFERS token is defined.
+				 *
+				 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state.
+				 *  \param[in,out] Buffer           Buffer to send to (data IN commands) or fill from (data OUT commands) the host,
+				 *                                  which must remain valid until the transfer completes.
+				 *  \param[in]     Length           Number of data stage bytes to transfer, which must be non-zero.
+				 *
+				 *  \return Boolean \c true if the transfer was submitted, \c false otherwise.
+				 */
+				bool MS_Device_SubmitDataAsync(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                               void* const Buffer,
+				                               const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1, 2);
+			#endif
+
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
+		/* Enums: */
+			enum MS_Device_TaskStates_t
+			{
+				MS_TASK_WaitForCommand = 0,
+				MS_TASK_DataStage      = 1,
+				MS_TASK_SendStatus     = 2,
+			};
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_MASSSTORAGE_DEVICE_C)
 				static void MS_Device_ReturnCommandStatus(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 				static bool MS_Device_ReadInCommandBlock(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void MS_Device_ProcessDataStage(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void MS_Device_CompleteCommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                      const bool CommandSuccess) ATTR_NON_NULL_PTR_ARG(1);
 			#endif
 
 	#endif
@@ -155,6 +264,9 @@
 			}
 		#endif
 
+	/* Includes: */
+		#include "MassStorageSCSI.h"
+
 #endif
 
 /** @} */
@@ -0,0 +1,452 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../../Core/USBMode.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+
+#define  __INCLUDE_FROM_MS_DRIVER
+#define  __INCLUDE_FROM_MASSSTORAGE_SCSI_C
+#include "MassStorageSCSI.h"
+
+bool MS_Device_ProcessSCSICommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                  const MS_SCSI_LUN_t* const LUNTable)
+{
+	const MS_SCSI_LUN_t* LUN = &LUNTable[MSInterfaceInfo->State.CommandBlock.LUN];
+	bool CommandSuccess      = false;
+
+	switch (MSInterfaceInfo->State.CommandBlock.SCSICommandData[0])
+	{
+		case SCSI_CMD_INQUIRY:
+			CommandSuccess = MS_Device_SCSI_Inquiry(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_REQUEST_SENSE:
+			CommandSuccess = MS_Device_SCSI_RequestSense(MSInterfaceInfo);
+			break;
+		case SCSI_CMD_READ_CAPACITY_10:
+			CommandSuccess = MS_Device_SCSI_ReadCapacity(MSInterfaceInfo, LUN, false);
+			break;
+		case SCSI_CMD_SERVICE_ACTION_IN_16:
+			if ((MSInterfaceInfo->State.CommandBlock.SCSICommandData[1] & 0x1F) == SCSI_SERVICE_ACTION_READ_CAPACITY_16)
+			{
+				CommandSuccess = MS_Device_SCSI_ReadCapacity(MSInterfaceInfo, LUN, true);
+			}
+			else
+			{
+				MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+				                        SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+			}
+
+			break;
+		case SCSI_CMD_SEND_DIAGNOSTIC:
+			CommandSuccess = MS_Device_SCSI_SendDiagnostic(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_READ_6:
+		case SCSI_CMD_READ_10:
+		case SCSI_CMD_READ_16:
+			CommandSuccess = MS_Device_SCSI_ReadWrite(MSInterfaceInfo, LUN, true);
+			break;
+		case SCSI_CMD_WRITE_6:
+		case SCSI_CMD_WRITE_10:
+		case SCSI_CMD_WRITE_16:
+			CommandSuccess = MS_Device_SCSI_ReadWrite(MSInterfaceInfo, LUN, false);
+			break;
+		case SCSI_CMD_MODE_SENSE_6:
+			CommandSuccess = MS_Device_SCSI_ModeSense_6(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_START_STOP_UNIT:
+		case SCSI_CMD_SYNCHRONIZE_CACHE_10:
+			CommandSuccess = MS_Device_SCSI_SynchronizeCache(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_TEST_UNIT_READY:
+			if (LUN->Backend->IsReady && !(LUN->Backend->IsReady(LUN)))
+			{
+				MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_NOT_READY,
+				                        SCSI_ASENSE_MEDIUM_NOT_PRESENT, SCSI_ASENSEQ_NO_QUALIFIER);
+				break;
+			}
+
+			CommandSuccess = true;
+			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+			break;
+		case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
+		case SCSI_CMD_VERIFY_10:
+			CommandSuccess = true;
+			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+			break;
+		default:
+			MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+			                        SCSI_ASENSE_INVALID_COMMAND, SCSI_ASENSEQ_NO_QUALIFIER);
+			break;
+	}
+
+	if (CommandSuccess)
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_GOOD,
+		                        SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+	}
+
+	return CommandSuccess;
+}
+
+static void MS_Device_SCSI_SetSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                    const uint8_t Key,
+                                    const uint8_t Acode,
+                                    const uint8_t Aqual)
+{
+	MSInterfaceInfo->State.SenseKey                 = Key;
+	MSInterfaceInfo->State.AdditionalSenseCode      = Acode;
+	MSInterfaceInfo->State.AdditionalSenseQualifier = Aqual;
+}
+
+static void MS_Device_SCSI_WriteResponse(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                         const void* const Buffer,
+                                         const uint16_t Length,
+                                         const uint16_t AllocationLength)
+{
+	uint16_t BytesTransferred = MIN(Length, AllocationLength);
+
+	Endpoint_Write_Stream_LE(Buffer, BytesTransferred, NULL);
+	Endpoint_Null_Stream((AllocationLength - BytesTransferred), NULL);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+}
+
+static bool MS_Device_SCSI_Inquiry(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                   const MS_SCSI_LUN_t* const LUN)
+{
+	const uint8_t* CommandData      = MSInterfaceInfo->State.CommandBlock.SCSICommandData;
+	uint16_t       AllocationLength = (((uint16_t)CommandData[3] << 8) | CommandData[4]);
+
+	/* Only the standard INQUIRY data is supported, fail if any of the optional INQUIRY bits are set */
+	if ((CommandData[1] & ((1 << 0) | (1 << 1))) || CommandData[2])
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                        SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	MS_Device_SCSI_WriteResponse(MSInterfaceInfo, LUN->InquiryData, sizeof(SCSI_Inquiry_Response_t), AllocationLength);
+	return true;
+}
+
+static bool MS_Device_SCSI_RequestSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	SCSI_Request_Sense_Response_t SenseData;
+
+	memset(&SenseData, 0x00, sizeof(SenseData));
+	SenseData.ResponseCode             = 0x70;
+	SenseData.AdditionalLength         = 0x0A;
+	SenseData.SenseKey                 = MSInterfaceInfo->State.SenseKey;
+	SenseData.AdditionalSenseCode      = MSInterfaceInfo->State.AdditionalSenseCode;
+	SenseData.AdditionalSenseQualifier = MSInterfaceInfo->State.AdditionalSenseQualifier;
+
+	MS_Device_SCSI_WriteResponse(MSInterfaceInfo, &SenseData, sizeof(SenseData),
+	                             MSInterfaceInfo->State.CommandBlock.SCSICommandData[4]);
+	return true;
+}
+
+static bool MS_Device_SCSI_ReadCapacity(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                        const MS_SCSI_LUN_t* const LUN,
+                                        const bool IsLongResponse)
+{
+	uint8_t  CapacityData[32];
+	uint32_t LastBlockAddress = (LUN->TotalBlocks - 1);
+
+	memset(CapacityData, 0x00, sizeof(CapacityData));
+
+	if (IsLongResponse)
+	{
+		/* READ CAPACITY (16) returns a 64-bit last block address and a 32-bit block length, padded to 32 bytes */
+		CapacityData[4]  = (LastBlockAddress >> 24);
+		CapacityData[5]  = (LastBlockAddress >> 16);
+		CapacityData[6]  = (LastBlockAddress >> 8);
+		CapacityData[7]  = (LastBlockAddress & 0xFF);
+		CapacityData[10] = (LUN->BlockSize >> 8);
+		CapacityData[11] = (LUN->BlockSize & 0xFF);
+
+		MS_Device_SCSI_WriteResponse(MSInterfaceInfo, CapacityData, 32,
+		                             MIN(MS_Device_SCSI_GetBE32(&MSInterfaceInfo->State.CommandBlock.SCSICommandData[10]), 32));
+	}
+	else
+	{
+		/* READ CAPACITY (10) returns a 32-bit last block address and a 32-bit block length */
+		CapacityData[0]  = (LastBlockAddress >> 24);
+		CapacityData[1]  = (LastBlockAddress >> 16);
+		CapacityData[2]  = (LastBlockAddress >> 8);
+		CapacityData[3]  = (LastBlockAddress & 0xFF);
+		CapacityData[6]  = (LUN->BlockSize >> 8);
+		CapacityData[7]  = (LUN->BlockSize & 0xFF);
+
+		MS_Device_SCSI_WriteResponse(MSInterfaceInfo, CapacityData, 8, 8);
+	}
+
+	return true;
+}
+
+static bool MS_Device_SCSI_SendDiagnostic(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_SCSI_LUN_t* const LUN)
+{
+	/* Only the SELF TEST diagnostic is supported */
+	if (!(MSInterfaceInfo->State.CommandBlock.SCSICommandData[1] & (1 << 2)))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                        SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (LUN->Backend->SelfTest && !(LUN->Backend->SelfTest(LUN)))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_HARDWARE_ERROR,
+		                        SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+	return true;
+}
+
+static bool MS_Device_SCSI_ReadWrite(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                     const MS_SCSI_LUN_t* const LUN,
+                                     const bool IsDataRead)
+{
+	const uint8_t* CommandData = MSInterfaceInfo->State.CommandBlock.SCSICommandData;
+	uint32_t       BlockAddress;
+	uint32_t       TotalBlocks;
+	bool           BlockAddressValid = true;
+
+	switch (CommandData[0])
+	{
+		case SCSI_CMD_READ_6:
+		case SCSI_CMD_WRITE_6:
+			BlockAddress = (((uint32_t)(CommandData[1] & 0x1F) << 16) | ((uint16_t)CommandData[2] << 8) | CommandData[3]);
+			TotalBlocks  = (CommandData[4] ? CommandData[4] : 256);
+			break;
+		case SCSI_CMD_READ_10:
+		case SCSI_CMD_WRITE_10:
+			BlockAddress = MS_Device_SCSI_GetBE32(&CommandData[2]);
+			TotalBlocks  = (((uint16_t)CommandData[7] << 8) | CommandData[8]);
+			break;
+		default:
+			/* Only the lower 32 bits of the 64-bit block address of READ (16) and WRITE (16) commands are supported */
+			BlockAddressValid = !(MS_Device_SCSI_GetBE32(&CommandData[2]));
+			BlockAddress      = MS_Device_SCSI_GetBE32(&CommandData[6]);
+			TotalBlocks       = MS_Device_SCSI_GetBE32(&CommandData[10]);
+			break;
+	}
+
+	if (!(IsDataRead) && LUN->ReadOnly)
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_DATA_PROTECT,
+		                        SCSI_ASENSE_WRITE_PROTECTED, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (!(BlockAddressValid) || (BlockAddress >= LUN->TotalBlocks) || (TotalBlocks > (LUN->TotalBlocks - BlockAddress)))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                        SCSI_ASENSE_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	/* Fail if the host's data stage is in the wrong direction or too short for the requested blocks, as the data endpoint
+	 * selected by the class driver and the remaining data length are taken from the command block wrapper */
+	if (TotalBlocks && ((IsDataRead != !!(MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN)) ||
+	                    (TotalBlocks > (MSInterfaceInfo->State.CommandBlock.DataTransferLength / LUN->BlockSize))))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                        SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (LUN->Backend->IsReady && !(LUN->Backend->IsReady(LUN)))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_NOT_READY,
+		                        SCSI_ASENSE_MEDIUM_NOT_PRESENT, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	BlockAddress += LUN->FirstBlock;
+
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	/* Hand the transfer of memory mapped media to the asynchronous transfer engine, a run of contiguous blocks at a time */
+	if (TotalBlocks && LUN->Backend->MapBlocks)
+	{
+		MSInterfaceInfo->State.TransferLUN             = LUN;
+		MSInterfaceInfo->State.TransferBlockAddress    = BlockAddress;
+		MSInterfaceInfo->State.TransferBlocksRemaining = TotalBlocks;
+		MSInterfaceInfo->State.TransferIsRead          = IsDataRead;
+
+		MS_Device_DeferDataStage(MSInterfaceInfo, MS_Device_SCSI_TransferMapped);
+		return true;
+	}
+	#endif
+
+	/* Defer the transfer to be made one endpoint bank at a time if the backend supports it, so that the main loop keeps running */
+	if (TotalBlocks && LUN->Backend->ReadBank && LUN->Backend->WriteBank)
+	{
+		MSInterfaceInfo->State.TransferLUN             = LUN;
+		MSInterfaceInfo->State.TransferBlockAddress    = BlockAddress;
+		MSInterfaceInfo->State.TransferBlocksRemaining = TotalBlocks;
+		MSInterfaceInfo->State.TransferBlockOffset     = 0;
+		MSInterfaceInfo->State.TransferIsRead          = IsDataRead;
+
+		MS_Device_DeferDataStage(MSInterfaceInfo, MS_Device_SCSI_TransferBank);
+		return true;
+	}
+
+	/* Pass the transfer on to the backend, in chunks of at most 65535 blocks */
+	while (TotalBlocks)
+	{
+		uint16_t BlocksInChunk = MIN(TotalBlocks, UINT16_MAX);
+		bool     ChunkSuccess;
+
+		if (IsDataRead)
+		  ChunkSuccess = LUN->Backend->ReadBlocks(MSInterfaceInfo, LUN, BlockAddress, BlocksInChunk);
+		else
+		  ChunkSuccess = LUN->Backend->WriteBlocks(MSInterfaceInfo, LUN, BlockAddress, BlocksInChunk);
+
+		if (!(ChunkSuccess))
+		{
+			MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_MEDIUM_ERROR,
+			                        SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+			return false;
+		}
+
+		MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)BlocksInChunk * LUN->BlockSize);
+
+		BlockAddress += BlocksInChunk;
+		TotalBlocks  -= BlocksInChunk;
+	}
+
+	return true;
+}
+
+static uint8_t MS_Device_SCSI_TransferBank(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	const MS_SCSI_LUN_t* LUN        = MSInterfaceInfo->State.TransferLUN;
+	bool                 IsDataRead = MSInterfaceInfo->State.TransferIsRead;
+	uint16_t             BankSize   = (IsDataRead) ? MSInterfaceInfo->Config.DataINEndpoint.Size : MSInterfaceInfo->Config.DataOUTEndpoint.Size;
+	uint16_t             Length     = MIN(BankSize, (LUN->BlockSize - MSInterfaceInfo->State.TransferBlockOffset));
+	bool                 BankSuccess;
+
+	if (IsDataRead)
+	{
+		BankSuccess = LUN->Backend->ReadBank(MSInterfaceInfo, LUN, MSInterfaceInfo->State.TransferBlockAddress,
+		                                     MSInterfaceInfo->State.TransferBlockOffset, Length);
+	}
+	else
+	{
+		BankSuccess = LUN->Backend->WriteBank(MSInterfaceInfo, LUN, MSInterfaceInfo->State.TransferBlockAddress,
+		                                      MSInterfaceInfo->State.TransferBlockOffset, Length);
+	}
+
+	if (!(BankSuccess))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_MEDIUM_ERROR,
+		                        SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+		return MS_DATASTAGE_Failed;
+	}
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= Length;
+	MSInterfaceInfo->State.TransferBlockOffset             += Length;
+
+	/* Move on to the next block once the current block has been transferred */
+	if (MSInterfaceInfo->State.TransferBlockOffset == LUN->BlockSize)
+	{
+		MSInterfaceInfo->State.TransferBlockOffset = 0;
+		MSInterfaceInfo->State.TransferBlockAddress++;
+
+		if (!(--MSInterfaceInfo->State.TransferBlocksRemaining))
+		  return MS_DATASTAGE_Complete;
+	}
+
+	return MS_DATASTAGE_InProgress;
+}
+
+#if defined(ASYNC_ENDPOINT_TRANSFERS)
+static uint8_t MS_Device_SCSI_TransferMapped(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	const MS_SCSI_LUN_t* LUN           = MSInterfaceInfo->State.TransferLUN;
+	uint16_t             BlocksInChunk = MIN(MSInterfaceInfo->State.TransferBlocksRemaining, (UINT16_MAX / LUN->BlockSize));
+	uint8_t*             BlockData     = LUN->Backend->MapBlocks(LUN, MSInterfaceInfo->State.TransferBlockAddress, &BlocksInChunk);
+
+	if ((BlockData == NULL) || !(BlocksInChunk) ||
+	    !(MS_Device_SubmitDataAsync(MSInterfaceInfo, BlockData, (BlocksInChunk * LUN->BlockSize))))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_MEDIUM_ERROR,
+		                        SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+		return MS_DATASTAGE_Failed;
+	}
+
+	MSInterfaceInfo->State.TransferBlockAddress    += BlocksInChunk;
+	MSInterfaceInfo->State.TransferBlocksRemaining -= BlocksInChunk;
+
+	return (MSInterfaceInfo->State.TransferBlocksRemaining) ? MS_DATASTAGE_InProgress : MS_DATASTAGE_Complete;
+}
+#endif
+
+static bool MS_Device_SCSI_ModeSense_6(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                       const MS_SCSI_LUN_t* const LUN)
+{
+	/* Send an empty header response with the Write Protect flag status */
+	Endpoint_Write_8(0x00);
+	Endpoint_Write_8(0x00);
+	Endpoint_Write_8(LUN->ReadOnly ? 0x80 : 0x00);
+	Endpoint_Write_8(0x00);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= 4;
+	return true;
+}
+
+static bool MS_Device_SCSI_SynchronizeCache(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                            const MS_SCSI_LUN_t* const LUN)
+{
+	if (LUN->Backend->SynchronizeCache && !(LUN->Backend->SynchronizeCache(LUN)))
+	{
+		MS_Device_SCSI_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_MEDIUM_ERROR,
+		                        SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+	return true;
+}
+
+static uint32_t MS_Device_SCSI_GetBE32(const uint8_t* const Data)
+{
+	return (((uint32_t)Data[0] << 24) | ((uint32_t)Data[1] << 16) | ((uint16_t)Data[2] << 8) | Data[3]);
+}
+
+#endif
+
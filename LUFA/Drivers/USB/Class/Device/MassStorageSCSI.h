@@ -0,0 +1,232 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Device mode SCSI command engine for the library USB Mass Storage Class driver.
+ *
+ *  Device mode SCSI command engine for the library USB Mass Storage Class driver.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB module driver
+ *        dispatch header located in LUFA/Drivers/USB.h.
+ */
+
+/** \ingroup Group_USBClassMSDevice
+ *  \defgroup Group_USBClassMSDeviceSCSI Mass Storage Class Device SCSI Command Engine
+ *
+ *  \section Sec_USBClassMSDeviceSCSI_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Drivers/USB/Class/Device/MassStorageSCSI.c <i>(Makefile source module name: LUFA_SRC_USBCLASS)</i>
+ *
+ *  \section Sec_USBClassMSDeviceSCSI_ModDescription Module Description
+ *  SCSI command engine for the device mode Mass Storage Class driver. This module decodes and processes the SCSI commands
+ *  received by a Mass Storage interface on behalf of the user application, so that the application need only supply the
+ *  storage medium of each logical unit (LUN) as a set of backend functions, via a \ref MS_SCSI_Backend_t structure.
+ *
+ *  To use the engine, the user application should define a table of \ref MS_SCSI_LUN_t structures, one for each of
+ *  the logical units of the interface, and call \ref MS_Device_ProcessSCSICommand() with the table from within its
+ *  \ref CALLBACK_MS_Device_SCSICommandReceived() callback. The following SCSI commands are supported:
+ *    - INQUIRY, REQUEST SENSE, TEST UNIT READY and MODE SENSE (6)
+ *    - READ CAPACITY (10) and READ CAPACITY (16)
+ *    - READ (6), READ (10), READ (16), WRITE (6), WRITE (10) and WRITE (16)
+ *    - SYNCHRONIZE CACHE (10) and START STOP UNIT, which flush any write cache of the backend
+ *    - SEND DIAGNOSTIC (self test only), PREVENT ALLOW MEDIUM REMOVAL and VERIFY (10)
+ *
+ *  Backends which provide the optional \c ReadBank and \c WriteBank functions have their block transfers deferred via
+ *  \ref MS_Device_DeferDataStage(), so that the main program loop continues to run while a long transfer is in progress.
+ *  When the \c ASYNC_ENDPOINT_TRANSFERS token is defined, the block transfers of backends which provide the optional
+ *  \c MapBlocks function are instead handed to the asynchronous endpoint transfer engine via \ref MS_Device_SubmitDataAsync().
+ *
+ *  @{
+ */
+
+#ifndef _MS_SCSI_DEVICE_H_
+#define _MS_SCSI_DEVICE_H_
+
+	/* Includes: */
+		#include "../../USB.h"
+		#include "MassStorageClassDevice.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_MS_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Type Defines: */
+			/** \brief Mass Storage Class Device SCSI Backend Structure.
+			 *
+			 *  Type define for the set of functions implementing the storage medium of one or more logical units. The read
+			 *  and write functions must transfer the given blocks to or from the currently selected data endpoint of the
+			 *  interface, and should abort early if the host resets the interface via the \c IsMassStoreReset state flag.
+			 *  Optional functions may be set to \c NULL if the storage medium does not require them.
+			 */
+			typedef struct
+			{
+				bool (*ReadBlocks)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                   const MS_SCSI_LUN_t* const LUN,
+				                   const uint32_t BlockAddress,
+				                   const uint16_t TotalBlocks); /**< Reads the given blocks from the medium and writes them to the
+				                                                 *   data IN endpoint. The block address is relative to the start
+				                                                 *   of the medium, i.e. the \c FirstBlock of the LUN has already
+				                                                 *   been added. Returns \c false on failure.
+				                                                 */
+				bool (*WriteBlocks)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                    const MS_SCSI_LUN_t* const LUN,
+				                    const uint32_t BlockAddress,
+				                    const uint16_t TotalBlocks); /**< Reads the given blocks from the data OUT endpoint and writes
+				                                                  *   them to the medium, as for \c ReadBlocks. Returns \c false
+				                                                  *   on failure.
+				                                                  */
+				bool (*ReadBank)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                 const MS_SCSI_LUN_t* const LUN,
+				                 const uint32_t BlockAddress,
+				                 const uint16_t BlockOffset,
+				                 const uint16_t Length); /**< Optional, reads the given number of bytes from the given byte
+				                                          *   offset within a block of the medium, and writes them to the
+				                                          *   data IN endpoint. The bytes never cross a block boundary, and
+				                                          *   always fit within the ready endpoint bank. If set along with
+				                                          *   \c WriteBank, block transfers are made one endpoint bank at a
+				                                          *   time from \ref MS_Device_USBTask() instead of via \c ReadBlocks
+				                                          *   and \c WriteBlocks. Returns \c false on failure.
+				                                          */
+				bool (*WriteBank)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                  const MS_SCSI_LUN_t* const LUN,
+				                  const uint32_t BlockAddress,
+				                  const uint16_t BlockOffset,
+				                  const uint16_t Length); /**< Optional, reads the given number of bytes from the data OUT
+				                                           *   endpoint and writes them to the medium, as for \c ReadBank.
+				                                           *   Returns \c false on failure.
+				                                           */
+				uint8_t* (*MapBlocks)(const MS_SCSI_LUN_t* const LUN,
+				                      const uint32_t BlockAddress,
+				                      uint16_t* const TotalBlocks); /**< Optional, for media held in directly addressable
+				                                                     *   memory such as RAM disks. Returns a pointer to the
+				                                                     *   given block of the medium, and reduces the given
+				                                                     *   block count to the number of blocks stored
+				                                                     *   contiguously from it, or returns \c NULL on failure.
+				                                                     *   If set and the \c ASYNC_ENDPOINT_TRANSFERS token is
+				                                                     *   defined, block transfers are made directly between
+				                                                     *   the medium and the data endpoints by the asynchronous
+				                                                     *   endpoint transfer engine, instead of via the other
+				                                                     *   read and write functions.
+				                                                     */
+				bool (*SynchronizeCache)(const MS_SCSI_LUN_t* const LUN); /**< Optional, commits any cached write data to
+				                                                           *   the medium. Returns \c false on failure.
+				                                                           */
+				bool (*SelfTest)(const MS_SCSI_LUN_t* const LUN); /**< Optional, checks that the medium is functioning
+				                                                   *   correctly. Returns \c false on failure.
+				                                                   */
+				bool (*IsReady)(const MS_SCSI_LUN_t* const LUN); /**< Optional, indicates if the medium is present and ready
+				                                                  *   for access, for removable media such as memory cards.
+				                                                  */
+			} MS_SCSI_Backend_t;
+
+			/** \brief Mass Storage Class Device SCSI Logical Unit Structure.
+			 *
+			 *  Type define for a logical unit of a Mass Storage interface processed by the SCSI command engine. A table of
+			 *  these structures, one for each of the interface's \c TotalLUNs logical units, is passed to
+			 *  \ref MS_Device_ProcessSCSICommand(). Several logical units may share a backend, each mapping a different
+			 *  region of the same medium via its \c FirstBlock value.
+			 */
+			struct MS_SCSI_LUN
+			{
+				const MS_SCSI_Backend_t*       Backend; /**< Backend implementing the storage medium of the logical unit. */
+				const SCSI_Inquiry_Response_t* InquiryData; /**< SCSI INQUIRY response data of the logical unit. */
+				void*                          BackendData; /**< Optional backend specific data, such as a medium instance. */
+
+				uint32_t FirstBlock; /**< Address on the medium of the first block of the logical unit. */
+				uint32_t TotalBlocks; /**< Total number of blocks of the logical unit. */
+				uint16_t BlockSize; /**< Size of each block of the logical unit, in bytes. */
+				bool     ReadOnly; /**< Indicates if the logical unit is write protected. */
+			};
+
+		/* Function Prototypes: */
+			/** Processes the SCSI command held in the command block of the given Mass Storage interface, dispatching it to the
+			 *  logical unit indicated by the command block. This should be called from the application's
+			 *  \ref CALLBACK_MS_Device_SCSICommandReceived() callback, and its result returned from the callback.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state.
+			 *  \param[in]     LUNTable         Pointer to a table of logical units, one for each LUN of the interface.
+			 *
+			 *  \return Boolean \c true if the SCSI command completed successfully, \c false otherwise.
+			 */
+			bool MS_Device_ProcessSCSICommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                  const MS_SCSI_LUN_t* const LUNTable) ATTR_NON_NULL_PTR_ARG(1, 2);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_MASSSTORAGE_SCSI_C)
+				static void MS_Device_SCSI_SetSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                    const uint8_t Key,
+				                                    const uint8_t Acode,
+				                                    const uint8_t Aqual) ATTR_NON_NULL_PTR_ARG(1);
+				static void MS_Device_SCSI_WriteResponse(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                         const void* const Buffer,
+				                                         const uint16_t Length,
+				                                         const uint16_t AllocationLength) ATTR_NON_NULL_PTR_ARG(1);
+				static bool MS_Device_SCSI_Inquiry(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                   const MS_SCSI_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_RequestSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static bool MS_Device_SCSI_ReadCapacity(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                        const MS_SCSI_LUN_t* const LUN,
+				                                        const bool IsLongResponse) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_SendDiagnostic(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                          const MS_SCSI_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_ReadWrite(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                     const MS_SCSI_LUN_t* const LUN,
+				                                     const bool IsDataRead) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static uint8_t MS_Device_SCSI_TransferBank(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				#if defined(ASYNC_ENDPOINT_TRANSFERS)
+				static uint8_t MS_Device_SCSI_TransferMapped(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				#endif
+				static bool MS_Device_SCSI_ModeSense_6(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                       const MS_SCSI_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_SynchronizeCache(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                            const MS_SCSI_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static uint32_t MS_Device_SCSI_GetBE32(const uint8_t* const Data) ATTR_NON_NULL_PTR_ARG(1);
+			#endif
+
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -259,18 +259,26 @@ int16_t PRNT_Device_ReceiveByte(USB_ClassInfo_PRNT_Device_t* const PRNTInterface
 	return ReceivedByte;
 }
 
-#if defined(FDEV_SETUP_STREAM)
+#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 void PRNT_Device_CreateStream(USB_ClassInfo_PRNT_Device_t* const PRNTInterfaceInfo,
                               FILE* const Stream)
 {
+#if (ARCH == ARCH_SIM)
+	fdev_setup_stream(Stream, PRNT_Device_putchar, PRNT_Device_getchar, _FDEV_SETUP_RW);
+#else
 	*Stream = (FILE)FDEV_SETUP_STREAM(PRNT_Device_putchar, PRNT_Device_getchar, _FDEV_SETUP_RW);
+#endif
 	fdev_set_udata(Stream, PRNTInterfaceInfo);
 }
 
 void PRNT_Device_CreateBlockingStream(USB_ClassInfo_PRNT_Device_t* const PRNTInterfaceInfo,
                                       FILE* const Stream)
 {
+#if (ARCH == ARCH_SIM)
+	fdev_setup_stream(Stream, PRNT_Device_putchar, PRNT_Device_getchar_Blocking, _FDEV_SETUP_RW);
+#else
 	*Stream = (FILE)FDEV_SETUP_STREAM(PRNT_Device_putchar, PRNT_Device_getchar_Blocking, _FDEV_SETUP_RW);
+#endif
 	fdev_set_udata(Stream, PRNTInterfaceInfo);
 }
 
@@ -228,7 +228,7 @@
 			 */
 			uint8_t PRNT_Device_Flush(USB_ClassInfo_PRNT_Device_t* const PRNTInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
-			#if defined(FDEV_SETUP_STREAM) || defined(__DOXYGEN__)
+			#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM) || defined(__DOXYGEN__)
 			/** Creates a standard character stream for the given Printer Device instance so that it can be used with all the regular
 			 *  functions in the standard <stdio.h> library that accept a \c FILE stream as a destination (e.g. \c fprintf()). The created
 			 *  stream is bidirectional and can be used for both input and output functions.
@@ -266,7 +266,7 @@
 	#if !defined(__DOXYGEN__)
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_PRINTER_DEVICE_C)
-				#if defined(FDEV_SETUP_STREAM)
+				#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 				static int PRNT_Device_putchar(char c,
 				                               FILE* Stream) ATTR_NON_NULL_PTR_ARG(2);
 				static int PRNT_Device_getchar(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
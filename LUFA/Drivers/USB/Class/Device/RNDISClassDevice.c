@@ -457,17 +457,32 @@ uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
 	if (!(Endpoint_IsOUTReceived()))
 		return ENDPOINT_RWSTREAM_NoError;
 
-	RNDIS_Packet_Message_t RNDISPacketHeader;
-	Endpoint_Read_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
+	uint32_t DataLength;
 
-	if (le32_to_cpu(RNDISPacketHeader.DataLength) > ETHERNET_FRAME_SIZE_MAX)
+	#if defined(ENDPOINT_HAS_BANK_POINTER)
+	/* Parse the packet message header in place if the bank holds all of it, rather than copying it out first */
+	if (Endpoint_BytesRemainingInBank() >= sizeof(RNDIS_Packet_Message_t))
+	{
+		DataLength = le32_to_cpu(((const RNDIS_Packet_Message_t*)Endpoint_GetBankPointer())->DataLength);
+		Endpoint_CommitBank(sizeof(RNDIS_Packet_Message_t));
+	}
+	else
+	#endif
+	{
+		RNDIS_Packet_Message_t RNDISPacketHeader;
+		Endpoint_Read_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
+
+		DataLength = le32_to_cpu(RNDISPacketHeader.DataLength);
+	}
+
+	if (DataLength > ETHERNET_FRAME_SIZE_MAX)
 	{
 		Endpoint_StallTransaction();
 
 		return RNDIS_ERROR_LOGICAL_CMD_FAILED;
 	}
 
-	const size_t ExpectedLength = (uint16_t)le32_to_cpu(RNDISPacketHeader.DataLength);
+	const size_t ExpectedLength = (uint16_t)DataLength;
 
 	if (ExpectedLength > BufferSize)
 		*PacketLength = BufferSize;
@@ -499,16 +514,35 @@ uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
 	if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
 	  return ErrorCode;
 
-	RNDIS_Packet_Message_t RNDISPacketHeader;
+	RNDIS_Packet_Message_t  LocalPacketHeader;
+	RNDIS_Packet_Message_t* RNDISPacketHeader = &LocalPacketHeader;
+
+	#if defined(ENDPOINT_HAS_BANK_POINTER)
+	/* Construct the packet message header in place if the bank has room for all of it, rather than copying it in */
+	bool HeaderInBank = (Endpoint_BytesRemainingInBank() >= sizeof(RNDIS_Packet_Message_t));
 
-	memset(&RNDISPacketHeader, 0, sizeof(RNDIS_Packet_Message_t));
+	if (HeaderInBank)
+	  RNDISPacketHeader = (RNDIS_Packet_Message_t*)Endpoint_GetBankPointer();
+	#endif
 
-	RNDISPacketHeader.MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG);
-	RNDISPacketHeader.MessageLength = cpu_to_le32(sizeof(RNDIS_Packet_Message_t) + PacketLength);
-	RNDISPacketHeader.DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t));
-	RNDISPacketHeader.DataLength    = cpu_to_le32(PacketLength);
+	memset(RNDISPacketHeader, 0, sizeof(RNDIS_Packet_Message_t));
+
+	RNDISPacketHeader->MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG);
+	RNDISPacketHeader->MessageLength = cpu_to_le32(sizeof(RNDIS_Packet_Message_t) + PacketLength);
+	RNDISPacketHeader->DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t));
+	RNDISPacketHeader->DataLength    = cpu_to_le32(PacketLength);
+
+	#if defined(ENDPOINT_HAS_BANK_POINTER)
+	if (HeaderInBank)
+	{
+		Endpoint_CommitBank(sizeof(RNDIS_Packet_Message_t));
+	}
+	else
+	#endif
+	{
+		Endpoint_Write_Stream_LE(&LocalPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
+	}
 
-	Endpoint_Write_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
 	Endpoint_Write_Stream_LE(Buffer, PacketLength, NULL);
 	Endpoint_ClearIN();
 
@@ -369,18 +369,26 @@ uint8_t AOA_Host_Flush(USB_ClassInfo_AOA_Host_t* const AOAInterfaceInfo)
 	return PIPE_READYWAIT_NoError;
 }
 
-#if defined(FDEV_SETUP_STREAM)
+#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 void AOA_Host_CreateStream(USB_ClassInfo_AOA_Host_t* const AOAInterfaceInfo,
                            FILE* const Stream)
 {
+#if (ARCH == ARCH_SIM)
+	fdev_setup_stream(Stream, AOA_Host_putchar, AOA_Host_getchar, _FDEV_SETUP_RW);
+#else
 	*Stream = (FILE)FDEV_SETUP_STREAM(AOA_Host_putchar, AOA_Host_getchar, _FDEV_SETUP_RW);
+#endif
 	fdev_set_udata(Stream, AOAInterfaceInfo);
 }
 
 void AOA_Host_CreateBlockingStream(USB_ClassInfo_AOA_Host_t* const AOAInterfaceInfo,
                                    FILE* const Stream)
 {
+#if (ARCH == ARCH_SIM)
+	fdev_setup_stream(Stream, AOA_Host_putchar, AOA_Host_getchar_Blocking, _FDEV_SETUP_RW);
+#else
 	*Stream = (FILE)FDEV_SETUP_STREAM(AOA_Host_putchar, AOA_Host_getchar_Blocking, _FDEV_SETUP_RW);
+#endif
 	fdev_set_udata(Stream, AOAInterfaceInfo);
 }
 
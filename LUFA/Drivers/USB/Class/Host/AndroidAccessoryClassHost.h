@@ -284,7 +284,7 @@
 	#if !defined(__DOXYGEN__)
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_ANDROIDACCESSORY_HOST_C)
-				#if defined(FDEV_SETUP_STREAM)
+				#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 				static int AOA_Host_putchar(char c,
 				                            FILE* Stream) ATTR_NON_NULL_PTR_ARG(2);
 				static int AOA_Host_getchar(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
@@ -457,18 +457,26 @@ uint8_t CDC_Host_Flush(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 	return PIPE_READYWAIT_NoError;
 }
 
-#if defined(FDEV_SETUP_STREAM)
+#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 	void CDC_Host_CreateStream(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo,
 	                           FILE* const Stream)
 	{
+	#if (ARCH == ARCH_SIM)
+		fdev_setup_stream(Stream, CDC_Host_putchar, CDC_Host_getchar, _FDEV_SETUP_RW);
+	#else
 		*Stream = (FILE)FDEV_SETUP_STREAM(CDC_Host_putchar, CDC_Host_getchar, _FDEV_SETUP_RW);
+	#endif
 		fdev_set_udata(Stream, CDCInterfaceInfo);
 	}
 
 	void CDC_Host_CreateBlockingStream(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo,
 	                                   FILE* const Stream)
 	{
+	#if (ARCH == ARCH_SIM)
+		fdev_setup_stream(Stream, CDC_Host_putchar, CDC_Host_getchar_Blocking, _FDEV_SETUP_RW);
+	#else
 		*Stream = (FILE)FDEV_SETUP_STREAM(CDC_Host_putchar, CDC_Host_getchar_Blocking, _FDEV_SETUP_RW);
+	#endif
 		fdev_set_udata(Stream, CDCInterfaceInfo);
 	}
 
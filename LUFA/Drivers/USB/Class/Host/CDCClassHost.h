@@ -313,7 +313,7 @@
 			 */
 			uint8_t CDC_Host_Flush(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
-			#if defined(FDEV_SETUP_STREAM) || defined(__DOXYGEN__)
+			#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM) || defined(__DOXYGEN__)
 			/** Creates a standard character stream for the given CDC Device instance so that it can be used with all the regular
 			 *  functions in the standard \c <stdio.h> library that accept a \c FILE stream as a destination (e.g. \c fprintf). The created
 			 *  stream is bidirectional and can be used for both input and output functions.
@@ -361,7 +361,7 @@
 	#if !defined(__DOXYGEN__)
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_CDC_HOST_C)
-				#if defined(FDEV_SETUP_STREAM)
+				#if defined(FDEV_SETUP_STREAM) || (ARCH == ARCH_SIM)
 				static int CDC_Host_putchar(char c,
 				                            FILE* Stream) ATTR_NON_NULL_PTR_ARG(2);
 				static int CDC_Host_getchar(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
@@ -143,6 +143,49 @@ static uint8_t DCOMP_MS_Host_NextMSInterfaceEndpoint(void* const CurrentDescript
 static uint8_t MS_Host_SendCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                    MS_CommandBlockWrapper_t* const SCSICommandBlock,
                                    const void* const BufferPtr)
+{
+	uint8_t* DataPtr = (uint8_t*)BufferPtr;
+
+	if (BufferPtr == NULL)
+	  return MS_Host_SendCommandStream(MSInterfaceInfo, SCSICommandBlock, NULL, NULL);
+
+	return MS_Host_SendCommandStream(MSInterfaceInfo, SCSICommandBlock,
+	                                 (SCSICommandBlock->Flags & MS_COMMAND_DIR_DATA_IN) ? MS_Host_ReadToBuffer : MS_Host_WriteFromBuffer,
+	                                 &DataPtr);
+}
+
+static uint8_t MS_Host_SendCommandStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                         MS_CommandBlockWrapper_t* const SCSICommandBlock,
+                                         MS_Host_StreamCallback_t Callback,
+                                         void* const CallbackData)
+{
+	uint8_t ErrorCode = MS_Host_EndReadAhead(MSInterfaceInfo);
+
+	/* A failed read-ahead command only affects blocks which were never requested, and so is not an error here */
+	if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != MS_ERROR_LOGICAL_CMD_FAILED))
+	  return ErrorCode;
+
+	if ((ErrorCode = MS_Host_SendCommandBlock(MSInterfaceInfo, SCSICommandBlock)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if (Callback != NULL)
+	{
+		ErrorCode = MS_Host_SendReceiveData(MSInterfaceInfo, (SCSICommandBlock->Flags & MS_COMMAND_DIR_DATA_IN),
+		                                    le32_to_cpu(SCSICommandBlock->DataTransferLength), Callback, CallbackData);
+
+		if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != PIPE_RWSTREAM_PipeStalled))
+		{
+			Pipe_Freeze();
+			return ErrorCode;
+		}
+	}
+
+	MS_CommandStatusWrapper_t SCSIStatusBlock;
+	return MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSIStatusBlock);
+}
+
+static uint8_t MS_Host_SendCommandBlock(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                        MS_CommandBlockWrapper_t* const SCSICommandBlock)
 {
 	uint8_t ErrorCode = PIPE_RWSTREAM_NoError;
 
@@ -166,19 +209,7 @@ static uint8_t MS_Host_SendCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInf
 
 	Pipe_Freeze();
 
-	if (BufferPtr != NULL)
-	{
-		ErrorCode = MS_Host_SendReceiveData(MSInterfaceInfo, SCSICommandBlock, (void*)BufferPtr);
-
-		if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != PIPE_RWSTREAM_PipeStalled))
-		{
-			Pipe_Freeze();
-			return ErrorCode;
-		}
-	}
-
-	MS_CommandStatusWrapper_t SCSIStatusBlock;
-	return MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSIStatusBlock);
+	return ErrorCode;
 }
 
 static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo)
@@ -235,13 +266,14 @@ static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInte
 }
 
 static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
-                                       MS_CommandBlockWrapper_t* const SCSICommandBlock,
-                                       void* BufferPtr)
+                                       const bool IsDataIN,
+                                       uint32_t BytesRem,
+                                       MS_Host_StreamCallback_t Callback,
+                                       void* const CallbackData)
 {
-	uint8_t  ErrorCode = PIPE_RWSTREAM_NoError;
-	uint16_t BytesRem  = le32_to_cpu(SCSICommandBlock->DataTransferLength);
+	uint8_t ErrorCode = PIPE_RWSTREAM_NoError;
 
-	if (SCSICommandBlock->Flags & MS_COMMAND_DIR_DATA_IN)
+	if (IsDataIN)
 	{
 		if ((ErrorCode = MS_Host_WaitForDataReceived(MSInterfaceInfo)) != PIPE_RWSTREAM_NoError)
 		{
@@ -252,20 +284,42 @@ static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfac
 		Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipe.Address);
 		Pipe_Unfreeze();
 
-		if ((ErrorCode = Pipe_Read_Stream_LE(BufferPtr, BytesRem, NULL)) != PIPE_RWSTREAM_NoError)
-		  return ErrorCode;
+		while (BytesRem)
+		{
+			if ((ErrorCode = Pipe_WaitUntilReady()) != PIPE_READYWAIT_NoError)
+			  return ErrorCode;
 
-		Pipe_ClearIN();
+			uint16_t BankLength = MIN(Pipe_BytesInPipe(), BytesRem);
+
+			Callback(BankLength, CallbackData);
+			BytesRem -= BankLength;
+
+			/* Banks are only released once empty, as a read-ahead stream may end part way through one */
+			if (!(Pipe_BytesInPipe()))
+			  Pipe_ClearIN();
+		}
 	}
 	else
 	{
 		Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipe.Address);
 		Pipe_Unfreeze();
 
-		if ((ErrorCode = Pipe_Write_Stream_LE(BufferPtr, BytesRem, NULL)) != PIPE_RWSTREAM_NoError)
-		  return ErrorCode;
+		while (BytesRem)
+		{
+			if ((ErrorCode = Pipe_WaitUntilReady()) != PIPE_READYWAIT_NoError)
+			  return ErrorCode;
+
+			uint16_t BankLength = MIN((uint16_t)(MSInterfaceInfo->Config.DataOUTPipe.Size - Pipe_BytesInPipe()), BytesRem);
+
+			Callback(BankLength, CallbackData);
+			BytesRem -= BankLength;
+
+			if (!(Pipe_IsReadWriteAllowed()))
+			  Pipe_ClearOUT();
+		}
 
-		Pipe_ClearOUT();
+		if (Pipe_BytesInPipe())
+		  Pipe_ClearOUT();
 
 		while (!(Pipe_IsOUTReady()))
 		{
@@ -279,6 +333,32 @@ static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfac
 	return ErrorCode;
 }
 
+static void MS_Host_ReadToBuffer(const uint16_t Length,
+                                 void* const CallbackData)
+{
+	uint8_t** BufferPtr = (uint8_t**)CallbackData;
+
+	Pipe_Read_Stream_LE(*BufferPtr, Length, NULL);
+	*BufferPtr += Length;
+}
+
+static void MS_Host_WriteFromBuffer(const uint16_t Length,
+                                    void* const CallbackData)
+{
+	uint8_t** BufferPtr = (uint8_t**)CallbackData;
+
+	Pipe_Write_Stream_LE(*BufferPtr, Length, NULL);
+	*BufferPtr += Length;
+}
+
+static void MS_Host_DiscardData(const uint16_t Length,
+                                void* const CallbackData)
+{
+	(void)CallbackData;
+
+	Pipe_Discard_Stream(Length, NULL);
+}
+
 static uint8_t MS_Host_GetReturnedStatus(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                          MS_CommandStatusWrapper_t* const SCSICommandStatus)
 {
@@ -309,6 +389,8 @@ uint8_t MS_Host_ResetMSInterface(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo)
 {
 	uint8_t ErrorCode;
 
+	MSInterfaceInfo->State.ReadAheadActive = false;
+
 	USB_ControlRequest = (USB_Request_Header_t)
 		{
 			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE),
@@ -450,6 +532,10 @@ uint8_t MS_Host_ReadDeviceCapacity(USB_ClassInfo_MS_Host_t* const MSInterfaceInf
 	DeviceCapacity->Blocks    = BE32_TO_CPU(DeviceCapacity->Blocks);
 	DeviceCapacity->BlockSize = BE32_TO_CPU(DeviceCapacity->BlockSize);
 
+	MSInterfaceInfo->State.CapacityValid     = true;
+	MSInterfaceInfo->State.CapacityLUN       = LUNIndex;
+	MSInterfaceInfo->State.CapacityLastBlock = DeviceCapacity->Blocks;
+
 	return PIPE_RWSTREAM_NoError;
 }
 
@@ -514,31 +600,10 @@ uint8_t MS_Host_ReadDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                  const uint16_t BlockSize,
                                  void* BlockBuffer)
 {
-	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
-	  return HOST_SENDCONTROL_DeviceDisconnected;
-
-	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
-		{
-			.DataTransferLength = cpu_to_le32((uint32_t)Blocks * BlockSize),
-			.Flags              = MS_COMMAND_DIR_DATA_IN,
-			.LUN                = LUNIndex,
-			.SCSICommandLength  = 10,
-			.SCSICommandData    =
-				{
-					SCSI_CMD_READ_10,
-					0x00,                   // Unused (control bits, all off)
-					(BlockAddress >> 24),   // MSB of Block Address
-					(BlockAddress >> 16),
-					(BlockAddress >> 8),
-					(BlockAddress & 0xFF),  // LSB of Block Address
-					0x00,                   // Reserved
-					0x00,                   // MSB of Total Blocks to Read
-					Blocks,                 // LSB of Total Blocks to Read
-					0x00                    // Unused (control)
-				}
-		};
+	uint8_t* DataPtr = (uint8_t*)BlockBuffer;
 
-	return MS_Host_SendCommand(MSInterfaceInfo, &SCSICommandBlock, BlockBuffer);
+	return MS_Host_ReadDeviceBlocksStream(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize,
+	                                      MS_Host_ReadToBuffer, &DataPtr);
 }
 
 uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
@@ -547,6 +612,107 @@ uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo
                                   const uint8_t Blocks,
                                   const uint16_t BlockSize,
                                   const void* BlockBuffer)
+{
+	uint8_t* DataPtr = (uint8_t*)BlockBuffer;
+
+	return MS_Host_WriteDeviceBlocksStream(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize,
+	                                       MS_Host_WriteFromBuffer, &DataPtr);
+}
+
+uint8_t MS_Host_ReadDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                       const uint8_t LUNIndex,
+                                       const uint32_t BlockAddress,
+                                       const uint16_t Blocks,
+                                       const uint16_t BlockSize,
+                                       MS_Host_StreamCallback_t Callback,
+                                       void* const CallbackData)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	uint8_t ErrorCode;
+
+	/* Start a new READ command unless the requested blocks follow on from those already read from an open one */
+	if (!(MSInterfaceInfo->State.ReadAheadActive) ||
+	    (MSInterfaceInfo->State.ReadAheadLUN          != LUNIndex)     ||
+	    (MSInterfaceInfo->State.ReadAheadBlockAddress != BlockAddress) ||
+	    (MSInterfaceInfo->State.ReadAheadBlockSize    != BlockSize)    ||
+	    (MSInterfaceInfo->State.ReadAheadBlocksRem    <  Blocks))
+	{
+		ErrorCode = MS_Host_EndReadAhead(MSInterfaceInfo);
+
+		if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != MS_ERROR_LOGICAL_CMD_FAILED))
+		  return ErrorCode;
+
+		uint16_t TotalBlocks = Blocks;
+
+		if (MSInterfaceInfo->Config.ReadAheadBlocks && MSInterfaceInfo->State.CapacityValid &&
+		    (MSInterfaceInfo->State.CapacityLUN == LUNIndex) && (BlockAddress <= MSInterfaceInfo->State.CapacityLastBlock))
+		{
+			uint32_t BlocksToEnd = (MSInterfaceInfo->State.CapacityLastBlock - BlockAddress + 1);
+
+			TotalBlocks = MIN((uint32_t)Blocks + MSInterfaceInfo->Config.ReadAheadBlocks, 0xFFFF);
+			TotalBlocks = MAX(MIN(TotalBlocks, BlocksToEnd), Blocks);
+		}
+
+		MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
+			{
+				.DataTransferLength = cpu_to_le32((uint32_t)TotalBlocks * BlockSize),
+				.Flags              = MS_COMMAND_DIR_DATA_IN,
+				.LUN                = LUNIndex,
+				.SCSICommandLength  = 10,
+				.SCSICommandData    =
+					{
+						SCSI_CMD_READ_10,
+						0x00,                   // Unused (control bits, all off)
+						(BlockAddress >> 24),   // MSB of Block Address
+						(BlockAddress >> 16),
+						(BlockAddress >> 8),
+						(BlockAddress & 0xFF),  // LSB of Block Address
+						0x00,                   // Reserved
+						(TotalBlocks >> 8),     // MSB of Total Blocks to Read
+						(TotalBlocks & 0xFF),   // LSB of Total Blocks to Read
+						0x00                    // Unused (control)
+					}
+			};
+
+		if ((ErrorCode = MS_Host_SendCommandBlock(MSInterfaceInfo, &SCSICommandBlock)) != PIPE_RWSTREAM_NoError)
+		  return ErrorCode;
+
+		MSInterfaceInfo->State.ReadAheadActive       = true;
+		MSInterfaceInfo->State.ReadAheadLUN          = LUNIndex;
+		MSInterfaceInfo->State.ReadAheadBlockSize    = BlockSize;
+		MSInterfaceInfo->State.ReadAheadBlocksRem    = TotalBlocks;
+		MSInterfaceInfo->State.ReadAheadBlockAddress = BlockAddress;
+	}
+
+	ErrorCode = MS_Host_SendReceiveData(MSInterfaceInfo, true, ((uint32_t)Blocks * BlockSize), Callback, CallbackData);
+
+	MSInterfaceInfo->State.ReadAheadBlocksRem    -= Blocks;
+	MSInterfaceInfo->State.ReadAheadBlockAddress += Blocks;
+
+	if ((ErrorCode == PIPE_RWSTREAM_NoError) && MSInterfaceInfo->State.ReadAheadBlocksRem)
+	  return PIPE_RWSTREAM_NoError;
+
+	MSInterfaceInfo->State.ReadAheadActive = false;
+
+	if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != PIPE_RWSTREAM_PipeStalled))
+	{
+		Pipe_Freeze();
+		return ErrorCode;
+	}
+
+	MS_CommandStatusWrapper_t SCSIStatusBlock;
+	return MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSIStatusBlock);
+}
+
+uint8_t MS_Host_WriteDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                        const uint8_t LUNIndex,
+                                        const uint32_t BlockAddress,
+                                        const uint16_t Blocks,
+                                        const uint16_t BlockSize,
+                                        MS_Host_StreamCallback_t Callback,
+                                        void* const CallbackData)
 {
 	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
 	  return HOST_SENDCONTROL_DeviceDisconnected;
@@ -566,13 +732,36 @@ uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo
 					(BlockAddress >> 8),
 					(BlockAddress & 0xFF),  // LSB of Block Address
 					0x00,                   // Reserved
-					0x00,                   // MSB of Total Blocks to Write
-					Blocks,                 // LSB of Total Blocks to Write
+					(Blocks >> 8),          // MSB of Total Blocks to Write
+					(Blocks & 0xFF),        // LSB of Total Blocks to Write
 					0x00                    // Unused (control)
 				}
 		};
 
-	return MS_Host_SendCommand(MSInterfaceInfo, &SCSICommandBlock, BlockBuffer);
+	return MS_Host_SendCommandStream(MSInterfaceInfo, &SCSICommandBlock, Callback, CallbackData);
+}
+
+uint8_t MS_Host_EndReadAhead(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo)
+{
+	uint8_t ErrorCode;
+
+	if (!(MSInterfaceInfo->State.ReadAheadActive))
+	  return PIPE_RWSTREAM_NoError;
+
+	MSInterfaceInfo->State.ReadAheadActive = false;
+
+	ErrorCode = MS_Host_SendReceiveData(MSInterfaceInfo, true,
+	                                    ((uint32_t)MSInterfaceInfo->State.ReadAheadBlocksRem * MSInterfaceInfo->State.ReadAheadBlockSize),
+	                                    MS_Host_DiscardData, NULL);
+
+	if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != PIPE_RWSTREAM_PipeStalled))
+	{
+		Pipe_Freeze();
+		return ErrorCode;
+	}
+
+	MS_CommandStatusWrapper_t SCSIStatusBlock;
+	return MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSIStatusBlock);
 }
 
 #endif
@@ -73,6 +73,18 @@
 			#define MS_ERROR_LOGICAL_CMD_FAILED              0x80
 
 		/* Type Defines: */
+			/** Type define for a block stream callback function, passed to \ref MS_Host_ReadDeviceBlocksStream() and
+			 *  \ref MS_Host_WriteDeviceBlocksStream(). The callback is run once for each bank of the data stage with the
+			 *  relevant data pipe already selected and unfrozen, and must read or write exactly the given number of bytes
+			 *  from or to the pipe, e.g. via \ref Pipe_Read_Stream_LE() or \ref Pipe_Write_Stream_LE() with a \c NULL
+			 *  bytes processed pointer. The driver takes care of clearing each bank once it has been filled or emptied.
+			 *
+			 *  \param[in]     Length        Number of bytes to transfer in the current bank.
+			 *  \param[in,out] CallbackData  Application pointer given when the stream was started.
+			 */
+			typedef void (*MS_Host_StreamCallback_t)(const uint16_t Length,
+			                                         void* const CallbackData);
+
 			/** \brief Mass Storage Class Host Mode Configuration and State Structure.
 			 *
 			 *  Class state structure. An instance of this structure should be made within the user application,
@@ -85,6 +97,14 @@
 				{
 					USB_Pipe_Table_t DataINPipe; /**< Data IN Pipe configuration table. */
 					USB_Pipe_Table_t DataOUTPipe; /**< Data OUT Pipe configuration table. */
+
+					uint16_t         ReadAheadBlocks; /**< Number of blocks to request from the device beyond those given to
+					                                   *   \ref MS_Host_ReadDeviceBlocks() or \ref MS_Host_ReadDeviceBlocksStream(),
+					                                   *   so that subsequent sequential reads can be served from the same READ
+					                                   *   command without a new command/status exchange. Read-ahead is only
+					                                   *   performed on a LUN once \ref MS_Host_ReadDeviceCapacity() has been
+					                                   *   called on it, and is disabled when zero.
+					                                   */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -97,6 +117,16 @@
 					uint8_t  InterfaceNumber; /**< Interface index of the Mass Storage interface within the attached device. */
 
 					uint32_t TransactionTag; /**< Current transaction tag for data synchronizing of packets. */
+
+					bool     CapacityValid; /**< Indicates if the \c CapacityLUN and \c CapacityLastBlock values are valid. */
+					uint8_t  CapacityLUN; /**< LUN index last passed to \ref MS_Host_ReadDeviceCapacity(). */
+					uint32_t CapacityLastBlock; /**< Address of the last block of \c CapacityLUN, used to bound read-ahead. */
+
+					bool     ReadAheadActive; /**< Indicates if a READ command with unread read-ahead data is still open. */
+					uint8_t  ReadAheadLUN; /**< LUN index of the open read-ahead command. */
+					uint16_t ReadAheadBlockSize; /**< Block size of the open read-ahead command. */
+					uint16_t ReadAheadBlocksRem; /**< Number of blocks of the open read-ahead command not yet read. */
+					uint32_t ReadAheadBlockAddress; /**< Address of the next block of the open read-ahead command. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
@@ -286,6 +316,69 @@
 			                                  const uint16_t BlockSize,
 			                                  const void* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 
+			/** Reads blocks of data from the attached Mass Storage device's medium as a single READ command, passing the
+			 *  data to the given callback one pipe bank at a time as it arrives rather than into a single buffer. This allows
+			 *  large multi-block reads to be consumed on the fly, e.g. written straight out to another peripheral.
+			 *
+			 *  If read-ahead is enabled via the \c ReadAheadBlocks configuration value, the READ command may be left open once
+			 *  the requested blocks have been read, so that the next sequential read is served from the data already in flight.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state.
+			 *  \param[in]     LUNIndex         LUN index within the device the command is being issued to.
+			 *  \param[in]     BlockAddress     Starting block address within the device to read from.
+			 *  \param[in]     Blocks           Total number of blocks to read.
+			 *  \param[in]     BlockSize        Size in bytes of each block within the device.
+			 *  \param[in]     Callback         Callback function to read each bank of data from the pipe.
+			 *  \param[in,out] CallbackData     Application pointer passed to each invocation of the callback.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED if not ready.
+			 */
+			uint8_t MS_Host_ReadDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+			                                       const uint8_t LUNIndex,
+			                                       const uint32_t BlockAddress,
+			                                       const uint16_t Blocks,
+			                                       const uint16_t BlockSize,
+			                                       MS_Host_StreamCallback_t Callback,
+			                                       void* const CallbackData) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
+
+			/** Writes blocks of data to the attached Mass Storage device's medium as a single WRITE command, sourcing the
+			 *  data from the given callback one pipe bank at a time rather than from a single buffer.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state.
+			 *  \param[in]     LUNIndex         LUN index within the device the command is being issued to.
+			 *  \param[in]     BlockAddress     Starting block address within the device to write to.
+			 *  \param[in]     Blocks           Total number of blocks to write.
+			 *  \param[in]     BlockSize        Size in bytes of each block within the device.
+			 *  \param[in]     Callback         Callback function to write each bank of data to the pipe.
+			 *  \param[in,out] CallbackData     Application pointer passed to each invocation of the callback.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED if not ready.
+			 */
+			uint8_t MS_Host_WriteDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+			                                        const uint8_t LUNIndex,
+			                                        const uint32_t BlockAddress,
+			                                        const uint16_t Blocks,
+			                                        const uint16_t BlockSize,
+			                                        MS_Host_StreamCallback_t Callback,
+			                                        void* const CallbackData) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
+
+			/** Completes any READ command left open by read-ahead, discarding the unread blocks and reading back the command
+			 *  status from the device. This is performed automatically before any other command is issued, but may be called
+			 *  by the application to return the device to idle, e.g. before the medium is removed.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED if the read-ahead
+			 *          command failed.
+			 */
+			uint8_t MS_Host_EndReadAhead(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 		/* Inline Functions: */
 			/** General management task for a given Mass Storage host class interface, required for the correct operation of
 			 *  the interface. This should be called frequently in the main program loop, before the master USB management task
@@ -309,10 +402,25 @@
 				static uint8_t MS_Host_SendCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                   MS_CommandBlockWrapper_t* const SCSICommandBlock,
 				                                   const void* const BufferPtr) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+				static uint8_t MS_Host_SendCommandStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                         MS_CommandBlockWrapper_t* const SCSICommandBlock,
+				                                         MS_Host_StreamCallback_t Callback,
+				                                         void* const CallbackData) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+				static uint8_t MS_Host_SendCommandBlock(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                        MS_CommandBlockWrapper_t* const SCSICommandBlock)
+				                                        ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 				static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 				static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
-				                                       MS_CommandBlockWrapper_t* const SCSICommandBlock,
-				                                       void* BufferPtr) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+				                                       const bool IsDataIN,
+				                                       uint32_t BytesRem,
+				                                       MS_Host_StreamCallback_t Callback,
+				                                       void* const CallbackData) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(4);
+				static void    MS_Host_ReadToBuffer(const uint16_t Length,
+				                                    void* const CallbackData) ATTR_NON_NULL_PTR_ARG(2);
+				static void    MS_Host_WriteFromBuffer(const uint16_t Length,
+				                                       void* const CallbackData) ATTR_NON_NULL_PTR_ARG(2);
+				static void    MS_Host_DiscardData(const uint16_t Length,
+				                                   void* const CallbackData);
 				static uint8_t MS_Host_GetReturnedStatus(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                         MS_CommandStatusWrapper_t* const SCSICommandStatus)
 				                                         ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
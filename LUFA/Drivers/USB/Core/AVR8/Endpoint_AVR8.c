@@ -126,6 +126,36 @@ void Endpoint_ClearEndpoints(void)
 	}
 }
 
+uint16_t Endpoint_Write_Bank(const void* const Buffer,
+                             uint16_t Length)
+{
+	const uint8_t* DataStream = (const uint8_t*)Buffer;
+	uint16_t BytesInBank      = Endpoint_BytesRemainingInBank();
+
+	if (Length > BytesInBank)
+	  Length = BytesInBank;
+
+	for (uint16_t i = 0; i < Length; i++)
+	  Endpoint_Write_8(*(DataStream++));
+
+	return Length;
+}
+
+uint16_t Endpoint_Read_Bank(void* const Buffer,
+                            uint16_t Length)
+{
+	uint8_t* DataStream  = (uint8_t*)Buffer;
+	uint16_t BytesInBank = Endpoint_BytesRemainingInBank();
+
+	if (Length > BytesInBank)
+	  Length = BytesInBank;
+
+	for (uint16_t i = 0; i < Length; i++)
+	  *(DataStream++) = Endpoint_Read_8();
+
+	return Length;
+}
+
 void Endpoint_ClearStatusStage(void)
 {
 	if (USB_ControlRequest.bmRequestType & REQDIR_DEVICETOHOST)
@@ -181,7 +211,12 @@ uint8_t Endpoint_WaitUntilReady(void)
 		else if (USB_DeviceState_LCL == DEVICE_STATE_Suspended)
 		  return ENDPOINT_READYWAIT_BusSuspended;
 		else if (Endpoint_IsStalled())
-		  return ENDPOINT_READYWAIT_EndpointStalled;
+		{
+			USB_PROFILE_ENDPOINT(Stalls, 1);
+			return ENDPOINT_READYWAIT_EndpointStalled;
+		}
+
+		USB_PROFILE_ENDPOINT(BusyWaitIterations, 1);
 
 		uint16_t CurrentFrameNumber = USB_Device_GetFrameNumber();
 
@@ -106,6 +106,12 @@
 				return (MaskVal << EPSIZE0);
 			}
 
+			static inline uint16_t Endpoint_GetEndpointSize_Prv(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetEndpointSize_Prv(void)
+			{
+				return (8 << ((UECFG1X & (0x07 << EPSIZE0)) >> EPSIZE0));
+			}
+
 		/* Function Prototypes: */
 			void Endpoint_ClearEndpoints(void);
 			bool Endpoint_ConfigureEndpoint_Prv(const uint8_t Number,
@@ -240,6 +246,23 @@
 				return (UECFG0X & (1 << EPDIR)) ? ENDPOINT_DIR_IN : ENDPOINT_DIR_OUT;
 			}
 
+			/** Indicates the number of bytes which may still be transferred through the currently selected endpoint's
+			 *  bank before it must be cleared. For OUT direction endpoints this is the number of unread bytes remaining
+			 *  in the bank, and for IN direction endpoints it is the amount of free space left in the bank.
+			 *
+			 *  \ingroup Group_EndpointRW_AVR8
+			 *
+			 *  \return Number of bytes which may be read from or written to the currently selected endpoint's bank.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint16_t Endpoint_BytesRemainingInBank(void)
+			{
+				if (Endpoint_GetEndpointDirection() == ENDPOINT_DIR_OUT)
+				  return Endpoint_BytesInEndpoint();
+
+				return (Endpoint_GetEndpointSize_Prv() - Endpoint_BytesInEndpoint());
+			}
+
 			/** Get the endpoint address of the currently selected endpoint. This is typically used to save
 			 *  the currently selected endpoint so that it can be restored after another endpoint has been
 			 *  manipulated.
@@ -452,6 +475,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Endpoint_ClearIN(void)
 			{
+				USB_PROFILE_ENDPOINT(Packets, 1);
+
 				#if !defined(CONTROL_ONLY_DEVICE)
 					UEINTX &= ~((1 << TXINI) | (1 << FIFOCON));
 				#else
@@ -467,6 +492,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Endpoint_ClearOUT(void)
 			{
+				USB_PROFILE_ENDPOINT(Packets, 1);
+
 				#if !defined(CONTROL_ONLY_DEVICE)
 					UEINTX &= ~((1 << RXOUTI) | (1 << FIFOCON));
 				#else
@@ -775,6 +802,34 @@
 			#endif
 
 		/* Function Prototypes: */
+			/** Writes a block of data into the currently selected endpoint's bank in a single burst, for IN direction
+			 *  endpoints. The data is copied up to the end of the current bank, and the number of bytes copied is
+			 *  returned; the bank is not automatically cleared once full, nor is the endpoint waited upon.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_AVR8
+			 *
+			 *  \param[in] Buffer  Pointer to the source data buffer to read from.
+			 *  \param[in] Length  Number of bytes to write into the bank.
+			 *
+			 *  \return Number of bytes actually written into the bank.
+			 */
+			uint16_t Endpoint_Write_Bank(const void* const Buffer,
+			                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Reads a block of data from the currently selected endpoint's bank in a single burst, for OUT direction
+			 *  endpoints. The data is copied up to the end of the current bank, and the number of bytes copied is
+			 *  returned; the bank is not automatically cleared once empty, nor is the endpoint waited upon.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_AVR8
+			 *
+			 *  \param[out] Buffer  Pointer to the destination data buffer to write to.
+			 *  \param[in]  Length  Maximum number of bytes to read from the bank.
+			 *
+			 *  \return Number of bytes actually read from the bank.
+			 */
+			uint16_t Endpoint_Read_Bank(void* const Buffer,
+			                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
 			/** Configures a table of endpoint descriptions, in sequence. This function can be used to configure multiple
 			 *  endpoints at the same time.
 			 *
@@ -215,6 +215,203 @@ uint8_t Pipe_Null_Stream(uint16_t Length,
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Pipe_Read_8())
 #include "Template/Template_Pipe_RW.c"
 
+#if defined(ASYNC_PIPE_TRANSFERS)
+typedef struct
+{
+	uint8_t*             Buffer;
+	uint16_t             Length;
+	uint16_t             BytesTransferred;
+	Pipe_AsyncCallback_t Callback;
+	uint8_t              Address;
+	uint8_t              Options;
+	bool                 LastPacketQueued;
+	volatile uint8_t     Status;
+} Pipe_AsyncTransfer_t;
+
+static Pipe_AsyncTransfer_t Pipe_AsyncTransfers[PIPE_TOTAL_PIPES];
+
+static void Pipe_FinishAsync(Pipe_AsyncTransfer_t* const Transfer,
+                             const uint8_t Status)
+{
+	UPIENX &= ~((1 << RXINE) | (1 << TXOUTE) | (1 << RXSTALLE));
+	Pipe_Freeze();
+
+	Transfer->Status = Status;
+
+	if (Transfer->Callback != NULL)
+	  Transfer->Callback(Transfer->Address, Status, Transfer->BytesTransferred);
+}
+
+bool Pipe_SubmitAsync(const uint8_t Address,
+                      void* const Buffer,
+                      const uint16_t Length,
+                      const uint8_t Options,
+                      const Pipe_AsyncCallback_t Callback)
+{
+	uint8_t PNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PNum == PIPE_CONTROLPIPE) || (PNum >= PIPE_TOTAL_PIPES))
+	  return false;
+
+	Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+	if (Transfer->Status == PIPE_ASYNC_InProgress)
+	  return false;
+
+	Transfer->Buffer           = (uint8_t*)Buffer;
+	Transfer->Length           = Length;
+	Transfer->BytesTransferred = 0;
+	Transfer->Callback         = Callback;
+	Transfer->Address          = Address;
+	Transfer->Options          = Options;
+	Transfer->LastPacketQueued = false;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+	Transfer->Status = PIPE_ASYNC_InProgress;
+
+	Pipe_SelectPipe(Address);
+	UPIENX |= (((Address & PIPE_DIR_IN) ? (1 << RXINE) : (1 << TXOUTE)) | (1 << RXSTALLE));
+	Pipe_Unfreeze();
+	Pipe_SelectPipe(PrevSelectedPipe);
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return true;
+}
+
+uint8_t Pipe_GetAsyncStatus(const uint8_t Address,
+                            uint16_t* const BytesTransferred)
+{
+	uint8_t PNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PNum == PIPE_CONTROLPIPE) || (PNum >= PIPE_TOTAL_PIPES))
+	  return PIPE_ASYNC_Idle;
+
+	Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t Status = Transfer->Status;
+
+	if (BytesTransferred != NULL)
+	  *BytesTransferred = Transfer->BytesTransferred;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return Status;
+}
+
+void Pipe_CancelAsync(const uint8_t Address)
+{
+	uint8_t PNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PNum == PIPE_CONTROLPIPE) || (PNum >= PIPE_TOTAL_PIPES))
+	  return;
+
+	Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	if (Transfer->Status == PIPE_ASYNC_InProgress)
+	{
+		uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+		Pipe_SelectPipe(Transfer->Address);
+		Pipe_FinishAsync(Transfer, PIPE_ASYNC_Cancelled);
+		Pipe_SelectPipe(PrevSelectedPipe);
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void Pipe_AbortAsyncTransfers(void)
+{
+	for (uint8_t PNum = 1; PNum < PIPE_TOTAL_PIPES; PNum++)
+	  Pipe_CancelAsync(PNum);
+}
+
+void Pipe_ProcessAsyncTransfers(void)
+{
+	for (uint8_t PNum = 1; PNum < PIPE_TOTAL_PIPES; PNum++)
+	{
+		Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+		if (Transfer->Status != PIPE_ASYNC_InProgress)
+		  continue;
+
+		Pipe_SelectPipe(Transfer->Address);
+
+		if (Pipe_IsStalled())
+		{
+			Pipe_FinishAsync(Transfer, PIPE_ASYNC_PipeStalled);
+			continue;
+		}
+
+		uint8_t* DataStream     = &Transfer->Buffer[Transfer->BytesTransferred];
+		uint16_t BytesRemaining = (Transfer->Length - Transfer->BytesTransferred);
+
+		if (Transfer->Address & PIPE_DIR_IN)
+		{
+			if (!(Pipe_IsINReceived()))
+			  continue;
+
+			uint16_t BytesInBank = Pipe_BytesInPipe();
+			bool     ShortPacket = (BytesInBank < Pipe_GetPipeSize_Prv());
+
+			if (BytesInBank > BytesRemaining)
+			  BytesInBank = BytesRemaining;
+
+			Transfer->BytesTransferred += BytesInBank;
+
+			while (BytesInBank--)
+			  *(DataStream++) = Pipe_Read_8();
+
+			if (!(Pipe_BytesInPipe()))
+			  Pipe_ClearIN();
+
+			if (ShortPacket || (Transfer->BytesTransferred == Transfer->Length))
+			  Pipe_FinishAsync(Transfer, PIPE_ASYNC_Complete);
+		}
+		else
+		{
+			if (!(Pipe_IsOUTReady()))
+			  continue;
+
+			/* The transfer only ends once the bank holding its last packet has been sent, as the pipe is then frozen */
+			if (Transfer->LastPacketQueued)
+			{
+				Pipe_FinishAsync(Transfer, PIPE_ASYNC_Complete);
+				continue;
+			}
+
+			/* A zero length packet is sent if all the data has been sent but the last packet was full, or the transfer is empty */
+			uint16_t BytesInBank = (Pipe_GetPipeSize_Prv() - Pipe_BytesInPipe());
+
+			if (BytesInBank > BytesRemaining)
+			  BytesInBank = BytesRemaining;
+
+			Transfer->BytesTransferred += BytesInBank;
+
+			while (BytesInBank--)
+			  Pipe_Write_8(*(DataStream++));
+
+			bool FullPacket = (Pipe_BytesInPipe() == Pipe_GetPipeSize_Prv());
+
+			Pipe_ClearOUT();
+
+			if ((Transfer->BytesTransferred == Transfer->Length) && !(FullPacket && (Transfer->Options & PIPE_ASYNC_OPT_SEND_ZLP)))
+			  Transfer->LastPacketQueued = true;
+		}
+	}
+}
+#endif
+
 #endif
 
 #endif
@@ -431,6 +431,79 @@
 			                              uint16_t* const BytesProcessed) ATTR_NON_NULL_PTR_ARG(1);
 			/**@}*/
 
+			#if defined(ASYNC_PIPE_TRANSFERS) || defined(__DOXYGEN__)
+			/** \name Asynchronous transfer functions */
+			/**@{*/
+
+			/** Submits a buffer for transfer through the given non-control pipe, without waiting for the transfer to
+			 *  complete. The pipe is unfrozen and the transfer is advanced one bank at a time from within the USB
+			 *  controller interrupt, so that the main application loop is not blocked; the given buffer must therefore
+			 *  remain valid until the transfer has completed or been cancelled. The pipe is frozen again once the
+			 *  transfer ends.
+			 *
+			 *  OUT transfers are split into packets of the pipe's bank size, with each packet sent to the device as it
+			 *  is filled, followed by a zero length packet if requested via the \ref PIPE_ASYNC_OPT_SEND_ZLP option and
+			 *  the last packet was full; the transfer completes once the bank holding its last packet has been sent to
+			 *  the device. IN transfers complete once the requested length has been received, or a short
+			 *  packet has been received from the device. A transfer ends with a status of \ref PIPE_ASYNC_PipeStalled if
+			 *  the device stalls the pipe.
+			 *
+			 *  Only one asynchronous transfer may be pending on each pipe number at any one time, and the pipe should
+			 *  not be accessed via the other pipe read and write functions while a transfer is pending.
+			 *
+			 *  \note This function is only available when the \c ASYNC_PIPE_TRANSFERS token is defined.
+			 *
+			 *  \param[in]     Address   Address of the configured non-control pipe to submit the transfer on, including
+			 *                           its \c PIPE_DIR_* direction mask.
+			 *  \param[in,out] Buffer    Pointer to the buffer to transfer from (OUT pipes) or to (IN pipes).
+			 *  \param[in]     Length    Length of the transfer, in bytes.
+			 *  \param[in]     Options   Mask of \c PIPE_ASYNC_OPT_* options for the transfer.
+			 *  \param[in]     Callback  Optional callback to run once the transfer ends, or \c NULL if the transfer
+			 *                           status is to be polled via \ref Pipe_GetAsyncStatus().
+			 *
+			 *  \return Boolean \c true if the transfer was queued, \c false if the pipe is invalid or already busy.
+			 */
+			bool Pipe_SubmitAsync(const uint8_t Address,
+			                      void* const Buffer,
+			                      const uint16_t Length,
+			                      const uint8_t Options,
+			                      const Pipe_AsyncCallback_t Callback) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Retrieves the current status of the last asynchronous transfer submitted on the given pipe.
+			 *
+			 *  \note This function is only available when the \c ASYNC_PIPE_TRANSFERS token is defined.
+			 *
+			 *  \param[in]  Address           Address of the pipe to check.
+			 *  \param[out] BytesTransferred  Optional location where the number of bytes transferred so far is stored,
+			 *                                or \c NULL if not required.
+			 *
+			 *  \return A value from the \ref Pipe_AsyncStatus_t enum.
+			 */
+			uint8_t Pipe_GetAsyncStatus(const uint8_t Address,
+			                            uint16_t* const BytesTransferred);
+
+			/** Cancels any pending asynchronous transfer on the given pipe, freezing the pipe. If a transfer was pending,
+			 *  its completion callback (if any) is run with a status of \ref PIPE_ASYNC_Cancelled before this function
+			 *  returns.
+			 *
+			 *  \note This function is only available when the \c ASYNC_PIPE_TRANSFERS token is defined.
+			 *
+			 *  \param[in] Address  Address of the pipe whose pending transfer is to be cancelled.
+			 */
+			void Pipe_CancelAsync(const uint8_t Address);
+
+			/**@}*/
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(ASYNC_PIPE_TRANSFERS)
+			void Pipe_ProcessAsyncTransfers(void);
+			void Pipe_AbortAsyncTransfers(void);
+			#endif
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
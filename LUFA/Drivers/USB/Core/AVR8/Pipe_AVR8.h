@@ -507,6 +507,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Pipe_ClearIN(void)
 			{
+				USB_PROFILE_PIPE(Packets, 1);
+
 				UPINTX &= ~((1 << RXINI) | (1 << FIFOCON));
 			}
 
@@ -518,6 +520,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Pipe_ClearOUT(void)
 			{
+				USB_PROFILE_PIPE(Packets, 1);
+
 				UPINTX &= ~((1 << TXOUTI) | (1 << FIFOCON));
 			}
 
@@ -907,6 +911,12 @@
 				return (MaskVal << EPSIZE0);
 			}
 
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint16_t Pipe_GetPipeSize_Prv(void)
+			{
+				return (8 << ((UPCFG1X & (0x07 << EPSIZE0)) >> EPSIZE0));
+			}
+
 		/* Function Prototypes: */
 			void Pipe_ClearPipes(void);
 	#endif
@@ -68,10 +68,35 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 		}
 		else
 		{
-			TEMPLATE_TRANSFER_BYTE(DataStream);
-			TEMPLATE_BUFFER_MOVE(DataStream, 1);
-			Length--;
-			BytesInTransfer++;
+			uint16_t BytesInChunk = Endpoint_BytesRemainingInBank();
+
+			if (BytesInChunk > Length)
+			  BytesInChunk = Length;
+
+			Length          -= BytesInChunk;
+			BytesInTransfer += BytesInChunk;
+
+			USB_PROFILE_ENDPOINT(BytesTransferred, BytesInChunk);
+
+			while (BytesInChunk >= 4)
+			{
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+
+				BytesInChunk -= 4;
+			}
+
+			while (BytesInChunk--)
+			{
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+			}
 		}
 	}
 
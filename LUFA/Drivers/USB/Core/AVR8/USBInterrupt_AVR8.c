@@ -108,6 +108,11 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 			  USB_PLL_Off();
 
 			USB_DeviceState = DEVICE_STATE_Unattached;
+
+			#if defined(ASYNC_ENDPOINT_TRANSFERS)
+			Endpoint_AbortAsyncTransfers();
+			#endif
+
 			EVENT_USB_Device_Disconnect();
 		}
 	}
@@ -166,6 +171,10 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_DeviceState                = DEVICE_STATE_Default;
 		USB_Device_ConfigurationNumber = 0;
 
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
 		USB_INT_Clear(USB_INT_SUSPI);
 		USB_INT_Disable(USB_INT_SUSPI);
 		USB_INT_Enable(USB_INT_WAKEUPI);
@@ -197,6 +206,10 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_INT_Clear(USB_INT_DCONNI);
 		USB_INT_Disable(USB_INT_DDISCI);
 
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
 		EVENT_USB_Host_DeviceUnattached();
 
 		USB_ResetInterface();
@@ -209,6 +222,10 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_Host_VBUS_Manual_Off();
 		USB_Host_VBUS_Auto_Off();
 
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
 		EVENT_USB_Host_HostError(HOST_ERROR_VBusVoltageDip);
 		EVENT_USB_Host_DeviceUnattached();
 
@@ -231,6 +248,10 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 	{
 		USB_INT_Clear(USB_INT_BCERRI);
 
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
 		EVENT_USB_Host_DeviceEnumerationFailed(HOST_ENUMERROR_NoDeviceDetected, 0);
 		EVENT_USB_Host_DeviceUnattached();
 
@@ -243,6 +264,14 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 	{
 		USB_INT_Clear(USB_INT_IDTI);
 
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
 		if (USB_DeviceState != DEVICE_STATE_Unattached)
 		  EVENT_USB_Device_Disconnect();
 
@@ -257,21 +286,47 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 	#endif
 }
 
-#if defined(INTERRUPT_CONTROL_ENDPOINT) && defined(USB_CAN_BE_DEVICE)
+#if ((defined(INTERRUPT_CONTROL_ENDPOINT) || defined(ASYNC_ENDPOINT_TRANSFERS)) && defined(USB_CAN_BE_DEVICE)) || \
+    (defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST))
 ISR(USB_COM_vect, ISR_BLOCK)
 {
+	#if defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST)
+	if (USB_CurrentMode == USB_MODE_Host)
+	{
+		uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+		Pipe_ProcessAsyncTransfers();
+
+		Pipe_SelectPipe(PrevSelectedPipe);
+		return;
+	}
+	#endif
+
+	#if (defined(INTERRUPT_CONTROL_ENDPOINT) || defined(ASYNC_ENDPOINT_TRANSFERS)) && defined(USB_CAN_BE_DEVICE)
 	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
 
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	Endpoint_ProcessAsyncTransfers();
+	#endif
+
+	#if defined(INTERRUPT_CONTROL_ENDPOINT)
 	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
-	USB_INT_Disable(USB_INT_RXSTPI);
 
-	GlobalInterruptEnable();
+	if (Endpoint_IsSETUPReceived() && USB_INT_IsEnabled(USB_INT_RXSTPI))
+	{
+		USB_INT_Disable(USB_INT_RXSTPI);
 
-	USB_Device_ProcessControlRequest();
+		GlobalInterruptEnable();
+
+		USB_Device_ProcessControlRequest();
+
+		Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+		USB_INT_Enable(USB_INT_RXSTPI);
+	}
+	#endif
 
-	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
-	USB_INT_Enable(USB_INT_RXSTPI);
 	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+	#endif
 }
 #endif
 
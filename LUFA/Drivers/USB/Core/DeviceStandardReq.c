@@ -109,6 +109,16 @@ void USB_Device_ProcessControlRequest(void)
 				  USB_Device_SetConfiguration();
 
 				break;
+			#if defined(LUFA_ENABLE_PROFILING)
+			case USB_PROFILING_VENDOR_REQUEST:
+				if ((bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_DEVICE)) ||
+					(bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_VENDOR | REQREC_DEVICE)))
+				{
+					USB_Profiling_ProcessControlRequest();
+				}
+
+				break;
+			#endif
 
 			default:
 				break;
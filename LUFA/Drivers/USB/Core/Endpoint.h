@@ -75,6 +75,7 @@
 	/* Includes: */
 		#include "../../../Common/Common.h"
 		#include "USBMode.h"
+		#include "Profiling.h"
 
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
@@ -117,6 +118,8 @@
 			#include "UC3/Endpoint_UC3.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/Endpoint_XMEGA.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/Endpoint_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
@@ -63,7 +63,22 @@
 			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
 		#endif
 
+		#if defined(ASYNC_ENDPOINT_TRANSFERS) && defined(CONTROL_ONLY_DEVICE)
+			#error The ASYNC_ENDPOINT_TRANSFERS and CONTROL_ONLY_DEVICE tokens are mutually exclusive.
+		#endif
+
 	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Option mask for \c Endpoint_SubmitAsync(), indicating that no special transfer options are required. */
+			#define ENDPOINT_ASYNC_OPT_NONE         0
+
+			/** Option mask for \c Endpoint_SubmitAsync(). When given for an IN transfer whose length is an exact multiple of
+			 *  the endpoint bank size, a zero length packet is sent after the last full packet so that the host sees the end of
+			 *  the transfer. This should not be used when the host already knows the exact length of the data to expect, such
+			 *  as for the data stage of a Mass Storage command.
+			 */
+			#define ENDPOINT_ASYNC_OPT_SEND_ZLP     (1 << 0)
+
 		/* Enums: */
 			/** Enum for the possible error return codes of the \c Endpoint_*_Stream_* functions. */
 			enum Endpoint_Stream_RW_ErrorCodes_t
@@ -104,6 +119,31 @@
 				                                            */
 			};
 
+			/** Enum for the possible status codes of an asynchronous endpoint transfer, as returned by
+			 *  \c Endpoint_GetAsyncStatus() and passed to the transfer's completion callback.
+			 */
+			enum Endpoint_AsyncStatus_t
+			{
+				ENDPOINT_ASYNC_Idle       = 0, /**< No transfer has yet been submitted on the endpoint. */
+				ENDPOINT_ASYNC_InProgress = 1, /**< The transfer is currently being processed by the library. */
+				ENDPOINT_ASYNC_Complete   = 2, /**< The transfer completed, either in full or on a short packet from the host. */
+				ENDPOINT_ASYNC_Cancelled  = 3, /**< The transfer was cancelled by the user application, or aborted by the
+				                                *   library due to a bus reset or disconnection.
+				                                */
+			};
+
+		/* Type Defines: */
+			/** Type define for an asynchronous endpoint transfer completion callback function. The callback is run from
+			 *  within the USB controller interrupt once the transfer has completed or been cancelled.
+			 *
+			 *  \param[in] Address           Address of the endpoint the transfer was submitted on.
+			 *  \param[in] Status            Final status of the transfer, a value from the \ref Endpoint_AsyncStatus_t enum.
+			 *  \param[in] BytesTransferred  Total number of bytes transferred before the transfer completed.
+			 */
+			typedef void (*Endpoint_AsyncCallback_t)(const uint8_t Address,
+			                                         const uint8_t Status,
+			                                         const uint16_t BytesTransferred);
+
 	/* Architecture Includes: */
 		#if (ARCH == ARCH_AVR8)
 			#include "AVR8/EndpointStream_AVR8.h"
@@ -111,6 +151,8 @@
 			#include "UC3/EndpointStream_UC3.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/EndpointStream_XMEGA.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/EndpointStream_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
@@ -360,6 +360,10 @@
 					void EVENT_USB_Device_Reset(void) ATTR_WEAK ATTR_ALIAS(USB_Event_Stub);
 					void EVENT_USB_Device_StartOfFrame(void) ATTR_WEAK ATTR_ALIAS(USB_Event_Stub);
 				#endif
+
+				#if (ARCH == ARCH_SIM) && defined(USB_CAN_BE_DEVICE)
+					void EVENT_USB_VirtualHost_Idle(void) ATTR_WEAK ATTR_ALIAS(USB_Event_Stub);
+				#endif
 			#endif
 	#endif
 
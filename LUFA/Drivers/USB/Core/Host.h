@@ -126,6 +126,8 @@
 			#include "AVR8/Host_AVR8.h"
 		#elif (ARCH == ARCH_UC3)
 			#include "UC3/Host_UC3.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/Host_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
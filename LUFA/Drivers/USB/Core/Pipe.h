@@ -85,6 +85,7 @@
 	/* Includes: */
 		#include "../../../Common/Common.h"
 		#include "USBMode.h"
+		#include "Profiling.h"
 
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
@@ -131,6 +132,8 @@
 			#include "AVR8/Pipe_AVR8.h"
 		#elif (ARCH == ARCH_UC3)
 			#include "UC3/Pipe_UC3.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/Pipe_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
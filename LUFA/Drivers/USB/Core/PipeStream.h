@@ -63,7 +63,21 @@
 			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
 		#endif
 
+		#if defined(ASYNC_PIPE_TRANSFERS) && (ARCH != ARCH_AVR8) && (ARCH != ARCH_SIM)
+			#error The ASYNC_PIPE_TRANSFERS token is currently only supported on the AVR8 and simulated architectures.
+		#endif
+
 	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Option mask for \c Pipe_SubmitAsync(), indicating that no special transfer options are required. */
+			#define PIPE_ASYNC_OPT_NONE             0
+
+			/** Option mask for \c Pipe_SubmitAsync(). When given for an OUT transfer whose length is an exact multiple of
+			 *  the pipe bank size, a zero length packet is sent after the last full packet so that the device sees the end of
+			 *  the transfer.
+			 */
+			#define PIPE_ASYNC_OPT_SEND_ZLP         (1 << 0)
+
 		/* Enums: */
 			/** Enum for the possible error return codes of the Pipe_*_Stream_* functions. */
 			enum Pipe_Stream_RW_ErrorCodes_t
@@ -82,11 +96,41 @@
 				                                       */
 			};
 
+			/** Enum for the possible status codes of an asynchronous pipe transfer, as returned by
+			 *  \c Pipe_GetAsyncStatus() and passed to the transfer's completion callback.
+			 */
+			enum Pipe_AsyncStatus_t
+			{
+				PIPE_ASYNC_Idle        = 0, /**< No transfer has yet been submitted on the pipe. */
+				PIPE_ASYNC_InProgress  = 1, /**< The transfer is currently being processed by the library. */
+				PIPE_ASYNC_Complete    = 2, /**< The transfer completed, either in full or on a short packet from the device. */
+				PIPE_ASYNC_Cancelled   = 3, /**< The transfer was cancelled by the user application, or aborted by the
+				                             *   library due to the device being disconnected.
+				                             */
+				PIPE_ASYNC_PipeStalled = 4, /**< The device stalled the pipe during the transfer. The stall must be cleared
+				                             *   before the pipe can be used again.
+				                             */
+			};
+
+		/* Type Defines: */
+			/** Type define for an asynchronous pipe transfer completion callback function. The callback is run from
+			 *  within the USB controller interrupt once the transfer has completed, failed or been cancelled.
+			 *
+			 *  \param[in] Address           Address of the pipe the transfer was submitted on.
+			 *  \param[in] Status            Final status of the transfer, a value from the \ref Pipe_AsyncStatus_t enum.
+			 *  \param[in] BytesTransferred  Total number of bytes transferred before the transfer ended.
+			 */
+			typedef void (*Pipe_AsyncCallback_t)(const uint8_t Address,
+			                                     const uint8_t Status,
+			                                     const uint16_t BytesTransferred);
+
 	/* Architecture Includes: */
 		#if (ARCH == ARCH_AVR8)
 			#include "AVR8/PipeStream_AVR8.h"
 		#elif (ARCH == ARCH_UC3)
 			#include "UC3/PipeStream_UC3.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/PipeStream_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
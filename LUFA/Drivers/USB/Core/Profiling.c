@@ -0,0 +1,175 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "USBMode.h"
+
+#if defined(LUFA_ENABLE_PROFILING)
+
+#define  __INCLUDE_FROM_PROFILING_C
+#include "Profiling.h"
+#include "USBTask.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+USB_Profiling_Counters_t USB_Profiling_EndpointCounters[ENDPOINT_TOTAL_ENDPOINTS];
+#endif
+
+#if defined(USB_CAN_BE_HOST)
+USB_Profiling_Counters_t USB_Profiling_PipeCounters[PIPE_TOTAL_PIPES];
+#endif
+
+uint16_t USB_Profiling_MaxTaskInterval;
+
+static uint16_t USB_Profiling_PreviousTaskFrame;
+
+void USB_Profiling_ResetCounters(void)
+{
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	#if defined(USB_CAN_BE_DEVICE)
+	memset(USB_Profiling_EndpointCounters, 0x00, sizeof(USB_Profiling_EndpointCounters));
+	#endif
+
+	#if defined(USB_CAN_BE_HOST)
+	memset(USB_Profiling_PipeCounters, 0x00, sizeof(USB_Profiling_PipeCounters));
+	#endif
+
+	USB_Profiling_MaxTaskInterval = 0;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void USB_Profiling_RecordTaskInterval(void)
+{
+	uint16_t CurrentFrameNumber;
+	bool     IsConfigured;
+
+	#if defined(USB_CAN_BE_BOTH)
+	if (USB_CurrentMode == USB_MODE_Host)
+	{
+		CurrentFrameNumber = USB_Host_GetFrameNumber();
+		IsConfigured       = (USB_HostState == HOST_STATE_Configured);
+	}
+	else
+	{
+		CurrentFrameNumber = USB_Device_GetFrameNumber();
+		IsConfigured       = (USB_DeviceState == DEVICE_STATE_Configured);
+	}
+	#elif defined(USB_CAN_BE_HOST)
+	CurrentFrameNumber = USB_Host_GetFrameNumber();
+	IsConfigured       = (USB_HostState == HOST_STATE_Configured);
+	#else
+	CurrentFrameNumber = USB_Device_GetFrameNumber();
+	IsConfigured       = (USB_DeviceState == DEVICE_STATE_Configured);
+	#endif
+
+	if (IsConfigured)
+	{
+		uint16_t TaskInterval = ((CurrentFrameNumber - USB_Profiling_PreviousTaskFrame) & USB_PROFILING_FRAME_NUMBER_MASK);
+
+		if (TaskInterval > USB_Profiling_MaxTaskInterval)
+		  USB_Profiling_MaxTaskInterval = TaskInterval;
+	}
+
+	USB_Profiling_PreviousTaskFrame = CurrentFrameNumber;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+void USB_Profiling_ProcessControlRequest(void)
+{
+	if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_VENDOR | REQREC_DEVICE))
+	{
+		Endpoint_ClearSETUP();
+		USB_Profiling_ResetCounters();
+		Endpoint_ClearStatusStage();
+		return;
+	}
+
+	switch (USB_ControlRequest.wValue)
+	{
+		case USB_PROFILING_TABLE_Summary:
+			USB_Profiling_SendSummary();
+			break;
+		case USB_PROFILING_TABLE_Endpoints:
+			if (USB_ControlRequest.wIndex < ENDPOINT_TOTAL_ENDPOINTS)
+			  USB_Profiling_SendCounters(&USB_Profiling_EndpointCounters[USB_ControlRequest.wIndex]);
+
+			break;
+		#if defined(USB_CAN_BE_HOST)
+		case USB_PROFILING_TABLE_Pipes:
+			if (USB_ControlRequest.wIndex < PIPE_TOTAL_PIPES)
+			  USB_Profiling_SendCounters(&USB_Profiling_PipeCounters[USB_ControlRequest.wIndex]);
+
+			break;
+		#endif
+	}
+}
+
+static void USB_Profiling_SendSummary(void)
+{
+	USB_Profiling_Summary_t Summary =
+		{
+			.TotalEndpoints  = ENDPOINT_TOTAL_ENDPOINTS,
+			#if defined(USB_CAN_BE_HOST)
+			.TotalPipes      = PIPE_TOTAL_PIPES,
+			#else
+			.TotalPipes      = 0,
+			#endif
+			.MaxTaskInterval = cpu_to_le16(USB_Profiling_MaxTaskInterval),
+		};
+
+	Endpoint_ClearSETUP();
+	Endpoint_Write_Control_Stream_LE(&Summary, sizeof(Summary));
+	Endpoint_ClearOUT();
+}
+
+static void USB_Profiling_SendCounters(const USB_Profiling_Counters_t* const Counters)
+{
+	USB_Profiling_Counters_t CountersLE;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	CountersLE.BytesTransferred   = cpu_to_le32(Counters->BytesTransferred);
+	CountersLE.Packets            = cpu_to_le32(Counters->Packets);
+	CountersLE.BusyWaitIterations = cpu_to_le32(Counters->BusyWaitIterations);
+	CountersLE.Stalls             = cpu_to_le32(Counters->Stalls);
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	Endpoint_ClearSETUP();
+	Endpoint_Write_Control_Stream_LE(&CountersLE, sizeof(CountersLE));
+	Endpoint_ClearOUT();
+}
+#endif
+
+#endif
+
@@ -0,0 +1,201 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB performance profiling counters.
+ *  \copydetails Group_Profiling
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USB
+ *  \defgroup Group_Profiling USB Performance Profiling
+ *  \brief USB performance profiling counters.
+ *
+ *  This module contains the optional performance counters of the USB driver, which record how much traffic each
+ *  endpoint and pipe is moving and how long the driver spends waiting on each, so that saturated interfaces can be
+ *  identified on a deployed unit. The counters are only compiled into the library when the \c LUFA_ENABLE_PROFILING
+ *  token is defined in the project makefile or \c LUFAConfig.h header; when it is not defined, all profiling hooks
+ *  in the driver compile away to nothing.
+ *
+ *  The following counters are maintained for each endpoint (in device mode) and each pipe (in host mode):
+ *    - The number of data bytes moved through the endpoint or pipe by the non-control stream read/write functions.
+ *    - The number of packets (banks) released to or acknowledged from the USB controller.
+ *    - The number of times the \c Endpoint_WaitUntilReady() or \c Pipe_WaitUntilReady() functions polled the
+ *      endpoint or pipe without finding it ready, i.e. the time the application spent busy-waiting on NAKs.
+ *    - The number of transfers aborted because the endpoint or pipe was stalled.
+ *
+ *  In addition, the longest interval between two calls to \ref USB_USBTask() while the device or host is configured
+ *  is recorded in USB frames (milliseconds), to expose main loop latency which will stall control requests.
+ *
+ *  In device mode, the counters can be read by the host through a vendor specific control request with a
+ *  \c bRequest value of \ref USB_PROFILING_VENDOR_REQUEST, which is handled automatically by the library. A
+ *  device-to-host request with a \c wValue of \ref USB_PROFILING_TABLE_Summary returns a \ref USB_Profiling_Summary_t
+ *  structure, while a \c wValue of \ref USB_PROFILING_TABLE_Endpoints or \ref USB_PROFILING_TABLE_Pipes returns the
+ *  \ref USB_Profiling_Counters_t structure of the endpoint or pipe indicated by \c wIndex. A host-to-device request
+ *  with no data stage resets all counters. All multi-byte values are sent in little endian format.
+ *
+ *  A reader application for Linux hosts is supplied in the LUFA/CodeTemplates/ProfilingReader/ directory.
+ *
+ *  @{
+ */
+
+#ifndef __USBPROFILING_H__
+#define __USBPROFILING_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+		#include "USBMode.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if !defined(USB_PROFILING_VENDOR_REQUEST) || defined(__DOXYGEN__)
+				/** Vendor specific control request \c bRequest value used by the host to read and reset the profiling
+				 *  counters of a device. This value can be overridden by defining the \c USB_PROFILING_VENDOR_REQUEST
+				 *  token in the project makefile, if it conflicts with a vendor request already used by the application.
+				 */
+				#define USB_PROFILING_VENDOR_REQUEST   0xF0
+			#endif
+
+		/* Enums: */
+			/** Enum for the counter tables which may be read through the profiling vendor control request, given in
+			 *  the request's \c wValue field.
+			 */
+			enum USB_Profiling_Tables_t
+			{
+				USB_PROFILING_TABLE_Summary   = 0, /**< Global summary, returned as a \ref USB_Profiling_Summary_t structure. */
+				USB_PROFILING_TABLE_Endpoints = 1, /**< Counters of the endpoint given in \c wIndex. */
+				USB_PROFILING_TABLE_Pipes     = 2, /**< Counters of the pipe given in \c wIndex. */
+			};
+
+		/* Type Defines: */
+			/** \brief Endpoint or pipe profiling counters.
+			 *
+			 *  Type define for the profiling counters of a single endpoint or pipe. All counters wrap on overflow.
+			 */
+			typedef struct
+			{
+				uint32_t BytesTransferred; /**< Number of data bytes moved through the non-control stream read/write functions. */
+				uint32_t Packets; /**< Number of packets released to or acknowledged from the USB controller. */
+				uint32_t BusyWaitIterations; /**< Number of times the endpoint or pipe was polled for readiness without success. */
+				uint32_t Stalls; /**< Number of transfers aborted due to the endpoint or pipe being stalled. */
+			} USB_Profiling_Counters_t;
+
+			/** \brief Profiling counter summary.
+			 *
+			 *  Type define for the summary returned by the profiling vendor control request for the
+			 *  \ref USB_PROFILING_TABLE_Summary table.
+			 */
+			typedef struct
+			{
+				uint8_t  TotalEndpoints; /**< Number of entries in the endpoint counter table. */
+				uint8_t  TotalPipes; /**< Number of entries in the pipe counter table. */
+				uint16_t MaxTaskInterval; /**< Longest recorded interval between calls to \ref USB_USBTask(), in USB frames. */
+			} ATTR_PACKED USB_Profiling_Summary_t;
+
+		/* Global Variables: */
+			#if defined(LUFA_ENABLE_PROFILING) || defined(__DOXYGEN__)
+				#if defined(USB_CAN_BE_DEVICE) || defined(__DOXYGEN__)
+					/** Profiling counters of each endpoint, indexed by endpoint number.
+					 *
+					 *  \note This global is only present if the user application can be a USB device.
+					 */
+					extern USB_Profiling_Counters_t USB_Profiling_EndpointCounters[];
+				#endif
+
+				#if defined(USB_CAN_BE_HOST) || defined(__DOXYGEN__)
+					/** Profiling counters of each pipe, indexed by pipe number.
+					 *
+					 *  \note This global is only present if the user application can be a USB host.
+					 */
+					extern USB_Profiling_Counters_t USB_Profiling_PipeCounters[];
+				#endif
+
+				/** Longest interval between two calls to \ref USB_USBTask() while the device or host was configured,
+				 *  in USB frames. As USB frame numbers are 11 bits wide, intervals of 2048 frames or more cannot be
+				 *  measured accurately.
+				 */
+				extern uint16_t USB_Profiling_MaxTaskInterval;
+			#endif
+
+		/* Function Prototypes: */
+			#if defined(LUFA_ENABLE_PROFILING) || defined(__DOXYGEN__)
+				/** Resets all endpoint, pipe and main loop latency profiling counters to zero. */
+				void USB_Profiling_ResetCounters(void);
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define USB_PROFILING_FRAME_NUMBER_MASK    0x07FF
+
+			#if defined(LUFA_ENABLE_PROFILING)
+				#define USB_PROFILE_ENDPOINT(Counter, Amount) MACROS{ USB_Profiling_EndpointCounters[Endpoint_GetCurrentEndpoint() & ENDPOINT_EPNUM_MASK].Counter += (Amount); }MACROE
+				#define USB_PROFILE_PIPE(Counter, Amount)     MACROS{ USB_Profiling_PipeCounters[Pipe_GetCurrentPipe()].Counter += (Amount); }MACROE
+			#else
+				#define USB_PROFILE_ENDPOINT(Counter, Amount) MACROS{ }MACROE
+				#define USB_PROFILE_PIPE(Counter, Amount)     MACROS{ }MACROE
+			#endif
+
+		/* Function Prototypes: */
+			#if defined(LUFA_ENABLE_PROFILING)
+				void USB_Profiling_RecordTaskInterval(void);
+
+				#if defined(USB_CAN_BE_DEVICE)
+					void USB_Profiling_ProcessControlRequest(void);
+
+					#if defined(__INCLUDE_FROM_PROFILING_C)
+						static void USB_Profiling_SendSummary(void);
+						static void USB_Profiling_SendCounters(const USB_Profiling_Counters_t* const Counters);
+					#endif
+				#endif
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -0,0 +1,89 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define _GNU_SOURCE
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBMode.h"
+
+#if defined(USB_CAN_BE_HOST)
+
+#include "../USBController.h"
+
+#include <dlfcn.h>
+
+const USB_SIM_DevicePort_t* USB_Loopback_DevicePort;
+
+static void* USB_Loopback_DeviceLibrary;
+
+bool USB_Loopback_AttachDevice(const char* const LibraryPath)
+{
+	USB_Loopback_DetachDevice();
+
+	/* Bind the device's references to its own copy of the library, rather than to the host's */
+	void* DeviceLibrary = dlopen(LibraryPath, (RTLD_NOW | RTLD_LOCAL | RTLD_DEEPBIND));
+
+	if (DeviceLibrary == NULL)
+	  return false;
+
+	const USB_SIM_DevicePort_t* DevicePort = dlsym(DeviceLibrary, "USB_VirtualHost_LoopbackPort");
+	int (*DeviceMain)(int, char**) = (int (*)(int, char**))dlsym(DeviceLibrary, "main");
+
+	if ((DevicePort == NULL) || (DeviceMain == NULL))
+	{
+		dlclose(DeviceLibrary);
+		return false;
+	}
+
+	DevicePort->Start(DeviceMain, (char*)LibraryPath);
+
+	USB_Loopback_DeviceLibrary = DeviceLibrary;
+	USB_Loopback_DevicePort    = DevicePort;
+
+	return true;
+}
+
+void USB_Loopback_DetachDevice(void)
+{
+	if (USB_Loopback_DeviceLibrary == NULL)
+	  return;
+
+	USB_Loopback_DevicePort = NULL;
+
+	dlclose(USB_Loopback_DeviceLibrary);
+	USB_Loopback_DeviceLibrary = NULL;
+}
+
+#endif
+
+#endif
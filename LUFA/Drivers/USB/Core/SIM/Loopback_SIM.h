@@ -0,0 +1,137 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief In-process host to device loopback for the host-native simulated architecture.
+ *  \copydetails Group_Loopback_SIM
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USB
+ *  \defgroup Group_Loopback_SIM Host to Device Loopback (SIM)
+ *  \brief In-process host to device loopback for the host-native simulated architecture.
+ *
+ *  When the library is compiled in host mode for the host-native simulated architecture (\c ARCH_SIM), the simulated
+ *  host controller can be connected to a device mode build of the library running in the same process, so that the
+ *  host mode stack and class drivers (for example the \c MassStorageHost demo) can be exercised against the device
+ *  mode stack and class drivers (for example the \c MassStorage demo) without any USB hardware. All bus events,
+ *  frames and packet transactions are passed directly between the simulated host pipes and the simulated device
+ *  endpoints, and are paced by the host's polling of the simulated controller, so that the end-to-end enumeration
+ *  time and transfer throughput may be measured in simulated frames via \ref USB_Loopback_GetFrameCount().
+ *
+ *  As both instances of the library share the same global symbol names, the device must be built as a separate
+ *  shared library, compiled for \c ARCH_SIM with \c USB_DEVICE_ONLY and linked with the \c -shared and \c -fPIC
+ *  switches. The device library is loaded with a private symbol namespace by \ref USB_Loopback_AttachDevice(), and
+ *  its \c main() function is then run as a coroutine of the host, which is resumed each time the host polls the
+ *  simulated controller and suspended again at the device's next poll of its own controller. The host application
+ *  must be linked against the system's dynamic loader library (\c -ldl). The LUFA SIM build system module (see
+ *  \ref Page_BuildModule_LUFA_SIM) takes care of both, through its \c so target for the device and its \c all target
+ *  for the host.
+ *
+ *  Usage Example:
+ *  \code
+ *		int main(void)
+ *		{
+ *			USB_Loopback_AttachDevice("./MassStorage.so");
+ *
+ *			USB_Init();
+ *			GlobalInterruptEnable();
+ *
+ *			for (;;)
+ *			  USB_USBTask();
+ *		}
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __LOOPBACK_SIM_H__
+#define __LOOPBACK_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+		#include "USBRegisters_SIM.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Function Prototypes: */
+			/** Loads a device mode build of the library from the given shared library, and connects it to the simulated
+			 *  host controller. The device's \c main() function is started with the library path as its only command
+			 *  line argument, and will attach to the bus as normal once it has initialized its USB interface. Any
+			 *  previously attached device is first detached.
+			 *
+			 *  \param[in] LibraryPath  Path to the shared library containing the device firmware.
+			 *
+			 *  \return Boolean \c true if the device library was loaded, \c false otherwise.
+			 */
+			bool USB_Loopback_AttachDevice(const char* const LibraryPath) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Disconnects and unloads the device previously loaded by \ref USB_Loopback_AttachDevice(), if any. The
+			 *  host will see the device detach from the bus at the next poll of the simulated controller.
+			 */
+			void USB_Loopback_DetachDevice(void);
+
+		/* Inline Functions: */
+			/** Retrieves the total number of simulated 1ms frames that have elapsed since the USB interface was
+			 *  initialized, for the measurement of enumeration time and throughput in simulated time.
+			 *
+			 *  \return Number of simulated frames elapsed.
+			 */
+			ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT
+			static inline uint32_t USB_Loopback_GetFrameCount(void)
+			{
+				return USB_SIM.FrameCount;
+			}
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* External Variables: */
+			extern const USB_SIM_DevicePort_t* USB_Loopback_DevicePort;
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
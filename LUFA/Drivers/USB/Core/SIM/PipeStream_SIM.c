@@ -0,0 +1,381 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBMode.h"
+
+#if defined(USB_CAN_BE_HOST)
+
+#include "PipeStream_SIM.h"
+
+uint8_t Pipe_Discard_Stream(uint16_t Length,
+                            uint16_t* const BytesProcessed)
+{
+	uint8_t  ErrorCode;
+	uint16_t BytesInTransfer = 0;
+
+	Pipe_SetPipeToken(PIPE_TOKEN_IN);
+
+	if ((ErrorCode = Pipe_WaitUntilReady()))
+	  return ErrorCode;
+
+	if (BytesProcessed != NULL)
+	  Length -= *BytesProcessed;
+
+	while (Length)
+	{
+		if (!(Pipe_IsReadWriteAllowed()))
+		{
+			Pipe_ClearIN();
+
+			if (BytesProcessed != NULL)
+			{
+				*BytesProcessed += BytesInTransfer;
+				return PIPE_RWSTREAM_IncompleteTransfer;
+			}
+
+			if ((ErrorCode = Pipe_WaitUntilReady()))
+			  return ErrorCode;
+		}
+		else
+		{
+			Pipe_Discard_8();
+
+			Length--;
+			BytesInTransfer++;
+		}
+	}
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint8_t Pipe_Null_Stream(uint16_t Length,
+                         uint16_t* const BytesProcessed)
+{
+	uint8_t  ErrorCode;
+	uint16_t BytesInTransfer = 0;
+
+	Pipe_SetPipeToken(PIPE_TOKEN_OUT);
+
+	if ((ErrorCode = Pipe_WaitUntilReady()))
+	  return ErrorCode;
+
+	if (BytesProcessed != NULL)
+	  Length -= *BytesProcessed;
+
+	while (Length)
+	{
+		if (!(Pipe_IsReadWriteAllowed()))
+		{
+			Pipe_ClearOUT();
+
+			if (BytesProcessed != NULL)
+			{
+				*BytesProcessed += BytesInTransfer;
+				return PIPE_RWSTREAM_IncompleteTransfer;
+			}
+
+			USB_USBTask();
+
+			if ((ErrorCode = Pipe_WaitUntilReady()))
+			  return ErrorCode;
+		}
+		else
+		{
+			Pipe_Write_8(0);
+
+			Length--;
+			BytesInTransfer++;
+		}
+	}
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+/* The following abuses the C preprocessor in order to copy-paste common code with slight alterations,
+ * so that the code needs to be written once. It is a crude form of templating to reduce code maintenance. */
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Write_Stream_LE
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_OUT
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   DataStream += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Pipe_Write_8(*BufferPtr)
+#include "Template/Template_Pipe_RW.c"
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Write_Stream_BE
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_OUT
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   DataStream -= Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Pipe_Write_8(*BufferPtr)
+#include "Template/Template_Pipe_RW.c"
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Read_Stream_LE
+#define  TEMPLATE_BUFFER_TYPE                      void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_IN
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearIN()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   DataStream += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Pipe_Read_8()
+#include "Template/Template_Pipe_RW.c"
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Read_Stream_BE
+#define  TEMPLATE_BUFFER_TYPE                      void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_IN
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearIN()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   DataStream -= Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Pipe_Read_8()
+#include "Template/Template_Pipe_RW.c"
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Write_PStream_LE
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_OUT
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   DataStream += Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Pipe_Write_8(pgm_read_byte(BufferPtr))
+#include "Template/Template_Pipe_RW.c"
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Write_PStream_BE
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_OUT
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
+#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   DataStream -= Amount
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Pipe_Write_8(pgm_read_byte(BufferPtr))
+#include "Template/Template_Pipe_RW.c"
+
+#if defined(ASYNC_PIPE_TRANSFERS)
+typedef struct
+{
+	uint8_t*             Buffer;
+	uint16_t             Length;
+	uint16_t             BytesTransferred;
+	Pipe_AsyncCallback_t Callback;
+	uint8_t              Address;
+	uint8_t              Options;
+	bool                 LastPacketQueued;
+	volatile uint8_t     Status;
+} Pipe_AsyncTransfer_t;
+
+static Pipe_AsyncTransfer_t Pipe_AsyncTransfers[PIPE_TOTAL_PIPES];
+
+static void Pipe_FinishAsync(Pipe_AsyncTransfer_t* const Transfer,
+                             const uint8_t Status)
+{
+	USB_Pipe_SelectedFIFO->InterruptEnabled = false;
+	Pipe_Freeze();
+
+	Transfer->Status = Status;
+
+	if (Transfer->Callback != NULL)
+	  Transfer->Callback(Transfer->Address, Status, Transfer->BytesTransferred);
+}
+
+bool Pipe_SubmitAsync(const uint8_t Address,
+                      void* const Buffer,
+                      const uint16_t Length,
+                      const uint8_t Options,
+                      const Pipe_AsyncCallback_t Callback)
+{
+	uint8_t PNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PNum == PIPE_CONTROLPIPE) || (PNum >= PIPE_TOTAL_PIPES))
+	  return false;
+
+	Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+	if (Transfer->Status == PIPE_ASYNC_InProgress)
+	  return false;
+
+	Transfer->Buffer           = (uint8_t*)Buffer;
+	Transfer->Length           = Length;
+	Transfer->BytesTransferred = 0;
+	Transfer->Callback         = Callback;
+	Transfer->Address          = Address;
+	Transfer->Options          = Options;
+	Transfer->LastPacketQueued = false;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+	Transfer->Status = PIPE_ASYNC_InProgress;
+
+	Pipe_SelectPipe(Address);
+	USB_Pipe_SelectedFIFO->InterruptEnabled = true;
+	Pipe_Unfreeze();
+	Pipe_SelectPipe(PrevSelectedPipe);
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return true;
+}
+
+uint8_t Pipe_GetAsyncStatus(const uint8_t Address,
+                            uint16_t* const BytesTransferred)
+{
+	uint8_t PNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PNum == PIPE_CONTROLPIPE) || (PNum >= PIPE_TOTAL_PIPES))
+	  return PIPE_ASYNC_Idle;
+
+	Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t Status = Transfer->Status;
+
+	if (BytesTransferred != NULL)
+	  *BytesTransferred = Transfer->BytesTransferred;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return Status;
+}
+
+void Pipe_CancelAsync(const uint8_t Address)
+{
+	uint8_t PNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PNum == PIPE_CONTROLPIPE) || (PNum >= PIPE_TOTAL_PIPES))
+	  return;
+
+	Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	if (Transfer->Status == PIPE_ASYNC_InProgress)
+	{
+		uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+		Pipe_SelectPipe(Transfer->Address);
+		Pipe_FinishAsync(Transfer, PIPE_ASYNC_Cancelled);
+		Pipe_SelectPipe(PrevSelectedPipe);
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void Pipe_AbortAsyncTransfers(void)
+{
+	for (uint8_t PNum = 1; PNum < PIPE_TOTAL_PIPES; PNum++)
+	  Pipe_CancelAsync(PNum);
+}
+
+void Pipe_ProcessAsyncTransfers(void)
+{
+	for (uint8_t PNum = 1; PNum < PIPE_TOTAL_PIPES; PNum++)
+	{
+		Pipe_AsyncTransfer_t* Transfer = &Pipe_AsyncTransfers[PNum];
+
+		if (Transfer->Status != PIPE_ASYNC_InProgress)
+		  continue;
+
+		Pipe_SelectPipe(Transfer->Address);
+
+		if (Pipe_IsStalled())
+		{
+			Pipe_FinishAsync(Transfer, PIPE_ASYNC_PipeStalled);
+			continue;
+		}
+
+		uint8_t* DataStream     = &Transfer->Buffer[Transfer->BytesTransferred];
+		uint16_t BytesRemaining = (Transfer->Length - Transfer->BytesTransferred);
+
+		if (Transfer->Address & PIPE_DIR_IN)
+		{
+			if (!(Pipe_IsINReceived()))
+			  continue;
+
+			uint16_t BytesInBank = Pipe_BytesInPipe();
+			bool     ShortPacket = (BytesInBank < USB_Pipe_SelectedFIFO->Size);
+
+			if (BytesInBank > BytesRemaining)
+			  BytesInBank = BytesRemaining;
+
+			Transfer->BytesTransferred += BytesInBank;
+
+			while (BytesInBank--)
+			  *(DataStream++) = Pipe_Read_8();
+
+			if (!(Pipe_BytesInPipe()))
+			  Pipe_ClearIN();
+
+			if (ShortPacket || (Transfer->BytesTransferred == Transfer->Length))
+			  Pipe_FinishAsync(Transfer, PIPE_ASYNC_Complete);
+		}
+		else
+		{
+			if (!(Pipe_IsOUTReady()))
+			  continue;
+
+			/* The transfer only ends once the bank holding its last packet has been sent, as the pipe is then frozen */
+			if (Transfer->LastPacketQueued)
+			{
+				Pipe_FinishAsync(Transfer, PIPE_ASYNC_Complete);
+				continue;
+			}
+
+			/* A zero length packet is sent if all the data has been sent but the last packet was full, or the transfer is empty */
+			uint16_t BytesInBank = (USB_Pipe_SelectedFIFO->Size - Pipe_BytesInPipe());
+
+			if (BytesInBank > BytesRemaining)
+			  BytesInBank = BytesRemaining;
+
+			Transfer->BytesTransferred += BytesInBank;
+
+			while (BytesInBank--)
+			  Pipe_Write_8(*(DataStream++));
+
+			bool FullPacket = (Pipe_BytesInPipe() == USB_Pipe_SelectedFIFO->Size);
+
+			Pipe_ClearOUT();
+
+			if ((Transfer->BytesTransferred == Transfer->Length) && !(FullPacket && (Transfer->Options & PIPE_ASYNC_OPT_SEND_ZLP)))
+			  Transfer->LastPacketQueued = true;
+		}
+	}
+}
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,304 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBMode.h"
+
+#if defined(USB_CAN_BE_HOST)
+
+#include "../Pipe.h"
+#include "Loopback_SIM.h"
+
+uint8_t USB_Host_ControlPipeSize = PIPE_CONTROLPIPE_DEFAULT_SIZE;
+
+Pipe_FIFO_t           USB_Pipe_FIFOs[PIPE_TOTAL_PIPES];
+
+volatile uint8_t      USB_Pipe_SelectedPipe = PIPE_CONTROLPIPE;
+volatile Pipe_FIFO_t* USB_Pipe_SelectedFIFO = &USB_Pipe_FIFOs[PIPE_CONTROLPIPE];
+
+bool Pipe_IsINReceived(void)
+{
+	USB_Controller_Poll();
+
+	return USB_Pipe_SelectedFIFO->INReceived;
+}
+
+bool Pipe_IsOUTReady(void)
+{
+	USB_Controller_Poll();
+
+	return !(USB_Pipe_SelectedFIFO->Pending);
+}
+
+bool Pipe_IsSETUPSent(void)
+{
+	USB_Controller_Poll();
+
+	return !(USB_Pipe_SelectedFIFO->Pending);
+}
+
+uint8_t Pipe_Read_8(void)
+{
+	return USB_Pipe_SelectedFIFO->Data[USB_Pipe_SelectedFIFO->Position++];
+}
+
+void Pipe_Write_8(const uint8_t Data)
+{
+	USB_Pipe_SelectedFIFO->Data[USB_Pipe_SelectedFIFO->Position++] = Data;
+}
+
+bool Pipe_ConfigurePipeTable(const USB_Pipe_Table_t* const Table,
+                             const uint8_t Entries)
+{
+	for (uint8_t i = 0; i < Entries; i++)
+	{
+		if (!(Table[i].Address))
+		  continue;
+
+		if (!(Pipe_ConfigurePipe(Table[i].Address, Table[i].Type, Table[i].EndpointAddress, Table[i].Size, Table[i].Banks)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Pipe_ConfigurePipe(const uint8_t Address,
+                        const uint8_t Type,
+                        const uint8_t EndpointAddress,
+                        const uint16_t Size,
+                        const uint8_t Banks)
+{
+	uint8_t Number = (Address & PIPE_EPNUM_MASK);
+	uint8_t Token  = (Address & PIPE_DIR_IN) ? PIPE_TOKEN_IN : PIPE_TOKEN_OUT;
+
+	if ((Number >= PIPE_TOTAL_PIPES) || !(Size) || (Size > PIPE_MAX_SIZE) || !(Banks))
+	  return false;
+
+	if (Type == EP_TYPE_CONTROL)
+	  Token = PIPE_TOKEN_SETUP;
+
+	Pipe_SelectPipe(Number);
+
+	USB_Pipe_SelectedFIFO->Type            = Type;
+	USB_Pipe_SelectedFIFO->Token           = Token;
+	USB_Pipe_SelectedFIFO->EndpointAddress = (EndpointAddress & PIPE_EPNUM_MASK);
+	USB_Pipe_SelectedFIFO->Size            = Size;
+	USB_Pipe_SelectedFIFO->Banks           = Banks;
+	USB_Pipe_SelectedFIFO->InterruptPeriod = 0;
+	USB_Pipe_SelectedFIFO->NextFrame       = 0;
+	USB_Pipe_SelectedFIFO->Frozen          = true;
+	USB_Pipe_SelectedFIFO->NAKReceived     = false;
+	USB_Pipe_SelectedFIFO->Stalled         = false;
+	USB_Pipe_SelectedFIFO->ErrorFlags      = 0;
+
+	Pipe_ResetPipe(Number);
+	Pipe_EnablePipe();
+	Pipe_SetInfiniteINRequests();
+
+	USB_Pipe_SelectedFIFO->Configured      = true;
+
+	return true;
+}
+
+void Pipe_ClearPipes(void)
+{
+	for (uint8_t PNum = 0; PNum < PIPE_TOTAL_PIPES; PNum++)
+	{
+		Pipe_SelectPipe(PNum);
+		memset((void*)USB_Pipe_SelectedFIFO, 0, sizeof(Pipe_FIFO_t));
+	}
+
+	Pipe_SelectPipe(PIPE_CONTROLPIPE);
+}
+
+bool Pipe_IsEndpointBound(const uint8_t EndpointAddress)
+{
+	uint8_t PrevPipeNumber = Pipe_GetCurrentPipe();
+
+	for (uint8_t PNum = 0; PNum < PIPE_TOTAL_PIPES; PNum++)
+	{
+		Pipe_SelectPipe(PNum);
+
+		if (!(Pipe_IsConfigured()))
+		  continue;
+
+		if (Pipe_GetBoundEndpointAddress() == EndpointAddress)
+		  return true;
+	}
+
+	Pipe_SelectPipe(PrevPipeNumber);
+	return false;
+}
+
+uint8_t Pipe_WaitUntilReady(void)
+{
+	#if (USB_STREAM_TIMEOUT_MS < 0xFF)
+	uint8_t  TimeoutMSRem = USB_STREAM_TIMEOUT_MS;
+	#else
+	uint16_t TimeoutMSRem = USB_STREAM_TIMEOUT_MS;
+	#endif
+
+	uint16_t PreviousFrameNumber = USB_Host_GetFrameNumber();
+
+	for (;;)
+	{
+		if (Pipe_GetPipeToken() == PIPE_TOKEN_IN)
+		{
+			if (Pipe_IsINReceived())
+			  return PIPE_READYWAIT_NoError;
+		}
+		else
+		{
+			if (Pipe_IsOUTReady())
+			  return PIPE_READYWAIT_NoError;
+		}
+
+		if (Pipe_IsStalled())
+		{
+			USB_PROFILE_PIPE(Stalls, 1);
+			return PIPE_READYWAIT_PipeStalled;
+		}
+		else if (USB_HostState == HOST_STATE_Unattached)
+		  return PIPE_READYWAIT_DeviceDisconnected;
+
+		USB_PROFILE_PIPE(BusyWaitIterations, 1);
+
+		uint16_t CurrentFrameNumber = USB_Host_GetFrameNumber();
+
+		if (CurrentFrameNumber != PreviousFrameNumber)
+		{
+			PreviousFrameNumber = CurrentFrameNumber;
+
+			if (!(TimeoutMSRem--))
+			  return PIPE_READYWAIT_Timeout;
+		}
+	}
+}
+
+static void Pipe_ProcessTransaction(Pipe_FIFO_t* const FIFO)
+{
+	uint16_t Length;
+	uint8_t  Handshake;
+
+	if (FIFO->Token == PIPE_TOKEN_IN)
+	{
+		Length    = FIFO->Size;
+		Handshake = USB_Loopback_DevicePort->Transaction(USB_SIM_TOKEN_IN, USB_SIM.Address, (FIFO->EndpointAddress | PIPE_DIR_IN),
+		                                                 FIFO->Data, &Length);
+	}
+	else
+	{
+		Length    = FIFO->Length;
+		Handshake = USB_Loopback_DevicePort->Transaction(FIFO->Token, USB_SIM.Address, FIFO->EndpointAddress,
+		                                                 FIFO->Data, &Length);
+	}
+
+	switch (Handshake)
+	{
+		case USB_SIM_HANDSHAKE_ACK:
+			FIFO->DataToggle ^= true;
+			FIFO->Position    = 0;
+
+			if (FIFO->Token == PIPE_TOKEN_IN)
+			{
+				if (Length > FIFO->Size)
+				{
+					FIFO->ErrorFlags |= PIPE_ERRORFLAG_OVERFLOW;
+					Length = FIFO->Size;
+				}
+
+				if (!(FIFO->InfiniteINRequests) && FIFO->INRequests)
+				  FIFO->INRequests--;
+
+				FIFO->Length     = Length;
+				FIFO->INReceived = true;
+			}
+			else
+			{
+				FIFO->Length     = 0;
+				FIFO->Pending    = false;
+			}
+
+			break;
+		case USB_SIM_HANDSHAKE_NAK:
+			FIFO->NAKReceived = true;
+			break;
+		case USB_SIM_HANDSHAKE_STALL:
+			FIFO->Stalled     = true;
+			break;
+		default:
+			FIFO->ErrorFlags |= PIPE_ERRORFLAG_TIMEOUT;
+			break;
+	}
+}
+
+void Pipe_ProcessTransactions(void)
+{
+	if (USB_Loopback_DevicePort == NULL)
+	  return;
+
+	for (uint8_t PNum = 0; PNum < PIPE_TOTAL_PIPES; PNum++)
+	{
+		Pipe_FIFO_t* FIFO = &USB_Pipe_FIFOs[PNum];
+
+		if (!(FIFO->Configured) || !(FIFO->Enabled) || FIFO->Frozen || FIFO->Stalled || FIFO->ErrorFlags)
+		  continue;
+
+		if (FIFO->Token == PIPE_TOKEN_IN)
+		{
+			if (FIFO->INReceived || (!(FIFO->InfiniteINRequests) && !(FIFO->INRequests)))
+			  continue;
+		}
+		else if (!(FIFO->Pending))
+		{
+			continue;
+		}
+
+		/* Periodic pipes are only serviced once per polling interval, whether or not the device had data ready */
+		if ((FIFO->Type == EP_TYPE_INTERRUPT) || (FIFO->Type == EP_TYPE_ISOCHRONOUS))
+		{
+			if (USB_SIM.FrameCount < FIFO->NextFrame)
+			  continue;
+
+			FIFO->NextFrame = (USB_SIM.FrameCount + MAX(FIFO->InterruptPeriod, 1));
+		}
+
+		Pipe_ProcessTransaction(FIFO);
+	}
+}
+
+#endif
+
+#endif
@@ -0,0 +1,314 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB Controller definitions for the host-native simulated USB controller.
+ *  \copydetails Group_USBManagement_SIM
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USBManagement
+ *  \defgroup Group_USBManagement_SIM USB Interface Management (SIM)
+ *  \brief USB Controller definitions for the host-native simulated USB controller.
+ *
+ *  Functions, macros, variables, enums and types related to the setup and management of the USB interface.
+ *
+ *  @{
+ */
+
+#ifndef __USBCONTROLLER_SIM_H__
+#define __USBCONTROLLER_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+		#include "../USBMode.h"
+		#include "../Events.h"
+		#include "../USBTask.h"
+		#include "../USBInterrupt.h"
+		#include "USBRegisters_SIM.h"
+
+	/* Includes: */
+		#if defined(USB_CAN_BE_HOST) || defined(__DOXYGEN__)
+			#include "../Host.h"
+			#include "../Pipe.h"
+			#include "../HostStandardReq.h"
+			#include "../PipeStream.h"
+			#include "Loopback_SIM.h"
+		#endif
+
+		#if defined(USB_CAN_BE_DEVICE) || defined(__DOXYGEN__)
+			#include "../Device.h"
+			#include "../Endpoint.h"
+			#include "../DeviceStandardReq.h"
+			#include "../EndpointStream.h"
+			#include "VirtualHost_SIM.h"
+		#endif
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks and Defines: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+		#if defined(INTERRUPT_CONTROL_ENDPOINT)
+			#error INTERRUPT_CONTROL_ENDPOINT is not available for the simulated USB controller.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** \name USB Controller Option Masks */
+			/**@{*/
+			/** Regulator disable option mask for \ref USB_Init(). The simulated USB controller has no voltage regulator, thus this
+			 *  option is accepted for source compatibility with AVR8 projects but is otherwise ignored.
+			 */
+			#define USB_OPT_REG_DISABLED              (0 << 1)
+
+			/** Regulator enable option mask for \ref USB_Init(). The simulated USB controller has no voltage regulator, thus this
+			 *  option is accepted for source compatibility with AVR8 projects but is otherwise ignored.
+			 */
+			#define USB_OPT_REG_ENABLED               (0 << 1)
+
+			/** Manual PLL control option mask for \ref USB_Init(). The simulated USB controller has no PLL, thus this option is
+			 *  accepted for source compatibility with AVR8 projects but is otherwise ignored.
+			 */
+			#define USB_OPT_MANUAL_PLL                (0 << 2)
+
+			/** Automatic PLL control option mask for \ref USB_Init(). The simulated USB controller has no PLL, thus this option is
+			 *  accepted for source compatibility with AVR8 projects but is otherwise ignored.
+			 */
+			#define USB_OPT_AUTO_PLL                  (0 << 2)
+			/**@}*/
+
+			#if !defined(USB_SIM_POLLS_PER_FRAME) || defined(__DOXYGEN__)
+				/** Number of times the simulated USB controller is polled by the stack (through \ref USB_USBTask() or any
+				 *  of the endpoint status functions) for each simulated 1ms USB frame. As the simulated controller has no
+				 *  real time base, this sets the rate of simulated time and thus the pacing of interrupt and isochronous
+				 *  transfers and the length of the stream timeout periods relative to the stack's own processing.
+				 *
+				 *  This value may be overridden in the user project makefile as the value of the
+				 *  \ref USB_SIM_POLLS_PER_FRAME token, and passed to the compiler using the -D switch.
+				 */
+				#define USB_SIM_POLLS_PER_FRAME     64
+			#endif
+
+			#if !defined(USB_STREAM_TIMEOUT_MS) || defined(__DOXYGEN__)
+				/** Constant for the maximum software timeout period of the USB data stream transfer functions
+				 *  (both control and standard) when in either device or host mode. If the next packet of a stream
+				 *  is not received or acknowledged within this time period, the stream function will fail.
+				 *
+				 *  This value may be overridden in the user project makefile as the value of the
+				 *  \ref USB_STREAM_TIMEOUT_MS token, and passed to the compiler using the -D switch.
+				 */
+				#define USB_STREAM_TIMEOUT_MS       100
+			#endif
+
+		/* Inline Functions: */
+			/** Detaches the device from the USB bus. This has the effect of removing the device from any
+			 *  attached host, ceasing USB communications. If no host is present, this prevents any host from
+			 *  enumerating the device once attached until \ref USB_Attach() is called.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void USB_Detach(void)
+			{
+				USB_SIM.Attached = false;
+			}
+
+			/** Attaches the device to the USB bus. This announces the device's presence to any attached
+			 *  USB host, starting the enumeration process. If no host is present, attaching the device
+			 *  will allow for enumeration once a host is connected to the device.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void USB_Attach(void)
+			{
+				USB_SIM.Attached = true;
+			}
+
+		/* Function Prototypes: */
+			/** Main function to initialize and start the USB interface. Once active, the USB interface will
+			 *  allow for device connection to a host when in device mode, or for device enumeration while in
+			 *  host mode.
+			 *
+			 *  As the USB library relies on interrupts for the device and host mode enumeration processes,
+			 *  the user must enable global interrupts before or shortly after this function is called. The
+			 *  simulated controller raises its interrupts from \ref USB_USBTask() and the endpoint status
+			 *  functions, and only while global interrupts are enabled.
+			 *
+			 *  Calling this function when the USB interface is already initialized will cause a complete USB
+			 *  interface reset and re-enumeration.
+			 *
+			 *  \param[in] Mode     Mask indicating what mode the USB interface is to be initialized to, a value
+			 *                      from the \ref USB_Modes_t enum.
+			 *                      \note This parameter does not exist on devices with only one supported USB
+			 *                            mode (device or host).
+			 *
+			 *  \param[in] Options  Mask indicating the options which should be used when initializing the USB
+			 *                      interface to control the USB interface's behavior. This should be comprised of
+			 *                      a \c USB_DEVICE_OPT_* mask (when the device mode is enabled) to set the device
+			 *                      mode speed.
+			 *
+			 *  \note To reduce the FLASH requirements of the library if only device or host mode is required,
+			 *        the mode can be statically set in the project makefile by defining the token \c USB_DEVICE_ONLY
+			 *        (for device mode) or \c USB_HOST_ONLY (for host mode), passing the token to the compiler
+			 *        via the -D switch. If the mode is statically set, this parameter does not exist in the
+			 *        function prototype.
+			 *        \n\n
+			 *
+			 *  \note To reduce the FLASH requirements of the library if only fixed settings are required,
+			 *        the options may be set statically in the same manner as the mode (see the Mode parameter of
+			 *        this function). To statically set the USB options, pass in the \c USE_STATIC_OPTIONS token,
+			 *        defined to the appropriate options masks. When the options are statically set, this
+			 *        parameter does not exist in the function prototype.
+			 *        \n\n
+			 *
+			 *  \note The mode parameter does not exist on devices where only one mode is possible, such as USB
+			 *        AVR models which only implement the USB device mode in hardware.
+			 *
+			 *  \see \ref Group_Device for the \c USB_DEVICE_OPT_* masks.
+			 */
+			void USB_Init(
+			               #if defined(USB_CAN_BE_BOTH) || defined(__DOXYGEN__)
+			               const uint8_t Mode
+			               #endif
+
+			               #if (defined(USB_CAN_BE_BOTH) && !defined(USE_STATIC_OPTIONS)) || defined(__DOXYGEN__)
+			               ,
+			               #elif (!defined(USB_CAN_BE_BOTH) && defined(USE_STATIC_OPTIONS))
+			               void
+			               #endif
+
+			               #if !defined(USE_STATIC_OPTIONS) || defined(__DOXYGEN__)
+			               const uint8_t Options
+			               #endif
+			               );
+
+			/** Shuts down the USB interface. This turns off the USB interface after deallocating all USB FIFO
+			 *  memory, endpoints and pipes. When turned off, no USB functionality can be used until the interface
+			 *  is restarted with the \ref USB_Init() function.
+			 */
+			void USB_Disable(void);
+
+			/** Resets the interface, when already initialized. This will re-enumerate the device if already connected
+			 *  to a host, or re-enumerate an already attached device when in host mode.
+			 */
+			void USB_ResetInterface(void);
+
+		/* Global Variables: */
+			#if defined(USB_CAN_BE_BOTH) || defined(__DOXYGEN__)
+				/** Indicates the mode that the USB interface is currently initialized to, a value from the
+				 *  \ref USB_Modes_t enum.
+				 *
+				 *  \attention This variable should be treated as read-only in the user application, and never manually
+				 *             changed in value.
+				 *
+				 *  \note When the controller is initialized into UID auto-detection mode, this variable will hold the
+				 *        currently selected USB mode (i.e. \ref USB_MODE_Device or \ref USB_MODE_Host). If the controller
+				 *        is fixed into a specific mode (either through the \c USB_DEVICE_ONLY or \c USB_HOST_ONLY compile time
+				 *        options, or a limitation of the USB controller in the chosen device model) this will evaluate to
+				 *        a constant of the appropriate value and will never evaluate to \ref USB_MODE_None even when the
+				 *        USB interface is not initialized.
+				 */
+				extern volatile uint8_t USB_CurrentMode;
+			#elif defined(USB_CAN_BE_HOST)
+				#define USB_CurrentMode USB_MODE_Host
+			#elif defined(USB_CAN_BE_DEVICE)
+				#define USB_CurrentMode USB_MODE_Device
+			#endif
+
+			#if !defined(USE_STATIC_OPTIONS) || defined(__DOXYGEN__)
+				/** Indicates the current USB options that the USB interface was initialized with when \ref USB_Init()
+				 *  was called. This value will be one of the \c USB_MODE_* masks defined elsewhere in this module.
+				 *
+				 *  \attention This variable should be treated as read-only in the user application, and never manually
+				 *             changed in value.
+				 */
+				extern volatile uint8_t USB_Options;
+			#elif defined(USE_STATIC_OPTIONS)
+				#define USB_Options USE_STATIC_OPTIONS
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_USB_CONTROLLER_C)
+				#if defined(USB_CAN_BE_DEVICE)
+				static void USB_Init_Device(void);
+				#endif
+
+				#if defined(USB_CAN_BE_HOST)
+				static void USB_Init_Host(void);
+				#endif
+			#endif
+
+		/* Inline Functions: */
+			ATTR_ALWAYS_INLINE
+			static inline void USB_Controller_Enable(void)
+			{
+				USB_SIM.Enabled = true;
+			}
+
+			ATTR_ALWAYS_INLINE
+			static inline void USB_Controller_Disable(void)
+			{
+				USB_SIM.Enabled = false;
+			}
+
+			ATTR_ALWAYS_INLINE
+			static inline void USB_Controller_Reset(void)
+			{
+				USB_SIM.Enabled          = false;
+				USB_SIM.Suspended        = false;
+				USB_SIM.Address          = 0;
+				USB_SIM.DeviceConnected  = false;
+				USB_SIM.SOFEnabled       = false;
+				USB_SIM.BusReset         = false;
+				USB_SIM.BusResume        = false;
+				USB_SIM.RemoteWakeupSent = false;
+				USB_SIM.FramePolls       = 0;
+				USB_SIM.FrameNumber      = 0;
+				USB_SIM.Enabled          = true;
+			}
+
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
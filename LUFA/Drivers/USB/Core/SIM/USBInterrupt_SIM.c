@@ -0,0 +1,283 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBInterrupt.h"
+
+void USB_INT_DisableAllInterrupts(void)
+{
+	USB_SIM.InterruptEnable = 0;
+}
+
+void USB_INT_ClearAllInterrupts(void)
+{
+	USB_SIM.InterruptFlags  = 0;
+}
+
+ISR(USB_BUSEVENT_vect)
+{
+	#if defined(USB_CAN_BE_DEVICE)
+	#if !defined(NO_SOF_EVENTS)
+	if (USB_INT_HasOccurred(USB_INT_SOFI) && USB_INT_IsEnabled(USB_INT_SOFI))
+	{
+		USB_INT_Clear(USB_INT_SOFI);
+
+		EVENT_USB_Device_StartOfFrame();
+	}
+	#endif
+
+	if (USB_INT_HasOccurred(USB_INT_BUSEVENTI_Suspend))
+	{
+		USB_INT_Clear(USB_INT_BUSEVENTI_Suspend);
+
+		#if !defined(NO_LIMITED_CONTROLLER_CONNECT)
+		USB_DeviceState = DEVICE_STATE_Unattached;
+
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
+		EVENT_USB_Device_Disconnect();
+		#else
+		USB_DeviceState = DEVICE_STATE_Suspended;
+		EVENT_USB_Device_Suspend();
+		#endif
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_BUSEVENTI_Resume))
+	{
+		USB_INT_Clear(USB_INT_BUSEVENTI_Resume);
+
+		if (USB_Device_ConfigurationNumber)
+		  USB_DeviceState = DEVICE_STATE_Configured;
+		else
+		  USB_DeviceState = (USB_Device_IsAddressSet()) ? DEVICE_STATE_Addressed : DEVICE_STATE_Powered;
+
+		#if !defined(NO_LIMITED_CONTROLLER_CONNECT)
+		EVENT_USB_Device_Connect();
+		#else
+		EVENT_USB_Device_WakeUp();
+		#endif
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_BUSEVENTI_Reset))
+	{
+		USB_INT_Clear(USB_INT_BUSEVENTI_Reset);
+
+		USB_DeviceState                = DEVICE_STATE_Default;
+		USB_Device_ConfigurationNumber = 0;
+
+		USB_Device_EnableDeviceAddress(0);
+
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
+		Endpoint_ClearEndpoints();
+		Endpoint_ConfigureEndpoint(ENDPOINT_CONTROLEP, EP_TYPE_CONTROL,
+		                           USB_Device_ControlEndpointSize, 1);
+
+		EVENT_USB_Device_Reset();
+	}
+	#endif
+
+	#if defined(USB_CAN_BE_HOST)
+	#if !defined(NO_SOF_EVENTS)
+	if (USB_INT_HasOccurred(USB_INT_HSOFI) && USB_INT_IsEnabled(USB_INT_HSOFI))
+	{
+		USB_INT_Clear(USB_INT_HSOFI);
+
+		EVENT_USB_Host_StartOfFrame();
+	}
+	#endif
+
+	if (USB_INT_HasOccurred(USB_INT_DDISCI) && USB_INT_IsEnabled(USB_INT_DDISCI))
+	{
+		USB_INT_Clear(USB_INT_DDISCI);
+		USB_INT_Clear(USB_INT_DCONNI);
+		USB_INT_Disable(USB_INT_DDISCI);
+
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
+		EVENT_USB_Host_DeviceUnattached();
+
+		USB_ResetInterface();
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_VBERRI) && USB_INT_IsEnabled(USB_INT_VBERRI))
+	{
+		USB_INT_Clear(USB_INT_VBERRI);
+
+		USB_Host_VBUS_Manual_Off();
+		USB_Host_VBUS_Auto_Off();
+
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
+		EVENT_USB_Host_HostError(HOST_ERROR_VBusVoltageDip);
+		EVENT_USB_Host_DeviceUnattached();
+
+		USB_HostState = HOST_STATE_Unattached;
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_SRPI) && USB_INT_IsEnabled(USB_INT_SRPI))
+	{
+		USB_INT_Clear(USB_INT_SRPI);
+		USB_INT_Disable(USB_INT_SRPI);
+
+		EVENT_USB_Host_DeviceAttached();
+
+		USB_INT_Enable(USB_INT_DDISCI);
+
+		USB_HostState = HOST_STATE_Powered;
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_BCERRI) && USB_INT_IsEnabled(USB_INT_BCERRI))
+	{
+		USB_INT_Clear(USB_INT_BCERRI);
+
+		#if defined(ASYNC_PIPE_TRANSFERS)
+		Pipe_AbortAsyncTransfers();
+		#endif
+
+		EVENT_USB_Host_DeviceEnumerationFailed(HOST_ENUMERROR_NoDeviceDetected, 0);
+		EVENT_USB_Host_DeviceUnattached();
+
+		USB_ResetInterface();
+	}
+	#endif
+}
+
+#if (defined(ASYNC_ENDPOINT_TRANSFERS) && defined(USB_CAN_BE_DEVICE)) || (defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST))
+ISR(USB_COM_vect)
+{
+	#if defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST)
+	if (USB_CurrentMode == USB_MODE_Host)
+	{
+		uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+		Pipe_ProcessAsyncTransfers();
+
+		Pipe_SelectPipe(PrevSelectedPipe);
+		return;
+	}
+	#endif
+
+	#if defined(ASYNC_ENDPOINT_TRANSFERS) && defined(USB_CAN_BE_DEVICE)
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	Endpoint_ProcessAsyncTransfers();
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+	#endif
+}
+
+static bool USB_INT_IsEndpointInterruptPending(void)
+{
+	#if defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST)
+	if (USB_CurrentMode == USB_MODE_Host)
+	{
+		/* A pipe raises its interrupt once its bank is ready or the device has stalled it, while the interrupt is enabled */
+		for (uint8_t PNum = 1; PNum < PIPE_TOTAL_PIPES; PNum++)
+		{
+			Pipe_FIFO_t* FIFO = &USB_Pipe_FIFOs[PNum];
+
+			if (!(FIFO->InterruptEnabled))
+			  continue;
+
+			if (FIFO->Stalled || ((FIFO->Token == PIPE_TOKEN_IN) ? FIFO->INReceived : !(FIFO->Pending)))
+			  return true;
+		}
+	}
+	#endif
+
+	#if defined(ASYNC_ENDPOINT_TRANSFERS) && defined(USB_CAN_BE_DEVICE)
+	if (USB_CurrentMode == USB_MODE_Device)
+	{
+		/* Like the physical controllers, a ready endpoint bank raises the endpoint interrupt only while it is enabled */
+		for (uint8_t EPNum = 1; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+		{
+			Endpoint_FIFO_t* INFIFO  = &USB_Endpoint_FIFOs[EPNum].IN;
+			Endpoint_FIFO_t* OUTFIFO = &USB_Endpoint_FIFOs[EPNum].OUT;
+
+			if ((INFIFO->InterruptEnabled && !(INFIFO->Pending)) || (OUTFIFO->InterruptEnabled && OUTFIFO->Pending))
+			  return true;
+		}
+	}
+	#endif
+
+	return false;
+}
+#endif
+
+void USB_INT_ServiceInterrupts(void)
+{
+	if (!(GetGlobalInterruptMask()))
+	  return;
+
+	uint16_t PendingInterrupts = (USB_SIM.InterruptFlags & USB_SIM.InterruptEnable);
+
+	#if (defined(ASYNC_ENDPOINT_TRANSFERS) && defined(USB_CAN_BE_DEVICE)) || (defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST))
+	bool EndpointInterruptPending = USB_INT_IsEndpointInterruptPending();
+	#else
+	bool EndpointInterruptPending = false;
+	#endif
+
+	/* Device bus events are all gated by the single bus event interrupt enable */
+	if (USB_INT_IsEnabled(USB_INT_BUSEVENTI))
+	{
+		PendingInterrupts |= (USB_SIM.InterruptFlags & ((1 << USB_INT_BUSEVENTI_Suspend) |
+		                                                (1 << USB_INT_BUSEVENTI_Resume)  |
+		                                                (1 << USB_INT_BUSEVENTI_Reset)));
+	}
+
+	if (!(PendingInterrupts) && !(EndpointInterruptPending))
+	  return;
+
+	GlobalInterruptDisable();
+
+	if (PendingInterrupts)
+	  USB_BUSEVENT_vect();
+
+	#if (defined(ASYNC_ENDPOINT_TRANSFERS) && defined(USB_CAN_BE_DEVICE)) || (defined(ASYNC_PIPE_TRANSFERS) && defined(USB_CAN_BE_HOST))
+	if (EndpointInterruptPending)
+	  USB_COM_vect();
+	#endif
+
+	GlobalInterruptEnable();
+}
+
+#endif
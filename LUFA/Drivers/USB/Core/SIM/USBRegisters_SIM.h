@@ -0,0 +1,140 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Simulated USB controller register definitions for the host-native simulated architecture.
+ *
+ *  This file contains the in-memory register block of the simulated USB controller, which takes the place of the
+ *  memory mapped USB peripheral registers found on the physical architectures.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+#ifndef __USBREGISTERS_SIM_H__
+#define __USBREGISTERS_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Enums: */
+			enum USB_SIM_Tokens_t
+			{
+				USB_SIM_TOKEN_SETUP          = 0,
+				USB_SIM_TOKEN_IN             = 1,
+				USB_SIM_TOKEN_OUT            = 2,
+			};
+
+			enum USB_SIM_Handshakes_t
+			{
+				USB_SIM_HANDSHAKE_ACK        = 0,
+				USB_SIM_HANDSHAKE_NAK        = 1,
+				USB_SIM_HANDSHAKE_STALL      = 2,
+				USB_SIM_HANDSHAKE_NoResponse = 3,
+			};
+
+			enum USB_SIM_BusEvents_t
+			{
+				USB_SIM_BUSEVENT_Reset       = 0,
+				USB_SIM_BUSEVENT_Suspend     = 1,
+				USB_SIM_BUSEVENT_Resume      = 2,
+			};
+
+		/* Type Defines: */
+			typedef struct
+			{
+				bool     Enabled;
+				bool     Attached;
+				bool     Suspended;
+				bool     FullSpeed;
+				bool     RemoteWakeup;
+				uint8_t  Address;
+
+				bool     HostMode;
+				bool     VBUSEnabled;
+				bool     DeviceConnected;
+				bool     SOFEnabled;
+				bool     BusReset;
+				uint32_t BusResetEndFrame;
+				bool     BusResume;
+				bool     RemoteWakeupSent;
+
+				uint16_t FrameNumber;
+				uint16_t FramePolls;
+				uint32_t FrameCount;
+
+				uint16_t InterruptEnable;
+				uint16_t InterruptFlags;
+			} USB_SIM_Controller_t;
+
+			/* Table of entry points exported by a device mode build of the library, through which a host mode
+			 * build in the same process drives the device's side of the simulated bus.
+			 */
+			typedef struct
+			{
+				void    (*Start)(int (*Main)(int, char**), char* const Name);
+				bool    (*Run)(void);
+				bool    (*IsAttached)(void);
+				bool    (*IsFullSpeed)(void);
+				bool    (*IsRemoteWakeupSent)(void);
+				void    (*BusEvent)(const uint8_t Event);
+				void    (*StartOfFrame)(void);
+				uint8_t (*Transaction)(const uint8_t Token,
+				                       const uint8_t DeviceAddress,
+				                       const uint8_t EndpointAddress,
+				                       void* const Buffer,
+				                       uint16_t* const Length);
+			} USB_SIM_DevicePort_t;
+
+		/* External Variables: */
+			extern volatile USB_SIM_Controller_t USB_SIM;
+
+		/* Function Prototypes: */
+			void USB_Controller_Poll(void);
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
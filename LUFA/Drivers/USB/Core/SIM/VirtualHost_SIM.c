@@ -0,0 +1,546 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBMode.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+
+#include "../USBController.h"
+
+#include <ucontext.h>
+
+#define VIRTUALHOST_LOOPBACK_STACK_SIZE  (256UL * 1024)
+
+enum USB_VirtualHost_Stages_t
+{
+	VIRTUALHOST_STAGE_Setup      = 0,
+	VIRTUALHOST_STAGE_DataIN     = 1,
+	VIRTUALHOST_STAGE_DataOUT    = 2,
+	VIRTUALHOST_STAGE_StatusIN   = 3,
+	VIRTUALHOST_STAGE_StatusOUT  = 4,
+};
+
+static USB_VirtualHost_Transfer_t* USB_VirtualHost_QueueHead;
+static USB_VirtualHost_Transfer_t* USB_VirtualHost_QueueTail;
+static bool                        USB_VirtualHost_Connected;
+static uint32_t                    USB_VirtualHost_NextStartFrame;
+
+static bool                        USB_VirtualHost_LoopbackActive;
+static bool                        USB_VirtualHost_LoopbackFinished;
+static int                         (*USB_VirtualHost_LoopbackMain)(int, char**);
+static char*                       USB_VirtualHost_LoopbackArgs[2];
+static ucontext_t                  USB_VirtualHost_HostContext;
+static ucontext_t                  USB_VirtualHost_DeviceContext;
+static uint8_t                     USB_VirtualHost_DeviceStack[VIRTUALHOST_LOOPBACK_STACK_SIZE];
+
+static Endpoint_FIFO_t* USB_VirtualHost_GetFIFO(const uint8_t Address)
+{
+	if ((Address & ENDPOINT_EPNUM_MASK) >= ENDPOINT_TOTAL_ENDPOINTS)
+	  return NULL;
+
+	if (Address & ENDPOINT_DIR_IN)
+	  return &USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK].IN;
+	else
+	  return &USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK].OUT;
+}
+
+static uint8_t USB_VirtualHost_SendOUT(const uint8_t Address,
+                                       const void* const Data,
+                                       uint16_t Length,
+                                       const bool IsSETUP)
+{
+	Endpoint_FIFO_t* FIFO = USB_VirtualHost_GetFIFO(Address & ~ENDPOINT_DIR_IN);
+
+	if ((FIFO == NULL) || !(FIFO->Configured))
+	  return USB_SIM_HANDSHAKE_NoResponse;
+
+	if (IsSETUP)
+	{
+		/* Hold off the next request until the device has consumed the previous request's status stage */
+		if (FIFO->Pending && !(FIFO->IsSETUP))
+		  return USB_SIM_HANDSHAKE_NAK;
+
+		USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT.Stalled = false;
+		USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].IN.Stalled  = false;
+		USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].IN.Pending  = false;
+	}
+	else if (FIFO->Stalled)
+	{
+		return USB_SIM_HANDSHAKE_STALL;
+	}
+	else if (FIFO->Pending && (FIFO->Type != EP_TYPE_ISOCHRONOUS))
+	{
+		return USB_SIM_HANDSHAKE_NAK;
+	}
+
+	if (Length > FIFO->Size)
+	  Length = FIFO->Size;
+
+	if (Length)
+	  memcpy(FIFO->Data, Data, Length);
+
+	FIFO->Length      = Length;
+	FIFO->Position    = 0;
+	FIFO->IsSETUP     = IsSETUP;
+	FIFO->DataToggle ^= true;
+	FIFO->Pending     = true;
+
+	return USB_SIM_HANDSHAKE_ACK;
+}
+
+static uint8_t USB_VirtualHost_ReceiveIN(const uint8_t Address,
+                                         void* const Buffer,
+                                         const uint16_t MaxLength,
+                                         uint16_t* const PacketLength)
+{
+	Endpoint_FIFO_t* FIFO = USB_VirtualHost_GetFIFO(Address | ENDPOINT_DIR_IN);
+
+	if ((FIFO == NULL) || !(FIFO->Configured))
+	  return USB_SIM_HANDSHAKE_NoResponse;
+	else if (FIFO->Stalled)
+	  return USB_SIM_HANDSHAKE_STALL;
+	else if (!(FIFO->Pending))
+	  return USB_SIM_HANDSHAKE_NAK;
+
+	*PacketLength = FIFO->PacketLength;
+
+	if (Buffer != NULL)
+	  memcpy(Buffer, FIFO->Data, MIN(FIFO->PacketLength, MaxLength));
+
+	FIFO->DataToggle ^= true;
+	FIFO->Pending     = false;
+
+	return USB_SIM_HANDSHAKE_ACK;
+}
+
+static void USB_VirtualHost_ProcessHandshake(USB_VirtualHost_Transfer_t* const Transfer,
+                                             const uint8_t Handshake)
+{
+	switch (Handshake)
+	{
+		case USB_SIM_HANDSHAKE_NAK:
+			Transfer->NAKs++;
+			break;
+		case USB_SIM_HANDSHAKE_STALL:
+			Transfer->Status = VIRTUALHOST_STATUS_Stalled;
+			break;
+		case USB_SIM_HANDSHAKE_NoResponse:
+			Transfer->Status = VIRTUALHOST_STATUS_NoResponse;
+			break;
+	}
+}
+
+static void USB_VirtualHost_ProcessControlTransfer(USB_VirtualHost_Transfer_t* const Transfer)
+{
+	uint8_t* DataStream    = ((uint8_t*)Transfer->Buffer + Transfer->BytesTransferred);
+	uint16_t BytesRem      = (Transfer->Length - Transfer->BytesTransferred);
+	uint16_t ControlEPSize = USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT.Size;
+	uint16_t PacketLength  = 0;
+	uint8_t  Handshake;
+
+	switch (Transfer->Stage)
+	{
+		case VIRTUALHOST_STAGE_Setup:
+			Handshake = USB_VirtualHost_SendOUT(ENDPOINT_CONTROLEP, &Transfer->Request, sizeof(USB_Request_Header_t), true);
+
+			if (Handshake == USB_SIM_HANDSHAKE_ACK)
+			{
+				if (!(Transfer->Length))
+				  Transfer->Stage = VIRTUALHOST_STAGE_StatusIN;
+				else if (Transfer->Request.bmRequestType & REQDIR_DEVICETOHOST)
+				  Transfer->Stage = VIRTUALHOST_STAGE_DataIN;
+				else
+				  Transfer->Stage = VIRTUALHOST_STAGE_DataOUT;
+			}
+
+			break;
+		case VIRTUALHOST_STAGE_DataIN:
+			Handshake = USB_VirtualHost_ReceiveIN(ENDPOINT_CONTROLEP, (Transfer->Buffer ? DataStream : NULL), BytesRem, &PacketLength);
+
+			if (Handshake == USB_SIM_HANDSHAKE_ACK)
+			{
+				Transfer->BytesTransferred += MIN(PacketLength, BytesRem);
+				Transfer->Packets++;
+
+				if ((PacketLength < ControlEPSize) || (Transfer->BytesTransferred == Transfer->Length))
+				  Transfer->Stage = VIRTUALHOST_STAGE_StatusOUT;
+			}
+
+			break;
+		case VIRTUALHOST_STAGE_DataOUT:
+			PacketLength = MIN(BytesRem, ControlEPSize);
+			Handshake    = USB_VirtualHost_SendOUT(ENDPOINT_CONTROLEP, DataStream, PacketLength, false);
+
+			if (Handshake == USB_SIM_HANDSHAKE_ACK)
+			{
+				Transfer->BytesTransferred += PacketLength;
+				Transfer->Packets++;
+
+				if (Transfer->BytesTransferred == Transfer->Length)
+				  Transfer->Stage = VIRTUALHOST_STAGE_StatusIN;
+			}
+
+			break;
+		case VIRTUALHOST_STAGE_StatusIN:
+			Handshake = USB_VirtualHost_ReceiveIN(ENDPOINT_CONTROLEP, NULL, 0, &PacketLength);
+
+			if (Handshake == USB_SIM_HANDSHAKE_ACK)
+			  Transfer->Status = VIRTUALHOST_STATUS_Complete;
+
+			return;
+		case VIRTUALHOST_STAGE_StatusOUT:
+			Handshake = USB_VirtualHost_SendOUT(ENDPOINT_CONTROLEP, NULL, 0, false);
+
+			if (Handshake == USB_SIM_HANDSHAKE_ACK)
+			  Transfer->Status = VIRTUALHOST_STATUS_Complete;
+
+			return;
+		default:
+			return;
+	}
+
+	USB_VirtualHost_ProcessHandshake(Transfer, Handshake);
+}
+
+static void USB_VirtualHost_ProcessDataTransfer(USB_VirtualHost_Transfer_t* const Transfer)
+{
+	uint8_t* DataStream   = ((uint8_t*)Transfer->Buffer + Transfer->BytesTransferred);
+	uint16_t BytesRem     = (Transfer->Length - Transfer->BytesTransferred);
+	uint16_t PacketLength = 0;
+	uint8_t  Handshake;
+
+	if (Transfer->Type != EP_TYPE_BULK)
+	{
+		if (USB_SIM.FrameCount < Transfer->NextFrame)
+		  return;
+
+		Transfer->NextFrame = (USB_SIM.FrameCount + MAX(Transfer->Interval, 1));
+	}
+
+	Endpoint_FIFO_t* FIFO = USB_VirtualHost_GetFIFO(Transfer->Address);
+	uint16_t EPSize       = (FIFO != NULL) ? FIFO->Size : 0;
+
+	if (Transfer->Address & ENDPOINT_DIR_IN)
+	{
+		Handshake = USB_VirtualHost_ReceiveIN(Transfer->Address, (Transfer->Buffer ? DataStream : NULL), BytesRem, &PacketLength);
+
+		if (Handshake == USB_SIM_HANDSHAKE_ACK)
+		{
+			Transfer->BytesTransferred += MIN(PacketLength, BytesRem);
+			Transfer->Packets++;
+
+			if (Transfer->BytesTransferred == Transfer->Length)
+			  Transfer->Status = VIRTUALHOST_STATUS_Complete;
+			else if ((PacketLength < EPSize) && (Transfer->Type != EP_TYPE_ISOCHRONOUS))
+			  Transfer->Status = VIRTUALHOST_STATUS_Complete;
+		}
+	}
+	else
+	{
+		PacketLength = MIN(BytesRem, EPSize);
+		Handshake    = USB_VirtualHost_SendOUT(Transfer->Address, DataStream, PacketLength, false);
+
+		if (Handshake == USB_SIM_HANDSHAKE_ACK)
+		{
+			Transfer->BytesTransferred += PacketLength;
+			Transfer->Packets++;
+
+			if (Transfer->BytesTransferred == Transfer->Length)
+			  Transfer->Status = VIRTUALHOST_STATUS_Complete;
+		}
+	}
+
+	USB_VirtualHost_ProcessHandshake(Transfer, Handshake);
+}
+
+static void USB_VirtualHost_CompleteTransfer(const uint8_t Status)
+{
+	USB_VirtualHost_Transfer_t* Transfer = USB_VirtualHost_QueueHead;
+
+	USB_VirtualHost_QueueHead = Transfer->Next;
+	if (USB_VirtualHost_QueueHead == NULL)
+	  USB_VirtualHost_QueueTail = NULL;
+
+	Transfer->Status   = Status;
+	Transfer->EndFrame = USB_SIM.FrameCount;
+
+	USB_VirtualHost_NextStartFrame = (USB_SIM.FrameCount + 1);
+	Transfer->Next     = NULL;
+
+	if (Transfer->Callback != NULL)
+	  Transfer->Callback(Transfer);
+}
+
+void USB_VirtualHost_Submit(USB_VirtualHost_Transfer_t* const Transfer)
+{
+	Transfer->Status           = VIRTUALHOST_STATUS_Queued;
+	Transfer->BytesTransferred = 0;
+	Transfer->Packets          = 0;
+	Transfer->NAKs             = 0;
+	Transfer->Next             = NULL;
+
+	if (Transfer->Type == EP_TYPE_CONTROL)
+	  Transfer->Length = Transfer->Request.wLength;
+
+	if (USB_VirtualHost_QueueTail != NULL)
+	  USB_VirtualHost_QueueTail->Next = Transfer;
+	else
+	  USB_VirtualHost_QueueHead = Transfer;
+
+	USB_VirtualHost_QueueTail = Transfer;
+}
+
+void USB_VirtualHost_SubmitScript(USB_VirtualHost_Transfer_t* const Script,
+                                  const uint8_t Entries)
+{
+	for (uint8_t i = 0; i < Entries; i++)
+	  USB_VirtualHost_Submit(&Script[i]);
+}
+
+void USB_VirtualHost_ResetBus(void)
+{
+	USB_SIM.Suspended       = false;
+	USB_SIM.InterruptFlags |= (1 << USB_INT_BUSEVENTI_Reset);
+}
+
+void USB_VirtualHost_SuspendBus(void)
+{
+	USB_SIM.Suspended       = true;
+	USB_SIM.RemoteWakeup    = false;
+	USB_SIM.InterruptFlags |= (1 << USB_INT_BUSEVENTI_Suspend);
+}
+
+void USB_VirtualHost_ResumeBus(void)
+{
+	USB_SIM.Suspended       = false;
+	USB_SIM.InterruptFlags |= (1 << USB_INT_BUSEVENTI_Resume);
+}
+
+bool USB_VirtualHost_IsIdle(void)
+{
+	return (USB_VirtualHost_QueueHead == NULL);
+}
+
+static void USB_VirtualHost_StartOfFrame(void)
+{
+	USB_SIM.FramePolls  = 0;
+	USB_SIM.FrameNumber = ((USB_SIM.FrameNumber + 1) & 0x07FF);
+	USB_SIM.FrameCount++;
+
+	USB_SIM.InterruptFlags |= (1 << USB_INT_SOFI);
+}
+
+void USB_VirtualHost_ProcessNextTransaction(void)
+{
+	/* When driven by a host mode instance over the loopback port, hand control back to the host at each poll */
+	if (USB_VirtualHost_LoopbackActive)
+	{
+		swapcontext(&USB_VirtualHost_DeviceContext, &USB_VirtualHost_HostContext);
+		return;
+	}
+
+	if (USB_SIM.Attached && !(USB_SIM.Suspended) && (++USB_SIM.FramePolls >= USB_SIM_POLLS_PER_FRAME))
+	  USB_VirtualHost_StartOfFrame();
+
+	if (!(USB_SIM.Attached))
+	{
+		USB_VirtualHost_Connected = false;
+
+		while (USB_VirtualHost_QueueHead != NULL)
+		  USB_VirtualHost_CompleteTransfer(VIRTUALHOST_STATUS_Disconnected);
+
+		return;
+	}
+
+	if (!(USB_VirtualHost_Connected))
+	{
+		USB_VirtualHost_Connected      = true;
+		USB_VirtualHost_NextStartFrame = (USB_SIM.FrameCount + 1);
+		USB_VirtualHost_ResetBus();
+		return;
+	}
+
+	if (USB_SIM.Suspended)
+	{
+		if (USB_SIM.RemoteWakeup)
+		  USB_VirtualHost_ResumeBus();
+
+		return;
+	}
+
+	if (USB_SIM.InterruptFlags & (1 << USB_INT_BUSEVENTI_Reset))
+	  return;
+
+	USB_VirtualHost_Transfer_t* Transfer = USB_VirtualHost_QueueHead;
+
+	if (Transfer == NULL)
+	{
+		EVENT_USB_VirtualHost_Idle();
+		return;
+	}
+
+	if (Transfer->Status == VIRTUALHOST_STATUS_Queued)
+	{
+		/* Like a real host controller, new transfers are only scheduled from the start of the next frame */
+		if (USB_SIM.FrameCount < USB_VirtualHost_NextStartFrame)
+		  return;
+
+		Transfer->Status     = VIRTUALHOST_STATUS_Active;
+		Transfer->Stage      = VIRTUALHOST_STAGE_Setup;
+		Transfer->StartFrame = USB_SIM.FrameCount;
+		Transfer->NextFrame  = USB_SIM.FrameCount;
+	}
+
+	if (Transfer->Type == EP_TYPE_CONTROL)
+	  USB_VirtualHost_ProcessControlTransfer(Transfer);
+	else
+	  USB_VirtualHost_ProcessDataTransfer(Transfer);
+
+	if (Transfer->Status != VIRTUALHOST_STATUS_Active)
+	  USB_VirtualHost_CompleteTransfer(Transfer->Status);
+}
+
+static void USB_VirtualHost_LoopbackEntry(void)
+{
+	USB_VirtualHost_LoopbackMain(1, USB_VirtualHost_LoopbackArgs);
+
+	USB_SIM.Attached                 = false;
+	USB_VirtualHost_LoopbackFinished = true;
+}
+
+static void USB_VirtualHost_LoopbackStart(int (*Main)(int, char**), char* const Name)
+{
+	/* The device is started as a program run without any command line arguments other than its own name */
+	USB_VirtualHost_LoopbackArgs[0]  = Name;
+	USB_VirtualHost_LoopbackArgs[1]  = NULL;
+
+	USB_VirtualHost_LoopbackMain     = Main;
+	USB_VirtualHost_LoopbackActive   = true;
+	USB_VirtualHost_LoopbackFinished = false;
+
+	getcontext(&USB_VirtualHost_DeviceContext);
+	USB_VirtualHost_DeviceContext.uc_stack.ss_sp   = USB_VirtualHost_DeviceStack;
+	USB_VirtualHost_DeviceContext.uc_stack.ss_size = sizeof(USB_VirtualHost_DeviceStack);
+	USB_VirtualHost_DeviceContext.uc_link          = &USB_VirtualHost_HostContext;
+	makecontext(&USB_VirtualHost_DeviceContext, USB_VirtualHost_LoopbackEntry, 0);
+}
+
+static bool USB_VirtualHost_LoopbackRun(void)
+{
+	if (USB_VirtualHost_LoopbackFinished)
+	  return false;
+
+	swapcontext(&USB_VirtualHost_HostContext, &USB_VirtualHost_DeviceContext);
+	return !(USB_VirtualHost_LoopbackFinished);
+}
+
+static bool USB_VirtualHost_LoopbackIsAttached(void)
+{
+	return (USB_SIM.Enabled && USB_SIM.Attached);
+}
+
+static bool USB_VirtualHost_LoopbackIsFullSpeed(void)
+{
+	return USB_SIM.FullSpeed;
+}
+
+static bool USB_VirtualHost_LoopbackIsRemoteWakeupSent(void)
+{
+	bool RemoteWakeupSent = USB_SIM.RemoteWakeup;
+
+	USB_SIM.RemoteWakeup = false;
+	return RemoteWakeupSent;
+}
+
+static void USB_VirtualHost_LoopbackBusEvent(const uint8_t Event)
+{
+	switch (Event)
+	{
+		case USB_SIM_BUSEVENT_Reset:
+			USB_VirtualHost_ResetBus();
+			break;
+		case USB_SIM_BUSEVENT_Suspend:
+			USB_VirtualHost_SuspendBus();
+			break;
+		case USB_SIM_BUSEVENT_Resume:
+			USB_VirtualHost_ResumeBus();
+			break;
+	}
+}
+
+static void USB_VirtualHost_LoopbackStartOfFrame(void)
+{
+	if (USB_SIM.Enabled && !(USB_SIM.Suspended))
+	  USB_VirtualHost_StartOfFrame();
+}
+
+static uint8_t USB_VirtualHost_LoopbackTransaction(const uint8_t Token,
+                                                   const uint8_t DeviceAddress,
+                                                   const uint8_t EndpointAddress,
+                                                   void* const Buffer,
+                                                   uint16_t* const Length)
+{
+	if (!(USB_VirtualHost_LoopbackIsAttached()) || USB_SIM.Suspended || (DeviceAddress != USB_SIM.Address))
+	  return USB_SIM_HANDSHAKE_NoResponse;
+
+	/* Bus reset still pending processing by the device */
+	if (USB_SIM.InterruptFlags & (1 << USB_INT_BUSEVENTI_Reset))
+	  return USB_SIM_HANDSHAKE_NoResponse;
+
+	switch (Token)
+	{
+		case USB_SIM_TOKEN_SETUP:
+			return USB_VirtualHost_SendOUT(EndpointAddress, Buffer, *Length, true);
+		case USB_SIM_TOKEN_OUT:
+			return USB_VirtualHost_SendOUT(EndpointAddress, Buffer, *Length, false);
+		default:
+			return USB_VirtualHost_ReceiveIN(EndpointAddress, Buffer, *Length, Length);
+	}
+}
+
+const USB_SIM_DevicePort_t USB_VirtualHost_LoopbackPort =
+	{
+		.Start              = USB_VirtualHost_LoopbackStart,
+		.Run                = USB_VirtualHost_LoopbackRun,
+		.IsAttached         = USB_VirtualHost_LoopbackIsAttached,
+		.IsFullSpeed        = USB_VirtualHost_LoopbackIsFullSpeed,
+		.IsRemoteWakeupSent = USB_VirtualHost_LoopbackIsRemoteWakeupSent,
+		.BusEvent           = USB_VirtualHost_LoopbackBusEvent,
+		.StartOfFrame       = USB_VirtualHost_LoopbackStartOfFrame,
+		.Transaction        = USB_VirtualHost_LoopbackTransaction,
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,248 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Scripted virtual USB host for the host-native simulated architecture.
+ *  \copydetails Group_VirtualHost_SIM
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USB
+ *  \defgroup Group_VirtualHost_SIM Scripted Virtual Host (SIM)
+ *  \brief Scripted virtual USB host for the host-native simulated architecture.
+ *
+ *  When the library is compiled for the host-native simulated architecture (\c ARCH_SIM), the device mode stack
+ *  is connected to an in-memory virtual host in place of a physical USB bus. The virtual host executes a queue of
+ *  user submitted control, bulk, interrupt and isochronous transfers against the device's endpoints, one packet
+ *  transaction at a time, each time the simulated controller is polled by the stack. As the virtual host is
+ *  advanced synchronously from the stack's own polling points, a given script always produces the same sequence
+ *  of packets, allowing the per-transfer cost and throughput of the stack and class drivers to be measured
+ *  deterministically on the build machine.
+ *
+ *  The virtual host issues a bus reset to the device each time the device attaches to the bus. Once the reset has
+ *  been processed and no transfers remain queued, the \ref EVENT_USB_VirtualHost_Idle() event is fired from each
+ *  poll of the controller, from which the next transfers of the script may be submitted, or the process ended.
+ *
+ *  As an alternative to a transfer script, a device mode build of the library may instead be driven by a host mode
+ *  build of the library in the same process, through the loopback port described in \ref Group_Loopback_SIM. In
+ *  this case the virtual host is inactive, and the device's bus events, frames and packets are all sourced from the
+ *  host mode stack.
+ *
+ *  Usage Example:
+ *  \code
+ *		static uint8_t DeviceDescriptor[18];
+ *
+ *		static USB_VirtualHost_Transfer_t Script[] =
+ *			{
+ *				{
+ *					.Type    = EP_TYPE_CONTROL,
+ *					.Request =
+ *						{
+ *							.bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE),
+ *							.bRequest      = REQ_GetDescriptor,
+ *							.wValue        = (DTYPE_Device << 8),
+ *							.wIndex        = 0,
+ *							.wLength       = sizeof(DeviceDescriptor),
+ *						},
+ *					.Buffer  = DeviceDescriptor,
+ *				},
+ *				{
+ *					.Type    = EP_TYPE_CONTROL,
+ *					.Request =
+ *						{
+ *							.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+ *							.bRequest      = REQ_SetConfiguration,
+ *							.wValue        = 1,
+ *						},
+ *				},
+ *			};
+ *
+ *		void EVENT_USB_VirtualHost_Idle(void)
+ *		{
+ *			static bool ScriptSubmitted = false;
+ *
+ *			if (ScriptSubmitted)
+ *			  exit(0);
+ *
+ *			USB_VirtualHost_SubmitScript(Script, (sizeof(Script) / sizeof(Script[0])));
+ *			ScriptSubmitted = true;
+ *		}
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __VIRTUALHOST_SIM_H__
+#define __VIRTUALHOST_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+		#include "../StdRequestType.h"
+		#include "USBRegisters_SIM.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Enums: */
+			/** Enum for the possible status codes of a \ref USB_VirtualHost_Transfer_t transfer. */
+			enum USB_VirtualHost_TransferStatus_t
+			{
+				VIRTUALHOST_STATUS_Queued           = 0, /**< Transfer is queued, but not yet started. */
+				VIRTUALHOST_STATUS_Active           = 1, /**< Transfer is currently being executed. */
+				VIRTUALHOST_STATUS_Complete         = 2, /**< Transfer completed successfully. */
+				VIRTUALHOST_STATUS_Stalled          = 3, /**< Transfer was aborted by a STALL handshake from the device. */
+				VIRTUALHOST_STATUS_NoResponse       = 4, /**< Transfer was aborted as the target endpoint is not configured. */
+				VIRTUALHOST_STATUS_Disconnected     = 5, /**< Transfer was aborted due to the device detaching from the bus. */
+			};
+
+		/* Type Defines: */
+			/** Type define for a transfer executed by the virtual host. The caller fills in the transfer request
+			 *  elements before submission via \ref USB_VirtualHost_Submit(); the result elements are filled in by
+			 *  the virtual host as the transfer executes. The transfer must remain valid until it has completed.
+			 */
+			typedef struct USB_VirtualHost_Transfer
+			{
+				uint8_t              Type; /**< Type of the transfer, a \c EP_TYPE_* mask. */
+				uint8_t              Address; /**< Address of the target endpoint in the device, including the
+				                               *   \c ENDPOINT_DIR_* direction mask. Ignored for control transfers,
+				                               *   which always target the default control endpoint.
+				                               */
+				USB_Request_Header_t Request; /**< SETUP request issued to the device, for control transfers. */
+				void*                Buffer; /**< Buffer to source data from (OUT) or store data into (IN). May be
+				                              *   \c NULL for IN transfers if the data is to be discarded.
+				                              */
+				uint16_t             Length; /**< Length of the transfer data stage, in bytes. For control transfers,
+				                              *   this is taken from the \c wLength element of the request.
+				                              */
+				uint8_t              Interval; /**< Polling interval in frames, for interrupt and isochronous transfers. */
+				void                 (*Callback)(struct USB_VirtualHost_Transfer* const Transfer); /**< Optional
+				                                                                                    *   routine to call
+				                                                                                    *   on completion.
+				                                                                                    */
+
+				uint8_t              Status; /**< Current status of the transfer, a value from the
+				                              *   \ref USB_VirtualHost_TransferStatus_t enum.
+				                              */
+				uint16_t             BytesTransferred; /**< Number of data stage bytes transferred. */
+				uint16_t             Packets; /**< Number of data stage packets transferred. */
+				uint16_t             NAKs; /**< Number of data stage transactions the device was not ready for. */
+				uint32_t             StartFrame; /**< Simulated frame count at which the transfer started. */
+				uint32_t             EndFrame; /**< Simulated frame count at which the transfer completed. */
+
+				#if !defined(__DOXYGEN__)
+				uint8_t              Stage;
+				uint32_t             NextFrame;
+				struct USB_VirtualHost_Transfer* Next;
+				#endif
+			} USB_VirtualHost_Transfer_t;
+
+		/* Function Prototypes: */
+			/** Queues a transfer for execution by the virtual host, after all previously submitted transfers have
+			 *  completed.
+			 *
+			 *  \param[in,out] Transfer  Pointer to the transfer to queue.
+			 */
+			void USB_VirtualHost_Submit(USB_VirtualHost_Transfer_t* const Transfer) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Queues a table of transfers for execution by the virtual host, in sequence.
+			 *
+			 *  \param[in,out] Script   Pointer to a table of transfers to queue.
+			 *  \param[in]     Entries  Number of entries in the transfer table.
+			 */
+			void USB_VirtualHost_SubmitScript(USB_VirtualHost_Transfer_t* const Script,
+			                                  const uint8_t Entries) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Signals a bus reset to the device, as issued by a host to begin enumeration. */
+			void USB_VirtualHost_ResetBus(void);
+
+			/** Suspends the bus, halting the simulated frames and the execution of queued transfers until the bus is
+			 *  resumed via \ref USB_VirtualHost_ResumeBus(), or by a remote wakeup request from the device.
+			 */
+			void USB_VirtualHost_SuspendBus(void);
+
+			/** Resumes the bus after a previous call to \ref USB_VirtualHost_SuspendBus(). */
+			void USB_VirtualHost_ResumeBus(void);
+
+			/** Determines if the virtual host has no transfers queued or in progress.
+			 *
+			 *  \return Boolean \c true if no transfers remain queued, \c false otherwise.
+			 */
+			bool USB_VirtualHost_IsIdle(void) ATTR_WARN_UNUSED_RESULT;
+
+		/* Inline Functions: */
+			/** Retrieves the total number of simulated 1ms frames that have elapsed since the USB interface was
+			 *  initialized, for the measurement of throughput in simulated time.
+			 *
+			 *  \return Number of simulated frames elapsed.
+			 */
+			ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT
+			static inline uint32_t USB_VirtualHost_GetFrameCount(void)
+			{
+				return USB_SIM.FrameCount;
+			}
+
+		/* Events: */
+			/** Event for the virtual host becoming idle. This event fires from each poll of the simulated controller
+			 *  while the device is attached to the bus and no transfers remain queued, so that the next transfers of
+			 *  the user script may be submitted.
+			 *
+			 *  \note This event may be left unimplemented in the user application, in which case no transfers will be
+			 *        executed unless submitted elsewhere.
+			 */
+			void EVENT_USB_VirtualHost_Idle(void);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* External Variables: */
+			extern const USB_SIM_DevicePort_t USB_VirtualHost_LoopbackPort;
+
+		/* Function Prototypes: */
+			void USB_VirtualHost_ProcessNextTransaction(void);
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -194,6 +194,190 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#include "Template/Template_Endpoint_RW.c"
 #endif
 
+#if defined(ASYNC_ENDPOINT_TRANSFERS)
+typedef struct
+{
+	uint8_t*                 Buffer;
+	uint16_t                 Length;
+	uint16_t                 BytesTransferred;
+	Endpoint_AsyncCallback_t Callback;
+	uint8_t                  Address;
+	uint8_t                  Options;
+	volatile uint8_t         Status;
+} Endpoint_AsyncTransfer_t;
+
+static Endpoint_AsyncTransfer_t Endpoint_AsyncTransfers[ENDPOINT_TOTAL_ENDPOINTS];
+
+static void Endpoint_FinishAsync(Endpoint_AsyncTransfer_t* const Transfer,
+                                 const uint8_t Status)
+{
+	if (Transfer->Address & ENDPOINT_DIR_IN)
+	  (&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].txinec  = true;
+	else
+	  (&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].rxoutec = true;
+
+	AVR32_USBB.udinteclr = (AVR32_USBB_UDINTECLR_EP0INTEC_MASK << USB_Endpoint_SelectedEndpoint);
+
+	Transfer->Status = Status;
+
+	if (Transfer->Callback != NULL)
+	  Transfer->Callback(Transfer->Address, Status, Transfer->BytesTransferred);
+}
+
+bool Endpoint_SubmitAsync(const uint8_t Address,
+                          void* const Buffer,
+                          const uint16_t Length,
+                          const uint8_t Options,
+                          const Endpoint_AsyncCallback_t Callback)
+{
+	uint8_t EPNum = (Address & ENDPOINT_EPNUM_MASK);
+
+	if ((EPNum == ENDPOINT_CONTROLEP) || (EPNum >= ENDPOINT_TOTAL_ENDPOINTS))
+	  return false;
+
+	Endpoint_AsyncTransfer_t* Transfer = &Endpoint_AsyncTransfers[EPNum];
+
+	if (Transfer->Status == ENDPOINT_ASYNC_InProgress)
+	  return false;
+
+	Transfer->Buffer           = (uint8_t*)Buffer;
+	Transfer->Length           = Length;
+	Transfer->BytesTransferred = 0;
+	Transfer->Callback         = Callback;
+	Transfer->Address          = Address;
+	Transfer->Options          = Options;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	Transfer->Status = ENDPOINT_ASYNC_InProgress;
+
+	Endpoint_SelectEndpoint(Address);
+
+	if (Address & ENDPOINT_DIR_IN)
+	  (&AVR32_USBB.UECON0SET)[USB_Endpoint_SelectedEndpoint].txines  = true;
+	else
+	  (&AVR32_USBB.UECON0SET)[USB_Endpoint_SelectedEndpoint].rxoutes = true;
+
+	AVR32_USBB.udinteset = (AVR32_USBB_UDINTESET_EP0INTES_MASK << USB_Endpoint_SelectedEndpoint);
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return true;
+}
+
+uint8_t Endpoint_GetAsyncStatus(const uint8_t Address,
+                                uint16_t* const BytesTransferred)
+{
+	uint8_t EPNum = (Address & ENDPOINT_EPNUM_MASK);
+
+	if ((EPNum == ENDPOINT_CONTROLEP) || (EPNum >= ENDPOINT_TOTAL_ENDPOINTS))
+	  return ENDPOINT_ASYNC_Idle;
+
+	Endpoint_AsyncTransfer_t* Transfer = &Endpoint_AsyncTransfers[EPNum];
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t Status = Transfer->Status;
+
+	if (BytesTransferred != NULL)
+	  *BytesTransferred = Transfer->BytesTransferred;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return Status;
+}
+
+void Endpoint_CancelAsync(const uint8_t Address)
+{
+	uint8_t EPNum = (Address & ENDPOINT_EPNUM_MASK);
+
+	if ((EPNum == ENDPOINT_CONTROLEP) || (EPNum >= ENDPOINT_TOTAL_ENDPOINTS))
+	  return;
+
+	Endpoint_AsyncTransfer_t* Transfer = &Endpoint_AsyncTransfers[EPNum];
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	if (Transfer->Status == ENDPOINT_ASYNC_InProgress)
+	{
+		uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+		Endpoint_SelectEndpoint(Transfer->Address);
+		Endpoint_FinishAsync(Transfer, ENDPOINT_ASYNC_Cancelled);
+		Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void Endpoint_AbortAsyncTransfers(void)
+{
+	for (uint8_t EPNum = 1; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	  Endpoint_CancelAsync(EPNum);
+}
+
+void Endpoint_ProcessAsyncTransfers(void)
+{
+	for (uint8_t EPNum = 1; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	{
+		Endpoint_AsyncTransfer_t* Transfer = &Endpoint_AsyncTransfers[EPNum];
+
+		if (Transfer->Status != ENDPOINT_ASYNC_InProgress)
+		  continue;
+
+		Endpoint_SelectEndpoint(Transfer->Address);
+
+		uint8_t* DataStream     = &Transfer->Buffer[Transfer->BytesTransferred];
+		uint16_t BytesRemaining = (Transfer->Length - Transfer->BytesTransferred);
+
+		if (Transfer->Address & ENDPOINT_DIR_IN)
+		{
+			if (!(Endpoint_IsINReady()))
+			  continue;
+
+			/* Send a zero length packet if all the data has been sent but the last packet was full, or the transfer is empty */
+			if (!(BytesRemaining))
+			{
+				Endpoint_ClearIN();
+				Endpoint_FinishAsync(Transfer, ENDPOINT_ASYNC_Complete);
+				continue;
+			}
+
+			Transfer->BytesTransferred += Endpoint_Write_Bank(DataStream, BytesRemaining);
+
+			bool FullPacket = (Endpoint_BytesInEndpoint() == Endpoint_GetEndpointSize_Prv());
+
+			Endpoint_ClearIN();
+
+			if ((Transfer->BytesTransferred == Transfer->Length) && !(FullPacket && (Transfer->Options & ENDPOINT_ASYNC_OPT_SEND_ZLP)))
+			  Endpoint_FinishAsync(Transfer, ENDPOINT_ASYNC_Complete);
+		}
+		else
+		{
+			if (!(Endpoint_IsOUTReceived()))
+			  continue;
+
+			bool ShortPacket = (Endpoint_BytesInEndpoint() < Endpoint_GetEndpointSize_Prv());
+
+			Transfer->BytesTransferred += Endpoint_Read_Bank(DataStream, BytesRemaining);
+
+			if (!(Endpoint_BytesInEndpoint()))
+			  Endpoint_ClearOUT();
+
+			if (ShortPacket || (Transfer->BytesTransferred == Transfer->Length))
+			  Endpoint_FinishAsync(Transfer, ENDPOINT_ASYNC_Complete);
+		}
+	}
+}
+#endif
+
 #endif
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Control_Stream_LE
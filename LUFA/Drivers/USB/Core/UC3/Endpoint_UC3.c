@@ -121,6 +121,34 @@ void Endpoint_ClearEndpoints(void)
 	}
 }
 
+uint16_t Endpoint_Write_Bank(const void* const Buffer,
+                             uint16_t Length)
+{
+	uint16_t BytesInBank = Endpoint_BytesRemainingInBank();
+
+	if (Length > BytesInBank)
+	  Length = BytesInBank;
+
+	memcpy(Endpoint_GetBankPointer(), Buffer, Length);
+	Endpoint_CommitBank(Length);
+
+	return Length;
+}
+
+uint16_t Endpoint_Read_Bank(void* const Buffer,
+                            uint16_t Length)
+{
+	uint16_t BytesInBank = Endpoint_BytesRemainingInBank();
+
+	if (Length > BytesInBank)
+	  Length = BytesInBank;
+
+	memcpy(Buffer, Endpoint_GetBankPointer(), Length);
+	Endpoint_CommitBank(Length);
+
+	return Length;
+}
+
 void Endpoint_ClearStatusStage(void)
 {
 	if (USB_ControlRequest.bmRequestType & REQDIR_DEVICETOHOST)
@@ -176,7 +204,12 @@ uint8_t Endpoint_WaitUntilReady(void)
 		else if (USB_DeviceState_LCL == DEVICE_STATE_Suspended)
 		  return ENDPOINT_READYWAIT_BusSuspended;
 		else if (Endpoint_IsStalled())
-		  return ENDPOINT_READYWAIT_EndpointStalled;
+		{
+			USB_PROFILE_ENDPOINT(Stalls, 1);
+			return ENDPOINT_READYWAIT_EndpointStalled;
+		}
+
+		USB_PROFILE_ENDPOINT(BusyWaitIterations, 1);
 
 		uint16_t CurrentFrameNumber = USB_Device_GetFrameNumber();
 
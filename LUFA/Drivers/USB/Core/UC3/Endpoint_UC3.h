@@ -92,6 +92,10 @@
 		/* Macros: */
 			#define ENDPOINT_HSB_ADDRESS_SPACE_SIZE            (64 * 1024UL)
 
+		/* External Variables: */
+			extern volatile uint32_t USB_Endpoint_SelectedEndpoint;
+			extern volatile uint8_t* USB_Endpoint_FIFOPos[];
+
 		/* Inline Functions: */
 			static inline uint32_t Endpoint_BytesToEPSizeMask(const uint16_t Bytes) ATTR_WARN_UNUSED_RESULT ATTR_CONST
 			                                                                        ATTR_ALWAYS_INLINE;
@@ -109,14 +113,16 @@
 				return (MaskVal << AVR32_USBB_EPSIZE_OFFSET);
 			}
 
+			static inline uint16_t Endpoint_GetEndpointSize_Prv(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetEndpointSize_Prv(void)
+			{
+				return (8 << (&AVR32_USBB.UECFG0)[USB_Endpoint_SelectedEndpoint].epsize);
+			}
+
 		/* Function Prototypes: */
 			void Endpoint_ClearEndpoints(void);
 			bool Endpoint_ConfigureEndpoint_Prv(const uint8_t Number,
 			                                    const uint32_t UECFGXData);
-
-		/* External Variables: */
-			extern volatile uint32_t USB_Endpoint_SelectedEndpoint;
-			extern volatile uint8_t* USB_Endpoint_FIFOPos[];
 	#endif
 
 	/* Public Interface - May be used in end-application: */
@@ -128,6 +134,11 @@
 				#define ENDPOINT_CONTROLEP_DEFAULT_SIZE     8
 			#endif
 
+			/** Indicates that the endpoint banks of the architecture are directly addressable, so that their contents
+			 *  may be accessed in place via \ref Endpoint_GetBankPointer() and \ref Endpoint_CommitBank().
+			 */
+			#define ENDPOINT_HAS_BANK_POINTER
+
 			#if !defined(CONTROL_ONLY_DEVICE) || defined(__DOXYGEN__)
 				#if defined(USB_SERIES_UC3A3_AVR32) || defined(USB_SERIES_UC3A4_AVR32)
 					#define ENDPOINT_TOTAL_ENDPOINTS        8
@@ -242,6 +253,23 @@
 				return ((&AVR32_USBB.UECFG0)[USB_Endpoint_SelectedEndpoint].epdir ? ENDPOINT_DIR_IN : ENDPOINT_DIR_OUT);
 			}
 
+			/** Indicates the number of bytes which may still be transferred through the currently selected endpoint's
+			 *  bank before it must be cleared. For OUT direction endpoints this is the number of unread bytes remaining
+			 *  in the bank, and for IN direction endpoints it is the amount of free space left in the bank.
+			 *
+			 *  \ingroup Group_EndpointRW_UC3
+			 *
+			 *  \return Number of bytes which may be read from or written to the currently selected endpoint's bank.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint16_t Endpoint_BytesRemainingInBank(void)
+			{
+				if (Endpoint_GetEndpointDirection() == ENDPOINT_DIR_OUT)
+				  return Endpoint_BytesInEndpoint();
+
+				return (Endpoint_GetEndpointSize_Prv() - Endpoint_BytesInEndpoint());
+			}
+
 			/** Get the endpoint address of the currently selected endpoint. This is typically used to save
 			 *  the currently selected endpoint so that it can be restored after another endpoint has been
 			 *  manipulated.
@@ -455,6 +483,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Endpoint_ClearIN(void)
 			{
+				USB_PROFILE_ENDPOINT(Packets, 1);
+
 				(&AVR32_USBB.UESTA0CLR)[USB_Endpoint_SelectedEndpoint].txinic   = true;
 				(&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].fifoconc = true;
 				USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint] = &AVR32_USBB_SLAVE[USB_Endpoint_SelectedEndpoint * ENDPOINT_HSB_ADDRESS_SPACE_SIZE];
@@ -468,6 +498,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Endpoint_ClearOUT(void)
 			{
+				USB_PROFILE_ENDPOINT(Packets, 1);
+
 				(&AVR32_USBB.UESTA0CLR)[USB_Endpoint_SelectedEndpoint].rxoutic  = true;
 				(&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].fifoconc = true;
 				USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint] = &AVR32_USBB_SLAVE[USB_Endpoint_SelectedEndpoint * ENDPOINT_HSB_ADDRESS_SPACE_SIZE];
@@ -727,6 +759,34 @@
 				(void)Dummy;
 			}
 
+			/** Retrieves a pointer to the next unread or unwritten byte in the currently selected endpoint's bank,
+			 *  allowing the bank contents to be parsed or constructed in place without an intermediate copy. Up to
+			 *  \ref Endpoint_BytesRemainingInBank() bytes may be accessed through the returned pointer, after which
+			 *  the number of bytes consumed or produced must be committed via \ref Endpoint_CommitBank().
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_UC3
+			 *
+			 *  \return Pointer to the current position in the currently selected endpoint's bank.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint8_t* Endpoint_GetBankPointer(void)
+			{
+				return (uint8_t*)USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint];
+			}
+
+			/** Advances the current position in the currently selected endpoint's bank after data has been read from
+			 *  or written to it directly via a pointer obtained from \ref Endpoint_GetBankPointer().
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_UC3
+			 *
+			 *  \param[in] Length  Number of bytes read from or written to the bank.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void Endpoint_CommitBank(const uint16_t Length)
+			{
+				USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint] += Length;
+			}
+
 		/* External Variables: */
 			/** Global indicating the maximum packet size of the default control endpoint located at address
 			 *  0 in the device. This value is set to the value indicated in the device descriptor in the user
@@ -750,6 +810,34 @@
 			#endif
 
 		/* Function Prototypes: */
+			/** Writes a block of data into the currently selected endpoint's bank in a single burst, for IN direction
+			 *  endpoints. The data is copied up to the end of the current bank, and the number of bytes copied is
+			 *  returned; the bank is not automatically cleared once full, nor is the endpoint waited upon.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_UC3
+			 *
+			 *  \param[in] Buffer  Pointer to the source data buffer to read from.
+			 *  \param[in] Length  Number of bytes to write into the bank.
+			 *
+			 *  \return Number of bytes actually written into the bank.
+			 */
+			uint16_t Endpoint_Write_Bank(const void* const Buffer,
+			                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Reads a block of data from the currently selected endpoint's bank in a single burst, for OUT direction
+			 *  endpoints. The data is copied up to the end of the current bank, and the number of bytes copied is
+			 *  returned; the bank is not automatically cleared once empty, nor is the endpoint waited upon.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_UC3
+			 *
+			 *  \param[out] Buffer  Pointer to the destination data buffer to write to.
+			 *  \param[in]  Length  Maximum number of bytes to read from the bank.
+			 *
+			 *  \return Number of bytes actually read from the bank.
+			 */
+			uint16_t Endpoint_Read_Bank(void* const Buffer,
+			                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
 			/** Configures a table of endpoint descriptions, in sequence. This function can be used to configure multiple
 			 *  endpoints at the same time.
 			 *
@@ -188,10 +188,15 @@ uint8_t Pipe_WaitUntilReady(void)
 		}
 
 		if (Pipe_IsStalled())
-		  return PIPE_READYWAIT_PipeStalled;
+		{
+			USB_PROFILE_PIPE(Stalls, 1);
+			return PIPE_READYWAIT_PipeStalled;
+		}
 		else if (USB_HostState == HOST_STATE_Unattached)
 		  return PIPE_READYWAIT_DeviceDisconnected;
 
+		USB_PROFILE_PIPE(BusyWaitIterations, 1);
+
 		uint16_t CurrentFrameNumber = USB_Host_GetFrameNumber();
 
 		if (CurrentFrameNumber != PreviousFrameNumber)
@@ -527,6 +527,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Pipe_ClearIN(void)
 			{
+				USB_PROFILE_PIPE(Packets, 1);
+
 				(&AVR32_USBB.UPSTA0CLR)[USB_Pipe_SelectedPipe].rxinic   = true;
 				(&AVR32_USBB.UPCON0CLR)[USB_Pipe_SelectedPipe].fifoconc = true;
 				USB_Pipe_FIFOPos[USB_Pipe_SelectedPipe] = &AVR32_USBB_SLAVE[USB_Pipe_SelectedPipe * PIPE_HSB_ADDRESS_SPACE_SIZE];
@@ -540,6 +542,8 @@
 			ATTR_ALWAYS_INLINE
 			static inline void Pipe_ClearOUT(void)
 			{
+				USB_PROFILE_PIPE(Packets, 1);
+
 				(&AVR32_USBB.UPSTA0CLR)[USB_Pipe_SelectedPipe].txoutic  = true;
 				(&AVR32_USBB.UPCON0CLR)[USB_Pipe_SelectedPipe].fifoconc = true;
 				USB_Pipe_FIFOPos[USB_Pipe_SelectedPipe] = &AVR32_USBB_SLAVE[USB_Pipe_SelectedPipe * PIPE_HSB_ADDRESS_SPACE_SIZE];
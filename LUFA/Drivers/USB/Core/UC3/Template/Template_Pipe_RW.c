@@ -58,11 +58,15 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 			if (BytesProcessed != NULL)
 			{
 				*BytesProcessed += BytesInTransfer;
+				USB_PROFILE_PIPE(BytesTransferred, BytesInTransfer);
 				return PIPE_RWSTREAM_IncompleteTransfer;
 			}
 
 			if ((ErrorCode = Pipe_WaitUntilReady()))
-			  return ErrorCode;
+			{
+				USB_PROFILE_PIPE(BytesTransferred, BytesInTransfer);
+				return ErrorCode;
+			}
 		}
 		else
 		{
@@ -73,6 +77,8 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 		}
 	}
 
+	USB_PROFILE_PIPE(BytesTransferred, BytesInTransfer);
+
 	return PIPE_RWSTREAM_NoError;
 }
 
@@ -76,6 +76,11 @@ ISR(USB_GEN_vect)
 		else
 		{
 			USB_DeviceState = DEVICE_STATE_Unattached;
+
+			#if defined(ASYNC_ENDPOINT_TRANSFERS)
+			Endpoint_AbortAsyncTransfers();
+			#endif
+
 			EVENT_USB_Device_Disconnect();
 		}
 	}
@@ -115,6 +120,10 @@ ISR(USB_GEN_vect)
 		USB_DeviceState                = DEVICE_STATE_Default;
 		USB_Device_ConfigurationNumber = 0;
 
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
 		USB_INT_Clear(USB_INT_SUSPI);
 		USB_INT_Disable(USB_INT_SUSPI);
 		USB_INT_Enable(USB_INT_WAKEUPI);
@@ -129,6 +138,18 @@ ISR(USB_GEN_vect)
 
 		EVENT_USB_Device_Reset();
 	}
+
+	#if defined(ASYNC_ENDPOINT_TRANSFERS)
+	/* The endpoint interrupts share this vector with the bus events, so pending asynchronous transfers are advanced here */
+	if (USB_CurrentMode == USB_MODE_Device)
+	{
+		uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+		Endpoint_ProcessAsyncTransfers();
+
+		Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+	}
+	#endif
 	#endif
 
 	#if defined(USB_CAN_BE_HOST)
@@ -155,6 +155,9 @@
 		 */
 		#define USB_SERIES_C4_XMEGA
 
+		/** Indicates that the target is the host-native simulated USB controller (i.e. \c ARCH_SIM) when defined. */
+		#define USB_SERIES_SIM
+
 		/** Indicates that the target microcontroller and compilation settings allow for the
 		 *  target to be configured in USB Device mode when defined.
 		 */
@@ -245,6 +248,10 @@
 			#elif (defined(__AVR_ATxmega16C4__) || defined(__AVR_ATxmega32C4__))
 				#define USB_SERIES_C4_XMEGA
 				#define USB_CAN_BE_DEVICE
+			#elif (ARCH == ARCH_SIM)
+				#define USB_SERIES_SIM
+				#define USB_CAN_BE_DEVICE
+				#define USB_CAN_BE_HOST
 			#endif
 
 			#if (defined(USB_HOST_ONLY) && defined(USB_DEVICE_ONLY))
@@ -45,6 +45,14 @@ volatile uint8_t     USB_DeviceState;
 
 void USB_USBTask(void)
 {
+	#if (ARCH == ARCH_SIM)
+		USB_Controller_Poll();
+	#endif
+
+	#if defined(LUFA_ENABLE_PROFILING)
+		USB_Profiling_RecordTaskInterval();
+	#endif
+
 	#if defined(USB_CAN_BE_BOTH)
 		if (USB_CurrentMode == USB_MODE_Device)
 		  USB_DeviceTask();
@@ -647,6 +647,74 @@
 			                                          uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
 			/**@}*/
 
+			#if defined(ASYNC_ENDPOINT_TRANSFERS) || defined(__DOXYGEN__)
+			/** \name Asynchronous transfer functions */
+			/**@{*/
+
+			/** Submits a buffer for transfer through the given non-control endpoint, without waiting for the transfer
+			 *  to complete. The transfer is advanced one bank at a time from within the USB controller interrupt, so
+			 *  that the main application loop is not blocked; the given buffer must therefore remain valid until the
+			 *  transfer has completed or been cancelled.
+			 *
+			 *  IN transfers are split into packets of the endpoint's bank size, with each packet sent to the host as it
+			 *  is filled, followed by a zero length packet if requested via the \ref ENDPOINT_ASYNC_OPT_SEND_ZLP option
+			 *  and the last packet was full. OUT transfers complete once the requested length has been received, or a
+			 *  short packet has been received from the host.
+			 *
+			 *  Only one asynchronous transfer may be pending on each endpoint number at any one time, and the endpoint
+			 *  should not be accessed via the other endpoint read and write functions while a transfer is pending.
+			 *
+			 *  \note This function is only available when the \c ASYNC_ENDPOINT_TRANSFERS token is defined.
+			 *
+			 *  \param[in]     Address   Address of the non-control endpoint to submit the transfer on.
+			 *  \param[in,out] Buffer    Pointer to the buffer to transfer from (IN endpoints) or to (OUT endpoints).
+			 *  \param[in]     Length    Length of the transfer, in bytes.
+			 *  \param[in]     Options   Mask of \c ENDPOINT_ASYNC_OPT_* options for the transfer.
+			 *  \param[in]     Callback  Optional callback to run once the transfer completes or is cancelled, or \c NULL
+			 *                           if the transfer status is to be polled via \ref Endpoint_GetAsyncStatus().
+			 *
+			 *  \return Boolean \c true if the transfer was queued, \c false if the endpoint is invalid or already busy.
+			 */
+			bool Endpoint_SubmitAsync(const uint8_t Address,
+			                          void* const Buffer,
+			                          const uint16_t Length,
+			                          const uint8_t Options,
+			                          const Endpoint_AsyncCallback_t Callback) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Retrieves the current status of the last asynchronous transfer submitted on the given endpoint.
+			 *
+			 *  \note This function is only available when the \c ASYNC_ENDPOINT_TRANSFERS token is defined.
+			 *
+			 *  \param[in]  Address           Address of the endpoint to check.
+			 *  \param[out] BytesTransferred  Optional location where the number of bytes transferred so far is stored,
+			 *                                or \c NULL if not required.
+			 *
+			 *  \return A value from the \ref Endpoint_AsyncStatus_t enum.
+			 */
+			uint8_t Endpoint_GetAsyncStatus(const uint8_t Address,
+			                                uint16_t* const BytesTransferred);
+
+			/** Cancels any pending asynchronous transfer on the given endpoint. If a transfer was pending, its completion
+			 *  callback (if any) is run with a status of \ref ENDPOINT_ASYNC_Cancelled before this function returns.
+			 *
+			 *  \note This function is only available when the \c ASYNC_ENDPOINT_TRANSFERS token is defined.
+			 *
+			 *  \param[in] Address  Address of the endpoint whose pending transfer is to be cancelled.
+			 */
+			void Endpoint_CancelAsync(const uint8_t Address);
+
+			/**@}*/
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(ASYNC_ENDPOINT_TRANSFERS)
+			void Endpoint_ProcessAsyncTransfers(void);
+			void Endpoint_AbortAsyncTransfers(void);
+			#endif
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -144,6 +144,12 @@
 				return (MaskVal << USB_EP_BUFSIZE_gp);
 			}
 
+			static inline uint16_t Endpoint_GetEndpointSize_Prv(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetEndpointSize_Prv(void)
+			{
+				return (8 << ((USB_Endpoint_SelectedHandle->CTRL & USB_EP_BUFSIZE_gm) >> USB_EP_BUFSIZE_gp));
+			}
+
 		/* Function Prototypes: */
 			bool Endpoint_ConfigureEndpoint_PRV(const uint8_t Address,
 			                                    const uint8_t Config,
@@ -160,6 +166,11 @@
 				#define ENDPOINT_CONTROLEP_DEFAULT_SIZE     8
 			#endif
 
+			/** Indicates that the endpoint banks of the architecture are directly addressable, so that their contents
+			 *  may be accessed in place via \ref Endpoint_GetBankPointer() and \ref Endpoint_CommitBank().
+			 */
+			#define ENDPOINT_HAS_BANK_POINTER
+
 		/* Enums: */
 			/** Enum for the possible error return codes of the \ref Endpoint_WaitUntilReady() function.
 			 *
@@ -270,6 +281,20 @@
 				  return (USB_Endpoint_SelectedFIFO->Length - USB_Endpoint_SelectedFIFO->Position);
 			}
 
+			/** Indicates the number of bytes which may still be transferred through the currently selected endpoint's
+			 *  bank before it must be cleared. For OUT direction endpoints this is the number of unread bytes remaining
+			 *  in the bank, and for IN direction endpoints it is the amount of free space left in the bank.
+			 *
+			 *  \ingroup Group_EndpointRW_XMEGA
+			 *
+			 *  \return Number of bytes which may be read from or written to the currently selected endpoint's bank.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint16_t Endpoint_BytesRemainingInBank(void)
+			{
+				return (USB_Endpoint_SelectedFIFO->Length - USB_Endpoint_SelectedFIFO->Position);
+			}
+
 			/** Get the endpoint address of the currently selected endpoint. This is typically used to save
 			 *  the currently selected endpoint so that it can be restored after another endpoint has been
 			 *  manipulated.
@@ -622,6 +647,34 @@
 				Endpoint_Discard_8();
 			}
 
+			/** Retrieves a pointer to the next unread or unwritten byte in the currently selected endpoint's bank,
+			 *  allowing the bank contents to be parsed or constructed in place without an intermediate copy. Up to
+			 *  \ref Endpoint_BytesRemainingInBank() bytes may be accessed through the returned pointer, after which
+			 *  the number of bytes consumed or produced must be committed via \ref Endpoint_CommitBank().
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_XMEGA
+			 *
+			 *  \return Pointer to the current position in the currently selected endpoint's bank.
+			 */
+			ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE
+			static inline uint8_t* Endpoint_GetBankPointer(void)
+			{
+				return (uint8_t*)&USB_Endpoint_SelectedFIFO->Data[USB_Endpoint_SelectedFIFO->Position];
+			}
+
+			/** Advances the current position in the currently selected endpoint's bank after data has been read from
+			 *  or written to it directly via a pointer obtained from \ref Endpoint_GetBankPointer().
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_XMEGA
+			 *
+			 *  \param[in] Length  Number of bytes read from or written to the bank.
+			 */
+			ATTR_ALWAYS_INLINE
+			static inline void Endpoint_CommitBank(const uint16_t Length)
+			{
+				USB_Endpoint_SelectedFIFO->Position += Length;
+			}
+
 		/* External Variables: */
 			/** Global indicating the maximum packet size of the default control endpoint located at address
 			 *  0 in the device. This value is set to the value indicated in the device descriptor in the user
@@ -645,6 +698,34 @@
 			#endif
 
 		/* Function Prototypes: */
+			/** Writes a block of data into the currently selected endpoint's bank in a single burst, for IN direction
+			 *  endpoints. The data is copied up to the end of the current bank, and the number of bytes copied is
+			 *  returned; the bank is not automatically cleared once full, nor is the endpoint waited upon.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_XMEGA
+			 *
+			 *  \param[in] Buffer  Pointer to the source data buffer to read from.
+			 *  \param[in] Length  Number of bytes to write into the bank.
+			 *
+			 *  \return Number of bytes actually written into the bank.
+			 */
+			uint16_t Endpoint_Write_Bank(const void* const Buffer,
+			                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Reads a block of data from the currently selected endpoint's bank in a single burst, for OUT direction
+			 *  endpoints. The data is copied up to the end of the current bank, and the number of bytes copied is
+			 *  returned; the bank is not automatically cleared once empty, nor is the endpoint waited upon.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_XMEGA
+			 *
+			 *  \param[out] Buffer  Pointer to the destination data buffer to write to.
+			 *  \param[in]  Length  Maximum number of bytes to read from the bank.
+			 *
+			 *  \return Number of bytes actually read from the bank.
+			 */
+			uint16_t Endpoint_Read_Bank(void* const Buffer,
+			                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+
 			/** Configures a table of endpoint descriptions, in sequence. This function can be used to configure multiple
 			 *  endpoints at the same time.
 			 *
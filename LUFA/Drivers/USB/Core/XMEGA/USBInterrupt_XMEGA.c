@@ -63,6 +63,11 @@ ISR(USB_BUSEVENT_vect)
 
 		#if !defined(NO_LIMITED_CONTROLLER_CONNECT)
 		USB_DeviceState = DEVICE_STATE_Unattached;
+
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
 		EVENT_USB_Device_Disconnect();
 		#else
 		USB_DeviceState = DEVICE_STATE_Suspended;
@@ -95,6 +100,10 @@ ISR(USB_BUSEVENT_vect)
 
 		USB_Device_EnableDeviceAddress(0);
 
+		#if defined(ASYNC_ENDPOINT_TRANSFERS)
+		Endpoint_AbortAsyncTransfers();
+		#endif
+
 		Endpoint_ClearEndpoints();
 		Endpoint_ConfigureEndpoint(ENDPOINT_CONTROLEP, EP_TYPE_CONTROL,
 		                           USB_Device_ControlEndpointSize, 1);
@@ -103,4 +112,17 @@ ISR(USB_BUSEVENT_vect)
 	}
 }
 
+#if defined(ASYNC_ENDPOINT_TRANSFERS)
+ISR(USB_TRNCOMPL_vect)
+{
+	USB.INTFLAGSBCLR = USB_TRNIF_bm;
+
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	Endpoint_ProcessAsyncTransfers();
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+}
+#endif
+
 #endif
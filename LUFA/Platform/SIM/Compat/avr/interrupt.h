@@ -0,0 +1,47 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Compatibility placeholder for <avr/interrupt.h> on the host-native simulated architecture.
+ *
+ *  AVR-LibC interrupt header placeholder for the host-native simulated architecture. The \c ISR() macro is
+ *  instead defined by LUFA/Common/Common.h, and global interrupts are managed by the SIM interrupt management driver.
+ */
+
+#ifndef _SIM_COMPAT_AVR_INTERRUPT_H_
+#define _SIM_COMPAT_AVR_INTERRUPT_H_
+
+	/* Macros: */
+		/* ISR() attribute arguments of AVR-LibC, which have no meaning for the simulated interrupts */
+		#define ISR_BLOCK
+		#define ISR_NOBLOCK
+		#define ISR_NAKED
+
+#endif
@@ -0,0 +1,165 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Compatibility placeholder for <avr/io.h> on the host-native simulated architecture.
+ *
+ *  AVR-LibC I/O register header placeholder for the host-native simulated architecture. The registers of
+ *  a real target do not exist when simulated, so should only be accessed from code compiled for \c ARCH_AVR8;
+ *  placeholders are provided for the port and timer registers, which have no effect when written.
+ */
+
+#ifndef _SIM_COMPAT_AVR_IO_H_
+#define _SIM_COMPAT_AVR_IO_H_
+
+	/* Includes: */
+		/* The AVR-LibC header brings in the standard integer types, which some applications rely upon */
+		#include <stdint.h>
+		#include <inttypes.h>
+
+	/* Global Variables: */
+		/* Placeholder storage for the AVR8 I/O registers used by the LUFA demos and projects outside of code conditionally
+		 * compiled for ARCH_AVR8, such as the timers of the audio demos. Values written are retained, but there is no
+		 * simulated peripheral behind any of them, so that they have no effect. */
+		static volatile uint8_t  DDRB     __attribute__((unused));
+		static volatile uint8_t  PORTB    __attribute__((unused));
+		static volatile uint8_t  PINB     __attribute__((unused));
+		static volatile uint8_t  DDRC     __attribute__((unused));
+		static volatile uint8_t  PORTC    __attribute__((unused));
+		static volatile uint8_t  PINC     __attribute__((unused));
+		static volatile uint8_t  DDRD     __attribute__((unused));
+		static volatile uint8_t  PORTD    __attribute__((unused));
+		static volatile uint8_t  PIND     __attribute__((unused));
+		static volatile uint8_t  DDRE     __attribute__((unused));
+		static volatile uint8_t  PORTE    __attribute__((unused));
+		static volatile uint8_t  PINE     __attribute__((unused));
+		static volatile uint8_t  DDRF     __attribute__((unused));
+		static volatile uint8_t  PORTF    __attribute__((unused));
+		static volatile uint8_t  PINF     __attribute__((unused));
+		static volatile uint8_t  TCCR0A   __attribute__((unused));
+		static volatile uint8_t  TCCR0B   __attribute__((unused));
+		static volatile uint8_t  TCNT0    __attribute__((unused));
+		static volatile uint8_t  OCR0A    __attribute__((unused));
+		static volatile uint8_t  OCR0B    __attribute__((unused));
+		static volatile uint8_t  TIMSK0   __attribute__((unused));
+		static volatile uint8_t  TIFR0    __attribute__((unused));
+		static volatile uint8_t  TCCR1A   __attribute__((unused));
+		static volatile uint8_t  TCCR1B   __attribute__((unused));
+		static volatile uint8_t  TCCR1C   __attribute__((unused));
+		static volatile uint8_t  TIMSK1   __attribute__((unused));
+		static volatile uint8_t  TIFR1    __attribute__((unused));
+		static volatile uint8_t  TCCR3A   __attribute__((unused));
+		static volatile uint8_t  TCCR3B   __attribute__((unused));
+		static volatile uint8_t  TCCR3C   __attribute__((unused));
+		static volatile uint8_t  TIMSK3   __attribute__((unused));
+		static volatile uint8_t  TIFR3    __attribute__((unused));
+		static volatile uint16_t TCNT1    __attribute__((unused));
+		static volatile uint16_t OCR1A    __attribute__((unused));
+		static volatile uint16_t OCR1B    __attribute__((unused));
+		static volatile uint16_t OCR1C    __attribute__((unused));
+		static volatile uint16_t ICR1     __attribute__((unused));
+		static volatile uint16_t TCNT3    __attribute__((unused));
+		static volatile uint16_t OCR3A    __attribute__((unused));
+		static volatile uint16_t OCR3B    __attribute__((unused));
+		static volatile uint16_t OCR3C    __attribute__((unused));
+		static volatile uint16_t ICR3     __attribute__((unused));
+
+	/* Macros: */
+		/* Register bit positions of the placeholder timer registers, as on the AVR8 architecture */
+		#define COM0A1   7
+		#define COM0A0   6
+		#define COM0B1   5
+		#define COM0B0   4
+		#define WGM01    1
+		#define WGM00    0
+		#define FOC0A    7
+		#define FOC0B    6
+		#define WGM02    3
+		#define CS02     2
+		#define CS01     1
+		#define CS00     0
+		#define OCIE0B   2
+		#define OCIE0A   1
+		#define TOIE0    0
+		#define OCF0B    2
+		#define OCF0A    1
+		#define TOV0     0
+		#define COM1A1   7
+		#define COM1A0   6
+		#define COM1B1   5
+		#define COM1B0   4
+		#define COM1C1   3
+		#define COM1C0   2
+		#define WGM11    1
+		#define WGM10    0
+		#define ICNC1    7
+		#define ICES1    6
+		#define WGM13    4
+		#define WGM12    3
+		#define CS12     2
+		#define CS11     1
+		#define CS10     0
+		#define ICIE1    5
+		#define OCIE1C   3
+		#define OCIE1B   2
+		#define OCIE1A   1
+		#define TOIE1    0
+		#define ICF1     5
+		#define OCF1C    3
+		#define OCF1B    2
+		#define OCF1A    1
+		#define TOV1     0
+		#define COM3A1   7
+		#define COM3A0   6
+		#define COM3B1   5
+		#define COM3B0   4
+		#define COM3C1   3
+		#define COM3C0   2
+		#define WGM31    1
+		#define WGM30    0
+		#define ICNC3    7
+		#define ICES3    6
+		#define WGM33    4
+		#define WGM32    3
+		#define CS32     2
+		#define CS31     1
+		#define CS30     0
+		#define ICIE3    5
+		#define OCIE3C   3
+		#define OCIE3B   2
+		#define OCIE3A   1
+		#define TOIE3    0
+		#define ICF3     5
+		#define OCF3C    3
+		#define OCF3B    2
+		#define OCF3A    1
+		#define TOV3     0
+
+#endif
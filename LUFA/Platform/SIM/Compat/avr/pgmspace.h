@@ -0,0 +1,78 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Compatibility placeholder for <avr/pgmspace.h> on the host-native simulated architecture.
+ *
+ *  AVR-LibC program space header placeholder for the host-native simulated architecture. The \c PROGMEM
+ *  attribute and the program space access functions used by LUFA are instead defined by LUFA/Common/Common.h,
+ *  while the remaining string functions used by applications are mapped here onto their RAM counterparts, as
+ *  program space data is held in RAM when simulated.
+ */
+
+#ifndef _SIM_COMPAT_AVR_PGMSPACE_H_
+#define _SIM_COMPAT_AVR_PGMSPACE_H_
+
+	/* Includes: */
+		#include <stdio.h>
+		#include <string.h>
+
+		#include "../../../../Common/Common.h"
+
+	/* Macros: */
+		#define strcat_P(...)     strcat(__VA_ARGS__)
+		#define strchr_P(...)     strchr(__VA_ARGS__)
+		#define strcmp_P(...)     strcmp(__VA_ARGS__)
+		#define strcpy_P(...)     strcpy(__VA_ARGS__)
+		#define strncmp_P(...)    strncmp(__VA_ARGS__)
+		#define strncpy_P(...)    strncpy(__VA_ARGS__)
+		#define sprintf_P(...)    sprintf(__VA_ARGS__)
+		#define snprintf_P(...)   snprintf(__VA_ARGS__)
+
+	/* Inline Functions: */
+		/* The C library of the build machine need not provide strlcpy(), so the BSD semantics are implemented here */
+		static inline size_t strlcpy_P(char* Destination,
+		                               const char* Source,
+		                               size_t Size)
+		{
+			size_t SourceLength = strlen(Source);
+
+			if (Size)
+			{
+				size_t CopyLength = ((SourceLength < (Size - 1)) ? SourceLength : (Size - 1));
+
+				memcpy(Destination, Source, CopyLength);
+				Destination[CopyLength] = '\0';
+			}
+
+			return SourceLength;
+		}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Compatibility wrapper for <stdio.h> on the host-native simulated architecture.
+ *
+ *  Standard I/O header wrapper for the host-native simulated architecture. The build machine's own header is
+ *  included, after which the AVR-LibC custom stream macros are defined on top of the functions of
+ *  LUFA/Platform/SIM/Streams.h, and the standard character I/O functions used by LUFA applications are redirected
+ *  to the versions in that module which also handle custom streams.
+ */
+
+#ifndef _SIM_COMPAT_STDIO_H_
+#define _SIM_COMPAT_STDIO_H_
+
+	/* Includes: */
+		#include_next <stdio.h>
+
+		#include "../Streams.h"
+
+	/* Macros: */
+		/* AVR-LibC custom stream flags and status codes */
+		#define _FDEV_SETUP_READ                    (1 << 0)
+		#define _FDEV_SETUP_WRITE                   (1 << 1)
+		#define _FDEV_SETUP_RW                      (_FDEV_SETUP_READ | _FDEV_SETUP_WRITE)
+
+		#define _FDEV_ERR                           -1
+		#define _FDEV_EOF                           -2
+
+		/* AVR-LibC custom stream set up macros; streams are set up with fdev_setup_stream(), as the AVR-LibC
+		 * FDEV_SETUP_STREAM() static initializer cannot be supported for the build machine's FILE structure */
+		#define fdev_setup_stream(Stream, Put, Get, Flags)  SIM_Stream_Setup((Stream), (Put), (Get))
+		#define fdev_set_udata(Stream, UserData)            SIM_Stream_SetUserData((Stream), (UserData))
+		#define fdev_get_udata(Stream)                      SIM_Stream_GetUserData(Stream)
+
+		#if !defined(__INCLUDE_FROM_SIM_STREAMS_C)
+			/* Standard character I/O functions, redirected so that they handle custom streams */
+			#undef fputc
+			#undef putc
+			#undef putchar
+			#undef fputs
+			#undef puts
+			#undef fwrite
+			#undef fprintf
+			#undef printf
+			#undef vfprintf
+			#undef fgetc
+			#undef getc
+			#undef getchar
+			#undef fflush
+
+			#define fputc(DataByte, Stream)             SIM_Stream_fputc((DataByte), (Stream))
+			#define putc(DataByte, Stream)              SIM_Stream_fputc((DataByte), (Stream))
+			#define putchar(DataByte)                   SIM_Stream_fputc((DataByte), stdout)
+			#define fputs(String, Stream)               SIM_Stream_fputs((String), (Stream))
+			#define puts(String)                        SIM_Stream_puts(String)
+			#define fwrite(Buffer, Size, Count, Stream) SIM_Stream_fwrite((Buffer), (Size), (Count), (Stream))
+			#define fprintf(...)                        SIM_Stream_fprintf(__VA_ARGS__)
+			#define printf(...)                         SIM_Stream_printf(__VA_ARGS__)
+			#define vfprintf(Stream, Format, Args)      SIM_Stream_vfprintf((Stream), (Format), (Args))
+			#define fgetc(Stream)                       SIM_Stream_fgetc(Stream)
+			#define getc(Stream)                        SIM_Stream_fgetc(Stream)
+			#define getchar()                           SIM_Stream_fgetc(stdin)
+			#define fflush(Stream)                      SIM_Stream_fflush(Stream)
+		#endif
+
+#endif
+
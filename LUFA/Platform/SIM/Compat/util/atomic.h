@@ -0,0 +1,103 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Compatibility header for <util/atomic.h> on the host-native simulated architecture.
+ *
+ *  AVR-LibC atomic block header for the host-native simulated architecture. The \c ATOMIC_BLOCK() and
+ *  \c NONATOMIC_BLOCK() macros disable and restore the simulated global interrupt flag of the SIM interrupt
+ *  management driver, so that code protecting its data from the simulated USB interrupt builds unmodified.
+ */
+
+#ifndef _SIM_COMPAT_UTIL_ATOMIC_H_
+#define _SIM_COMPAT_UTIL_ATOMIC_H_
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Inline Functions: */
+			static inline uint_reg_t SIM_Atomic_Enter(void)
+			{
+				GlobalInterruptDisable();
+				return 1;
+			}
+
+			static inline uint_reg_t SIM_Atomic_Leave(void)
+			{
+				GlobalInterruptEnable();
+				return 1;
+			}
+
+			static inline void SIM_Atomic_Restore(const uint_reg_t* const SavedMask)
+			{
+				SetGlobalInterruptMask(*SavedMask);
+			}
+
+			static inline void SIM_Atomic_ForceOn(const uint_reg_t* const SavedMask)
+			{
+				(void)SavedMask;
+				GlobalInterruptEnable();
+			}
+
+			static inline void SIM_Atomic_ForceOff(const uint_reg_t* const SavedMask)
+			{
+				(void)SavedMask;
+				GlobalInterruptDisable();
+			}
+	#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Executes the following block with the simulated global interrupts disabled, restoring them on exit
+			 *  according to the given \c ATOMIC_* type.
+			 */
+			#define ATOMIC_BLOCK(Type)      for (Type, SIM_AtomicToDo = SIM_Atomic_Enter(); SIM_AtomicToDo; SIM_AtomicToDo = 0)
+
+			/** Executes the following block with the simulated global interrupts enabled, restoring them on exit
+			 *  according to the given \c NONATOMIC_* type.
+			 */
+			#define NONATOMIC_BLOCK(Type)   for (Type, SIM_AtomicToDo = SIM_Atomic_Leave(); SIM_AtomicToDo; SIM_AtomicToDo = 0)
+
+			/** \c ATOMIC_BLOCK() type, restoring the global interrupt flag to its value on entry. */
+			#define ATOMIC_RESTORESTATE     uint_reg_t SIM_AtomicMask __attribute__((__cleanup__(SIM_Atomic_Restore))) = GetGlobalInterruptMask()
+
+			/** \c ATOMIC_BLOCK() type, enabling global interrupts on exit. */
+			#define ATOMIC_FORCEON          uint_reg_t SIM_AtomicMask __attribute__((__cleanup__(SIM_Atomic_ForceOn))) = 0
+
+			/** \c NONATOMIC_BLOCK() type, restoring the global interrupt flag to its value on entry. */
+			#define NONATOMIC_RESTORESTATE  ATOMIC_RESTORESTATE
+
+			/** \c NONATOMIC_BLOCK() type, disabling global interrupts on exit. */
+			#define NONATOMIC_FORCEOFF      uint_reg_t SIM_AtomicMask __attribute__((__cleanup__(SIM_Atomic_ForceOff))) = 0
+
+#endif
+
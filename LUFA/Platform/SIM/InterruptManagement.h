@@ -0,0 +1,81 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Interrupt Controller Driver for the host-native simulated architecture.
+ *
+ *  Interrupt controller driver for the host-native simulated architecture, holding the simulated global
+ *  interrupt enable state of the target.
+ */
+
+/** \ingroup Group_PlatformDrivers_SIM
+ *  \defgroup Group_PlatformDrivers_SIMInterrupts Interrupt Controller Driver - LUFA/Platform/SIM/InterruptManagement.h
+ *  \brief Interrupt Controller Driver for the host-native simulated architecture.
+ *
+ *  \section Sec_PlatformDrivers_SIMInterrupts_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Platform/SIM/InterruptManagement.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
+ *
+ *  \section Sec_PlatformDrivers_SIMInterrupts_ModDescription Module Description
+ *  Interrupt controller driver for the host-native simulated architecture. There are no asynchronous interrupts
+ *  when running as a regular process on the build machine; instead, simulated peripherals such as the USB controller
+ *  raise their interrupts synchronously from their polling points, and only while the global interrupt enable state
+ *  managed through \ref GlobalInterruptEnable() and \ref GlobalInterruptDisable() allows it.
+ *
+ *  @{
+ */
+
+#ifndef _SIM_INTERRUPT_MANAGEMENT_H_
+#define _SIM_INTERRUPT_MANAGEMENT_H_
+
+	/* Includes: */
+		#include "../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* External Variables: */
+			/** Simulated global interrupt enable state of the target. This should not be altered directly by the
+			 *  user application; use \ref GetGlobalInterruptMask() and \ref SetGlobalInterruptMask() instead.
+			 */
+			extern volatile uint_reg_t SIM_GlobalInterruptMask;
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
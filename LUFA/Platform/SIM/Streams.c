@@ -0,0 +1,244 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/* Defined ahead of the LUFA common header, which includes <stdio.h>, so that the standard character I/O functions
+ * used here are those of the build machine's C library rather than the redirected versions */
+#define  __INCLUDE_FROM_SIM_STREAMS_C
+#include "../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#include <stdlib.h>
+
+#include "Streams.h"
+
+/** Custom character stream set up by \ref SIM_Stream_Setup(), recorded by the address of its \c FILE structure. */
+typedef struct
+{
+	FILE*           Stream; /**< Stream's \c FILE structure, or \c NULL if the entry is free */
+	SIM_StreamPut_t Put; /**< Stream's character send function */
+	SIM_StreamGet_t Get; /**< Stream's character receive function */
+	void*           UserData; /**< Stream's user data pointer */
+} SIM_StreamInfo_t;
+
+static SIM_StreamInfo_t CustomStreams[SIM_MAX_STREAMS];
+
+static SIM_StreamInfo_t* SIM_Stream_Find(FILE* Stream)
+{
+	if (Stream == NULL)
+	  return NULL;
+
+	for (uint8_t StreamIndex = 0; StreamIndex < SIM_MAX_STREAMS; StreamIndex++)
+	{
+		if (CustomStreams[StreamIndex].Stream == Stream)
+		  return &CustomStreams[StreamIndex];
+	}
+
+	return NULL;
+}
+
+void SIM_Stream_Setup(FILE* Stream,
+                      SIM_StreamPut_t Put,
+                      SIM_StreamGet_t Get)
+{
+	SIM_StreamInfo_t* StreamInfo = SIM_Stream_Find(Stream);
+
+	if (StreamInfo == NULL)
+	{
+		for (uint8_t StreamIndex = 0; StreamIndex < SIM_MAX_STREAMS; StreamIndex++)
+		{
+			if (CustomStreams[StreamIndex].Stream == NULL)
+			{
+				StreamInfo = &CustomStreams[StreamIndex];
+				break;
+			}
+		}
+
+		if (StreamInfo == NULL)
+		{
+			fprintf(stderr, "LUFA SIM: more than %d custom character streams set up\n", SIM_MAX_STREAMS);
+			abort();
+		}
+	}
+
+	StreamInfo->Stream   = Stream;
+	StreamInfo->Put      = Put;
+	StreamInfo->Get      = Get;
+	StreamInfo->UserData = NULL;
+}
+
+void SIM_Stream_SetUserData(FILE* Stream,
+                            void* UserData)
+{
+	SIM_StreamInfo_t* StreamInfo = SIM_Stream_Find(Stream);
+
+	if (StreamInfo != NULL)
+	  StreamInfo->UserData = UserData;
+}
+
+void* SIM_Stream_GetUserData(FILE* Stream)
+{
+	SIM_StreamInfo_t* StreamInfo = SIM_Stream_Find(Stream);
+
+	return (StreamInfo != NULL) ? StreamInfo->UserData : NULL;
+}
+
+int SIM_Stream_fputc(int DataByte, FILE* Stream)
+{
+	SIM_StreamInfo_t* StreamInfo = SIM_Stream_Find(Stream);
+
+	if (StreamInfo == NULL)
+	  return fputc(DataByte, Stream);
+
+	if ((StreamInfo->Put == NULL) || StreamInfo->Put((char)DataByte, Stream))
+	  return EOF;
+
+	return (uint8_t)DataByte;
+}
+
+size_t SIM_Stream_fwrite(const void* Buffer, size_t Size, size_t Count, FILE* Stream)
+{
+	if (SIM_Stream_Find(Stream) == NULL)
+	  return fwrite(Buffer, Size, Count, Stream);
+
+	const uint8_t* DataBytes = (const uint8_t*)Buffer;
+
+	for (size_t Element = 0; Element < Count; Element++)
+	{
+		for (size_t ElementByte = 0; ElementByte < Size; ElementByte++)
+		{
+			if (SIM_Stream_fputc(*(DataBytes++), Stream) == EOF)
+			  return Element;
+		}
+	}
+
+	return Count;
+}
+
+int SIM_Stream_fputs(const char* String, FILE* Stream)
+{
+	if (SIM_Stream_Find(Stream) == NULL)
+	  return fputs(String, Stream);
+
+	int ReturnValue = 0;
+
+	/* As with AVR-LibC, the whole string is sent even if sending one of its characters fails */
+	while (*String)
+	{
+		if (SIM_Stream_fputc(*(String++), Stream) == EOF)
+		  ReturnValue = EOF;
+	}
+
+	return ReturnValue;
+}
+
+int SIM_Stream_puts(const char* String)
+{
+	if ((SIM_Stream_fputs(String, stdout) == EOF) || (SIM_Stream_fputc('\n', stdout) == EOF))
+	  return EOF;
+
+	return 0;
+}
+
+int SIM_Stream_vfprintf(FILE* Stream, const char* Format, va_list Args)
+{
+	if (SIM_Stream_Find(Stream) == NULL)
+	  return vfprintf(Stream, Format, Args);
+
+	/* Format into a temporary buffer sized by a first formatting pass, then send the formatted characters */
+	va_list LengthArgs;
+	va_copy(LengthArgs, Args);
+	int Length = vsnprintf(NULL, 0, Format, LengthArgs);
+	va_end(LengthArgs);
+
+	if (Length < 0)
+	  return EOF;
+
+	char* Formatted = malloc(Length + 1);
+
+	if (Formatted == NULL)
+	  return EOF;
+
+	vsnprintf(Formatted, Length + 1, Format, Args);
+
+	/* As with AVR-LibC, characters which fail to send are not reported as an error of the formatted write */
+	for (int FormattedIndex = 0; FormattedIndex < Length; FormattedIndex++)
+	  SIM_Stream_fputc(Formatted[FormattedIndex], Stream);
+
+	free(Formatted);
+
+	return Length;
+}
+
+int SIM_Stream_fprintf(FILE* Stream, const char* Format, ...)
+{
+	va_list Args;
+
+	va_start(Args, Format);
+	int Length = SIM_Stream_vfprintf(Stream, Format, Args);
+	va_end(Args);
+
+	return Length;
+}
+
+int SIM_Stream_printf(const char* Format, ...)
+{
+	va_list Args;
+
+	va_start(Args, Format);
+	int Length = SIM_Stream_vfprintf(stdout, Format, Args);
+	va_end(Args);
+
+	return Length;
+}
+
+int SIM_Stream_fgetc(FILE* Stream)
+{
+	SIM_StreamInfo_t* StreamInfo = SIM_Stream_Find(Stream);
+
+	if (StreamInfo == NULL)
+	  return fgetc(Stream);
+
+	if (StreamInfo->Get == NULL)
+	  return EOF;
+
+	int ReceivedByte = StreamInfo->Get(Stream);
+
+	return (ReceivedByte < 0) ? EOF : (uint8_t)ReceivedByte;
+}
+
+int SIM_Stream_fflush(FILE* Stream)
+{
+	if (SIM_Stream_Find(Stream) == NULL)
+	  return fflush(Stream);
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Character stream support for the host-native simulated architecture.
+ *
+ *  Character stream support for the host-native simulated architecture, providing the AVR-LibC custom stream
+ *  interface on top of the build machine's C library.
+ */
+
+/** \ingroup Group_PlatformDrivers_SIM
+ *  \defgroup Group_PlatformDrivers_SIMStreams Character Streams - LUFA/Platform/SIM/Streams.h
+ *  \brief Character stream support for the host-native simulated architecture.
+ *
+ *  \section Sec_PlatformDrivers_SIMStreams_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Platform/SIM/Streams.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
+ *
+ *  \section Sec_PlatformDrivers_SIMStreams_ModDescription Module Description
+ *  Character stream support for the host-native simulated architecture. AVR-LibC allows a \c FILE structure owned by
+ *  the application to be set up as a stream whose characters are passed to a pair of application functions, which the
+ *  character stream functions of the LUFA drivers rely upon. The build machine's C library cannot set up its \c FILE
+ *  structures in this way, so instead each such stream is recorded here by the address of its \c FILE structure, and
+ *  the standard character I/O functions used on streams by LUFA applications are redirected by the SIM compatibility
+ *  <tt>&lt;stdio.h&gt;</tt> header to the versions in this module. These pass the characters of recorded streams to
+ *  the stream's functions, and those of all other streams to the C library.
+ *
+ *  @{
+ */
+
+#ifndef _SIM_STREAMS_H_
+#define _SIM_STREAMS_H_
+
+	/* Includes: */
+		#include <stdio.h>
+		#include <stdarg.h>
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Maximum number of custom character streams which may be set up at the same time. */
+			#define SIM_MAX_STREAMS           8
+
+		/* Type Defines: */
+			/** Type define for the function of a custom character stream which sends a character. The function must
+			 *  return zero if the character was sent, or a nonzero value otherwise.
+			 */
+			typedef int (*SIM_StreamPut_t)(char DataByte, FILE* Stream);
+
+			/** Type define for the function of a custom character stream which receives a character. The function must
+			 *  return the received character, \c _FDEV_EOF if no character is available or \c _FDEV_ERR on error.
+			 */
+			typedef int (*SIM_StreamGet_t)(FILE* Stream);
+
+		/* Function Prototypes: */
+			/** Sets up the given \c FILE structure as a custom character stream, equivalent to the AVR-LibC
+			 *  \c fdev_setup_stream() macro. The stream's user data pointer is cleared.
+			 *
+			 *  \param[in] Stream  Pointer to the \c FILE structure of the stream to set up.
+			 *  \param[in] Put     Function to send each character written to the stream, or \c NULL if not writable.
+			 *  \param[in] Get     Function to receive each character read from the stream, or \c NULL if not readable.
+			 */
+			void SIM_Stream_Setup(FILE* Stream,
+			                      SIM_StreamPut_t Put,
+			                      SIM_StreamGet_t Get);
+
+			/** Sets the user data pointer of the given custom character stream, equivalent to the AVR-LibC
+			 *  \c fdev_set_udata() macro.
+			 *
+			 *  \param[in] Stream    Pointer to the \c FILE structure of a stream set up by \ref SIM_Stream_Setup().
+			 *  \param[in] UserData  User data pointer to associate with the stream.
+			 */
+			void SIM_Stream_SetUserData(FILE* Stream,
+			                            void* UserData);
+
+			/** Retrieves the user data pointer of the given custom character stream, equivalent to the AVR-LibC
+			 *  \c fdev_get_udata() macro.
+			 *
+			 *  \param[in] Stream  Pointer to the \c FILE structure of a stream set up by \ref SIM_Stream_Setup().
+			 *
+			 *  \return User data pointer associated with the stream, or \c NULL if none.
+			 */
+			void* SIM_Stream_GetUserData(FILE* Stream);
+
+			/** \name Standard character I/O functions, which handle custom character streams */
+			//@{
+			int SIM_Stream_fputc(int DataByte, FILE* Stream);
+			int SIM_Stream_fputs(const char* String, FILE* Stream);
+			size_t SIM_Stream_fwrite(const void* Buffer, size_t Size, size_t Count, FILE* Stream);
+			int SIM_Stream_vfprintf(FILE* Stream, const char* Format, va_list Args);
+			int SIM_Stream_fprintf(FILE* Stream, const char* Format, ...) __attribute__ ((format (printf, 2, 3)));
+			int SIM_Stream_printf(const char* Format, ...) __attribute__ ((format (printf, 1, 2)));
+			int SIM_Stream_puts(const char* String);
+			int SIM_Stream_fgetc(FILE* Stream);
+			int SIM_Stream_fflush(FILE* Stream);
+			//@}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
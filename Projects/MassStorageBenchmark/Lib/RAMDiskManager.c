@@ -0,0 +1,296 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Functions to manage the RAM disk storage medium of the benchmark, including reading and writing of blocks
+ *  of data. These functions are called by the library SCSI command engine when data must be stored or retrieved,
+ *  and move data directly between the USB endpoints and RAM, so that the measured throughput is that of the USB
+ *  stack and Mass Storage class driver alone.
+ *
+ *  On-target the disk is backed by a small RAM buffer which is mirrored across the whole reported capacity. In a
+ *  build for the host-native simulated architecture, the disk may instead be backed by a disk image file.
+ */
+
+#define  INCLUDE_FROM_RAMDISKMANAGER_C
+#include "RAMDiskManager.h"
+
+#if (ARCH == ARCH_SIM)
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+/** Structure to hold the SCSI response data to a SCSI INQUIRY command, for the RAM disk logical unit. This gives
+ *  information about the device's features and capabilities.
+ */
+const SCSI_Inquiry_Response_t RAMDiskManager_InquiryData =
+	{
+		.DeviceType          = DEVICE_TYPE_BLOCK,
+		.PeripheralQualifier = 0,
+
+		.Removable           = true,
+
+		.Version             = 0,
+
+		.ResponseDataFormat  = 2,
+		.NormACA             = false,
+		.TrmTsk              = false,
+		.AERC                = false,
+
+		.AdditionalLength    = 0x1F,
+
+		.SoftReset           = false,
+		.CmdQue              = false,
+		.Linked              = false,
+		.Sync                = false,
+		.WideBus16Bit        = false,
+		.WideBus32Bit        = false,
+		.RelAddr             = false,
+
+		.VendorID            = "LUFA",
+		.ProductID           = "RAM Disk",
+		.RevisionID          = {'0','.','0','0'},
+	};
+
+/** Library SCSI command engine backend for the RAM disk storage medium. */
+const MS_SCSI_Backend_t RAMDiskManager_SCSIBackend =
+	{
+		.ReadBlocks          = RAMDiskManager_SCSIReadBlocks,
+		.WriteBlocks         = RAMDiskManager_SCSIWriteBlocks,
+		.MapBlocks           = RAMDiskManager_SCSIMapBlocks,
+		#if (ARCH == ARCH_SIM)
+		.SynchronizeCache    = RAMDiskManager_SCSISynchronizeCache,
+		#endif
+	};
+
+/** RAM buffer backing the disk. Disk blocks beyond the size of the buffer wrap around onto the start of the buffer. */
+static uint8_t RAMDiskData[RAMDISK_BUFFER_BLOCKS][RAMDISK_BLOCK_SIZE];
+
+#if (ARCH == ARCH_SIM)
+/** Memory mapped disk image file backing the disk in place of the RAM buffer, or \c NULL if no image is open. */
+static uint8_t* ImageData;
+
+/** Size of the memory mapped disk image file, in bytes. */
+static size_t   ImageBytes;
+#endif
+
+/** Maps a logical unit onto the RAM disk, setting its backend and geometry.
+ *
+ *  \param[out] LUN  Logical unit to map onto the RAM disk
+ */
+void RAMDiskManager_Init(MS_SCSI_LUN_t* const LUN)
+{
+	LUN->Backend     = &RAMDiskManager_SCSIBackend;
+	LUN->InquiryData = &RAMDiskManager_InquiryData;
+	LUN->FirstBlock  = 0;
+	LUN->TotalBlocks = RAMDISK_TOTAL_BLOCKS;
+	LUN->BlockSize   = RAMDISK_BLOCK_SIZE;
+	LUN->ReadOnly    = DISK_READ_ONLY;
+}
+
+#if (ARCH == ARCH_SIM)
+/** Backs the RAM disk with a disk image file on the build machine, in place of the RAM buffer. The file is mapped
+ *  into memory, so that blocks written by the host are stored in the file. The capacity of the logical unit is
+ *  changed to the size of the file, rounded down to a whole number of blocks.
+ *
+ *  \param[in,out] LUN       Logical unit previously mapped onto the RAM disk via \ref RAMDiskManager_Init()
+ *  \param[in]     FileName  Path of the disk image file to open
+ *
+ *  \return Boolean \c true if the image was opened, \c false otherwise
+ */
+bool RAMDiskManager_OpenImage(MS_SCSI_LUN_t* const LUN,
+                              const char* const FileName)
+{
+	struct stat ImageInfo;
+	void*       ImageMapping;
+	int         ImageFile = open(FileName, (LUN->ReadOnly ? O_RDONLY : O_RDWR));
+
+	if (ImageFile < 0)
+	  return false;
+
+	if ((fstat(ImageFile, &ImageInfo) != 0) || (ImageInfo.st_size < RAMDISK_BLOCK_SIZE))
+	{
+		close(ImageFile);
+		return false;
+	}
+
+	ImageMapping = mmap(NULL, ImageInfo.st_size, (PROT_READ | (LUN->ReadOnly ? 0 : PROT_WRITE)), MAP_SHARED, ImageFile, 0);
+	close(ImageFile);
+
+	if (ImageMapping == MAP_FAILED)
+	  return false;
+
+	ImageData        = ImageMapping;
+	ImageBytes       = ImageInfo.st_size;
+	LUN->TotalBlocks = (ImageInfo.st_size / RAMDISK_BLOCK_SIZE);
+
+	return true;
+}
+#endif
+
+/** Retrieves the storage of a block of the RAM disk.
+ *
+ *  \param[in] BlockAddress  Address of the block to retrieve
+ *
+ *  \return Pointer to the block's data
+ */
+static uint8_t* RAMDiskManager_GetBlock(const uint32_t BlockAddress)
+{
+	#if (ARCH == ARCH_SIM)
+	if (ImageData != NULL)
+	  return &ImageData[(size_t)BlockAddress * RAMDISK_BLOCK_SIZE];
+	#endif
+
+	return RAMDiskData[BlockAddress % RAMDISK_BUFFER_BLOCKS];
+}
+
+/** SCSI command engine backend function to read blocks from the RAM disk and send them to the host via the
+ *  pre-selected data IN endpoint.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Logical unit the blocks are read from
+ *  \param[in] BlockAddress     Data block starting address for the read sequence
+ *  \param[in] TotalBlocks      Number of blocks of data to read
+ *
+ *  \return Boolean \c true if the blocks were read, \c false if the transfer was aborted
+ */
+static bool RAMDiskManager_SCSIReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_SCSI_LUN_t* const LUN,
+                                          const uint32_t BlockAddress,
+                                          const uint16_t TotalBlocks)
+{
+	for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		uint8_t* BlockData      = RAMDiskManager_GetBlock(BlockAddress + BlockIndex);
+		uint16_t BytesProcessed = 0;
+		uint8_t  ErrorCode;
+
+		/* Send the block a bank at a time, aborting if a Mass Storage reset occurs between banks */
+		while ((ErrorCode = Endpoint_Write_Stream_LE(BlockData, RAMDISK_BLOCK_SIZE, &BytesProcessed)) ==
+		       ENDPOINT_RWSTREAM_IncompleteTransfer)
+		{
+			if (MSInterfaceInfo->State.IsMassStoreReset)
+			  return false;
+		}
+
+		if (ErrorCode != ENDPOINT_RWSTREAM_NoError)
+		  return false;
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return true;
+}
+
+/** SCSI command engine backend function to write blocks received from the host via the pre-selected data OUT
+ *  endpoint to the RAM disk.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Logical unit the blocks are written to
+ *  \param[in] BlockAddress     Data block starting address for the write sequence
+ *  \param[in] TotalBlocks      Number of blocks of data to write
+ *
+ *  \return Boolean \c true if the blocks were written, \c false if the transfer was aborted
+ */
+static bool RAMDiskManager_SCSIWriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                           const MS_SCSI_LUN_t* const LUN,
+                                           const uint32_t BlockAddress,
+                                           const uint16_t TotalBlocks)
+{
+	for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		uint8_t* BlockData      = RAMDiskManager_GetBlock(BlockAddress + BlockIndex);
+		uint16_t BytesProcessed = 0;
+		uint8_t  ErrorCode;
+
+		/* Receive the block a bank at a time, aborting if a Mass Storage reset occurs between banks */
+		while ((ErrorCode = Endpoint_Read_Stream_LE(BlockData, RAMDISK_BLOCK_SIZE, &BytesProcessed)) ==
+		       ENDPOINT_RWSTREAM_IncompleteTransfer)
+		{
+			if (MSInterfaceInfo->State.IsMassStoreReset)
+			  return false;
+		}
+
+		if (ErrorCode != ENDPOINT_RWSTREAM_NoError)
+		  return false;
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return true;
+}
+
+/** SCSI command engine backend function to map a run of blocks of the RAM disk, so that the engine can transfer them
+ *  directly between the RAM disk and the data endpoints via the asynchronous endpoint transfer engine.
+ *
+ *  \param[in]     LUN           Logical unit the blocks are mapped from
+ *  \param[in]     BlockAddress  Address of the first block to map
+ *  \param[in,out] TotalBlocks   Number of blocks to map, reduced to the number of blocks stored contiguously
+ *
+ *  \return Pointer to the first block's data
+ */
+static uint8_t* RAMDiskManager_SCSIMapBlocks(const MS_SCSI_LUN_t* const LUN,
+                                             const uint32_t BlockAddress,
+                                             uint16_t* const TotalBlocks)
+{
+	#if (ARCH == ARCH_SIM)
+	if (ImageData != NULL)
+	  return RAMDiskManager_GetBlock(BlockAddress);
+	#endif
+
+	/* Blocks beyond the end of the RAM buffer wrap around onto its start, and so are not contiguous with those before */
+	uint16_t BufferBlock = (BlockAddress % RAMDISK_BUFFER_BLOCKS);
+
+	*TotalBlocks = MIN(*TotalBlocks, (RAMDISK_BUFFER_BLOCKS - BufferBlock));
+	return RAMDiskData[BufferBlock];
+}
+
+#if (ARCH == ARCH_SIM)
+/** SCSI command engine backend function to flush the blocks written to the RAM disk's image file, if any, to the
+ *  build machine's storage.
+ *
+ *  \param[in] LUN  Logical unit to synchronize
+ *
+ *  \return Boolean \c true if the image file was synchronized, \c false otherwise
+ */
+static bool RAMDiskManager_SCSISynchronizeCache(const MS_SCSI_LUN_t* const LUN)
+{
+	if (ImageData == NULL)
+	  return true;
+
+	return (msync(ImageData, ImageBytes, MS_SYNC) == 0);
+}
+#endif
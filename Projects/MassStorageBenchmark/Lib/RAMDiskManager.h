@@ -0,0 +1,88 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for RAMDiskManager.c.
+ */
+
+#ifndef _RAMDISK_MANAGER_H_
+#define _RAMDISK_MANAGER_H_
+
+	/* Includes: */
+		#include "../Descriptors.h"
+		#include "Config/AppConfig.h"
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Preprocessor Checks: */
+		#if (RAMDISK_BUFFER_BLOCKS > RAMDISK_TOTAL_BLOCKS)
+			#error RAMDISK_BUFFER_BLOCKS must not exceed RAMDISK_TOTAL_BLOCKS.
+		#endif
+
+	/* Defines: */
+		/** Block size of the RAM disk. This is kept at 512 to remain compatible with the OS. Do not change this value. */
+		#define RAMDISK_BLOCK_SIZE                  512
+
+		/** Value for the DeviceType entry in the SCSI_Inquiry_Response_t enum, indicating a Block Media device. */
+		#define DEVICE_TYPE_BLOCK                   0x00
+
+	/* External Variables: */
+		extern const SCSI_Inquiry_Response_t RAMDiskManager_InquiryData;
+		extern const MS_SCSI_Backend_t       RAMDiskManager_SCSIBackend;
+
+	/* Function Prototypes: */
+		void RAMDiskManager_Init(MS_SCSI_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1);
+
+		#if (ARCH == ARCH_SIM)
+		bool RAMDiskManager_OpenImage(MS_SCSI_LUN_t* const LUN,
+		                              const char* const FileName) ATTR_NON_NULL_PTR_ARG(1, 2);
+		#endif
+
+		#if defined(INCLUDE_FROM_RAMDISKMANAGER_C)
+			static uint8_t* RAMDiskManager_GetBlock(const uint32_t BlockAddress);
+			static bool RAMDiskManager_SCSIReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                          const MS_SCSI_LUN_t* const LUN,
+			                                          const uint32_t BlockAddress,
+			                                          const uint16_t TotalBlocks);
+			static bool RAMDiskManager_SCSIWriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                           const MS_SCSI_LUN_t* const LUN,
+			                                           const uint32_t BlockAddress,
+			                                           const uint16_t TotalBlocks);
+			static uint8_t* RAMDiskManager_SCSIMapBlocks(const MS_SCSI_LUN_t* const LUN,
+			                                             const uint32_t BlockAddress,
+			                                             uint16_t* const TotalBlocks);
+			#if (ARCH == ARCH_SIM)
+			static bool RAMDiskManager_SCSISynchronizeCache(const MS_SCSI_LUN_t* const LUN);
+			#endif
+		#endif
+
+#endif
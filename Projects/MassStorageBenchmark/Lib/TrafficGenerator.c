@@ -0,0 +1,452 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Mass Storage traffic generator for the host-native simulated architecture. The generator acts as the USB host
+ *  through the library's scripted virtual host, enumerating the device and then replaying a series of access
+ *  patterns as raw Bulk-Only Transport command and status wrappers. The time taken by each command is recorded
+ *  both in simulated USB frames and in build machine time, and a report of the per-command cost of each pattern is
+ *  printed once all patterns have been replayed, after which the process exits.
+ */
+
+#define  INCLUDE_FROM_TRAFFICGENERATOR_C
+#include "TrafficGenerator.h"
+
+#include <stdlib.h>
+
+/** Names of each access pattern, for the report. */
+static const char* const PatternNames[TRAFFIC_PATTERN_TOTAL] =
+	{
+		[TRAFFIC_PATTERN_CommandOverhead] = "Command overhead",
+		[TRAFFIC_PATTERN_SequentialRead]  = "Sequential read",
+		[TRAFFIC_PATTERN_SequentialWrite] = "Sequential write",
+		[TRAFFIC_PATTERN_RandomRead]      = "Random read",
+		[TRAFFIC_PATTERN_RandomWrite]     = "Random write",
+		[TRAFFIC_PATTERN_FileSystem]      = "File system",
+	};
+
+/** Control transfers issued to the device to address and configure it, before any commands are issued. */
+static USB_VirtualHost_Transfer_t EnumerationScript[] =
+	{
+		{
+			.Type    = EP_TYPE_CONTROL,
+			.Request =
+				{
+					.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+					.bRequest      = REQ_SetAddress,
+					.wValue        = 1,
+				},
+		},
+		{
+			.Type    = EP_TYPE_CONTROL,
+			.Request =
+				{
+					.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+					.bRequest      = REQ_SetConfiguration,
+					.wValue        = 1,
+				},
+		},
+	};
+
+/** Statistics gathered for each access pattern. */
+static TrafficGenerator_Statistics_t PatternStatistics[TRAFFIC_PATTERN_TOTAL];
+
+/** Current state of the traffic generator, a value from the \ref TrafficGenerator_States_t enum. */
+static uint8_t  GeneratorState = TRAFFIC_STATE_Enumerate;
+
+/** Access pattern currently being replayed, a value from the \ref TrafficGenerator_Patterns_t enum. */
+static uint8_t  CurrentPattern;
+
+/** Number of commands of the current access pattern issued so far. */
+static uint16_t CommandIndex;
+
+/** Capacity of the disk in blocks, as reported by the device. */
+static uint32_t DiskBlocks;
+
+/** Next block address of the sequential access patterns. */
+static uint32_t SequentialBlock;
+
+/** Cluster currently being written by the file system access pattern. */
+static uint32_t FileCluster;
+
+/** State of the pseudo-random number generator, seeded identically on each run so that each run replays the same
+ *  random block addresses.
+ */
+static uint32_t RandomState = 1;
+
+/** Command tag of the last command issued. */
+static uint32_t CommandTag;
+
+/** Indicates if the last command completed successfully. */
+static bool     CommandSucceeded;
+
+/** Build machine time at which the last command was issued, in nanoseconds. */
+static uint64_t CommandStartTime;
+
+/** Command wrapper of the command currently being issued. */
+static MS_CommandBlockWrapper_t  CommandBlock;
+
+/** Status wrapper returned by the device for the command currently being issued. */
+static MS_CommandStatusWrapper_t CommandStatus;
+
+/** Virtual host transfers for the command, data and status stages of the command currently being issued. */
+static USB_VirtualHost_Transfer_t CommandTransfer, DataTransfer, StatusTransfer;
+
+/** Buffer holding the data stage of the command currently being issued. */
+static uint8_t DataBuffer[TRAFFIC_MAX_BLOCKS_PER_COMMAND * TRAFFIC_BLOCK_SIZE];
+
+
+/** Event handler for the virtual host becoming idle, fired once the previous command (if any) has completed. The
+ *  next command of the current access pattern is issued from here.
+ */
+void EVENT_USB_VirtualHost_Idle(void)
+{
+	switch (GeneratorState)
+	{
+		case TRAFFIC_STATE_Enumerate:
+			USB_VirtualHost_SubmitScript(EnumerationScript, (sizeof(EnumerationScript) / sizeof(EnumerationScript[0])));
+
+			GeneratorState = TRAFFIC_STATE_ReadCapacity;
+			break;
+		case TRAFFIC_STATE_ReadCapacity:
+		{
+			uint8_t ReadCapacityCommand[10] = {SCSI_CMD_READ_CAPACITY_10};
+
+			if (USB_DeviceState != DEVICE_STATE_Configured)
+			{
+				printf("Device failed to enumerate.\n");
+				exit(EXIT_FAILURE);
+			}
+
+			TrafficGenerator_SubmitCommand(ReadCapacityCommand, sizeof(ReadCapacityCommand), true, 8);
+
+			GeneratorState = TRAFFIC_STATE_StartReplay;
+			break;
+		}
+		case TRAFFIC_STATE_StartReplay:
+			DiskBlocks = (((uint32_t)DataBuffer[0] << 24) | ((uint32_t)DataBuffer[1] << 16) |
+			              ((uint32_t)DataBuffer[2] << 8)  | DataBuffer[3]) + 1;
+
+			if (!(CommandSucceeded) || (DiskBlocks < (TRAFFIC_FAT_REGION_BLOCKS + TRAFFIC_MAX_BLOCKS_PER_COMMAND)))
+			{
+				printf("Device reported no usable capacity.\n");
+				exit(EXIT_FAILURE);
+			}
+
+			printf("Disk capacity: %lu blocks, %u commands per pattern\n\n", (unsigned long)DiskBlocks, TRAFFIC_GENERATOR_COMMANDS);
+
+			GeneratorState = TRAFFIC_STATE_Replay;
+			TrafficGenerator_SubmitNextCommand();
+			break;
+		case TRAFFIC_STATE_Replay:
+			TrafficGenerator_SubmitNextCommand();
+			break;
+	}
+}
+
+/** Issues the next command of the current access pattern, advancing to the next pattern once the current pattern
+ *  is complete. Once all patterns have been replayed, the report is printed and the process exits, with a failure
+ *  exit code if any command failed.
+ */
+static void TrafficGenerator_SubmitNextCommand(void)
+{
+	if (CommandIndex == TRAFFIC_GENERATOR_COMMANDS)
+	{
+		CommandIndex = 0;
+		CurrentPattern++;
+	}
+
+	if (CurrentPattern == TRAFFIC_PATTERN_TOTAL)
+	{
+		uint32_t TotalFailures = 0;
+
+		TrafficGenerator_PrintReport();
+
+		for (uint8_t PatternIndex = 0; PatternIndex < TRAFFIC_PATTERN_TOTAL; PatternIndex++)
+		  TotalFailures += PatternStatistics[PatternIndex].Failures;
+
+		exit(TotalFailures ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
+	switch (CurrentPattern)
+	{
+		case TRAFFIC_PATTERN_CommandOverhead:
+		{
+			uint8_t TestUnitReadyCommand[6] = {SCSI_CMD_TEST_UNIT_READY};
+
+			TrafficGenerator_SubmitCommand(TestUnitReadyCommand, sizeof(TestUnitReadyCommand), false, 0);
+			break;
+		}
+		case TRAFFIC_PATTERN_SequentialRead:
+		case TRAFFIC_PATTERN_SequentialWrite:
+			if (!(CommandIndex) || ((SequentialBlock + TRAFFIC_MAX_BLOCKS_PER_COMMAND) > DiskBlocks))
+			  SequentialBlock = 0;
+
+			TrafficGenerator_SubmitBlockCommand((CurrentPattern == TRAFFIC_PATTERN_SequentialRead) ? SCSI_CMD_READ_10 : SCSI_CMD_WRITE_10,
+			                                    SequentialBlock, TRAFFIC_MAX_BLOCKS_PER_COMMAND);
+
+			SequentialBlock += TRAFFIC_MAX_BLOCKS_PER_COMMAND;
+			break;
+		case TRAFFIC_PATTERN_RandomRead:
+		case TRAFFIC_PATTERN_RandomWrite:
+		{
+			uint32_t Cluster = (TrafficGenerator_Random() % (DiskBlocks / TRAFFIC_CLUSTER_BLOCKS));
+
+			TrafficGenerator_SubmitBlockCommand((CurrentPattern == TRAFFIC_PATTERN_RandomRead) ? SCSI_CMD_READ_10 : SCSI_CMD_WRITE_10,
+			                                    (Cluster * TRAFFIC_CLUSTER_BLOCKS), TRAFFIC_CLUSTER_BLOCKS);
+			break;
+		}
+		case TRAFFIC_PATTERN_FileSystem:
+		{
+			/* Each cluster appended to a file costs a table read, a directory read, the cluster write, and then
+			 * the table and directory updates; the data area starts after the table region and directory block */
+			uint32_t TableBlock     = ((FileCluster / (TRAFFIC_BLOCK_SIZE / sizeof(uint32_t))) % TRAFFIC_FAT_REGION_BLOCKS);
+			uint32_t DirectoryBlock = TRAFFIC_FAT_REGION_BLOCKS;
+			uint32_t DataBlock      = (DirectoryBlock + 1 + (FileCluster * TRAFFIC_CLUSTER_BLOCKS));
+
+			switch (CommandIndex % 5)
+			{
+				case 0:
+					TrafficGenerator_SubmitBlockCommand(SCSI_CMD_READ_10, TableBlock, 1);
+					break;
+				case 1:
+					TrafficGenerator_SubmitBlockCommand(SCSI_CMD_READ_10, DirectoryBlock, 1);
+					break;
+				case 2:
+					TrafficGenerator_SubmitBlockCommand(SCSI_CMD_WRITE_10, DataBlock, TRAFFIC_CLUSTER_BLOCKS);
+					break;
+				case 3:
+					TrafficGenerator_SubmitBlockCommand(SCSI_CMD_WRITE_10, TableBlock, 1);
+					break;
+				case 4:
+					TrafficGenerator_SubmitBlockCommand(SCSI_CMD_WRITE_10, DirectoryBlock, 1);
+
+					if ((DataBlock + (2 * TRAFFIC_CLUSTER_BLOCKS)) > DiskBlocks)
+					  FileCluster = 0;
+					else
+					  FileCluster++;
+
+					break;
+			}
+
+			break;
+		}
+	}
+
+	CommandIndex++;
+}
+
+/** Issues a READ (10) or WRITE (10) command to the device. Written blocks are filled with a pattern derived from
+ *  their block address.
+ *
+ *  \param[in] Opcode        SCSI command opcode, either \c SCSI_CMD_READ_10 or \c SCSI_CMD_WRITE_10
+ *  \param[in] BlockAddress  Address of the first block to transfer
+ *  \param[in] TotalBlocks   Number of blocks to transfer
+ */
+static void TrafficGenerator_SubmitBlockCommand(const uint8_t Opcode,
+                                                const uint32_t BlockAddress,
+                                                const uint16_t TotalBlocks)
+{
+	uint8_t BlockCommand[10] =
+		{
+			Opcode,
+			0x00,
+			(BlockAddress >> 24),
+			(BlockAddress >> 16),
+			(BlockAddress >> 8),
+			(BlockAddress & 0xFF),
+			0x00,
+			(TotalBlocks >> 8),
+			(TotalBlocks & 0xFF),
+			0x00,
+		};
+
+	if (Opcode == SCSI_CMD_WRITE_10)
+	{
+		for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+		  memset(&DataBuffer[BlockIndex * TRAFFIC_BLOCK_SIZE], (uint8_t)(BlockAddress + BlockIndex), TRAFFIC_BLOCK_SIZE);
+	}
+
+	TrafficGenerator_SubmitCommand(BlockCommand, sizeof(BlockCommand), (Opcode == SCSI_CMD_READ_10),
+	                               (TotalBlocks * TRAFFIC_BLOCK_SIZE));
+}
+
+/** Issues a command to the device, by queueing the transfers of its command wrapper, data stage (if any) and
+ *  status wrapper on the virtual host. The data stage is transferred to or from \ref DataBuffer.
+ *
+ *  \param[in] CommandData    SCSI command block to issue
+ *  \param[in] CommandLength  Length of the SCSI command block, in bytes
+ *  \param[in] IsDataIN       Indicates if the data stage is from the device to the host
+ *  \param[in] DataLength     Length of the data stage, in bytes
+ */
+static void TrafficGenerator_SubmitCommand(const uint8_t* const CommandData,
+                                           const uint8_t CommandLength,
+                                           const bool IsDataIN,
+                                           const uint16_t DataLength)
+{
+	memset(&CommandBlock, 0x00, sizeof(CommandBlock));
+	memcpy(CommandBlock.SCSICommandData, CommandData, CommandLength);
+
+	CommandBlock.Signature          = CPU_TO_LE32(MS_CBW_SIGNATURE);
+	CommandBlock.Tag                = cpu_to_le32(++CommandTag);
+	CommandBlock.DataTransferLength = cpu_to_le32(DataLength);
+	CommandBlock.Flags              = (IsDataIN ? MS_COMMAND_DIR_DATA_IN : MS_COMMAND_DIR_DATA_OUT);
+	CommandBlock.LUN                = 0;
+	CommandBlock.SCSICommandLength  = CommandLength;
+
+	TrafficGenerator_SubmitTransfer(&CommandTransfer, MASS_STORAGE_OUT_EPADDR, &CommandBlock, sizeof(CommandBlock));
+
+	if (DataLength)
+	{
+		TrafficGenerator_SubmitTransfer(&DataTransfer, (IsDataIN ? MASS_STORAGE_IN_EPADDR : MASS_STORAGE_OUT_EPADDR),
+		                                DataBuffer, DataLength);
+	}
+	else
+	{
+		memset(&DataTransfer, 0x00, sizeof(DataTransfer));
+		DataTransfer.Status = VIRTUALHOST_STATUS_Complete;
+	}
+
+	TrafficGenerator_SubmitTransfer(&StatusTransfer, MASS_STORAGE_IN_EPADDR, &CommandStatus, sizeof(CommandStatus));
+	StatusTransfer.Callback = TrafficGenerator_CommandComplete;
+
+	CommandStartTime = TrafficGenerator_GetTimeNS();
+}
+
+/** Queues a bulk transfer on the virtual host.
+ *
+ *  \param[out] Transfer  Transfer to queue
+ *  \param[in]  Address   Address of the device endpoint to transfer to or from
+ *  \param[in]  Buffer    Buffer to transfer data to or from
+ *  \param[in]  Length    Length of the transfer, in bytes
+ */
+static void TrafficGenerator_SubmitTransfer(USB_VirtualHost_Transfer_t* const Transfer,
+                                            const uint8_t Address,
+                                            void* const Buffer,
+                                            const uint16_t Length)
+{
+	memset(Transfer, 0x00, sizeof(USB_VirtualHost_Transfer_t));
+
+	Transfer->Type    = EP_TYPE_BULK;
+	Transfer->Address = Address;
+	Transfer->Buffer  = Buffer;
+	Transfer->Length  = Length;
+
+	USB_VirtualHost_Submit(Transfer);
+}
+
+/** Completion callback for the status wrapper transfer of each issued command, which checks the returned status
+ *  and records the cost of the command against the current access pattern.
+ *
+ *  \param[in] Transfer  Completed status wrapper transfer
+ */
+static void TrafficGenerator_CommandComplete(USB_VirtualHost_Transfer_t* const Transfer)
+{
+	CommandSucceeded = ((CommandTransfer.Status == VIRTUALHOST_STATUS_Complete) &&
+	                    (DataTransfer.Status    == VIRTUALHOST_STATUS_Complete) &&
+	                    (Transfer->Status       == VIRTUALHOST_STATUS_Complete) &&
+	                    (Transfer->BytesTransferred == sizeof(CommandStatus))    &&
+	                    (CommandStatus.Signature == CPU_TO_LE32(MS_CSW_SIGNATURE)) &&
+	                    (CommandStatus.Tag       == CommandBlock.Tag)             &&
+	                    (CommandStatus.Status    == MS_SCSI_COMMAND_Pass)         &&
+	                    !(CommandStatus.DataTransferResidue));
+
+	if (GeneratorState != TRAFFIC_STATE_Replay)
+	  return;
+
+	TrafficGenerator_Statistics_t* Statistics = &PatternStatistics[CurrentPattern];
+
+	Statistics->Commands++;
+	Statistics->Bytes       += DataTransfer.BytesTransferred;
+	Statistics->Frames      += (Transfer->EndFrame - CommandTransfer.StartFrame);
+	Statistics->Packets     += (CommandTransfer.Packets + DataTransfer.Packets + Transfer->Packets);
+	Statistics->NAKs        += (CommandTransfer.NAKs + DataTransfer.NAKs + Transfer->NAKs);
+	Statistics->Nanoseconds += (TrafficGenerator_GetTimeNS() - CommandStartTime);
+
+	if (!(CommandSucceeded))
+	  Statistics->Failures++;
+}
+
+/** Prints the statistics gathered for each access pattern. The command overhead pattern transfers no data, and so
+ *  gives the fixed cost of each command in the Bulk-Only Transport and SCSI layers.
+ */
+static void TrafficGenerator_PrintReport(void)
+{
+	printf("%-18s %8s %6s %10s %8s %10s %8s %10s %10s\n", "Pattern", "Commands", "Failed", "Bytes", "NAKs",
+	       "Frames/cmd", "us/cmd", "KB/frame", "MB/s");
+
+	for (uint8_t PatternIndex = 0; PatternIndex < TRAFFIC_PATTERN_TOTAL; PatternIndex++)
+	{
+		TrafficGenerator_Statistics_t* Statistics = &PatternStatistics[PatternIndex];
+
+		if (!(Statistics->Commands))
+		  continue;
+
+		double Frames       = (Statistics->Frames ? Statistics->Frames : 1);
+		double Microseconds = ((Statistics->Nanoseconds ? Statistics->Nanoseconds : 1) / 1000.0);
+
+		printf("%-18s %8lu %6lu %10lu %8lu %10.2f %8.2f %10.2f %10.2f\n", PatternNames[PatternIndex],
+		       (unsigned long)Statistics->Commands, (unsigned long)Statistics->Failures,
+		       (unsigned long)Statistics->Bytes, (unsigned long)Statistics->NAKs,
+		       (Statistics->Frames / (double)Statistics->Commands), (Microseconds / Statistics->Commands),
+		       ((Statistics->Bytes / 1024.0) / Frames), (Statistics->Bytes / Microseconds));
+	}
+
+	printf("\nPer-command overhead: %.2f frames, %.2f us\n",
+	       (PatternStatistics[TRAFFIC_PATTERN_CommandOverhead].Frames / (double)TRAFFIC_GENERATOR_COMMANDS),
+	       (PatternStatistics[TRAFFIC_PATTERN_CommandOverhead].Nanoseconds / (1000.0 * TRAFFIC_GENERATOR_COMMANDS)));
+}
+
+/** Generates the next pseudo-random number in a fixed sequence, using a 32-bit xorshift generator.
+ *
+ *  \return Next pseudo-random number in the sequence
+ */
+static uint32_t TrafficGenerator_Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Retrieves the current build machine monotonic time, for timing commands.
+ *
+ *  \return Current time in nanoseconds
+ */
+static uint64_t TrafficGenerator_GetTimeNS(void)
+{
+	struct timespec CurrentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &CurrentTime);
+
+	return (((uint64_t)CurrentTime.tv_sec * 1000000000ULL) + CurrentTime.tv_nsec);
+}
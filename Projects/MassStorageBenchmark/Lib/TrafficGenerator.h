@@ -0,0 +1,127 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for TrafficGenerator.c.
+ */
+
+#ifndef _TRAFFIC_GENERATOR_H_
+#define _TRAFFIC_GENERATOR_H_
+
+	/* Includes: */
+		#include "../Descriptors.h"
+		#include "Config/AppConfig.h"
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Preprocessor Checks: */
+		#if (ARCH != ARCH_SIM)
+			#error The traffic generator requires the host-native simulated architecture (ARCH_SIM).
+		#endif
+
+	/* Defines: */
+		/** Maximum number of blocks transferred by a single generated command, limited by the 16-bit transfer
+		 *  length of the virtual host.
+		 */
+		#define TRAFFIC_MAX_BLOCKS_PER_COMMAND      64
+
+		/** Block size assumed by the traffic generator, which must match the block size reported by the device. */
+		#define TRAFFIC_BLOCK_SIZE                  512
+
+		/** Number of blocks at the start of the disk treated as the file allocation table region by the file system
+		 *  access pattern.
+		 */
+		#define TRAFFIC_FAT_REGION_BLOCKS           32
+
+		/** Number of blocks of each cluster written by the file system access pattern. */
+		#define TRAFFIC_CLUSTER_BLOCKS              8
+
+	/* Enums: */
+		/** Enum for the access patterns replayed by the traffic generator, in the order they are replayed. */
+		enum TrafficGenerator_Patterns_t
+		{
+			TRAFFIC_PATTERN_CommandOverhead = 0, /**< TEST UNIT READY commands with no data stage. */
+			TRAFFIC_PATTERN_SequentialRead  = 1, /**< Maximum length READ (10) commands over consecutive blocks. */
+			TRAFFIC_PATTERN_SequentialWrite = 2, /**< Maximum length WRITE (10) commands over consecutive blocks. */
+			TRAFFIC_PATTERN_RandomRead      = 3, /**< Cluster sized READ (10) commands at random cluster addresses. */
+			TRAFFIC_PATTERN_RandomWrite     = 4, /**< Cluster sized WRITE (10) commands at random cluster addresses. */
+			TRAFFIC_PATTERN_FileSystem      = 5, /**< Single block table and directory updates interleaved with
+			                                      *   cluster writes, as issued by a host copying a file to a FAT disk.
+			                                      */
+			TRAFFIC_PATTERN_TOTAL           = 6, /**< Total number of access patterns. */
+		};
+
+		/** Enum for the states of the traffic generator. */
+		enum TrafficGenerator_States_t
+		{
+			TRAFFIC_STATE_Enumerate     = 0, /**< Device is to be addressed and configured. */
+			TRAFFIC_STATE_ReadCapacity  = 1, /**< Capacity of the disk is to be read. */
+			TRAFFIC_STATE_StartReplay   = 2, /**< Capacity of the disk is to be checked before the replay begins. */
+			TRAFFIC_STATE_Replay        = 3, /**< Access patterns are being replayed. */
+		};
+
+	/* Type Defines: */
+		/** Type define for the statistics gathered for each access pattern replayed by the traffic generator. */
+		typedef struct
+		{
+			uint32_t Commands; /**< Number of commands issued. */
+			uint32_t Failures; /**< Number of commands which failed, or returned an invalid status wrapper. */
+			uint32_t Bytes; /**< Number of data stage bytes transferred. */
+			uint32_t Frames; /**< Number of simulated frames elapsed from each command wrapper to its status wrapper. */
+			uint32_t Packets; /**< Number of bulk packets transferred, including the command and status wrappers. */
+			uint32_t NAKs; /**< Number of bulk transactions the device was not ready for. */
+			uint64_t Nanoseconds; /**< Build machine time elapsed from each command wrapper to its status wrapper. */
+		} TrafficGenerator_Statistics_t;
+
+	/* Function Prototypes: */
+		void EVENT_USB_VirtualHost_Idle(void);
+
+		#if defined(INCLUDE_FROM_TRAFFICGENERATOR_C)
+			static void TrafficGenerator_SubmitCommand(const uint8_t* const CommandData,
+			                                           const uint8_t CommandLength,
+			                                           const bool IsDataIN,
+			                                           const uint16_t DataLength);
+			static void TrafficGenerator_SubmitTransfer(USB_VirtualHost_Transfer_t* const Transfer,
+			                                            const uint8_t Address,
+			                                            void* const Buffer,
+			                                            const uint16_t Length);
+			static void TrafficGenerator_SubmitBlockCommand(const uint8_t Opcode,
+			                                                const uint32_t BlockAddress,
+			                                                const uint16_t TotalBlocks);
+			static void TrafficGenerator_SubmitNextCommand(void);
+			static void TrafficGenerator_CommandComplete(USB_VirtualHost_Transfer_t* const Transfer);
+			static uint32_t TrafficGenerator_Random(void);
+			static uint64_t TrafficGenerator_GetTimeNS(void);
+			static void TrafficGenerator_PrintReport(void);
+		#endif
+
+#endif
@@ -75,9 +75,15 @@ DRESULT disk_ioctl (
 )
 {
 	if (ctrl == CTRL_SYNC)
-	  return RES_OK;
+	{
+		/* Commit any data still held in the Dataflash manager's write-back cache */
+		DataflashManager_CommitCache();
+		return RES_OK;
+	}
 	else
-	  return RES_PARERR;
+	{
+		return RES_PARERR;
+	}
 }
 
 
@@ -61,6 +61,20 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 			},
 	};
 
+/** SCSI logical unit of the Mass Storage interface, mapped to the board Dataflash. This table is passed to the library
+ *  SCSI command engine, which dispatches each SCSI command to its logical unit.
+ */
+static const MS_SCSI_LUN_t Disk_LUNs[] =
+	{
+		{
+			.Backend     = &DataflashManager_SCSIBackend,
+			.InquiryData = &DataflashManager_InquiryData,
+			.TotalBlocks = VIRTUAL_MEMORY_BLOCKS,
+			.BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE,
+			.ReadOnly    = DISK_READ_ONLY,
+		},
+	};
+
 /** Buffer to hold the previously generated HID report, for comparison purposes inside the HID class driver. */
 static uint8_t PrevHIDReportBuffer[GENERIC_REPORT_SIZE];
 
@@ -160,6 +174,14 @@ int main(void)
 	for (;;)
 	{
 		MS_Device_USBTask(&Disk_MS_Interface);
+
+		/* The logging timer ISR writes to the Dataflash once the device is unattached, so mask only the logging timer
+		 * interrupt while the cache may be committed by the main loop; a tick which falls due meanwhile is serviced
+		 * as soon as the interrupt is unmasked again */
+		TIMSK1 &= ~(1 << OCIE1A);
+		DataflashManager_CacheTask();
+		TIMSK1 |=  (1 << OCIE1A);
+
 		HID_Device_USBTask(&Generic_HID_Interface);
 		USB_USBTask();
 	}
@@ -271,7 +293,7 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo, Disk_LUNs);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
 	return CommandSuccess;
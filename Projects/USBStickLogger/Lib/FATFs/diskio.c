@@ -0,0 +1,98 @@
+/*-----------------------------------------------------------------------*/
+/* Low level disk I/O module skeleton for FatFs     (C)ChaN, 2007        */
+/*-----------------------------------------------------------------------*/
+/* This is a stub disk I/O module that acts as front end of the existing */
+/* disk I/O modules and attach it to FatFs module with common interface. */
+/*-----------------------------------------------------------------------*/
+
+#include "diskio.h"
+
+/*-----------------------------------------------------------------------*/
+/* Initialize a Drive                                                    */
+
+DSTATUS disk_initialize (
+	BYTE drv				/* Physical drive number (0..) */
+)
+{
+	return SectorCache_IsAttached() ? 0 : STA_NOINIT;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Return Disk Status                                                    */
+
+DSTATUS disk_status (
+	BYTE drv		/* Physical drive number (0..) */
+)
+{
+	return SectorCache_IsAttached() ? 0 : STA_NOINIT;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s)                                                        */
+
+DRESULT disk_read (
+	BYTE drv,		/* Physical drive number (0..) */
+	BYTE *buff,		/* Data buffer to store read data */
+	DWORD sector,	/* Sector address (LBA) */
+	BYTE count		/* Number of sectors to read (1..128) */
+)
+{
+	if (SectorCache_Read(sector, count, buff))
+	  return RES_ERROR;
+
+	return RES_OK;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Write Sector(s)                                                       */
+
+#if _READONLY == 0
+DRESULT disk_write (
+	BYTE drv,			/* Physical drive number (0..) */
+	const BYTE *buff,	/* Data to be written */
+	DWORD sector,		/* Sector address (LBA) */
+	BYTE count			/* Number of sectors to write (1..128) */
+)
+{
+	if (SectorCache_Write(sector, count, buff))
+	  return RES_ERROR;
+
+	return RES_OK;
+}
+#endif /* _READONLY */
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions                                               */
+
+DRESULT disk_ioctl (
+	BYTE drv,		/* Physical drive number (0..) */
+	BYTE ctrl,		/* Control code */
+	void *buff		/* Buffer to send/receive control data */
+)
+{
+	if (ctrl != CTRL_SYNC)
+	  return RES_PARERR;
+
+	/* Dirty sectors are only written to the disk when FatFs syncs a file, i.e. on f_sync() or f_close() */
+	if (SectorCache_Flush())
+	  return RES_ERROR;
+
+	return RES_OK;
+}
+
+
+DWORD get_fattime (void)
+{
+	/* No real time clock is available, so all files are stamped with a fixed date of 01/01/2021 00:00:00 */
+	return ((DWORD)(2021 - 1980) << 25) |
+	                     ((DWORD)1 << 21) |
+	                     ((DWORD)1 << 16);
+}
@@ -0,0 +1,462 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Sector cache between the FatFs disk I/O layer and the Mass Storage Host class driver. Single sector accesses, which
+ *  FatFs makes for the FAT, directory entries and partial file sectors, are served from two pools of cached sectors,
+ *  each replaced in least recently used order: one pool for the sectors of the FAT region of the mounted volume, and
+ *  one for all other sectors. Keeping the FAT sectors in their own pool prevents file data from evicting them while a
+ *  file is appended to, so that a cluster allocation does not require the FAT sector to be re-read from the disk.
+ *
+ *  Written sectors are held in the cache as dirty entries, and only written to the disk when the cache is flushed or
+ *  the entry is evicted. Consecutive dirty sectors are written back as a single multi-block WRITE command, streamed
+ *  to the disk directly from the cache entries. Multiple sector accesses, made by FatFs for whole sectors of file data,
+ *  bypass the cache to avoid evicting the file system metadata, while remaining coherent with any cached copies.
+ */
+
+#define  INCLUDE_FROM_SECTORCACHE_C
+#include "SectorCache.h"
+
+/** Statistics of the cache since the disk was attached. */
+SectorCache_Stats_t SectorCache_Stats;
+
+/** Mass Storage Host class driver interface of the attached disk, or \c NULL if no disk is attached. */
+static USB_ClassInfo_MS_Host_t* SectorCache_MSInterface;
+
+/** LUN index of the attached disk within its Mass Storage device. */
+static uint8_t SectorCache_LUNIndex;
+
+/** First sector of the FAT region of the mounted volume, whose sectors are cached in the FAT pool. */
+static uint32_t SectorCache_FATStartSector;
+
+/** Number of sectors in the FAT region of the mounted volume, or zero if no volume is mounted. */
+static uint32_t SectorCache_FATTotalSectors;
+
+/** Cache entries of both pools. The first \c SECTOR_CACHE_SECTORS entries belong to the general pool, and the remaining
+ *  \c FAT_CACHE_SECTORS entries to the FAT pool.
+ */
+static SectorCache_Entry_t SectorCache_Entries[SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS];
+
+/** Use order of the cache entries of both pools, indexed by the pools' \c UseOrder pointers. */
+static uint8_t SectorCache_UseOrder[SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS];
+
+/** Cache pool for all sectors outside the FAT region. */
+static SectorCache_Pool_t SectorCache_DataPool =
+	{
+		.UseOrder     = &SectorCache_UseOrder[0],
+		.TotalEntries = SECTOR_CACHE_SECTORS,
+	};
+
+#if (FAT_CACHE_SECTORS > 0)
+/** Cache pool for the sectors of the FAT region. */
+static SectorCache_Pool_t SectorCache_FATPool =
+	{
+		.UseOrder     = &SectorCache_UseOrder[SECTOR_CACHE_SECTORS],
+		.TotalEntries = FAT_CACHE_SECTORS,
+	};
+#endif
+
+
+/** Attaches the cache to a Mass Storage disk, discarding any previously cached sectors. The disk must have a block
+ *  size of \ref SECTOR_CACHE_SECTOR_SIZE bytes.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage Host class interface of the disk's device
+ *  \param[in] LUNIndex         Index of the disk's LUN within the device
+ */
+void SectorCache_Attach(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                        const uint8_t LUNIndex)
+{
+	for (uint8_t EntryIndex = 0; EntryIndex < (SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS); EntryIndex++)
+	{
+		SectorCache_Entries[EntryIndex].Flags = 0;
+		SectorCache_UseOrder[EntryIndex]      = EntryIndex;
+	}
+
+	memset(&SectorCache_Stats, 0x00, sizeof(SectorCache_Stats));
+
+	SectorCache_FATTotalSectors = 0;
+	SectorCache_LUNIndex        = LUNIndex;
+	SectorCache_MSInterface     = MSInterfaceInfo;
+}
+
+/** Detaches the cache from the current disk, e.g. once it has been removed. Any dirty sectors are discarded. */
+void SectorCache_Detach(void)
+{
+	SectorCache_MSInterface = NULL;
+}
+
+/** Determines if the cache is currently attached to a disk.
+ *
+ *  \return Boolean \c true if a disk is attached, \c false otherwise
+ */
+bool SectorCache_IsAttached(void)
+{
+	return (SectorCache_MSInterface != NULL);
+}
+
+/** Sets the region of the disk holding the volume's FAT copies, whose sectors are cached in the separate FAT pool. This
+ *  should be called once the volume has been mounted; until it is, all sectors are cached in the general pool.
+ *
+ *  \param[in] FirstSector   First sector of the FAT region
+ *  \param[in] TotalSectors  Number of sectors in the FAT region, across all FAT copies
+ */
+void SectorCache_SetFATRegion(const uint32_t FirstSector,
+                              const uint32_t TotalSectors)
+{
+	SectorCache_FATStartSector  = FirstSector;
+	SectorCache_FATTotalSectors = TotalSectors;
+}
+
+/** Reads sectors from the disk, via the cache.
+ *
+ *  \param[in]  Sector        First sector to read
+ *  \param[in]  TotalSectors  Number of consecutive sectors to read
+ *  \param[out] Buffer        Buffer to store the read sectors into
+ *
+ *  \return Zero on success, or an error code from the Mass Storage Host class driver
+ */
+uint8_t SectorCache_Read(const uint32_t Sector,
+                         const uint8_t TotalSectors,
+                         uint8_t* Buffer)
+{
+	SectorCache_Entry_t* Entry;
+	uint8_t              ErrorCode;
+
+	if (SectorCache_MSInterface == NULL)
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	if (TotalSectors == 1)
+	{
+		if ((Entry = SectorCache_FindEntry(Sector)) != NULL)
+		{
+			SectorCache_Stats.ReadHits++;
+		}
+		else
+		{
+			SectorCache_Stats.ReadMisses++;
+
+			if ((ErrorCode = SectorCache_AllocateEntry(Sector, &Entry)) != 0)
+			  return ErrorCode;
+
+			if ((ErrorCode = MS_Host_ReadDeviceBlocks(SectorCache_MSInterface, SectorCache_LUNIndex, Sector, 1,
+			                                          SECTOR_CACHE_SECTOR_SIZE, Entry->Data)) != 0)
+			{
+				Entry->Flags = 0;
+				return ErrorCode;
+			}
+		}
+
+		memcpy(Buffer, Entry->Data, SECTOR_CACHE_SECTOR_SIZE);
+		SectorCache_MarkUsed(SectorCache_GetEntryIndex(Entry));
+
+		return 0;
+	}
+
+	if ((ErrorCode = MS_Host_ReadDeviceBlocks(SectorCache_MSInterface, SectorCache_LUNIndex, Sector, TotalSectors,
+	                                          SECTOR_CACHE_SECTOR_SIZE, Buffer)) != 0)
+	{
+		return ErrorCode;
+	}
+
+	/* Cached copies of the read sectors may be newer than the disk contents, and take precedence */
+	for (uint8_t EntryIndex = 0; EntryIndex < (SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS); EntryIndex++)
+	{
+		Entry = &SectorCache_Entries[EntryIndex];
+
+		if ((Entry->Flags & SECTOR_CACHE_FLAG_VALID) && (Entry->Sector >= Sector) && (Entry->Sector < (Sector + TotalSectors)))
+		  memcpy(&Buffer[(uint16_t)(Entry->Sector - Sector) * SECTOR_CACHE_SECTOR_SIZE], Entry->Data, SECTOR_CACHE_SECTOR_SIZE);
+	}
+
+	return 0;
+}
+
+/** Writes sectors to the disk, via the cache. Single sectors are only stored in the cache, and are written to the disk
+ *  once evicted from the cache or when \ref SectorCache_Flush() is called.
+ *
+ *  \param[in] Sector        First sector to write
+ *  \param[in] TotalSectors  Number of consecutive sectors to write
+ *  \param[in] Buffer        Buffer holding the sectors to write
+ *
+ *  \return Zero on success, or an error code from the Mass Storage Host class driver
+ */
+uint8_t SectorCache_Write(const uint32_t Sector,
+                          const uint8_t TotalSectors,
+                          const uint8_t* Buffer)
+{
+	SectorCache_Entry_t* Entry;
+	uint8_t              ErrorCode;
+
+	if (SectorCache_MSInterface == NULL)
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	if (TotalSectors == 1)
+	{
+		if ((Entry = SectorCache_FindEntry(Sector)) != NULL)
+		{
+			if (Entry->Flags & SECTOR_CACHE_FLAG_DIRTY)
+			  SectorCache_Stats.WritesAbsorbed++;
+		}
+		else if ((ErrorCode = SectorCache_AllocateEntry(Sector, &Entry)) != 0)
+		{
+			return ErrorCode;
+		}
+
+		memcpy(Entry->Data, Buffer, SECTOR_CACHE_SECTOR_SIZE);
+		Entry->Flags |= SECTOR_CACHE_FLAG_DIRTY;
+		SectorCache_MarkUsed(SectorCache_GetEntryIndex(Entry));
+
+		return 0;
+	}
+
+	if ((ErrorCode = MS_Host_WriteDeviceBlocks(SectorCache_MSInterface, SectorCache_LUNIndex, Sector, TotalSectors,
+	                                           SECTOR_CACHE_SECTOR_SIZE, Buffer)) != 0)
+	{
+		return ErrorCode;
+	}
+
+	SectorCache_Stats.SectorsWritten += TotalSectors;
+	SectorCache_Stats.WriteCommands++;
+
+	/* Keep any cached copies of the written sectors up to date, which are now also clean */
+	for (uint8_t EntryIndex = 0; EntryIndex < (SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS); EntryIndex++)
+	{
+		Entry = &SectorCache_Entries[EntryIndex];
+
+		if ((Entry->Flags & SECTOR_CACHE_FLAG_VALID) && (Entry->Sector >= Sector) && (Entry->Sector < (Sector + TotalSectors)))
+		{
+			memcpy(Entry->Data, &Buffer[(uint16_t)(Entry->Sector - Sector) * SECTOR_CACHE_SECTOR_SIZE], SECTOR_CACHE_SECTOR_SIZE);
+			Entry->Flags &= ~SECTOR_CACHE_FLAG_DIRTY;
+		}
+	}
+
+	return 0;
+}
+
+/** Writes all dirty sectors in the cache back to the disk, in ascending sector order.
+ *
+ *  \return Zero on success, or an error code from the Mass Storage Host class driver
+ */
+uint8_t SectorCache_Flush(void)
+{
+	if (SectorCache_MSInterface == NULL)
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	for (;;)
+	{
+		SectorCache_Entry_t* FirstDirtyEntry = NULL;
+		uint8_t              ErrorCode;
+
+		for (uint8_t EntryIndex = 0; EntryIndex < (SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS); EntryIndex++)
+		{
+			SectorCache_Entry_t* Entry = &SectorCache_Entries[EntryIndex];
+
+			if (!(Entry->Flags & SECTOR_CACHE_FLAG_DIRTY))
+			  continue;
+
+			if ((FirstDirtyEntry == NULL) || (Entry->Sector < FirstDirtyEntry->Sector))
+			  FirstDirtyEntry = Entry;
+		}
+
+		if (FirstDirtyEntry == NULL)
+		  break;
+
+		if ((ErrorCode = SectorCache_WriteBackRun(FirstDirtyEntry)) != 0)
+		  return ErrorCode;
+	}
+
+	return 0;
+}
+
+/** Retrieves the cache pool a given sector is cached in, according to the current FAT region.
+ *
+ *  \param[in] Sector  Sector whose pool is to be retrieved
+ *
+ *  \return Pointer to the sector's cache pool
+ */
+static SectorCache_Pool_t* SectorCache_GetPool(const uint32_t Sector)
+{
+#if (FAT_CACHE_SECTORS > 0)
+	if ((Sector >= SectorCache_FATStartSector) && ((Sector - SectorCache_FATStartSector) < SectorCache_FATTotalSectors))
+	  return &SectorCache_FATPool;
+#endif
+
+	return &SectorCache_DataPool;
+}
+
+/** Searches both cache pools for a cached copy of a given sector. Sectors cached before the FAT region was set may
+ *  reside in the general pool rather than the FAT pool, and are still found.
+ *
+ *  \param[in] Sector  Sector to search for
+ *
+ *  \return Pointer to the sector's cache entry, or \c NULL if the sector is not cached
+ */
+static SectorCache_Entry_t* SectorCache_FindEntry(const uint32_t Sector)
+{
+	for (uint8_t EntryIndex = 0; EntryIndex < (SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS); EntryIndex++)
+	{
+		SectorCache_Entry_t* Entry = &SectorCache_Entries[EntryIndex];
+
+		if ((Entry->Flags & SECTOR_CACHE_FLAG_VALID) && (Entry->Sector == Sector))
+		  return Entry;
+	}
+
+	return NULL;
+}
+
+/** Retrieves the index of a cache entry within the cache entry table.
+ *
+ *  \param[in] Entry  Cache entry whose index is to be retrieved
+ *
+ *  \return Index of the entry
+ */
+static uint8_t SectorCache_GetEntryIndex(const SectorCache_Entry_t* const Entry)
+{
+	return (Entry - SectorCache_Entries);
+}
+
+/** Moves a cache entry to the most recently used position of its pool.
+ *
+ *  \param[in] EntryIndex  Index of the cache entry which has been used
+ */
+static void SectorCache_MarkUsed(const uint8_t EntryIndex)
+{
+	uint8_t* UseOrder = (EntryIndex < SECTOR_CACHE_SECTORS) ? &SectorCache_UseOrder[0] : &SectorCache_UseOrder[SECTOR_CACHE_SECTORS];
+	uint8_t  Position = 0;
+
+	while (UseOrder[Position] != EntryIndex)
+	  Position++;
+
+	while (Position)
+	{
+		UseOrder[Position] = UseOrder[Position - 1];
+		Position--;
+	}
+
+	UseOrder[0] = EntryIndex;
+}
+
+/** Allocates a cache entry for a sector in its cache pool, by replacing the pool's least recently used entry. If the
+ *  replaced entry is dirty, it is first written back to the disk. The new entry is marked as valid, but its contents
+ *  must be filled by the caller.
+ *
+ *  \param[in]  Sector  Sector to allocate a cache entry for
+ *  \param[out] Entry   Location to store a pointer to the allocated entry
+ *
+ *  \return Zero on success, or an error code from the Mass Storage Host class driver
+ */
+static uint8_t SectorCache_AllocateEntry(const uint32_t Sector,
+                                         SectorCache_Entry_t** const Entry)
+{
+	SectorCache_Pool_t*  Pool        = SectorCache_GetPool(Sector);
+	SectorCache_Entry_t* VictimEntry = &SectorCache_Entries[Pool->UseOrder[Pool->TotalEntries - 1]];
+	uint8_t              ErrorCode;
+
+	if (VictimEntry->Flags & SECTOR_CACHE_FLAG_DIRTY)
+	{
+		if ((ErrorCode = SectorCache_WriteBackRun(VictimEntry)) != 0)
+		  return ErrorCode;
+	}
+
+	VictimEntry->Sector = Sector;
+	VictimEntry->Flags  = SECTOR_CACHE_FLAG_VALID;
+
+	*Entry = VictimEntry;
+	return 0;
+}
+
+/** Writes a dirty cache entry back to the disk, along with the dirty entries of any directly following sectors, as a
+ *  single multi-block WRITE command. All written entries are marked as clean.
+ *
+ *  \param[in] FirstEntry  Dirty cache entry of the first sector to write
+ *
+ *  \return Zero on success, or an error code from the Mass Storage Host class driver
+ */
+static uint8_t SectorCache_WriteBackRun(SectorCache_Entry_t* const FirstEntry)
+{
+	SectorCache_WriteRun_t Run;
+	uint8_t                TotalEntries = 0;
+	uint8_t                ErrorCode;
+
+	Run.Entries[TotalEntries++] = FirstEntry;
+
+	while (TotalEntries < (SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS))
+	{
+		SectorCache_Entry_t* NextEntry = SectorCache_FindEntry(FirstEntry->Sector + TotalEntries);
+
+		if ((NextEntry == NULL) || !(NextEntry->Flags & SECTOR_CACHE_FLAG_DIRTY))
+		  break;
+
+		Run.Entries[TotalEntries++] = NextEntry;
+	}
+
+	Run.CurrentEntry = 0;
+	Run.EntryOffset  = 0;
+
+	if ((ErrorCode = MS_Host_WriteDeviceBlocksStream(SectorCache_MSInterface, SectorCache_LUNIndex, FirstEntry->Sector,
+	                                                 TotalEntries, SECTOR_CACHE_SECTOR_SIZE,
+	                                                 SectorCache_WriteRunData, &Run)) != 0)
+	{
+		return ErrorCode;
+	}
+
+	for (uint8_t EntryIndex = 0; EntryIndex < TotalEntries; EntryIndex++)
+	  Run.Entries[EntryIndex]->Flags &= ~SECTOR_CACHE_FLAG_DIRTY;
+
+	SectorCache_Stats.SectorsWritten += TotalEntries;
+	SectorCache_Stats.WriteCommands++;
+	return 0;
+}
+
+/** Mass Storage Host class driver stream callback, writing the next bank of a run of cache entries to the disk.
+ *
+ *  \param[in]     Length        Number of bytes to write to the pipe
+ *  \param[in,out] CallbackData  Pointer to the \ref SectorCache_WriteRun_t state of the run being written
+ */
+static void SectorCache_WriteRunData(const uint16_t Length,
+                                     void* const CallbackData)
+{
+	SectorCache_WriteRun_t* Run      = (SectorCache_WriteRun_t*)CallbackData;
+	uint16_t                BytesRem = Length;
+
+	while (BytesRem)
+	{
+		uint16_t BytesInEntry = MIN(BytesRem, (SECTOR_CACHE_SECTOR_SIZE - Run->EntryOffset));
+
+		Pipe_Write_Stream_LE(&Run->Entries[Run->CurrentEntry]->Data[Run->EntryOffset], BytesInEntry, NULL);
+		BytesRem -= BytesInEntry;
+
+		if ((Run->EntryOffset += BytesInEntry) == SECTOR_CACHE_SECTOR_SIZE)
+		{
+			Run->EntryOffset = 0;
+			Run->CurrentEntry++;
+		}
+	}
+}
@@ -0,0 +1,131 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for SectorCache.c.
+ */
+
+#ifndef _SECTOR_CACHE_H_
+#define _SECTOR_CACHE_H_
+
+	/* Includes: */
+		#include <string.h>
+
+		#include "Config/AppConfig.h"
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Preprocessor Checks: */
+		#if (SECTOR_CACHE_SECTORS < 1)
+			#error SECTOR_CACHE_SECTORS must be at least one.
+		#endif
+
+		#if ((SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS) > 255)
+			#error The total of SECTOR_CACHE_SECTORS and FAT_CACHE_SECTORS must not exceed 255.
+		#endif
+
+	/* Defines: */
+		/** Size of each cached sector. Only disks with this block size are supported, as it matches the FatFs sector size. */
+		#define SECTOR_CACHE_SECTOR_SIZE     512
+
+		/** Cache entry flag, indicating that the entry holds a copy of a disk sector. */
+		#define SECTOR_CACHE_FLAG_VALID      (1 << 0)
+
+		/** Cache entry flag, indicating that the entry has been written and not yet stored back to the disk. */
+		#define SECTOR_CACHE_FLAG_DIRTY      (1 << 1)
+
+	/* Type Defines: */
+		/** Type define for a single sector cache entry. */
+		typedef struct
+		{
+			uint32_t Sector; /**< Address of the disk sector held in the entry. */
+			uint8_t  Flags; /**< Mask of \c SECTOR_CACHE_FLAG_* flags for the entry. */
+			uint8_t  Data[SECTOR_CACHE_SECTOR_SIZE]; /**< Cached sector contents. */
+		} SectorCache_Entry_t;
+
+		/** Type define for a pool of cache entries, which are replaced in least recently used order. */
+		typedef struct
+		{
+			uint8_t* UseOrder; /**< Indexes of the pool's cache entries, ordered from most to least recently used. */
+			uint8_t  TotalEntries; /**< Number of cache entries in the pool. */
+		} SectorCache_Pool_t;
+
+		/** Type define for the cache statistics, for tuning of the cache sizes. */
+		typedef struct
+		{
+			uint32_t ReadHits; /**< Number of single sector reads served from the cache. */
+			uint32_t ReadMisses; /**< Number of single sector reads which had to be read from the disk. */
+			uint32_t WritesAbsorbed; /**< Number of single sector writes which replaced a still dirty cache entry. */
+			uint32_t SectorsWritten; /**< Total number of sectors written to the disk. */
+			uint32_t WriteCommands; /**< Total number of WRITE commands issued to the disk. */
+		} SectorCache_Stats_t;
+
+		/** Type define for the state of a run of dirty cache entries being written back to the disk. */
+		typedef struct
+		{
+			SectorCache_Entry_t* Entries[SECTOR_CACHE_SECTORS + FAT_CACHE_SECTORS]; /**< Entries of consecutive sectors in the run. */
+			uint8_t              CurrentEntry; /**< Index of the entry currently being written. */
+			uint16_t             EntryOffset; /**< Offset of the next byte to write within the current entry. */
+		} SectorCache_WriteRun_t;
+
+	/* External Variables: */
+		extern SectorCache_Stats_t SectorCache_Stats;
+
+	/* Function Prototypes: */
+		void    SectorCache_Attach(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+		                           const uint8_t LUNIndex) ATTR_NON_NULL_PTR_ARG(1);
+		void    SectorCache_Detach(void);
+		bool    SectorCache_IsAttached(void);
+		void    SectorCache_SetFATRegion(const uint32_t FirstSector,
+		                                 const uint32_t TotalSectors);
+		uint8_t SectorCache_Read(const uint32_t Sector,
+		                         const uint8_t TotalSectors,
+		                         uint8_t* Buffer) ATTR_NON_NULL_PTR_ARG(3);
+		uint8_t SectorCache_Write(const uint32_t Sector,
+		                          const uint8_t TotalSectors,
+		                          const uint8_t* Buffer) ATTR_NON_NULL_PTR_ARG(3);
+		uint8_t SectorCache_Flush(void);
+
+		#if defined(INCLUDE_FROM_SECTORCACHE_C)
+			static SectorCache_Pool_t*  SectorCache_GetPool(const uint32_t Sector) ATTR_WARN_UNUSED_RESULT;
+			static SectorCache_Entry_t* SectorCache_FindEntry(const uint32_t Sector) ATTR_WARN_UNUSED_RESULT;
+			static uint8_t              SectorCache_GetEntryIndex(const SectorCache_Entry_t* const Entry) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+			static void                 SectorCache_MarkUsed(const uint8_t EntryIndex);
+			static uint8_t              SectorCache_AllocateEntry(const uint32_t Sector,
+			                                                      SectorCache_Entry_t** const Entry) ATTR_NON_NULL_PTR_ARG(2);
+			static uint8_t              SectorCache_WriteBackRun(SectorCache_Entry_t* const FirstEntry) ATTR_NON_NULL_PTR_ARG(1);
+			static void                 SectorCache_WriteRunData(const uint16_t Length,
+			                                                     void* const CallbackData) ATTR_NON_NULL_PTR_ARG(2);
+		#endif
+
+#endif
+
@@ -0,0 +1,417 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Main source file for the USBStickLogger project. This file contains the main tasks of
+ *  the project and is responsible for the initial application hardware configuration.
+ */
+
+#include "USBStickLogger.h"
+
+/** LUFA Mass Storage Class driver interface configuration and state information. This structure is
+ *  passed to all Mass Storage Class driver functions, so that multiple instances of the same class
+ *  within a device can be differentiated from one another.
+ */
+USB_ClassInfo_MS_Host_t FlashDisk_MS_Interface =
+	{
+		.Config =
+			{
+				.DataINPipe             =
+					{
+						.Address        = (PIPE_DIR_IN  | 1),
+						.Banks          = 1,
+					},
+				.DataOUTPipe            =
+					{
+						.Address        = (PIPE_DIR_OUT | 2),
+						.Banks          = 1,
+					},
+			},
+	};
+
+/** FAT Fs structure to hold the internal state of the FAT driver for the attached disk's volume. */
+static FATFS DiskFATState;
+
+/** FAT Fs structure to hold a FAT file handle for the log data write destination. */
+static FIL LogFile;
+
+/** Indicates if the log file is currently open on the attached disk. */
+static bool LogFileOpen;
+
+/** Number of the next record to be written to the log file. */
+static uint32_t LogRecordNumber;
+
+/** Number of records written to the log file since it was last synchronized to the disk. */
+static uint16_t RecordsSinceSync;
+
+/** Total number of 500ms ticks elapsed since the last log record was written. */
+static uint8_t CurrentLoggingTicks;
+
+/** Flag set by the tick timer ISR when the next log record is due. */
+static volatile bool LogRecordDue;
+
+
+/** ISR to handle the 500ms ticks for data logging. */
+ISR(TIMER1_COMPA_vect, ISR_BLOCK)
+{
+	if (++CurrentLoggingTicks < LOG_INTERVAL_500MS)
+	  return;
+
+	CurrentLoggingTicks = 0;
+	LogRecordDue        = true;
+}
+
+/** Main program entry point. This routine configures the hardware required by the application, then
+ *  enters a loop to run the application tasks in sequence.
+ */
+int main(void)
+{
+	SetupHardware();
+
+	puts_P(PSTR(ESC_FG_CYAN "USB Stick Logger running.\r\n" ESC_FG_WHITE));
+
+	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+	GlobalInterruptEnable();
+
+	for (;;)
+	{
+		USBStickLogger_Task();
+
+		MS_Host_USBTask(&FlashDisk_MS_Interface);
+		USB_USBTask();
+	}
+}
+
+/** Configures the board hardware and chip peripherals for the project's functionality. */
+void SetupHardware(void)
+{
+#if (ARCH == ARCH_AVR8)
+	/* Disable watchdog if enabled by bootloader/fuses */
+	MCUSR &= ~(1 << WDRF);
+	wdt_disable();
+
+	/* Disable clock division */
+	clock_prescale_set(clock_div_1);
+#endif
+
+	/* Hardware Initialization */
+	Serial_Init(9600, false);
+	LEDs_Init();
+	Buttons_Init();
+	ADC_Init(ADC_FREE_RUNNING | ADC_PRESCALE_128);
+	Temperature_Init();
+	USB_Init();
+
+	/* 500ms logging interval timer configuration */
+	OCR1A   = (((F_CPU / 256) / 2) - 1);
+	TCCR1B  = (1 << WGM12) | (1 << CS12);
+	TIMSK1  = (1 << OCIE1A);
+
+	/* Create a stdio stream for the serial port for stdin and stdout */
+	Serial_CreateStream(NULL);
+}
+
+/** Task to manage the log file on an enumerated USB Mass Storage device once connected, appending a new record
+ *  to it each logging interval. The log file is closed when the board button is pressed, so that the disk may be
+ *  safely removed.
+ */
+void USBStickLogger_Task(void)
+{
+	if (USB_HostState != HOST_STATE_Configured)
+	  return;
+
+	if (!(LogFileOpen))
+	{
+		LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
+
+		if (!(OpenLogFile()))
+		{
+			LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+			USB_Host_SetDeviceConfiguration(0);
+			return;
+		}
+
+		LEDs_SetAllLEDs(LEDMASK_USB_READY);
+	}
+
+	if (Buttons_GetStatus() & BUTTONS_BUTTON1)
+	{
+		LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
+
+		if (!(CloseLogFile()))
+		{
+			LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+			USB_Host_SetDeviceConfiguration(0);
+			return;
+		}
+
+		puts_P(PSTR("Log file closed, disk may now be removed.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_DISK_SAFE);
+		USB_Host_SetDeviceConfiguration(0);
+		return;
+	}
+
+	if (!(LogRecordDue))
+	  return;
+
+	LogRecordDue = false;
+
+	if (!(WriteLogRecord()))
+	{
+		puts_P(PSTR("Error writing to log file.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		USB_Host_SetDeviceConfiguration(0);
+	}
+}
+
+/** Mounts the FAT volume of the attached Mass Storage device's first LUN, and opens the log file on it for appending.
+ *
+ *  \return Boolean \c true if the log file was opened, \c false otherwise
+ */
+bool OpenLogFile(void)
+{
+	puts_P(PSTR("Waiting until ready...\r\n"));
+
+	for (;;)
+	{
+		uint8_t ErrorCode = MS_Host_TestUnitReady(&FlashDisk_MS_Interface, 0);
+
+		if (!(ErrorCode))
+		  break;
+
+		/* Check if an error other than a logical command error (device busy) received */
+		if (ErrorCode != MS_ERROR_LOGICAL_CMD_FAILED)
+		{
+			puts_P(PSTR("Error waiting for device to be ready.\r\n"));
+			return false;
+		}
+	}
+
+	SCSI_Capacity_t DiskCapacity;
+	if (MS_Host_ReadDeviceCapacity(&FlashDisk_MS_Interface, 0, &DiskCapacity))
+	{
+		puts_P(PSTR("Error retrieving device capacity.\r\n"));
+		return false;
+	}
+
+	if (DiskCapacity.BlockSize != SECTOR_CACHE_SECTOR_SIZE)
+	{
+		printf_P(PSTR("Unsupported block size of %lu bytes.\r\n"), DiskCapacity.BlockSize);
+		return false;
+	}
+
+	SectorCache_Attach(&FlashDisk_MS_Interface, 0);
+
+	/* Mount the volume and open the log file, which also reads in the volume's layout */
+	f_mount(0, &DiskFATState);
+
+	if ((f_open(&LogFile, LOG_FILENAME, FA_OPEN_ALWAYS | FA_WRITE) != FR_OK) ||
+	    (f_lseek(&LogFile, LogFile.fsize) != FR_OK))
+	{
+		puts_P(PSTR("Error opening log file.\r\n"));
+		SectorCache_Detach();
+		return false;
+	}
+
+	/* Cache the sectors of all FAT copies in the separate FAT sector pool */
+	SectorCache_SetFATRegion(DiskFATState.fatbase, (DiskFATState.fsize * DiskFATState.n_fats));
+
+	printf_P(PSTR("Appending to " LOG_FILENAME ", currently %lu bytes.\r\n"), LogFile.fsize);
+
+	LogFileOpen      = true;
+	RecordsSinceSync = 0;
+	return true;
+}
+
+/** Appends a new record to the open log file, synchronizing the file to the disk every \c LOG_SYNC_RECORDS records.
+ *
+ *  \return Boolean \c true if the record was written, \c false otherwise
+ */
+bool WriteLogRecord(void)
+{
+	char LineBuffer[32];
+	UINT BytesWritten;
+
+	BytesWritten = snprintf(LineBuffer, sizeof(LineBuffer), "%lu, %d Degrees\r\n",
+	                        LogRecordNumber++, Temperature_GetTemperature());
+
+	if (f_write(&LogFile, LineBuffer, BytesWritten, &BytesWritten) != FR_OK)
+	  return false;
+
+	if (++RecordsSinceSync < LOG_SYNC_RECORDS)
+	  return true;
+
+	RecordsSinceSync = 0;
+
+	if (f_sync(&LogFile) != FR_OK)
+	  return false;
+
+	printf_P(PSTR("Synchronized, %lu sectors written, %lu/%lu cache hits.\r\n"), SectorCache_Stats.SectorsWritten,
+	         SectorCache_Stats.ReadHits, (SectorCache_Stats.ReadHits + SectorCache_Stats.ReadMisses));
+
+	return true;
+}
+
+/** Closes the open log file, writing all of its cached sectors to the disk.
+ *
+ *  \return Boolean \c true if the log file was closed, \c false otherwise
+ */
+bool CloseLogFile(void)
+{
+	if (!(LogFileOpen))
+	  return true;
+
+	LogFileOpen = false;
+
+	if (f_close(&LogFile) != FR_OK)
+	  return false;
+
+	f_mount(0, NULL);
+	SectorCache_Detach();
+
+	MS_Host_PreventAllowMediumRemoval(&FlashDisk_MS_Interface, 0, false);
+	return true;
+}
+
+/** Event handler for the USB_DeviceAttached event. This indicates that a device has been attached to the host, and
+ *  starts the library USB task to begin the enumeration and USB management process.
+ */
+void EVENT_USB_Host_DeviceAttached(void)
+{
+	puts_P(PSTR("Device Attached.\r\n"));
+	LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
+}
+
+/** Event handler for the USB_DeviceUnattached event. This indicates that a device has been removed from the host, and
+ *  stops the library USB task management process.
+ */
+void EVENT_USB_Host_DeviceUnattached(void)
+{
+	/* Records written since the last synchronization are lost if the disk is removed while the log file is open */
+	if (LogFileOpen)
+	  printf_P(PSTR("Device removed with %u unsynchronized records.\r\n"), RecordsSinceSync);
+
+	LogFileOpen = false;
+	SectorCache_Detach();
+	f_mount(0, NULL);
+
+	puts_P(PSTR("\r\nDevice Unattached.\r\n"));
+	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+}
+
+/** Event handler for the USB_DeviceEnumerationComplete event. This indicates that a device has been successfully
+ *  enumerated by the host and is now ready to be used by the application.
+ */
+void EVENT_USB_Host_DeviceEnumerationComplete(void)
+{
+	LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
+
+	uint16_t ConfigDescriptorSize;
+	uint8_t  ConfigDescriptorData[512];
+
+	if (USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
+	                                       sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful)
+	{
+		puts_P(PSTR("Error Retrieving Configuration Descriptor.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		return;
+	}
+
+	if (MS_Host_ConfigurePipes(&FlashDisk_MS_Interface,
+	                           ConfigDescriptorSize, ConfigDescriptorData) != MS_ENUMERROR_NoError)
+	{
+		puts_P(PSTR("Attached Device Not a Valid Mass Storage Device.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		return;
+	}
+
+	if (USB_Host_SetDeviceConfiguration(1) != HOST_SENDCONTROL_Successful)
+	{
+		puts_P(PSTR("Error Setting Device Configuration.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		return;
+	}
+
+	if (MS_Host_ResetMSInterface(&FlashDisk_MS_Interface))
+	{
+		puts_P(PSTR("Error resetting Mass Storage interface.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		USB_Host_SetDeviceConfiguration(0);
+		return;
+	}
+
+	SCSI_Request_Sense_Response_t SenseData;
+	if (MS_Host_RequestSense(&FlashDisk_MS_Interface, 0, &SenseData) != 0)
+	{
+		puts_P(PSTR("Error retrieving device sense.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		USB_Host_SetDeviceConfiguration(0);
+		return;
+	}
+
+	if (MS_Host_PreventAllowMediumRemoval(&FlashDisk_MS_Interface, 0, true))
+	{
+		puts_P(PSTR("Error setting Prevent Device Removal bit.\r\n"));
+		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+		USB_Host_SetDeviceConfiguration(0);
+		return;
+	}
+
+	puts_P(PSTR("Mass Storage Device Enumerated.\r\n"));
+	LEDs_SetAllLEDs(LEDMASK_USB_READY);
+}
+
+/** Event handler for the USB_HostError event. This indicates that a hardware error occurred while in host mode. */
+void EVENT_USB_Host_HostError(const uint8_t ErrorCode)
+{
+	USB_Disable();
+
+	printf_P(PSTR(ESC_FG_RED "Host Mode Error\r\n"
+	                         " -- Error Code %d\r\n" ESC_FG_WHITE), ErrorCode);
+
+	LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+	for(;;);
+}
+
+/** Event handler for the USB_DeviceEnumerationFailed event. This indicates that a problem occurred while
+ *  enumerating an attached USB device.
+ */
+void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
+                                            const uint8_t SubErrorCode)
+{
+	printf_P(PSTR(ESC_FG_RED "Dev Enum Error\r\n"
+	                         " -- Error Code %d\r\n"
+	                         " -- Sub Error Code %d\r\n"
+	                         " -- In State %d\r\n" ESC_FG_WHITE), ErrorCode, SubErrorCode, USB_HostState);
+
+	LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+}
+
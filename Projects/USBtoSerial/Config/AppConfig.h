@@ -0,0 +1,63 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Application Configuration Header File
+ *
+ *  This is a header file which is be used to configure some of
+ *  the application's compile time options, as an alternative to
+ *  specifying the compile time constants supplied through a
+ *  makefile or build system.
+ *
+ *  For information on what each token does, refer to the
+ *  \ref Sec_Options section of the application documentation.
+ */
+
+#ifndef _APP_CONFIG_H_
+#define _APP_CONFIG_H_
+
+	#define USB_TO_USART_BUFFER_SIZE       256
+	#define USART_TO_USB_BUFFER_SIZE       256
+
+//	#define ENABLE_HARDWARE_FLOW_CONTROL
+
+	#define FLOW_CONTROL_RTS_PORT          PORTC
+	#define FLOW_CONTROL_RTS_DDR           DDRC
+	#define FLOW_CONTROL_RTS_MASK          (1 << 0)
+
+	#define FLOW_CONTROL_CTS_PORT          PORTC
+	#define FLOW_CONTROL_CTS_PIN           PINC
+	#define FLOW_CONTROL_CTS_DDR           DDRC
+	#define FLOW_CONTROL_CTS_MASK          (1 << 1)
+
+	#define FLOW_CONTROL_HIGH_WATERMARK    ((USART_TO_USB_BUFFER_SIZE * 3) / 4)
+	#define FLOW_CONTROL_LOW_WATERMARK     (USART_TO_USB_BUFFER_SIZE / 4)
+
+#endif
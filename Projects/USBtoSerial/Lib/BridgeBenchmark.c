@@ -0,0 +1,373 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host-native benchmark of the USB to serial bridge's buffering and flow control. The bridge logic of
+ *  SerialBridge.c is driven by a simulation of the USART line and the host's USB bulk transfers, stepped one
+ *  USART byte time at a time with a USB frame every millisecond, with the same sequence of bridge calls as the
+ *  main loop and USART ISRs of the project.
+ *
+ *  In the USART to host direction the attached device sends continuously, while the host reads at most a set
+ *  number of IN packets per frame and periodically stops reading altogether, as a busy host application would.
+ *  The delivered throughput and number of bytes the bridge had to discard are measured with and without hardware
+ *  flow control, where the attached device honors the bridge's RTS line after a set number of bytes. In the host
+ *  to USART direction the host sends OUT packets as fast as the bridge accepts them, and the line utilization is
+ *  measured with and without the attached device periodically deasserting its CTS line.
+ *
+ *  Every delivered byte is checked against the sent sequence. The benchmark exits with an error if any byte was
+ *  corrupted, or if any byte was lost while hardware flow control was in use.
+ *
+ *  Usage: BridgeBenchmark [-b baud] [-t duration_ms] [-p packets_per_frame] [-i stall_interval_ms]
+ *                         [-s stall_ms] [-r rts_latency_bytes]
+ */
+
+#define  INCLUDE_FROM_BRIDGEBENCHMARK_C
+#include "BridgeBenchmark.h"
+
+/** USART baud rates each transfer is simulated at, when no specific baud rate is requested. */
+static const uint32_t DefaultBaudRates[] = {9600, 115200, 250000, 1000000};
+
+/** Baud rate requested on the command line, or zero to simulate each of the \ref DefaultBaudRates. */
+static uint32_t RequestedBaudRate;
+
+/** Duration of each simulated transfer, in milliseconds. */
+static uint32_t DurationMS      = BENCHMARK_DEFAULT_DURATION_MS;
+
+/** Number of bulk packets the host will transfer per USB frame. */
+static uint8_t  PacketsPerFrame = BENCHMARK_DEFAULT_PACKETS_PER_FRAME;
+
+/** Interval between periods in which the host stops reading, or the attached device deasserts CTS, in milliseconds. */
+static uint32_t StallIntervalMS = BENCHMARK_DEFAULT_STALL_INTERVAL_MS;
+
+/** Length of each period in which the host stops reading, or the attached device deasserts CTS, in milliseconds. */
+static uint32_t StallMS         = BENCHMARK_DEFAULT_STALL_MS;
+
+/** Number of bytes the attached device sends after the bridge deasserts its RTS line. */
+static uint8_t  RTSLatency      = BENCHMARK_DEFAULT_RTS_LATENCY;
+
+
+int main(int argc, char** argv)
+{
+	int Option;
+
+	while ((Option = getopt(argc, argv, "b:t:p:i:s:r:")) != -1)
+	{
+		switch (Option)
+		{
+			case 'b':
+				RequestedBaudRate = strtoul(optarg, NULL, 0);
+				break;
+			case 't':
+				DurationMS        = strtoul(optarg, NULL, 0);
+				break;
+			case 'p':
+				PacketsPerFrame   = strtoul(optarg, NULL, 0);
+				break;
+			case 'i':
+				StallIntervalMS   = strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				StallMS           = strtoul(optarg, NULL, 0);
+				break;
+			case 'r':
+				RTSLatency        = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-b baud] [-t duration_ms] [-p packets_per_frame] [-i stall_interval_ms] "
+				        "[-s stall_ms] [-r rts_latency_bytes]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (!(DurationMS) || !(PacketsPerFrame) || !(StallIntervalMS) || (StallMS > StallIntervalMS) ||
+	    (RTSLatency > BENCHMARK_MAX_RTS_LATENCY))
+	{
+		fprintf(stderr, "Invalid benchmark parameters.\n");
+		return 1;
+	}
+
+	printf("%u/%u byte buffers, RTS deasserted at %u bytes and reasserted at %u bytes\n",
+	       USB_TO_USART_BUFFER_SIZE, USART_TO_USB_BUFFER_SIZE, FLOW_CONTROL_HIGH_WATERMARK, FLOW_CONTROL_LOW_WATERMARK);
+	printf("%lu ms transfers, %u packet(s) per frame, %lu ms stalls every %lu ms, %u byte RTS latency\n\n",
+	       (unsigned long)DurationMS, PacketsPerFrame, (unsigned long)StallMS, (unsigned long)StallIntervalMS, RTSLatency);
+
+	printf("%-14s %8s %5s %8s %8s %6s %8s %6s\n", "Direction", "Baud", "Flow", "KB/s", "Line %", "Paused",
+	       "Lost", "Errors");
+
+	bool     Failed        = false;
+	uint8_t  TotalRates    = (RequestedBaudRate ? 1 : (sizeof(DefaultBaudRates) / sizeof(DefaultBaudRates[0])));
+
+	for (uint8_t RateIndex = 0; RateIndex < TotalRates; RateIndex++)
+	{
+		uint32_t BaudRate = (RequestedBaudRate ? RequestedBaudRate : DefaultBaudRates[RateIndex]);
+
+		for (uint8_t FlowControl = 0; FlowControl < 2; FlowControl++)
+		{
+			BridgeBenchmark_Statistics_t Statistics;
+
+			BridgeBenchmark_RunUSARTToHost(BaudRate, FlowControl, &Statistics);
+			BridgeBenchmark_PrintStatistics("USART to host", BaudRate, FlowControl, &Statistics);
+
+			if (Statistics.Errors || (FlowControl && Statistics.Lost))
+			  Failed = true;
+
+			BridgeBenchmark_RunHostToUSART(BaudRate, FlowControl, &Statistics);
+			BridgeBenchmark_PrintStatistics("Host to USART", BaudRate, FlowControl, &Statistics);
+
+			if (Statistics.Errors)
+			  Failed = true;
+		}
+	}
+
+	if (Failed)
+	{
+		fprintf(stderr, "\nData was corrupted, or lost while hardware flow control was in use.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/** Simulates a transfer from the attached device to the host through the bridge.
+ *
+ *  \param[in]  BaudRate     Baud rate of the USART line, in bits per second
+ *  \param[in]  FlowControl  Indicates if the attached device honors the bridge's RTS line
+ *  \param[out] Statistics   Statistics gathered for the transfer
+ */
+static void BridgeBenchmark_RunUSARTToHost(const uint32_t BaudRate,
+                                           const bool FlowControl,
+                                           BridgeBenchmark_Statistics_t* const Statistics)
+{
+	uint8_t  INBank[BENCHMARK_EPSIZE];
+	uint8_t  INBankCount = 0;
+	bool     RTSHistory[BENCHMARK_MAX_RTS_LATENCY + 1] = {false};
+	bool     RTSDeasserted = false;
+	uint32_t BitCount      = 0;
+	uint32_t Accepted      = 0;
+
+	*Statistics = (BridgeBenchmark_Statistics_t){0};
+	SerialBridge_Init();
+
+	for (uint32_t Frame = 0; Frame < DurationMS; Frame++)
+	{
+		uint8_t PacketBudget = PacketsPerFrame;
+		bool    HostStalled  = BridgeBenchmark_IsHostStalled(Frame);
+
+		BitCount += BaudRate;
+
+		while (BitCount >= (BENCHMARK_BITS_PER_BYTE * 1000UL))
+		{
+			BitCount -= (BENCHMARK_BITS_PER_BYTE * 1000UL);
+
+			/* Main loop: fill the IN endpoint bank once the host has taken the last packet, up to one byte less than
+			 * the bank size as the project does, and let the host take as many packets as it will in this frame */
+			for (;;)
+			{
+				if (!(INBankCount))
+				{
+					uint8_t BytesToSend = MIN(SerialBridge_GetHostTransmitCount(), (BENCHMARK_EPSIZE - 1));
+
+					while (BytesToSend)
+					{
+						uint8_t* SpanData;
+						uint8_t  SpanLength = MIN(SerialBridge_GetHostTransmitSpan(&SpanData), BytesToSend);
+
+						memcpy(&INBank[INBankCount], SpanData, SpanLength);
+						SerialBridge_HostDataSent(SpanLength);
+
+						INBankCount += SpanLength;
+						BytesToSend -= SpanLength;
+					}
+				}
+
+				if (!(INBankCount) || !(PacketBudget) || HostStalled)
+				  break;
+
+				for (uint8_t i = 0; i < INBankCount; i++)
+				{
+					if (INBank[i] != BridgeBenchmark_GetDataByte(Statistics->Delivered++))
+					  Statistics->Errors++;
+				}
+
+				INBankCount = 0;
+				PacketBudget--;
+			}
+
+			/* Main loop: reassert RTS once the USART receive buffer has drained below its low watermark */
+			if (FlowControl && SerialBridge_IsUSARTReceiveAllowed())
+			  RTSDeasserted = false;
+
+			/* The attached device only sees a change of the RTS line after its set latency */
+			RTSHistory[Statistics->ByteTimes % (BENCHMARK_MAX_RTS_LATENCY + 1)] = RTSDeasserted;
+
+			uint32_t SampleTime = (Statistics->ByteTimes + (BENCHMARK_MAX_RTS_LATENCY + 1) - RTSLatency);
+			bool     DevicePaused = (FlowControl && RTSHistory[SampleTime % (BENCHMARK_MAX_RTS_LATENCY + 1)]);
+
+			Statistics->ByteTimes++;
+
+			if (DevicePaused)
+			{
+				Statistics->PausedByteTimes++;
+				continue;
+			}
+
+			/* USART receive ISR: the sent sequence only advances for accepted bytes, so that discarded bytes are
+			 * counted as lost rather than as errors in the data delivered to the host */
+			Statistics->LineBytes++;
+
+			if (SerialBridge_USARTDataReceived(BridgeBenchmark_GetDataByte(Accepted)))
+			  Accepted++;
+			else
+			  Statistics->Lost++;
+
+			if (FlowControl && !(SerialBridge_IsUSARTReceiveAllowed()))
+			  RTSDeasserted = true;
+		}
+	}
+}
+
+/** Simulates a transfer from the host to the attached device through the bridge.
+ *
+ *  \param[in]  BaudRate     Baud rate of the USART line, in bits per second
+ *  \param[in]  FlowControl  Indicates if the attached device periodically deasserts its CTS line
+ *  \param[out] Statistics   Statistics gathered for the transfer
+ */
+static void BridgeBenchmark_RunHostToUSART(const uint32_t BaudRate,
+                                           const bool FlowControl,
+                                           BridgeBenchmark_Statistics_t* const Statistics)
+{
+	uint8_t  OUTBank[BENCHMARK_EPSIZE];
+	uint8_t  OUTBankCount  = 0;
+	uint8_t  OUTBankOffset = 0;
+	uint32_t BitCount      = 0;
+	uint32_t HostSent      = 0;
+
+	*Statistics = (BridgeBenchmark_Statistics_t){0};
+	SerialBridge_Init();
+
+	for (uint32_t Frame = 0; Frame < DurationMS; Frame++)
+	{
+		uint8_t PacketBudget = PacketsPerFrame;
+		bool    CTSDeasserted = (FlowControl && BridgeBenchmark_IsHostStalled(Frame));
+
+		BitCount += BaudRate;
+
+		while (BitCount >= (BENCHMARK_BITS_PER_BYTE * 1000UL))
+		{
+			BitCount -= (BENCHMARK_BITS_PER_BYTE * 1000UL);
+
+			/* Main loop: read received OUT packets directly into the free space of the USART transmit buffer, with
+			 * the host sending another packet each time the endpoint bank is emptied */
+			for (;;)
+			{
+				if (!(OUTBankCount) && PacketBudget)
+				{
+					for (uint8_t i = 0; i < BENCHMARK_EPSIZE; i++)
+					  OUTBank[i] = BridgeBenchmark_GetDataByte(HostSent++);
+
+					OUTBankCount  = BENCHMARK_EPSIZE;
+					OUTBankOffset = 0;
+					PacketBudget--;
+				}
+
+				uint8_t* FreeSpanData;
+				uint16_t BytesReceived = MIN(SerialBridge_GetHostReceiveSpan(&FreeSpanData), OUTBankCount);
+
+				if (!(BytesReceived))
+				  break;
+
+				memcpy(FreeSpanData, &OUTBank[OUTBankOffset], BytesReceived);
+				SerialBridge_HostDataReceived(BytesReceived);
+
+				OUTBankOffset += BytesReceived;
+				OUTBankCount  -= BytesReceived;
+			}
+
+			Statistics->ByteTimes++;
+
+			/* USART transmit ISR: send the next byte unless the attached device is deasserting its CTS line */
+			if (CTSDeasserted)
+			{
+				Statistics->PausedByteTimes++;
+			}
+			else if (SerialBridge_IsUSARTTransmitPending())
+			{
+				if (SerialBridge_GetUSARTTransmitByte() != BridgeBenchmark_GetDataByte(Statistics->Delivered++))
+				  Statistics->Errors++;
+
+				Statistics->LineBytes++;
+			}
+		}
+	}
+}
+
+/** Determines if the host has stopped reading from the bridge, or the attached device is deasserting its CTS line,
+ *  in the given USB frame.
+ *
+ *  \param[in] Frame  Number of the USB frame since the start of the transfer
+ *
+ *  \return Boolean \c true if the frame falls in a stall period, \c false otherwise
+ */
+static bool BridgeBenchmark_IsHostStalled(const uint32_t Frame)
+{
+	return ((Frame % StallIntervalMS) >= (StallIntervalMS - StallMS));
+}
+
+/** Prints the statistics of a simulated transfer as a row of the benchmark report.
+ *
+ *  \param[in] Name         Direction of the transfer
+ *  \param[in] BaudRate     Baud rate of the USART line, in bits per second
+ *  \param[in] FlowControl  Indicates if hardware flow control was in use
+ *  \param[in] Statistics   Statistics gathered for the transfer
+ */
+static void BridgeBenchmark_PrintStatistics(const char* const Name,
+                                            const uint32_t BaudRate,
+                                            const bool FlowControl,
+                                            const BridgeBenchmark_Statistics_t* const Statistics)
+{
+	uint32_t ByteTimes = MAX(Statistics->ByteTimes, 1);
+
+	printf("%-14s %8lu %5s %8.2f %8.1f %5.1f%% %8lu %6lu\n", Name, (unsigned long)BaudRate, (FlowControl ? "Yes" : "No"),
+	       ((double)Statistics->Delivered / DurationMS), (100.0 * Statistics->LineBytes / ByteTimes),
+	       (100.0 * Statistics->PausedByteTimes / ByteTimes), (unsigned long)Statistics->Lost,
+	       (unsigned long)Statistics->Errors);
+}
+
+/** Retrieves the value of a byte in the sent data sequence, which does not repeat with the buffer sizes.
+ *
+ *  \param[in] Sequence  Index of the byte in the sent data
+ *
+ *  \return Value of the indexed byte
+ */
+static inline uint8_t BridgeBenchmark_GetDataByte(const uint32_t Sequence)
+{
+	return (uint8_t)(Sequence ^ (Sequence >> 8));
+}
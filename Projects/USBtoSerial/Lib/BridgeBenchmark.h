@@ -0,0 +1,106 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for BridgeBenchmark.c.
+ */
+
+#ifndef _BRIDGE_BENCHMARK_H_
+#define _BRIDGE_BENCHMARK_H_
+
+	/* Includes: */
+		#include <stdbool.h>
+		#include <stdint.h>
+		#include <stdio.h>
+		#include <stdlib.h>
+		#include <string.h>
+		#include <unistd.h>
+
+		#include "Config/AppConfig.h"
+
+		#include "SerialBridge.h"
+
+	/* Defines: */
+		/** Size of the CDC data endpoints of the bridge, in bytes. */
+		#define BENCHMARK_EPSIZE                     64
+
+		/** Duration of each simulated transfer, in milliseconds. */
+		#define BENCHMARK_DEFAULT_DURATION_MS        2000
+
+		/** Default number of bulk packets the host will transfer in each direction per USB frame. */
+		#define BENCHMARK_DEFAULT_PACKETS_PER_FRAME  4
+
+		/** Default interval between periods in which the host stops reading data from the bridge, in milliseconds. */
+		#define BENCHMARK_DEFAULT_STALL_INTERVAL_MS  100
+
+		/** Default length of each period in which the host stops reading data from the bridge, in milliseconds. */
+		#define BENCHMARK_DEFAULT_STALL_MS           20
+
+		/** Default number of bytes the attached device sends after the bridge deasserts its RTS line. */
+		#define BENCHMARK_DEFAULT_RTS_LATENCY        2
+
+		/** Maximum supported RTS latency of the attached device, in bytes. */
+		#define BENCHMARK_MAX_RTS_LATENCY            32
+
+		/** Number of USART bits in each transferred byte, for 8N1 framing. */
+		#define BENCHMARK_BITS_PER_BYTE              10
+
+	/* Type Defines: */
+		/** Type define for the statistics gathered for each simulated transfer through the bridge. */
+		typedef struct
+		{
+			uint32_t ByteTimes; /**< Number of USART byte times in the transfer. */
+			uint32_t LineBytes; /**< Number of bytes transferred over the USART line. */
+			uint32_t Delivered; /**< Number of bytes delivered to their destination and checked. */
+			uint32_t Lost; /**< Number of bytes from the attached device discarded by the bridge. */
+			uint32_t Errors; /**< Number of delivered bytes which did not match the sent sequence. */
+			uint32_t PausedByteTimes; /**< Number of USART byte times in which the line was paused by flow control. */
+		} BridgeBenchmark_Statistics_t;
+
+	/* Function Prototypes: */
+		int main(int argc, char** argv);
+
+		#if defined(INCLUDE_FROM_BRIDGEBENCHMARK_C)
+			static void BridgeBenchmark_RunUSARTToHost(const uint32_t BaudRate,
+			                                           const bool FlowControl,
+			                                           BridgeBenchmark_Statistics_t* const Statistics);
+			static void BridgeBenchmark_RunHostToUSART(const uint32_t BaudRate,
+			                                           const bool FlowControl,
+			                                           BridgeBenchmark_Statistics_t* const Statistics);
+			static bool BridgeBenchmark_IsHostStalled(const uint32_t Frame);
+			static void BridgeBenchmark_PrintStatistics(const char* const Name,
+			                                            const uint32_t BaudRate,
+			                                            const bool FlowControl,
+			                                            const BridgeBenchmark_Statistics_t* const Statistics);
+			static inline uint8_t BridgeBenchmark_GetDataByte(const uint32_t Sequence);
+		#endif
+
+#endif
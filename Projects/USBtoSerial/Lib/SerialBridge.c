@@ -0,0 +1,170 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Buffering and flow control logic of the USB to serial bridge, between the CDC interface to the host and the USART
+ *  to the attached device. This holds no references to the USB controller or USART hardware, so that it can also be
+ *  built into a host-native benchmark of the bridge (see BridgeBenchmark.c).
+ */
+
+#include "SerialBridge.h"
+
+/** Circular buffer to hold data from the host before it is sent to the device via the serial port. */
+static RingBuffer_t USBtoUSART_Buffer;
+
+/** Underlying data buffer for \ref USBtoUSART_Buffer, where the stored bytes are located. */
+static uint8_t      USBtoUSART_Buffer_Data[USB_TO_USART_BUFFER_SIZE];
+
+/** Circular buffer to hold data from the serial port before it is sent to the host. */
+static RingBuffer_t USARTtoUSB_Buffer;
+
+/** Underlying data buffer for \ref USARTtoUSB_Buffer, where the stored bytes are located. */
+static uint8_t      USARTtoUSB_Buffer_Data[USART_TO_USB_BUFFER_SIZE];
+
+/** Indicates if reception from the attached device is paused, from the time the USART receive buffer reaches its
+ *  high watermark until it has drained below its low watermark.
+ */
+static volatile bool USARTReceivePaused;
+
+
+/** Initializes the bridge, emptying both of its buffers. */
+void SerialBridge_Init(void)
+{
+	RingBuffer_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
+	RingBuffer_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
+
+	USARTReceivePaused = false;
+}
+
+/** Retrieves the largest contiguous run of free space in the USART transmit buffer, into which data received from
+ *  the host can be read directly. The data must then be committed with \ref SerialBridge_HostDataReceived().
+ *
+ *  \param[out] Data  Location where a pointer to the start of the free run is to be stored
+ *
+ *  \return Number of bytes that can be read from the host into the run
+ */
+uint16_t SerialBridge_GetHostReceiveSpan(uint8_t** const Data)
+{
+	return RingBuffer_GetWriteSpan(&USBtoUSART_Buffer, Data);
+}
+
+/** Commits data read from the host into the run given by \ref SerialBridge_GetHostReceiveSpan(), queuing it for
+ *  transmission to the attached device.
+ *
+ *  \param[in] Length  Number of bytes read from the host
+ */
+void SerialBridge_HostDataReceived(const uint16_t Length)
+{
+	RingBuffer_AdvanceWrite(&USBtoUSART_Buffer, Length);
+}
+
+/** Determines if there is data from the host waiting to be sent to the attached device.
+ *
+ *  \return Boolean \c true if data is waiting to be sent via the USART, \c false otherwise
+ */
+bool SerialBridge_IsUSARTTransmitPending(void)
+{
+	return !(RingBuffer_IsEmpty(&USBtoUSART_Buffer));
+}
+
+/** Removes the next byte from the host to be sent to the attached device. This must only be called once
+ *  \ref SerialBridge_IsUSARTTransmitPending() has indicated that data is waiting.
+ *
+ *  \return Next byte to send via the USART
+ */
+uint8_t SerialBridge_GetUSARTTransmitByte(void)
+{
+	return RingBuffer_Remove(&USBtoUSART_Buffer);
+}
+
+/** Queues a byte received from the attached device for transmission to the host, discarding it if the USART receive
+ *  buffer is full.
+ *
+ *  \param[in] Data  Byte received via the USART
+ *
+ *  \return Boolean \c true if the byte was queued, \c false if it was lost
+ */
+bool SerialBridge_USARTDataReceived(const uint8_t Data)
+{
+	if (RingBuffer_IsFull(&USARTtoUSB_Buffer))
+	  return false;
+
+	RingBuffer_Insert(&USARTtoUSB_Buffer, Data);
+	return true;
+}
+
+/** Determines if the attached device may currently send data, for hardware flow control. Reception is paused once
+ *  the USART receive buffer fills to FLOW_CONTROL_HIGH_WATERMARK bytes, and resumed once it has drained to
+ *  FLOW_CONTROL_LOW_WATERMARK bytes.
+ *
+ *  \return Boolean \c true if the attached device may send data, \c false if it should pause
+ */
+bool SerialBridge_IsUSARTReceiveAllowed(void)
+{
+	uint16_t BufferCount = RingBuffer_GetCount(&USARTtoUSB_Buffer);
+
+	if (BufferCount >= FLOW_CONTROL_HIGH_WATERMARK)
+	  USARTReceivePaused = true;
+	else if (BufferCount <= FLOW_CONTROL_LOW_WATERMARK)
+	  USARTReceivePaused = false;
+
+	return !(USARTReceivePaused);
+}
+
+/** Retrieves the number of bytes received from the attached device which are waiting to be sent to the host.
+ *
+ *  \return Number of bytes waiting to be sent to the host
+ */
+uint16_t SerialBridge_GetHostTransmitCount(void)
+{
+	return RingBuffer_GetCount(&USARTtoUSB_Buffer);
+}
+
+/** Retrieves the contiguous run of data at the start of the USART receive buffer, which can be sent to the host
+ *  directly from the buffer. The sent data must then be removed with \ref SerialBridge_HostDataSent().
+ *
+ *  \param[out] Data  Location where a pointer to the start of the run is to be stored
+ *
+ *  \return Number of bytes in the run
+ */
+uint16_t SerialBridge_GetHostTransmitSpan(uint8_t** const Data)
+{
+	return RingBuffer_GetReadSpan(&USARTtoUSB_Buffer, Data);
+}
+
+/** Removes data which has been sent to the host from the start of the USART receive buffer.
+ *
+ *  \param[in] Length  Number of bytes sent to the host
+ */
+void SerialBridge_HostDataSent(const uint16_t Length)
+{
+	RingBuffer_AdvanceRead(&USARTtoUSB_Buffer, Length);
+}
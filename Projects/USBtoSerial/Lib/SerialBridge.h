@@ -0,0 +1,59 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for SerialBridge.c.
+ */
+
+#ifndef _SERIAL_BRIDGE_H_
+#define _SERIAL_BRIDGE_H_
+
+	/* Includes: */
+		#include "Config/AppConfig.h"
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+
+	/* Function Prototypes: */
+		void     SerialBridge_Init(void);
+
+		uint16_t SerialBridge_GetHostReceiveSpan(uint8_t** const Data) ATTR_NON_NULL_PTR_ARG(1);
+		void     SerialBridge_HostDataReceived(const uint16_t Length);
+		bool     SerialBridge_IsUSARTTransmitPending(void);
+		uint8_t  SerialBridge_GetUSARTTransmitByte(void);
+
+		bool     SerialBridge_USARTDataReceived(const uint8_t Data);
+		bool     SerialBridge_IsUSARTReceiveAllowed(void);
+		uint16_t SerialBridge_GetHostTransmitCount(void);
+		uint16_t SerialBridge_GetHostTransmitSpan(uint8_t** const Data) ATTR_NON_NULL_PTR_ARG(1);
+		void     SerialBridge_HostDataSent(const uint16_t Length);
+
+#endif
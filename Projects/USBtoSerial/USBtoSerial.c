@@ -36,18 +36,6 @@
 
 #include "USBtoSerial.h"
 
-/** Circular buffer to hold data from the host before it is sent to the device via the serial port. */
-static RingBuffer_t USBtoUSART_Buffer;
-
-/** Underlying data buffer for \ref USBtoUSART_Buffer, where the stored bytes are located. */
-static uint8_t      USBtoUSART_Buffer_Data[128];
-
-/** Circular buffer to hold data from the serial port before it is sent to the host. */
-static RingBuffer_t USARTtoUSB_Buffer;
-
-/** Underlying data buffer for \ref USARTtoUSB_Buffer, where the stored bytes are located. */
-static uint8_t      USARTtoUSB_Buffer_Data[128];
-
 /** LUFA CDC Class driver interface configuration and state information. This structure is
  *  passed to all CDC Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -86,26 +74,27 @@ int main(void)
 {
 	SetupHardware();
 
-	RingBuffer_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
-	RingBuffer_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
+	SerialBridge_Init();
 
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 	GlobalInterruptEnable();
 
 	for (;;)
 	{
-		/* Only try to read in bytes from the CDC interface if the transmit buffer is not full */
-		if (!(RingBuffer_IsFull(&USBtoUSART_Buffer)))
+		/* Read in whole packets from the CDC interface directly into the free space of the USART transmit buffer */
+		uint8_t* FreeSpanData;
+		uint16_t FreeSpanLength = SerialBridge_GetHostReceiveSpan(&FreeSpanData);
+
+		if (FreeSpanLength)
 		{
-			int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
+			uint16_t BytesReceived = CDC_Device_ReceiveData(&VirtualSerial_CDC_Interface, FreeSpanData, FreeSpanLength);
 
-			/* Store received byte into the USART transmit buffer */
-			if (!(ReceivedByte < 0))
-			  RingBuffer_Insert(&USBtoUSART_Buffer, ReceivedByte);
+			if (BytesReceived)
+			  SerialBridge_HostDataReceived(BytesReceived);
 		}
 
-		uint16_t BufferCount = RingBuffer_GetCount(&USARTtoUSB_Buffer);
-		if (BufferCount)
+		uint16_t BufferCount = SerialBridge_GetHostTransmitCount();
+		if (BufferCount && (USB_DeviceState == DEVICE_STATE_Configured))
 		{
 			Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpoint.Address);
 
@@ -117,25 +106,54 @@ int main(void)
 				 * while a Zero Length Packet (ZLP) to terminate the transfer is sent if the host isn't listening */
 				uint8_t BytesToSend = MIN(BufferCount, (CDC_TXRX_EPSIZE - 1));
 
-				/* Read bytes from the USART receive buffer into the USB IN endpoint */
-				while (BytesToSend--)
+				/* Copy bytes from the USART receive buffer into the USB IN endpoint, one contiguous run at a time */
+				while (BytesToSend)
 				{
-					/* Try to send the next byte of data to the host, abort if there is an error without dequeuing */
-					if (CDC_Device_SendByte(&VirtualSerial_CDC_Interface,
-											RingBuffer_Peek(&USARTtoUSB_Buffer)) != ENDPOINT_READYWAIT_NoError)
-					{
-						break;
-					}
+					uint8_t* SpanData;
+					uint8_t  SpanLength     = MIN(SerialBridge_GetHostTransmitSpan(&SpanData), BytesToSend);
+					uint16_t BytesProcessed = 0;
+
+					/* Try to send the run of data to the host, noting how much of it was written if the stream stops early */
+					uint8_t ErrorCode = Endpoint_Write_Stream_LE(SpanData, SpanLength, &BytesProcessed);
 
-					/* Dequeue the already sent byte from the buffer now we have confirmed that no transmission error occurred */
-					RingBuffer_Remove(&USARTtoUSB_Buffer);
+					if (ErrorCode == ENDPOINT_RWSTREAM_NoError)
+					  BytesProcessed = SpanLength;
+
+					/* Dequeue only the bytes which were written to the endpoint, so that only the remainder is sent again */
+					SerialBridge_HostDataSent(BytesProcessed);
+					BytesToSend -= BytesProcessed;
+
+					/* Abort on an error or a completed bank, leaving the remainder to be sent on a later pass */
+					if (ErrorCode != ENDPOINT_RWSTREAM_NoError)
+					  break;
+				}
+			}
+		}
+
+		/* Re-enable the USART transmit interrupt once there is data to send and the USART has been configured by the host */
+		if (SerialBridge_IsUSARTTransmitPending() && (UCSR1B & (1 << TXEN1)))
+		{
+			#if defined(ENABLE_HARDWARE_FLOW_CONTROL)
+			/* Hold off transmission while the attached device is deasserting its (active low) CTS line */
+			if (!(FLOW_CONTROL_CTS_PIN & FLOW_CONTROL_CTS_MASK))
+			#endif
+			{
+				ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+				{
+					UCSR1B |= (1 << UDRIE1);
 				}
 			}
 		}
 
-		/* Load the next byte from the USART transmit buffer into the USART if transmit buffer space is available */
-		if (Serial_IsSendReady() && !(RingBuffer_IsEmpty(&USBtoUSART_Buffer)))
-		  Serial_SendByte(RingBuffer_Remove(&USBtoUSART_Buffer));
+		#if defined(ENABLE_HARDWARE_FLOW_CONTROL)
+		/* Reassert RTS to resume reception once the USART receive buffer has drained below its low watermark; this must
+		 * not be interrupted by the USART receive ISR, which may pause reception again between the check and the update */
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			if (SerialBridge_IsUSARTReceiveAllowed())
+			  FLOW_CONTROL_RTS_PORT &= ~FLOW_CONTROL_RTS_MASK;
+		}
+		#endif
 
 		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
 		USB_USBTask();
@@ -157,6 +175,14 @@ void SetupHardware(void)
 	/* Hardware Initialization */
 	LEDs_Init();
 	USB_Init();
+
+#if defined(ENABLE_HARDWARE_FLOW_CONTROL)
+	/* Drive the (active low) RTS line asserted, and pull up the CTS line so that an unconnected CTS halts transmission */
+	FLOW_CONTROL_RTS_DDR  |=  FLOW_CONTROL_RTS_MASK;
+	FLOW_CONTROL_RTS_PORT &= ~FLOW_CONTROL_RTS_MASK;
+	FLOW_CONTROL_CTS_DDR  &= ~FLOW_CONTROL_CTS_MASK;
+	FLOW_CONTROL_CTS_PORT |=  FLOW_CONTROL_CTS_MASK;
+#endif
 }
 
 /** Event handler for the library USB Connection event. */
@@ -194,8 +220,33 @@ ISR(USART1_RX_vect, ISR_BLOCK)
 {
 	uint8_t ReceivedByte = UDR1;
 
-	if ((USB_DeviceState == DEVICE_STATE_Configured) && !(RingBuffer_IsFull(&USARTtoUSB_Buffer)))
-	  RingBuffer_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+	if (USB_DeviceState == DEVICE_STATE_Configured)
+	  SerialBridge_USARTDataReceived(ReceivedByte);
+
+	#if defined(ENABLE_HARDWARE_FLOW_CONTROL)
+	/* Deassert RTS to ask the attached device to pause sending once the buffer reaches its high watermark */
+	if (!(SerialBridge_IsUSARTReceiveAllowed()))
+	  FLOW_CONTROL_RTS_PORT |= FLOW_CONTROL_RTS_MASK;
+	#endif
+}
+
+/** ISR to manage the transmission of data to the serial port, loading the next byte from the circular buffer
+ *  of data received from the host each time the USART data register becomes empty.
+ */
+ISR(USART1_UDRE_vect, ISR_BLOCK)
+{
+	/* Disable the interrupt until more data is queued, or the attached device reasserts its CTS line */
+	#if defined(ENABLE_HARDWARE_FLOW_CONTROL)
+	if (!(SerialBridge_IsUSARTTransmitPending()) || (FLOW_CONTROL_CTS_PIN & FLOW_CONTROL_CTS_MASK))
+	#else
+	if (!(SerialBridge_IsUSARTTransmitPending()))
+	#endif
+	{
+		UCSR1B &= ~(1 << UDRIE1);
+		return;
+	}
+
+	UDR1 = SerialBridge_GetUSARTTransmitByte();
 }
 
 /** Event handler for the CDC Class driver Line Encoding Changed event.
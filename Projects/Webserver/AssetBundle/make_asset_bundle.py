@@ -0,0 +1,248 @@
+"""
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+"""
+
+"""
+    LUFA Webserver project asset bundle generator. This script packs a
+    directory of static web assets into a C header file of flash resident
+    (PROGMEM) tables for the webserver's AssetBundle.c source file, so that
+    the assets are served before falling back to the files on the Dataflash
+    disk. Each asset is stored with a pre-rendered
+    response header carrying its MIME type, length and entity tag, and the
+    bundle is indexed by a minimal perfect hash of the asset paths.
+
+    Usage: make_asset_bundle.py [--gzip] asset_directory output_file
+      --gzip  Also store compressible assets gzip compressed where that
+              makes them smaller; the compressed copy is served to clients
+              which accept the gzip content encoding, and the plain copy to
+              all other clients
+
+    Requires Python >= 3.6, and no other packages.
+"""
+
+import gzip
+import os
+import sys
+
+# MIME types of each supported file extension, the default being used for all others
+mime_types = {
+    "htm":  "text/html",
+    "html": "text/html",
+    "css":  "text/css",
+    "js":   "application/javascript",
+    "json": "application/json",
+    "txt":  "text/plain",
+    "svg":  "image/svg+xml",
+    "jpg":  "image/jpeg",
+    "gif":  "image/gif",
+    "bmp":  "image/bmp",
+    "png":  "image/png",
+    "ico":  "image/x-icon",
+}
+default_mime_type = "text/plain"
+
+# MIME types which are worth compressing, the others already being compressed formats
+compressible_mime_types = ("text/", "application/javascript", "application/json", "image/svg+xml", "image/bmp")
+
+# Maximum size of the body of a single asset, limited by the bundle's 16-bit length fields
+max_body_length = 0xFFFF
+
+# Largest per-bucket hash seed which may be tried when building the perfect hash index
+max_seed = 0xFFFF
+
+
+def fnv1a_hash(seed, data):
+    value = 2166136261 ^ seed
+    for byte in data:
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def path_hash(seed, path):
+    # Must match the AssetBundle_Hash() function of the webserver, which keeps only the upper half
+    # of the hash as the lower bits of an FNV hash are poorly mixed
+    return fnv1a_hash(seed, path) >> 16
+
+
+def build_perfect_hash(keys):
+    # Hash and displace: the keys are split into buckets by an unseeded hash, and a seed found for each
+    # bucket in turn, largest bucket first, which places all of its keys into free slots of the table
+    total = len(keys)
+    buckets = [[] for _ in range(total)]
+    for key in keys:
+        buckets[path_hash(0, key) % total].append(key)
+
+    seeds = [0] * total
+    slots = [None] * total
+
+    for bucket_index in sorted(range(total), key=lambda index: -len(buckets[index])):
+        bucket = buckets[bucket_index]
+        if not bucket:
+            break
+
+        for seed in range(1, max_seed + 1):
+            positions = [path_hash(seed, key) % total for key in bucket]
+            if len(set(positions)) == len(positions) and all(slots[position] is None for position in positions):
+                break
+        else:
+            raise RuntimeError("Unable to build the perfect hash index of the asset bundle")
+
+        seeds[bucket_index] = seed
+        for key, position in zip(bucket, positions):
+            slots[position] = key
+
+    return seeds, slots
+
+
+def c_string(data):
+    # Escape everything but plain printable characters, splitting the string after each escaped
+    # character so that a following hex digit is not taken as part of the escape sequence
+    text = ""
+    for byte in data:
+        if byte == ord("\r"):
+            text += "\\r"
+        elif byte == ord("\n"):
+            text += "\\n"
+        elif byte in (ord("\""), ord("\\")):
+            text += "\\" + chr(byte)
+        elif 0x20 <= byte < 0x7F:
+            text += chr(byte)
+        else:
+            text += "\\x%02X\"\"" % byte
+    return "\"" + text + "\""
+
+
+def c_header_line(line):
+    # The Server header is left for the compiler to complete, so that it matches the webserver's own responses
+    if line is None:
+        return "\"Server: LUFA \" LUFA_VERSION_STRING \"\\r\\n\""
+    return c_string(line.encode())
+
+
+def c_byte_array(data):
+    lines = []
+    for offset in range(0, len(data), 16):
+        lines.append("\t" + " ".join("0x%02X," % byte for byte in data[offset:offset + 16]))
+    return "\n".join(lines)
+
+
+def make_variant(mime_type, body, extra_header):
+    # Entity tags of zero are reserved by the webserver to indicate no conditional request
+    etag = fnv1a_hash(0, body) or 1
+
+    header = ["HTTP/1.1 200 OK\r\n",
+              None,
+              "MIME-version: 1.0\r\n",
+              "Content-Type: %s\r\n" % mime_type,
+              "Content-Length: %u\r\n" % len(body),
+              "ETag: \"%08x\"\r\n" % etag] + extra_header
+
+    return {"header": header, "body": body, "etag": etag}
+
+
+def load_assets(asset_directory, compress):
+    assets = []
+
+    for directory, subdirectories, files in os.walk(asset_directory):
+        subdirectories.sort()
+        for file_name in sorted(files):
+            file_path = os.path.join(directory, file_name)
+            path = os.path.relpath(file_path, asset_directory).replace(os.sep, "/")
+
+            with open(file_path, "rb") as asset_file:
+                body = asset_file.read()
+
+            extension = file_name.rsplit(".", 1)[1].lower() if "." in file_name else ""
+            mime_type = mime_types.get(extension, default_mime_type)
+
+            if len(body) > max_body_length:
+                raise RuntimeError("Asset %s is too large for the asset bundle" % path)
+
+            compressed_body = None
+            if compress and mime_type.startswith(compressible_mime_types):
+                compressed_body = gzip.compress(body, 9, mtime=0)
+                if len(compressed_body) >= len(body):
+                    compressed_body = None
+
+            # Assets stored in both forms must tell caches that the response depends on the client's accepted encodings
+            extra_header = ["Vary: Accept-Encoding\r\n"] if compressed_body else []
+
+            asset = {"path": path, "identity": make_variant(mime_type, body, extra_header), "gzip": None}
+            if compressed_body:
+                asset["gzip"] = make_variant(mime_type, compressed_body, ["Content-Encoding: gzip\r\n"] + extra_header)
+
+            assets.append(asset)
+
+    return assets
+
+
+def write_variant(output, name, variant):
+    output.write("static const char PROGMEM %sHeader[] =\n\t%s;\n" %
+                 (name, "\n\t".join(c_header_line(line) for line in variant["header"])))
+    # Empty bodies are padded to a single byte, as C does not allow empty arrays
+    output.write("static const uint8_t PROGMEM %sBody[] =\n{\n%s\n};\n" % (name, c_byte_array(variant["body"] or b"\x00")))
+
+
+def c_variant(name, variant):
+    return ("{.ResponseHeader = %sHeader, .Body = %sBody, .BodyLength = %u, .ETag = 0x%08XUL}" %
+            (name, name, len(variant["body"]), variant["etag"]))
+
+
+def write_bundle(assets, output_file_name):
+    assets_by_path = {asset["path"].encode(): asset for asset in assets}
+    seeds, slots = build_perfect_hash(list(assets_by_path.keys()))
+
+    with open(output_file_name, "w", newline="\n") as output:
+        output.write("/* Generated by make_asset_bundle.py - do not edit. Included only by AssetBundle.c. */\n\n")
+        output.write("#include <LUFA/Version.h>\n\n")
+
+        for index, asset in enumerate(assets):
+            output.write("/* %s */\n" % asset["path"])
+            output.write("static const char PROGMEM Asset%uPath[] = %s;\n" % (index, c_string(asset["path"].encode())))
+            write_variant(output, "Asset%u" % index, asset["identity"])
+            if asset["gzip"]:
+                write_variant(output, "Asset%uGzip" % index, asset["gzip"])
+            output.write("\n")
+
+        output.write("static const uint16_t PROGMEM AssetBundle_TotalEntries = %u;\n\n" % len(assets))
+
+        output.write("static const uint16_t PROGMEM AssetBundle_Seeds[] =\n{\n")
+        output.write("".join("\t%u,\n" % seed for seed in seeds) or "\t0,\n")
+        output.write("};\n\n")
+
+        output.write("static const AssetBundle_Entry_t PROGMEM AssetBundle_Entries[] =\n{\n")
+        for path in slots:
+            asset = assets_by_path[path]
+            index = assets.index(asset)
+            output.write("\t{.Path = Asset%uPath,\n" % index)
+            output.write("\t .Identity = %s,\n" % c_variant("Asset%u" % index, asset["identity"]))
+            output.write("\t .Gzip = %s},\n" % (c_variant("Asset%uGzip" % index, asset["gzip"]) if asset["gzip"] else "{.Body = NULL}"))
+        if not slots:
+            output.write("\t{.Path = NULL},\n")
+        output.write("};\n")
+
+
+def main(arguments):
+    compress = "--gzip" in arguments
+    arguments = [argument for argument in arguments if argument != "--gzip"]
+
+    if len(arguments) != 2:
+        print("Usage: make_asset_bundle.py [--gzip] asset_directory output_file", file=sys.stderr)
+        sys.exit(1)
+
+    asset_directory, output_file_name = arguments
+
+    assets = load_assets(asset_directory, compress) if os.path.isdir(asset_directory) else []
+    write_bundle(assets, output_file_name)
+
+    total_length = sum(len(asset["identity"]["body"]) + (len(asset["gzip"]["body"]) if asset["gzip"] else 0) for asset in assets)
+    print("Packed %u assets, %u bytes of response bodies" % (len(assets), total_length))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -47,6 +47,10 @@
 	#define ENABLE_DHCP_SERVER
 	#define ENABLE_TELNET_SERVER
 	#define MAX_URI_LENGTH                50
+	#define MAX_FILE_FRAGMENTS            3
+	#define HTTP_KEEP_ALIVE_TIMEOUT       5
+	#define HTTP_REXMIT_SLOTS             1
+	#define RNDIS_RX_QUEUE_LENGTH         0
 
 	#define DEVICE_IP_ADDRESS             (uint8_t[]){ 10,   0,   0,   2}
 	#define DEVICE_NETMASK                (uint8_t[]){255, 255, 255,   0}
@@ -60,6 +64,7 @@
 	#define UIP_CONF_MAX_CONNECTIONS      3
 	#define UIP_CONF_MAX_LISTENPORTS      5
 	#define UIP_CONF_BUFFER_SIZE          1514
+	#define UIP_CONF_EXTERNAL_BUFFER
 	#define UIP_CONF_LL_802154            0
 	#define UIP_CONF_LL_80211             0
 	#define UIP_CONF_ROUTER               0
@@ -0,0 +1,87 @@
+"""
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+"""
+
+"""
+    LUFA Webserver project test volume generator script. This script creates
+    a FAT16 disk image holding a single file of the given size, for the
+    host-native TAP server built with the project's makefile.tap makefile to
+    serve in place of the Dataflash disk. Each byte of the file holds the low
+    byte of seven times its offset, so that downloads can be checked.
+
+    Usage: make_test_volume.py [image] [size_kb] [name]
+      image    Name of the disk image file to create (default disk.img)
+      size_kb  Size of the file in kilobytes (default 4096)
+      name     8.3 name of the file on the volume (default BIG.BIN)
+
+    Requires Python >= 3.6, and no other packages.
+"""
+
+import struct
+import sys
+
+# Volume geometry, with enough clusters that the volume is always formatted as FAT16
+sector_size = 512
+cluster_sectors = 4
+root_entries = 512
+min_clusters = 4200
+max_clusters = 65524
+
+
+def make_volume(size, name):
+    cluster_bytes = cluster_sectors * sector_size
+    file_clusters = (size + cluster_bytes - 1) // cluster_bytes
+    total_clusters = max(file_clusters + 16, min_clusters)
+    if total_clusters > max_clusters:
+        raise ValueError("File too large for a FAT16 volume")
+
+    fat_sectors = ((total_clusters + 2) * 2 + sector_size - 1) // sector_size
+    root_sectors = root_entries * 32 // sector_size
+    data_start = 1 + fat_sectors + root_sectors
+    total_sectors = data_start + total_clusters * cluster_sectors
+
+    image = bytearray(total_sectors * sector_size)
+
+    # Boot sector, with a single FAT and no reserved sectors beyond itself
+    struct.pack_into("<3s8sHBHBHHBH", image, 0, b"\xEB\x3C\x90", b"MSDOS5.0", sector_size, cluster_sectors, 1, 1,
+                     root_entries, total_sectors if total_sectors < 65536 else 0, 0xF8, fat_sectors)
+    if total_sectors >= 65536:
+        struct.pack_into("<I", image, 32, total_sectors)
+    struct.pack_into("<B4s11s8s", image, 38, 0x29, b"\x00" * 4, b"NO NAME    ", b"FAT16   ")
+    image[510:512] = b"\x55\xAA"
+
+    # FAT, with the file stored in a single run of clusters from the first data cluster
+    fat = sector_size
+    struct.pack_into("<HH", image, fat, 0xFFF8, 0xFFFF)
+    for index in range(file_clusters):
+        cluster = 2 + index
+        struct.pack_into("<H", image, fat + cluster * 2, cluster + 1 if index < file_clusters - 1 else 0xFFFF)
+
+    # Root directory entry of the file
+    base, _, extension = name.upper().partition(".")
+    entry = (1 + fat_sectors) * sector_size
+    struct.pack_into("<11sB14xHI", image, entry, (base.ljust(8)[:8] + extension.ljust(3)[:3]).encode(), 0x20,
+                     2 if file_clusters else 0, size)
+
+    data = data_start * sector_size
+    image[data:data + size] = bytes((offset * 7) & 0xFF for offset in range(size))
+
+    return image
+
+
+def main():
+    image_name = sys.argv[1] if len(sys.argv) > 1 else "disk.img"
+    size = (int(sys.argv[2]) if len(sys.argv) > 2 else 4096) * 1024
+    name = sys.argv[3] if len(sys.argv) > 3 else "BIG.BIN"
+
+    with open(image_name, "wb") as image_file:
+        image_file.write(make_volume(size, name))
+
+    print("Created %s holding %s (%d bytes)" % (image_name, name.upper(), size))
+
+if __name__ == '__main__':
+    main()
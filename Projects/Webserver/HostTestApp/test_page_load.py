@@ -0,0 +1,220 @@
+"""
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+"""
+
+"""
+    LUFA Webserver project page load test script. This script fetches a page
+    from the webserver along with every asset (image, script, stylesheet, etc.)
+    it references, and reports the time taken to load the complete page. The
+    page is loaded with a new connection for each request, over persistent
+    connections, and with all requests pipelined onto a single connection, so
+    that the cost of each connection setup can be compared.
+
+    Usage: test_page_load.py [host] [page] [runs] [connections]
+      host         Address of the webserver (default 10.0.0.2)
+      page         Path of the page to load (default /)
+      runs         Number of times to load the page in each mode (default 5)
+      connections  Number of parallel persistent connections (default 2)
+
+    Requires Python >= 3.6, and no other packages.
+"""
+
+import re
+import socket
+import sys
+import threading
+import time
+
+# Webserver address, port and request timeout in seconds
+server_host = "10.0.0.2"
+server_port = 80
+socket_timeout = 10
+
+
+class ConnectionClosed(Exception):
+    pass
+
+
+class Connection(object):
+    def __init__(self, stats):
+        self.sock = socket.create_connection((server_host, server_port), socket_timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buffer = b""
+        self.stats = stats
+        stats["connections"] += 1
+
+    def close(self):
+        self.sock.close()
+
+    def send_requests(self, paths, keep_alive=True):
+        request = b""
+        for path in paths:
+            request += ("GET %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n\r\n" %
+                        (path, server_host, "keep-alive" if keep_alive else "close")).encode()
+        self.sock.sendall(request)
+
+    def _receive(self):
+        data = self.sock.recv(65536)
+        if not data:
+            raise ConnectionClosed()
+        self.buffer += data
+
+    def read_response(self):
+        while b"\r\n\r\n" not in self.buffer:
+            self._receive()
+
+        header, self.buffer = self.buffer.split(b"\r\n\r\n", 1)
+        lines = header.decode("latin-1").split("\r\n")
+        status = int(lines[0].split(" ")[1])
+        fields = dict((name.strip().lower(), value.strip()) for name, value in
+                      (line.split(":", 1) for line in lines[1:] if ":" in line))
+
+        # Responses without a length run until the server closes the connection
+        if "content-length" in fields:
+            length = int(fields["content-length"])
+            while len(self.buffer) < length:
+                self._receive()
+            body, self.buffer = self.buffer[:length], self.buffer[length:]
+        else:
+            try:
+                while True:
+                    self._receive()
+            except ConnectionClosed:
+                pass
+            body, self.buffer = self.buffer, b""
+            fields["connection"] = "close"
+
+        self.stats["requests"] += 1
+        self.stats["bytes"] += len(header) + 4 + len(body)
+        return status, body, fields.get("connection", "").lower() != "close"
+
+
+def find_assets(page, body):
+    base = page.rsplit("/", 1)[0] + "/"
+    assets = []
+    for link in re.findall(r'(?:src|href)\s*=\s*["\']([^"\'#?]+)', body.decode("latin-1"), re.IGNORECASE):
+        if ":" in link or link.startswith("//") or link.endswith(".htm") or link.endswith(".html"):
+            continue
+        path = link if link.startswith("/") else base + link
+        if path not in assets:
+            assets.append(path)
+    return assets
+
+
+def fetch_pipelined(paths, stats, keep_alive=True):
+    # Requests not answered before the server closes the connection are sent again on a new one
+    pending = list(paths)
+    while pending:
+        connection = Connection(stats)
+        connection.send_requests(pending, keep_alive)
+        try:
+            while pending:
+                _, _, connection_kept = connection.read_response()
+                pending.pop(0)
+                if not connection_kept:
+                    break
+        except (ConnectionClosed, ConnectionResetError):
+            pass
+        connection.close()
+
+
+def fetch_persistent(paths, stats, connections, first_connection=None):
+    queue = list(paths)
+    lock = threading.Lock()
+
+    def worker(connection):
+        while True:
+            with lock:
+                if not queue:
+                    break
+                path = queue.pop(0)
+            try:
+                if connection is None:
+                    connection = Connection(stats)
+                connection.send_requests([path])
+                _, _, connection_kept = connection.read_response()
+            except (ConnectionClosed, ConnectionResetError):
+                connection.close()
+                connection = None
+                with lock:
+                    queue.insert(0, path)
+                continue
+            if not connection_kept:
+                connection.close()
+                connection = None
+        if connection is not None:
+            connection.close()
+
+    threads = [threading.Thread(target=worker, args=(first_connection if index == 0 else None,))
+               for index in range(connections)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+
+def load_page(mode, page, connections):
+    stats = {"connections": 0, "requests": 0, "bytes": 0}
+    start = time.perf_counter()
+
+    connection = Connection(stats)
+    connection.send_requests([page], mode != "close")
+    status, body, connection_kept = connection.read_response()
+    if status != 200:
+        print("Page %s returned status %d." % (page, status))
+        sys.exit(1)
+
+    assets = find_assets(page, body)
+
+    if mode == "close":
+        connection.close()
+        for path in assets:
+            fetch_pipelined([path], stats, keep_alive=False)
+    elif mode == "keep-alive":
+        if not connection_kept:
+            connection.close()
+            connection = None
+        fetch_persistent(assets, stats, connections, connection)
+    else:
+        if connection_kept and assets:
+            connection.send_requests(assets)
+            try:
+                while assets:
+                    _, _, connection_kept = connection.read_response()
+                    assets.pop(0)
+                    if not connection_kept:
+                        break
+            except (ConnectionClosed, ConnectionResetError):
+                pass
+        connection.close()
+        fetch_pipelined(assets, stats)
+
+    stats["time"] = time.perf_counter() - start
+    return stats
+
+
+def main():
+    global server_host
+
+    server_host = sys.argv[1] if len(sys.argv) > 1 else server_host
+    page = sys.argv[2] if len(sys.argv) > 2 else "/"
+    runs = int(sys.argv[3]) if len(sys.argv) > 3 else 5
+    connections = int(sys.argv[4]) if len(sys.argv) > 4 else 2
+
+    print("Loading http://%s%s, %d run(s) per mode" % (server_host, page, runs))
+    print("%-12s %8s %10s %10s %10s %12s %10s" %
+          ("Mode", "Requests", "Conns", "Bytes", "Min ms", "Average ms", "Max ms"))
+
+    for mode in ("close", "keep-alive", "pipelined"):
+        results = [load_page(mode, page, connections) for _ in range(runs)]
+        times = [result["time"] * 1000 for result in results]
+        print("%-12s %8d %10d %10d %10.1f %12.1f %10.1f" %
+              (mode, results[-1]["requests"], results[-1]["connections"], results[-1]["bytes"],
+               min(times), sum(times) / len(times), max(times)))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,85 @@
+"""
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+"""
+
+"""
+    LUFA Webserver project download throughput test script. This script
+    downloads a file from the webserver over several parallel connections,
+    and reports the total number of bytes received and the combined transfer
+    rate once every download has completed.
+
+    Usage: test_throughput.py [host] [path] [connections]
+      host         Address of the webserver (default 10.0.0.2)
+      path         Path of the file to download (default /BIG.BIN)
+      connections  Number of parallel downloads (default 3)
+
+    Requires Python >= 3.6, and no other packages.
+"""
+
+import socket
+import sys
+import threading
+import time
+
+# Webserver address, port and request timeout in seconds
+server_host = "10.0.0.2"
+server_port = 80
+socket_timeout = 100
+
+
+def download(path, results, index):
+    sock = socket.create_connection((server_host, server_port), socket_timeout)
+    sock.sendall(("GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n" % (path, server_host)).encode())
+
+    # Count the whole response, as the server closes the connection once it has been sent
+    received = b""
+    while b"\r\n\r\n" not in received:
+        data = sock.recv(65536)
+        if not data:
+            break
+        received += data
+
+    status = int(received.split(b" ", 2)[1]) if received.startswith(b"HTTP/") else 0
+    length = len(received.split(b"\r\n\r\n", 1)[-1]) if b"\r\n\r\n" in received else 0
+
+    while True:
+        data = sock.recv(65536)
+        if not data:
+            break
+        length += len(data)
+
+    sock.close()
+    results[index] = (status, length)
+
+
+def main():
+    global server_host
+
+    server_host = sys.argv[1] if len(sys.argv) > 1 else server_host
+    path = sys.argv[2] if len(sys.argv) > 2 else "/BIG.BIN"
+    connections = int(sys.argv[3]) if len(sys.argv) > 3 else 3
+
+    results = [(0, 0)] * connections
+    threads = [threading.Thread(target=download, args=(path, results, index)) for index in range(connections)]
+
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+
+    total = sum(length for _, length in results)
+    print("Downloaded http://%s%s over %d connection(s)" % (server_host, path, connections))
+    print("Status codes: %s" % ", ".join(str(status) for status, _ in results))
+    print("%d bytes in %.2f s = %.1f KB/s" % (total, elapsed, total / 1024 / elapsed))
+
+    if any(status != 200 for status, _ in results):
+        sys.exit(1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,96 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  In-flash static asset bundle lookup. The bundle is generated from a directory of web assets at build time by the
+ *  make_asset_bundle.py script, and indexed by a minimal perfect hash of the asset paths so that any path can be
+ *  looked up with two hash calculations and a single string comparison, regardless of the number of assets.
+ */
+
+#define  INCLUDE_FROM_ASSETBUNDLE_C
+#include "AssetBundle.h"
+
+/* Asset bundle tables, generated from the web asset directory by the make_asset_bundle.py script */
+#include "AssetBundleData.h"
+
+/** Looks up an asset in the in-flash asset bundle by its path, selecting the representation of the asset to serve.
+ *
+ *  \param[in] Path        Path of the asset to find relative to the server root, with no leading '/' character
+ *  \param[in] AcceptGzip  Indicates if the client accepts the gzip content encoding
+ *
+ *  \return Pointer to the selected representation of the asset in flash, or \c NULL if the bundle does not contain the asset
+ */
+const AssetBundle_Variant_t* AssetBundle_Find(const char* Path,
+                                              const bool AcceptGzip)
+{
+	uint16_t TotalEntries = pgm_read_word(&AssetBundle_TotalEntries);
+
+	if (!(TotalEntries))
+	  return NULL;
+
+	/* The first hash selects the bucket of the path, and that bucket's seed then gives a second hash which is unique
+	 * across all assets in the bundle */
+	uint16_t Seed = pgm_read_word(&AssetBundle_Seeds[AssetBundle_Hash(0, Path) % TotalEntries]);
+	const AssetBundle_Entry_t* Entry = &AssetBundle_Entries[AssetBundle_Hash(Seed, Path) % TotalEntries];
+
+	/* Paths not in the bundle still hash to an entry, which must be checked against the requested path */
+	if (strcmp_P(Path, pgm_read_ptr(&Entry->Path)) != 0)
+	  return NULL;
+
+	/* Serve the compressed representation only to clients which can decode it, and the plain one to all others */
+	if (AcceptGzip && (pgm_read_ptr(&Entry->Gzip.Body) != NULL))
+	  return &Entry->Gzip;
+
+	return &Entry->Identity;
+}
+
+/** Calculates the seeded 32-bit FNV-1a hash of an asset path, which must match the hash used by the
+ *  make_asset_bundle.py script to build the bundle index. Only the upper half of the hash is returned,
+ *  as the lower bits of an FNV hash are poorly mixed.
+ *
+ *  \param[in] Seed  Seed value to mix into the hash
+ *  \param[in] Path  Asset path to hash
+ *
+ *  \return Hash value of the given path
+ */
+static uint16_t AssetBundle_Hash(const uint16_t Seed,
+                                 const char* Path)
+{
+	uint32_t Hash = (2166136261UL ^ Seed);
+
+	while (*Path)
+	{
+		Hash ^= (uint8_t)*(Path++);
+		Hash *= 16777619UL;
+	}
+
+	return (Hash >> 16);
+}
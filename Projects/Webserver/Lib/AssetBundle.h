@@ -0,0 +1,77 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for AssetBundle.c.
+ */
+
+#ifndef _ASSET_BUNDLE_H_
+#define _ASSET_BUNDLE_H_
+
+	/* Includes: */
+		#include <avr/pgmspace.h>
+		#include <string.h>
+
+		#include <LUFA/Common/Common.h>
+
+	/* Type Defines: */
+		/** Type define for one stored representation of an asset in the in-flash asset bundle. All pointers refer to
+		 *  data stored in flash.
+		 */
+		typedef struct
+		{
+			const char*    ResponseHeader; /**< Pre-rendered response header, excluding the Connection header and the blank line ending the header */
+			const uint8_t* Body; /**< Response body, or \c NULL if the asset is not stored in this representation */
+			uint16_t       BodyLength; /**< Length of the response body in bytes */
+			uint32_t       ETag; /**< Entity tag of the response body, never zero */
+		} AssetBundle_Variant_t;
+
+		/** Type define for an entry of the in-flash asset bundle, generated by the make_asset_bundle.py script. All
+		 *  pointers refer to data stored in flash.
+		 */
+		typedef struct
+		{
+			const char*           Path; /**< Path of the asset relative to the server root, with no leading '/' character */
+			AssetBundle_Variant_t Identity; /**< Uncompressed representation of the asset, always present */
+			AssetBundle_Variant_t Gzip; /**< gzip compressed representation of the asset, only present for compressible assets */
+		} AssetBundle_Entry_t;
+
+	/* Function Prototypes: */
+		const AssetBundle_Variant_t* AssetBundle_Find(const char* Path,
+		                                              const bool AcceptGzip);
+
+		#if defined(INCLUDE_FROM_ASSETBUNDLE_C)
+			static uint16_t AssetBundle_Hash(const uint16_t Seed,
+			                                 const char* Path);
+		#endif
+
+#endif
+
@@ -7,6 +7,8 @@
 
 #include "diskio.h"
 
+#include "../DataflashManager.h"
+
 /*-----------------------------------------------------------------------*/
 /* Initialize a Drive                                                    */
 
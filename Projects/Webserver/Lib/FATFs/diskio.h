@@ -12,8 +12,6 @@ extern "C" {
 #include "integer.h"
 #include "ff.h"
 
-#include "../DataflashManager.h"
-
 
 /* Status of Disk Functions */
 typedef BYTE	DSTATUS;
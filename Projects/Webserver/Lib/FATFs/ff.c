@@ -3003,6 +3003,32 @@ FRESULT f_lseek (
 
 
 
+#if _USE_FASTSEEK
+/*-----------------------------------------------------------------------*/
+/* Create the Cluster Link Map Table of a File                           */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_linkmap (
+	FIL *fp,		/* Pointer to the file object */
+	DWORD *tbl,		/* Pointer to the link map table to use */
+	UINT items		/* Number of items in the table (2 + 2 per fragment) */
+)
+{
+	FRESULT res;
+
+
+	fp->cltbl = tbl;
+	tbl[0] = items;						/* Give the table size to f_lseek */
+	res = f_lseek(fp, CREATE_LINKMAP);	/* Walk the cluster chain once to fill the table */
+	if (res != FR_OK)					/* A partially filled table is unterminated and must not be used, */
+		fp->cltbl = 0;					/* so fall back to following the FAT chain on seeks */
+
+	return res;
+}
+#endif
+
+
+
 #if _FS_MINIMIZE <= 1
 /*-----------------------------------------------------------------------*/
 /* Create a Directory Object                                             */
@@ -12,6 +12,8 @@
 
 #else			/* Embedded platform */
 
+#include <stdint.h>
+
 /* These types must be 16-bit, 32-bit or larger integer */
 typedef int				INT;
 typedef unsigned int	UINT;
@@ -22,15 +24,15 @@ typedef unsigned char	UCHAR;
 typedef unsigned char	BYTE;
 
 /* These types must be 16-bit integer */
-typedef short			SHORT;
-typedef unsigned short	USHORT;
-typedef unsigned short	WORD;
-typedef unsigned short	WCHAR;
-
-/* These types must be 32-bit integer */
-typedef long			LONG;
-typedef unsigned long	ULONG;
-typedef unsigned long	DWORD;
+typedef int16_t			SHORT;
+typedef uint16_t		USHORT;
+typedef uint16_t		WORD;
+typedef uint16_t		WCHAR;
+
+/* These types must be 32-bit integer (fixed width, so that the module also builds for 64-bit hosts) */
+typedef int32_t			LONG;
+typedef uint32_t		ULONG;
+typedef uint32_t		DWORD;
 
 #endif
 
@@ -31,7 +31,11 @@
 /** \file
  *
  *  Simple HTTP Webserver Application. When connected to the uIP stack,
- *  this will serve out files to HTTP clients on port 80.
+ *  this will serve out files to HTTP clients on port 80. Connections are
+ *  kept open between requests unless the client asks otherwise, and a
+ *  further request may be pipelined behind the one being served. Files
+ *  are served from the in-flash asset bundle where present, and from the
+ *  Dataflash disk otherwise.
  */
 
 #define  INCLUDE_FROM_HTTPSERVERAPP_C
@@ -42,19 +46,39 @@
  */
 const char PROGMEM HTTP200Header[] = "HTTP/1.1 200 OK\r\n"
                                      "Server: LUFA " LUFA_VERSION_STRING "\r\n"
-                                     "Connection: close\r\n"
-                                     "MIME-version: 1.0\r\n"
-                                     "Content-Type: ";
+                                     "MIME-version: 1.0\r\n";
 
 /** HTTP server response header, for transmission before a resource not found error. This indicates to the host that the given
  *  URL is invalid, and gives extra error information.
  */
 const char PROGMEM HTTP404Header[] = "HTTP/1.1 404 Not Found\r\n"
                                      "Server: LUFA " LUFA_VERSION_STRING "\r\n"
-                                     "Connection: close\r\n"
-                                     "MIME-version: 1.0\r\n"
-                                     "Content-Type: text/plain\r\n\r\n"
-                                     "Error 404: File Not Found: /";
+                                     "MIME-version: 1.0\r\n";
+
+/** HTTP server response header, for transmission when the client's cached copy of a bundled asset is still current. This is
+ *  followed by the entity tag of the asset.
+ */
+const char PROGMEM HTTP304Header[] = "HTTP/1.1 304 Not Modified\r\n"
+                                     "Server: LUFA " LUFA_VERSION_STRING "\r\n";
+
+/** HTTP server error message, for transmission after the resource not found error header, followed by the requested file name. */
+const char PROGMEM HTTP404Message[] = "Error 404: File Not Found: /";
+
+/** Start of the request line of the only supported request method, up to the leading slash of the requested path. */
+const char PROGMEM HTTPGetRequest[] = "GET /";
+
+/** Names of the request headers of interest to the webserver in lower case, indexed by \ref Webserver_RequestHeaders_t. Each
+ *  name must start with a different character, as request headers are told apart by their first character.
+ */
+const char PROGMEM HTTPRequestHeaders[WEBSERVER_HEADER_Total][sizeof("accept-encoding:")] =
+	{
+		[WEBSERVER_HEADER_Connection]     = "connection:",
+		[WEBSERVER_HEADER_IfNoneMatch]    = "if-none-match:",
+		[WEBSERVER_HEADER_AcceptEncoding] = "accept-encoding:",
+	};
+
+/** Name of the gzip content encoding, in lower case. */
+const char PROGMEM HTTPGzipEncoding[] = "gzip";
 
 /** Default filename to fetch when a directory is requested */
 const char PROGMEM DefaultDirFileName[] = "index.htm";
@@ -80,6 +104,16 @@ const MIME_Type_t MIMETypes[] =
 /** FATFs structure to hold the internal state of the FAT driver for the Dataflash contents. */
 FATFS DiskFATState;
 
+#if (HTTP_REXMIT_SLOTS > 0)
+/** Pool of retransmit slots shared between all connections, each holding a copy of the last unacknowledged segment of
+ *  file data sent on a connection so that it can be retransmitted without reading it from the Dataflash disk again.
+ */
+uint8_t RexmitSlotData[HTTP_REXMIT_SLOTS][UIP_TCP_MSS];
+
+/** Flags indicating which retransmit slots of the pool are held by a connection. */
+bool    RexmitSlotInUse[HTTP_REXMIT_SLOTS];
+#endif
+
 
 /** Initialization function for the simple HTTP webserver. */
 void HTTPServerApp_Init(void)
@@ -103,6 +137,10 @@ void HTTPServerApp_Callback(void)
 		/* Lock to the closed state so that no further processing will occur on the connection */
 		AppState->HTTPServer.CurrentState  = WEBSERVER_STATE_Closing;
 		AppState->HTTPServer.NextState     = WEBSERVER_STATE_Closing;
+
+		#if (HTTP_REXMIT_SLOTS > 0)
+		HTTPServerApp_ReleaseRexmitSlot();
+		#endif
 	}
 
 	if (uip_connected())
@@ -111,8 +149,15 @@ void HTTPServerApp_Callback(void)
 		AppState->HTTPServer.CurrentState  = WEBSERVER_STATE_OpenRequestedFile;
 		AppState->HTTPServer.NextState     = WEBSERVER_STATE_OpenRequestedFile;
 		AppState->HTTPServer.FileOpen      = false;
+		AppState->HTTPServer.Asset         = NULL;
+		AppState->HTTPServer.RequestReady  = false;
+		AppState->HTTPServer.ParseState    = WEBSERVER_PARSE_Method;
+		AppState->HTTPServer.ParseIndex    = 0;
 		AppState->HTTPServer.ACKedFilePos  = 0;
 		AppState->HTTPServer.SentChunkSize = 0;
+		AppState->HTTPServer.RexmitSlot    = HTTP_REXMIT_NO_SLOT;
+
+		timer_set(&AppState->HTTPServer.IdleTimer, (CLOCK_SECOND * HTTP_KEEP_ALIVE_TIMEOUT));
 	}
 
 	if (uip_acked())
@@ -120,23 +165,44 @@ void HTTPServerApp_Callback(void)
 		/* Add the amount of ACKed file data to the total sent file bytes counter */
 		AppState->HTTPServer.ACKedFilePos += AppState->HTTPServer.SentChunkSize;
 
+		#if (HTTP_REXMIT_SLOTS > 0)
+		/* The ACKed data will never need to be retransmitted, so its slot can be given to the next segment sent */
+		HTTPServerApp_ReleaseRexmitSlot();
+		#endif
+
 		/* Progress to the next state once the current state's data has been ACKed */
 		AppState->HTTPServer.CurrentState = AppState->HTTPServer.NextState;
 	}
 
 	if (uip_rexmit())
 	{
-		/* Return file pointer to the last ACKed position */
-		f_lseek(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.ACKedFilePos);
+		/* Return file pointer to the last ACKed position, unless the data to retransmit was kept in a retransmit slot */
+		if (AppState->HTTPServer.RexmitSlot == HTTP_REXMIT_NO_SLOT)
+		  f_lseek(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.ACKedFilePos);
 	}
 
+	if (uip_newdata())
+	{
+		/* Process the received request data, which may arrive while a previous request is still being served */
+		HTTPServerApp_ParseRequest();
+	}
+
+	/* Data still in flight must be ACKed before any more can be sent, unless it is being retransmitted */
+	if (uip_outstanding(uip_conn) && !(uip_rexmit()))
+	  return;
+
 	if (uip_rexmit() || uip_acked() || uip_newdata() || uip_connected() || uip_poll())
 	{
+		/* Once a response has been fully ACKed, finish it and move on to the next request if the connection is kept open */
+		if (AppState->HTTPServer.CurrentState == WEBSERVER_STATE_ResponseComplete)
+		  HTTPServerApp_CompleteResponse();
+
+		/* Open the file of a newly received request, so that its response header can be sent straight away */
+		if (AppState->HTTPServer.CurrentState == WEBSERVER_STATE_OpenRequestedFile)
+		  HTTPServerApp_OpenRequestedFile();
+
 		switch (AppState->HTTPServer.CurrentState)
 		{
-			case WEBSERVER_STATE_OpenRequestedFile:
-				HTTPServerApp_OpenRequestedFile();
-				break;
 			case WEBSERVER_STATE_SendResponseHeader:
 				HTTPServerApp_SendResponseHeader();
 				break;
@@ -158,46 +224,286 @@ void HTTPServerApp_Callback(void)
 	}
 }
 
-/** HTTP Server State handler for the Request Process state. This state manages the processing of incoming HTTP
- *  GET requests to the server from the receiving HTTP client.
+/** HTTP Server request parser. This processes the request data received from the HTTP client a byte at a time as it
+ *  arrives, so that requests split across several packets or pipelined into the same packet can be handled without
+ *  buffering them. Only the requested file path and the connection persistence of each request are retained.
  */
-static void HTTPServerApp_OpenRequestedFile(void)
+static void HTTPServerApp_ParseRequest(void)
 {
 	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
 	char*               const AppData     = (char*)uip_appdata;
 
-	/* No HTTP header received from the client, abort processing */
-	if (!(uip_newdata()))
-	  return;
+	for (uint16_t DataIndex = 0; DataIndex < uip_datalen(); DataIndex++)
+	{
+		uint8_t CurrentChar     = AppData[DataIndex];
+		bool    RequestReceived = false;
+
+		switch (AppState->HTTPServer.ParseState)
+		{
+			case WEBSERVER_PARSE_Method:
+				/* Must be a GET request, abort otherwise */
+				if (CurrentChar != pgm_read_byte(&HTTPGetRequest[AppState->HTTPServer.ParseIndex]))
+				{
+					HTTPServerApp_AbortConnection();
+					return;
+				}
+
+				if (++AppState->HTTPServer.ParseIndex == (sizeof(HTTPGetRequest) - 1))
+				{
+					AppState->HTTPServer.ParseState = WEBSERVER_PARSE_URI;
+					AppState->HTTPServer.ParseIndex = 0;
+				}
+
+				break;
+			case WEBSERVER_PARSE_URI:
+				if ((CurrentChar == ' ') || (CurrentChar == '\n'))
+				{
+					AppState->HTTPServer.NextFileName[AppState->HTTPServer.ParseIndex] = '\0';
+
+					/* HTTP/0.9 requests have no version or headers, and are always followed by the connection closing */
+					AppState->HTTPServer.NextKeepAlive   = false;
+					AppState->HTTPServer.NextAcceptGzip  = false;
+					AppState->HTTPServer.NextIfNoneMatch = 0;
+					AppState->HTTPServer.ParseState      = WEBSERVER_PARSE_Version;
+					RequestReceived                      = (CurrentChar == '\n');
+				}
+				else if ((CurrentChar != '\r') && (AppState->HTTPServer.ParseIndex < (sizeof(AppState->HTTPServer.NextFileName) - 1)))
+				{
+					AppState->HTTPServer.NextFileName[AppState->HTTPServer.ParseIndex++] = CurrentChar;
+				}
+
+				break;
+			case WEBSERVER_PARSE_Version:
+				if (CurrentChar == '\n')
+				{
+					AppState->HTTPServer.ParseState = WEBSERVER_PARSE_HeaderName;
+					AppState->HTTPServer.ParseIndex = 0;
+				}
+				else if (CurrentChar != '\r')
+				{
+					/* Connections are kept open by default from HTTP/1.1 onwards, the minor version being the last character */
+					AppState->HTTPServer.NextKeepAlive = (CurrentChar != '0');
+				}
+
+				break;
+			case WEBSERVER_PARSE_HeaderName:
+				if ((CurrentChar == '\r') && !(AppState->HTTPServer.ParseIndex))
+				  break;
+
+				if ((CurrentChar == '\n') && !(AppState->HTTPServer.ParseIndex))
+				{
+					/* Empty line marks the end of the request headers */
+					RequestReceived = true;
+					break;
+				}
+
+				/* Identify the request header from its first character, so that only one header name need be matched */
+				if (!(AppState->HTTPServer.ParseIndex))
+				{
+					AppState->HTTPServer.ParseHeader = 0;
+
+					while ((AppState->HTTPServer.ParseHeader < WEBSERVER_HEADER_Total) &&
+					       (tolower(CurrentChar) != pgm_read_byte(&HTTPRequestHeaders[AppState->HTTPServer.ParseHeader][0])))
+					{
+						AppState->HTTPServer.ParseHeader++;
+					}
+				}
+
+				if ((AppState->HTTPServer.ParseHeader < WEBSERVER_HEADER_Total) &&
+				    (tolower(CurrentChar) == pgm_read_byte(&HTTPRequestHeaders[AppState->HTTPServer.ParseHeader][AppState->HTTPServer.ParseIndex])))
+				{
+					/* Move on to the header value once the whole header name has been matched */
+					if (!(pgm_read_byte(&HTTPRequestHeaders[AppState->HTTPServer.ParseHeader][++AppState->HTTPServer.ParseIndex])))
+					{
+						AppState->HTTPServer.ParseState = WEBSERVER_PARSE_HeaderValue;
+						AppState->HTTPServer.ParseIndex = 0;
+					}
+				}
+				else
+				{
+					AppState->HTTPServer.ParseState = ((CurrentChar == '\n') ? WEBSERVER_PARSE_HeaderName : WEBSERVER_PARSE_SkipLine);
+					AppState->HTTPServer.ParseIndex = 0;
+				}
+
+				break;
+			case WEBSERVER_PARSE_HeaderValue:
+				if (CurrentChar == '\n')
+				{
+					AppState->HTTPServer.ParseState = WEBSERVER_PARSE_HeaderName;
+					AppState->HTTPServer.ParseIndex = 0;
+					break;
+				}
+
+				switch (AppState->HTTPServer.ParseHeader)
+				{
+					case WEBSERVER_HEADER_Connection:
+						if ((CurrentChar != ' ') && (CurrentChar != '\t'))
+						{
+							/* Only the "close" and "keep-alive" connection options change the connection persistence */
+							if (tolower(CurrentChar) == 'c')
+							  AppState->HTTPServer.NextKeepAlive = false;
+							else if (tolower(CurrentChar) == 'k')
+							  AppState->HTTPServer.NextKeepAlive = true;
+
+							AppState->HTTPServer.ParseState = WEBSERVER_PARSE_SkipLine;
+						}
+
+						break;
+					case WEBSERVER_HEADER_IfNoneMatch:
+						if (isxdigit(CurrentChar) &&
+						    (AppState->HTTPServer.ParseIndex++ < (sizeof(AppState->HTTPServer.NextIfNoneMatch) * 2)))
+						{
+							AppState->HTTPServer.NextIfNoneMatch = ((AppState->HTTPServer.NextIfNoneMatch << 4) |
+							                                        (isdigit(CurrentChar) ? (CurrentChar - '0') : (tolower(CurrentChar) - 'a' + 10)));
+						}
+						else if (!(strchr_P(PSTR(" \t\r\"W/"), CurrentChar)))
+						{
+							/* Lists of entity tags and wildcards are not supported, the request is served unconditionally instead */
+							AppState->HTTPServer.NextIfNoneMatch = 0;
+							AppState->HTTPServer.ParseState      = WEBSERVER_PARSE_SkipLine;
+						}
+
+						break;
+					case WEBSERVER_HEADER_AcceptEncoding:
+						if (tolower(CurrentChar) == pgm_read_byte(&HTTPGzipEncoding[AppState->HTTPServer.ParseIndex]))
+						{
+							if (!(pgm_read_byte(&HTTPGzipEncoding[++AppState->HTTPServer.ParseIndex])))
+							{
+								AppState->HTTPServer.NextAcceptGzip = true;
+								AppState->HTTPServer.ParseState     = WEBSERVER_PARSE_SkipLine;
+							}
+						}
+						else
+						{
+							/* Restart the search for the encoding name, which may begin with the mismatched character */
+							AppState->HTTPServer.ParseIndex = ((tolower(CurrentChar) == pgm_read_byte(&HTTPGzipEncoding[0])) ? 1 : 0);
+						}
+
+						break;
+				}
+
+				break;
+			case WEBSERVER_PARSE_SkipLine:
+				if (CurrentChar == '\n')
+				{
+					AppState->HTTPServer.ParseState = WEBSERVER_PARSE_HeaderName;
+					AppState->HTTPServer.ParseIndex = 0;
+				}
+
+				break;
+			case WEBSERVER_PARSE_Complete:
+				/* No room for a further pipelined request - drop it, and close the connection once the waiting request has
+				 * been served so that the client sends it again on a new connection */
+				AppState->HTTPServer.ParseState = WEBSERVER_PARSE_Discard;
+				return;
+			case WEBSERVER_PARSE_Discard:
+				return;
+		}
+
+		if (RequestReceived)
+		{
+			/* Serve the request straight away if the connection is idle, otherwise hold it until the current response
+			 * has completed, closing the receive window so that the client sends nothing more until then */
+			if ((AppState->HTTPServer.CurrentState == WEBSERVER_STATE_OpenRequestedFile) && !(AppState->HTTPServer.RequestReady))
+			{
+				HTTPServerApp_TakeNextRequest();
+			}
+			else
+			{
+				AppState->HTTPServer.ParseState = WEBSERVER_PARSE_Complete;
+				uip_stop();
+			}
+		}
+	}
+}
+
+/** Moves the most recently received request into place as the next request to serve, and restarts the request
+ *  parser if the connection is to be kept open after the request has been served.
+ */
+static void HTTPServerApp_TakeNextRequest(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	memcpy(AppState->HTTPServer.FileName, AppState->HTTPServer.NextFileName, sizeof(AppState->HTTPServer.FileName));
+	AppState->HTTPServer.AcceptGzip  = AppState->HTTPServer.NextAcceptGzip;
+	AppState->HTTPServer.IfNoneMatch = AppState->HTTPServer.NextIfNoneMatch;
 
-	char* RequestToken      = strtok(AppData, " ");
-	char* RequestedFileName = strtok(NULL, " ");
+	/* If any request data had to be discarded, the connection must be closed after this request for the client to retry */
+	AppState->HTTPServer.KeepAlive    = (AppState->HTTPServer.NextKeepAlive &&
+	                                     (AppState->HTTPServer.ParseState != WEBSERVER_PARSE_Discard));
+	AppState->HTTPServer.RequestReady = true;
+
+	if (AppState->HTTPServer.KeepAlive)
+	{
+		AppState->HTTPServer.ParseState = WEBSERVER_PARSE_Method;
+		AppState->HTTPServer.ParseIndex = 0;
+
+		/* Re-open the receive window if it was closed while the request was waiting to be served */
+		uip_restart();
+	}
+	else
+	{
+		AppState->HTTPServer.ParseState = WEBSERVER_PARSE_Discard;
+	}
+}
+
+/** HTTP Server State handler for the Request Process state. This state manages the opening of the file requested by
+ *  the last request received from the HTTP client, and the closing of persistent connections left idle.
+ */
+static void HTTPServerApp_OpenRequestedFile(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
 
-	/* Must be a GET request, abort otherwise */
-	if (strcmp_P(RequestToken, PSTR("GET")) != 0)
+	/* No complete HTTP request received from the client yet, close the connection if it has been idle too long */
+	if (!(AppState->HTTPServer.RequestReady))
 	{
-		uip_abort();
+		if (uip_poll() && timer_expired(&AppState->HTTPServer.IdleTimer))
+		{
+			uip_close();
+
+			AppState->HTTPServer.CurrentState = WEBSERVER_STATE_Closed;
+			AppState->HTTPServer.NextState    = WEBSERVER_STATE_Closed;
+		}
+
 		return;
 	}
 
-	/* Copy over the requested filename */
-	strlcpy(AppState->HTTPServer.FileName, &RequestedFileName[1], sizeof(AppState->HTTPServer.FileName));
+	AppState->HTTPServer.RequestReady = false;
 
 	/* Determine the length of the URI so that it can be checked to see if it is a directory */
 	uint8_t FileNameLen = strlen(AppState->HTTPServer.FileName);
 
 	/* If the URI is a directory, append the default filename */
-	if ((AppState->HTTPServer.FileName[FileNameLen - 1] == '/') || !(FileNameLen))
+	if (!(FileNameLen) || (AppState->HTTPServer.FileName[FileNameLen - 1] == '/'))
 	{
 		strlcpy_P(&AppState->HTTPServer.FileName[FileNameLen], DefaultDirFileName,
 		          (sizeof(AppState->HTTPServer.FileName) - FileNameLen));
 	}
 
-	/* Try to open the file from the Dataflash disk */
-	AppState->HTTPServer.FileOpen     = (f_open(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.FileName,
-	                                            (FA_OPEN_EXISTING | FA_READ)) == FR_OK);
+	/* Look for the file in the in-flash asset bundle first, in the compressed form if the client can decompress it */
+	AppState->HTTPServer.Asset    = AssetBundle_Find(AppState->HTTPServer.FileName, AppState->HTTPServer.AcceptGzip);
+	AppState->HTTPServer.FileOpen = false;
+
+	/* Try to open the file from the Dataflash disk if it is not in the asset bundle */
+	if (AppState->HTTPServer.Asset == NULL)
+	{
+		AppState->HTTPServer.FileOpen = (f_open(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.FileName,
+		                                        (FA_OPEN_EXISTING | FA_READ)) == FR_OK);
+
+		/* Map out the file's cluster chain so that retransmissions can seek without walking the FAT - if the file has
+		 * more fragments than the map can hold, seeks fall back to following the cluster chain from the start of the file */
+		if (AppState->HTTPServer.FileOpen)
+		{
+			f_linkmap(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.FileLinkMap,
+			          (sizeof(AppState->HTTPServer.FileLinkMap) / sizeof(AppState->HTTPServer.FileLinkMap[0])));
+		}
+	}
+
+	/* Start the response from the beginning of the file */
+	AppState->HTTPServer.ACKedFilePos  = 0;
+	AppState->HTTPServer.SentChunkSize = 0;
 
-	/* Lock to the SendResponseHeader state until connection terminated */
+	/* Lock to the SendResponseHeader state until the response header has been sent */
 	AppState->HTTPServer.CurrentState = WEBSERVER_STATE_SendResponseHeader;
 	AppState->HTTPServer.NextState    = WEBSERVER_STATE_SendResponseHeader;
 }
@@ -213,20 +519,32 @@ static void HTTPServerApp_SendResponseHeader(void)
 	char* Extension     = strpbrk(AppState->HTTPServer.FileName, ".");
 	bool  FoundMIMEType = false;
 
-	/* If the file isn't already open, it wasn't found - send back a 404 error response and abort */
+	/* Bundled assets carry their own pre-rendered response header */
+	if (AppState->HTTPServer.Asset != NULL)
+	{
+		HTTPServerApp_SendAssetResponseHeader();
+		return;
+	}
+
+	/* If the file isn't already open, it wasn't found - send back a 404 error response */
 	if (!(AppState->HTTPServer.FileOpen))
 	{
-		/* Copy over the HTTP 404 response header and send it to the receiving client */
+		/* Copy over the HTTP 404 response header and error message and send it to the receiving client */
 		strcpy_P(AppData, HTTP404Header);
+		HTTPServerApp_AppendEntityHeaders(AppData, (strlen_P(HTTP404Message) + strlen(AppState->HTTPServer.FileName)));
+		strcat_P(AppData, PSTR("Content-Type: text/plain\r\n\r\n"));
+		strcat_P(AppData, HTTP404Message);
 		strcat(AppData, AppState->HTTPServer.FileName);
 		uip_send(AppData, strlen(AppData));
 
-		AppState->HTTPServer.NextState = WEBSERVER_STATE_Closing;
+		AppState->HTTPServer.NextState = WEBSERVER_STATE_ResponseComplete;
 		return;
 	}
 
 	/* Copy over the HTTP 200 response header and send it to the receiving client */
 	strcpy_P(AppData, HTTP200Header);
+	HTTPServerApp_AppendEntityHeaders(AppData, AppState->HTTPServer.FileHandle.fsize);
+	strcat_P(AppData, PSTR("Content-Type: "));
 
 	/* Check to see if a MIME type for the requested file's extension was found */
 	if (Extension != NULL)
@@ -256,8 +574,69 @@ static void HTTPServerApp_SendResponseHeader(void)
 	/* Send the MIME header to the receiving client */
 	uip_send(AppData, strlen(AppData));
 
-	/* When the MIME header is ACKed, progress to the data send stage */
-	AppState->HTTPServer.NextState = WEBSERVER_STATE_SendData;
+	/* When the MIME header is ACKed, progress to the data send stage, unless the file is empty */
+	AppState->HTTPServer.NextState = (AppState->HTTPServer.FileHandle.fsize ? WEBSERVER_STATE_SendData : WEBSERVER_STATE_ResponseComplete);
+}
+
+/** HTTP Server State handler for the HTTP Response Header Send state, when the requested file is served from the
+ *  in-flash asset bundle. The asset's pre-rendered response header is sent, unless the client already holds a current
+ *  copy of the asset, in which case a Not Modified response is sent in its place.
+ */
+static void HTTPServerApp_SendAssetResponseHeader(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+	char*               const AppData     = (char*)uip_appdata;
+
+	AssetBundle_Variant_t Asset;
+	memcpy_P(&Asset, AppState->HTTPServer.Asset, sizeof(AssetBundle_Variant_t));
+
+	if (AppState->HTTPServer.IfNoneMatch == Asset.ETag)
+	{
+		/* Copy over the HTTP 304 response header and the asset's entity tag, no response body follows */
+		strcpy_P(AppData, HTTP304Header);
+		sprintf_P(&AppData[strlen(AppData)], PSTR("ETag: \"%08lx\"\r\n"), (unsigned long)Asset.ETag);
+
+		AppState->HTTPServer.NextState = WEBSERVER_STATE_ResponseComplete;
+	}
+	else
+	{
+		/* Copy over the pre-rendered response header, which already holds the content type, length and entity tag */
+		strcpy_P(AppData, Asset.ResponseHeader);
+
+		AppState->HTTPServer.NextState = (Asset.BodyLength ? WEBSERVER_STATE_SendData : WEBSERVER_STATE_ResponseComplete);
+	}
+
+	HTTPServerApp_AppendConnectionHeader(AppData);
+	strcat_P(AppData, PSTR("\r\n"));
+
+	uip_send(AppData, strlen(AppData));
+}
+
+/** Appends the connection persistence and content length header lines of the current response to a response
+ *  header under construction, so that the client can find the end of the response on a persistent connection.
+ *
+ *  \param[in,out] Buffer         Response header to append to
+ *  \param[in]     ContentLength  Length of the response body, in bytes
+ */
+static void HTTPServerApp_AppendEntityHeaders(char* const Buffer,
+                                              const uint32_t ContentLength)
+{
+	HTTPServerApp_AppendConnectionHeader(Buffer);
+	sprintf_P(&Buffer[strlen(Buffer)], PSTR("Content-Length: %lu\r\n"), (unsigned long)ContentLength);
+}
+
+/** Appends the connection persistence header line of the current response to a response header under construction.
+ *
+ *  \param[in,out] Buffer  Response header to append to
+ */
+static void HTTPServerApp_AppendConnectionHeader(char* const Buffer)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	if (AppState->HTTPServer.KeepAlive)
+	  strcat_P(Buffer, PSTR("Connection: keep-alive\r\n"));
+	else
+	  strcat_P(Buffer, PSTR("Connection: close\r\n"));
 }
 
 /** HTTP Server State handler for the Data Send state. This state manages the transmission of file chunks
@@ -268,17 +647,155 @@ static void HTTPServerApp_SendData(void)
 	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
 	char*               const AppData     = (char*)uip_appdata;
 
+	/* Bundled assets are sent straight from flash */
+	if (AppState->HTTPServer.Asset != NULL)
+	{
+		HTTPServerApp_SendAssetData();
+		return;
+	}
+
+	#if (HTTP_REXMIT_SLOTS > 0)
+	/* Retransmit the unacknowledged data from its retransmit slot if it was kept, rather than reading it from the disk again */
+	if (uip_rexmit() && (AppState->HTTPServer.RexmitSlot != HTTP_REXMIT_NO_SLOT))
+	{
+		memcpy(AppData, RexmitSlotData[AppState->HTTPServer.RexmitSlot], AppState->HTTPServer.SentChunkSize);
+		uip_send(AppData, AppState->HTTPServer.SentChunkSize);
+		return;
+	}
+	#endif
+
 	/* Get the maximum segment size for the current packet */
 	uint16_t MaxChunkSize = uip_mss();
 
-	/* Read the next chunk of data from the open file */
-	f_read(&AppState->HTTPServer.FileHandle, AppData, MaxChunkSize, &AppState->HTTPServer.SentChunkSize);
+	/* Read the next chunk of data from the open file, abort if the file could not be read as the header has already
+	 * promised the client the full file length */
+	if ((f_read(&AppState->HTTPServer.FileHandle, AppData, MaxChunkSize, &AppState->HTTPServer.SentChunkSize) != FR_OK) ||
+	    !(AppState->HTTPServer.SentChunkSize))
+	{
+		HTTPServerApp_AbortConnection();
+		return;
+	}
+
+	#if (HTTP_REXMIT_SLOTS > 0)
+	/* Keep a copy of the chunk for retransmission if a retransmit slot is free, otherwise it is read again if lost */
+	HTTPServerApp_AllocateRexmitSlot();
+
+	if (AppState->HTTPServer.RexmitSlot != HTTP_REXMIT_NO_SLOT)
+	  memcpy(RexmitSlotData[AppState->HTTPServer.RexmitSlot], AppData, AppState->HTTPServer.SentChunkSize);
+	#endif
 
 	/* Send the next file chunk to the receiving client */
 	uip_send(AppData, AppState->HTTPServer.SentChunkSize);
 
-	/* Check if we are at the last chunk of the file, if so next ACK should close the connection */
-	if (MaxChunkSize != AppState->HTTPServer.SentChunkSize)
-	  AppState->HTTPServer.NextState = WEBSERVER_STATE_Closing;
+	/* Check if we are at the last chunk of the file, if so the response is complete once it has been ACKed */
+	if (f_eof(&AppState->HTTPServer.FileHandle))
+	  AppState->HTTPServer.NextState = WEBSERVER_STATE_ResponseComplete;
+}
+
+/** HTTP Server State handler for the Data Send state, when the requested file is served from the in-flash asset
+ *  bundle. Each chunk is copied from the last ACKed position in the asset body, so that retransmissions need no
+ *  seeking.
+ */
+static void HTTPServerApp_SendAssetData(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+	char*               const AppData     = (char*)uip_appdata;
+
+	AssetBundle_Variant_t Asset;
+	memcpy_P(&Asset, AppState->HTTPServer.Asset, sizeof(AssetBundle_Variant_t));
+
+	/* Send as much of the remainder of the asset body as will fit into the current packet */
+	uint16_t BytesRemaining = (Asset.BodyLength - AppState->HTTPServer.ACKedFilePos);
+	AppState->HTTPServer.SentChunkSize = ((BytesRemaining < uip_mss()) ? BytesRemaining : uip_mss());
+
+	memcpy_P(AppData, &Asset.Body[AppState->HTTPServer.ACKedFilePos], AppState->HTTPServer.SentChunkSize);
+	uip_send(AppData, AppState->HTTPServer.SentChunkSize);
+
+	/* Check if we are at the last chunk of the asset, if so the response is complete once it has been ACKed */
+	if (AppState->HTTPServer.SentChunkSize == BytesRemaining)
+	  AppState->HTTPServer.NextState = WEBSERVER_STATE_ResponseComplete;
+}
+
+/** HTTP Server State handler for the Response Complete state. This state closes the file of the response which has
+ *  been fully sent, and either closes the connection or makes ready to serve the next request from the client.
+ */
+static void HTTPServerApp_CompleteResponse(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	f_close(&AppState->HTTPServer.FileHandle);
+	AppState->HTTPServer.FileOpen = false;
+
+	/* Close the connection if the client did not ask for it to be kept open */
+	if (!(AppState->HTTPServer.KeepAlive))
+	{
+		AppState->HTTPServer.CurrentState = WEBSERVER_STATE_Closing;
+		AppState->HTTPServer.NextState    = WEBSERVER_STATE_Closing;
+		return;
+	}
+
+	/* Serve the pipelined request next if one was received while the response was being sent */
+	if ((AppState->HTTPServer.ParseState == WEBSERVER_PARSE_Complete) ||
+	    (AppState->HTTPServer.ParseState == WEBSERVER_PARSE_Discard))
+	{
+		HTTPServerApp_TakeNextRequest();
+	}
+
+	timer_set(&AppState->HTTPServer.IdleTimer, (CLOCK_SECOND * HTTP_KEEP_ALIVE_TIMEOUT));
+
+	AppState->HTTPServer.CurrentState = WEBSERVER_STATE_OpenRequestedFile;
+	AppState->HTTPServer.NextState    = WEBSERVER_STATE_OpenRequestedFile;
+}
+
+/** Aborts the connection to the HTTP client, closing the file of the current response if one is open. */
+static void HTTPServerApp_AbortConnection(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	f_close(&AppState->HTTPServer.FileHandle);
+	AppState->HTTPServer.FileOpen = false;
+
+	#if (HTTP_REXMIT_SLOTS > 0)
+	HTTPServerApp_ReleaseRexmitSlot();
+	#endif
+
+	uip_abort();
+
+	AppState->HTTPServer.CurrentState = WEBSERVER_STATE_Closed;
+	AppState->HTTPServer.NextState    = WEBSERVER_STATE_Closed;
+}
+
+#if (HTTP_REXMIT_SLOTS > 0)
+/** Gives the current connection a free slot of the retransmit slot pool, if it does not already hold one and a
+ *  slot is free. Connections which cannot be given a slot read their data from the disk again when retransmitting.
+ */
+static void HTTPServerApp_AllocateRexmitSlot(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	if (AppState->HTTPServer.RexmitSlot != HTTP_REXMIT_NO_SLOT)
+	  return;
+
+	for (uint8_t Slot = 0; Slot < HTTP_REXMIT_SLOTS; Slot++)
+	{
+		if (!(RexmitSlotInUse[Slot]))
+		{
+			RexmitSlotInUse[Slot]           = true;
+			AppState->HTTPServer.RexmitSlot = Slot;
+			break;
+		}
+	}
 }
 
+/** Returns the retransmit slot held by the current connection, if any, to the retransmit slot pool. */
+static void HTTPServerApp_ReleaseRexmitSlot(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	if (AppState->HTTPServer.RexmitSlot == HTTP_REXMIT_NO_SLOT)
+	  return;
+
+	RexmitSlotInUse[AppState->HTTPServer.RexmitSlot] = false;
+	AppState->HTTPServer.RexmitSlot = HTTP_REXMIT_NO_SLOT;
+}
+#endif
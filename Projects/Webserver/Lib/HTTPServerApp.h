@@ -38,11 +38,14 @@
 
 	/* Includes: */
 		#include <avr/pgmspace.h>
+		#include <ctype.h>
+		#include <stdio.h>
 		#include <string.h>
 
 		#include <LUFA/Version.h>
 
 		#include "Config/AppConfig.h"
+		#include "AssetBundle.h"
 
 		#include <uip.h>
 		#include <ff.h>
@@ -51,13 +54,36 @@
 		/** States for each HTTP connection to the webserver. */
 		enum Webserver_States_t
 		{
-			WEBSERVER_STATE_OpenRequestedFile, /**< Currently opening requested file */
+			WEBSERVER_STATE_OpenRequestedFile, /**< Currently waiting for a request, or opening the requested file */
 			WEBSERVER_STATE_SendResponseHeader, /**< Currently sending HTTP response headers to the client */
 			WEBSERVER_STATE_SendData, /**< Currently sending HTTP page data to the client */
+			WEBSERVER_STATE_ResponseComplete, /**< Response fully sent and ACKed, ready to serve the next request */
 			WEBSERVER_STATE_Closing, /**< Ready to close the connection to the client */
 			WEBSERVER_STATE_Closed, /**< Connection closed after all data sent */
 		};
 
+		/** States of the parser for the HTTP requests received on each connection to the webserver. */
+		enum Webserver_ParseStates_t
+		{
+			WEBSERVER_PARSE_Method, /**< Currently matching the request method, which must be GET */
+			WEBSERVER_PARSE_URI, /**< Currently copying the requested file path */
+			WEBSERVER_PARSE_Version, /**< Currently reading the HTTP version of the request line */
+			WEBSERVER_PARSE_HeaderName, /**< Currently matching the name of a request header against the headers of interest */
+			WEBSERVER_PARSE_HeaderValue, /**< Currently reading the value of a request header of interest */
+			WEBSERVER_PARSE_SkipLine, /**< Currently skipping the remainder of a request header line */
+			WEBSERVER_PARSE_Complete, /**< Pipelined request fully received, waiting for the current response to complete */
+			WEBSERVER_PARSE_Discard, /**< Request data discarded, the connection will close after the current response */
+		};
+
+		/** Request headers of interest to the webserver, as indexes into the list of request header names. */
+		enum Webserver_RequestHeaders_t
+		{
+			WEBSERVER_HEADER_Connection, /**< Connection header, giving the connection persistence */
+			WEBSERVER_HEADER_IfNoneMatch, /**< If-None-Match header, giving the entity tag of the client's cached copy */
+			WEBSERVER_HEADER_AcceptEncoding, /**< Accept-Encoding header, giving the content encodings the client accepts */
+			WEBSERVER_HEADER_Total, /**< Total number of request headers of interest */
+		};
+
 	/* Type Defines: */
 		/** Type define for a MIME type handler. */
 		typedef struct
@@ -68,16 +94,33 @@
 
 	/* Macros: */
 		/** TCP listen port for incoming HTTP traffic. */
-		#define HTTP_SERVER_PORT  80
+		#define HTTP_SERVER_PORT      80
+
+		/** Retransmit slot index of a connection which holds no retransmit slot. */
+		#define HTTP_REXMIT_NO_SLOT   0xFF
 
 	/* Function Prototypes: */
 		void HTTPServerApp_Init(void);
 		void HTTPServerApp_Callback(void);
 
 		#if defined(INCLUDE_FROM_HTTPSERVERAPP_C)
+			static void HTTPServerApp_ParseRequest(void);
+			static void HTTPServerApp_TakeNextRequest(void);
 			static void HTTPServerApp_OpenRequestedFile(void);
 			static void HTTPServerApp_SendResponseHeader(void);
+			static void HTTPServerApp_SendAssetResponseHeader(void);
+			static void HTTPServerApp_AppendConnectionHeader(char* const Buffer);
+			static void HTTPServerApp_AppendEntityHeaders(char* const Buffer,
+			                                              const uint32_t ContentLength);
 			static void HTTPServerApp_SendData(void);
+			static void HTTPServerApp_SendAssetData(void);
+			static void HTTPServerApp_CompleteResponse(void);
+			static void HTTPServerApp_AbortConnection(void);
+
+			#if (HTTP_REXMIT_SLOTS > 0)
+			static void HTTPServerApp_AllocateRexmitSlot(void);
+			static void HTTPServerApp_ReleaseRexmitSlot(void);
+			#endif
 		#endif
 
 #endif
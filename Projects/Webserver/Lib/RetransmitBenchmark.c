@@ -0,0 +1,514 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host-native benchmark of the webserver's HTTP retransmission path. A FAT16 volume holding a single large file is
+ *  synthesized in memory, and the file is served through the webserver's FatFs configuration using the same sequence
+ *  of FatFs calls as the HTTP server application - each segment is read from the file in turn, and when an injected
+ *  segment loss causes a retransmission, the file pointer is returned to the last ACKed position before the segment
+ *  is read again. The transfer is made once following the FAT cluster chain on each seek, once with a cluster link
+ *  map built when the file is opened, and once keeping a copy of each unacknowledged segment in a retransmit slot so
+ *  that lost segments are not read again. The number of disk sector reads and the time spent retransmitting are
+ *  reported for each, along with the time spent copying segments into the retransmit slot. The contents of every
+ *  ACKed segment are checked against the file.
+ *
+ *  Usage: RetransmitBenchmark [-s size_kb] [-c sectors_per_cluster] [-f fragments] [-l loss_percent] [-m mss]
+ */
+
+#define  INCLUDE_FROM_RETRANSMITBENCHMARK_C
+#include "RetransmitBenchmark.h"
+
+/** Sectors of the synthesized volume before the data area, holding the boot sector, FAT and root directory. */
+static uint8_t*  SystemArea;
+
+/** Number of sectors in the system area of the synthesized volume, which is also the first data area sector. */
+static uint32_t  DataStartSector;
+
+/** Number of sectors in the FAT of the synthesized volume, which follows the boot sector. */
+static uint32_t  FATSectors;
+
+/** Cluster numbers of the served file, in file order. */
+static uint32_t* FileClusters;
+
+/** Number of clusters in the served file. */
+static uint32_t  FileClusterCount;
+
+/** Size of the served file, in bytes. */
+static uint32_t  FileBytes           = (BENCHMARK_DEFAULT_FILE_KB * 1024UL);
+
+/** Number of sectors in each cluster of the synthesized volume. */
+static uint8_t   ClusterSectors      = BENCHMARK_DEFAULT_CLUSTER_SECTORS;
+
+/** Number of fragments the served file is split into on the synthesized volume. */
+static uint32_t  FileFragments       = 1;
+
+/** Percentage of transmitted segments which are lost. */
+static uint8_t   LossPercent         = BENCHMARK_DEFAULT_LOSS_PERCENT;
+
+/** TCP maximum segment size, giving the size of each file chunk read by the server. */
+static uint16_t  SegmentSize         = BENCHMARK_DEFAULT_MSS;
+
+/** Buffer for each segment read from the served file, standing in for the uIP packet buffer. */
+static uint8_t   SegmentBuffer[BENCHMARK_MAX_MSS];
+
+/** Retransmit slot holding a copy of the last unacknowledged segment, standing in for the server's retransmit slot pool. */
+static uint8_t   RexmitSlot[BENCHMARK_MAX_MSS];
+
+/** Statistics of the transfer in progress, updated by the disk read function. */
+static RetransmitBenchmark_Statistics_t* ActiveStatistics;
+
+/** Current state of the pseudo-random segment loss generator. */
+static uint32_t  RandomState;
+
+
+/** Main program entry point. This routine synthesizes the volume to serve from, and then transfers the served
+ *  file in each retransmission mode before printing the statistics of each transfer.
+ */
+int main(int argc, char** argv)
+{
+	RetransmitBenchmark_Statistics_t ChainStatistics;
+	RetransmitBenchmark_Statistics_t LinkMapStatistics;
+	RetransmitBenchmark_Statistics_t RexmitSlotStatistics;
+	int Option;
+
+	while ((Option = getopt(argc, argv, "s:c:f:l:m:")) != -1)
+	{
+		switch (Option)
+		{
+			case 's':
+				FileBytes      = (strtoul(optarg, NULL, 0) * 1024UL);
+				break;
+			case 'c':
+				ClusterSectors = strtoul(optarg, NULL, 0);
+				break;
+			case 'f':
+				FileFragments  = strtoul(optarg, NULL, 0);
+				break;
+			case 'l':
+				LossPercent    = strtoul(optarg, NULL, 0);
+				break;
+			case 'm':
+				SegmentSize    = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-s size_kb] [-c sectors_per_cluster] [-f fragments] [-l loss_percent] [-m mss]\n",
+				        argv[0]);
+				return 1;
+		}
+	}
+
+	/* Cluster sizes must be a power of two, and every segment must be able to get through eventually */
+	if (!(FileBytes) || !(ClusterSectors) || (ClusterSectors & (ClusterSectors - 1)) || (ClusterSectors > 64) ||
+	    !(FileFragments) || (LossPercent >= 100) || !(SegmentSize) || (SegmentSize > BENCHMARK_MAX_MSS))
+	{
+		fprintf(stderr, "Invalid benchmark parameters.\n");
+		return 1;
+	}
+
+	if (!(RetransmitBenchmark_CreateVolume()))
+	{
+		fprintf(stderr, "Unable to create a FAT16 volume holding the requested file.\n");
+		return 1;
+	}
+
+	printf("FAT16 volume with %u byte clusters, serving a %lu KB file in %lu fragment(s)\n",
+	       (ClusterSectors * BENCHMARK_SECTOR_SIZE), (unsigned long)(FileBytes / 1024), (unsigned long)FileFragments);
+	printf("%u byte segments with %u%% segment loss, link map holding up to %u fragment(s)\n\n",
+	       SegmentSize, LossPercent, MAX_FILE_FRAGMENTS);
+
+	RetransmitBenchmark_RunTransfer(BENCHMARK_MODE_ChainWalk,  &ChainStatistics);
+	RetransmitBenchmark_RunTransfer(BENCHMARK_MODE_LinkMap,    &LinkMapStatistics);
+	RetransmitBenchmark_RunTransfer(BENCHMARK_MODE_RexmitSlot, &RexmitSlotStatistics);
+
+	printf("%-18s %8s %8s %6s %10s %10s %12s %9s %10s %9s %9s\n", "Rexmit mode", "Segments", "Rexmits", "Errors",
+	       "Disk reads", "FAT reads", "Rexmit reads", "Max reads", "us/rexmit", "Max us", "Copy ms");
+	RetransmitBenchmark_PrintStatistics("FAT chain walk", &ChainStatistics);
+	RetransmitBenchmark_PrintStatistics("Cluster link map", &LinkMapStatistics);
+	RetransmitBenchmark_PrintStatistics("Retransmit slot", &RexmitSlotStatistics);
+
+	if (LinkMapStatistics.LinkMapResult != FR_OK)
+	{
+		printf("\nLink map creation failed (FatFs result %d), seeks fell back to walking the FAT chain.\n",
+		       LinkMapStatistics.LinkMapResult);
+	}
+
+	free(FileClusters);
+	free(SystemArea);
+
+	return ((ChainStatistics.Errors || LinkMapStatistics.Errors || RexmitSlotStatistics.Errors) ? 1 : 0);
+}
+
+/** Synthesizes the FAT16 volume in memory, holding the served file in the requested number of fragments. Only the
+ *  boot sector, FAT and root directory are stored; the contents of the data area are generated as they are read.
+ *
+ *  \return Boolean \c true if the volume was created, \c false if the file cannot be held on a FAT16 volume
+ */
+static bool RetransmitBenchmark_CreateVolume(void)
+{
+	uint32_t ClusterBytes  = ((uint32_t)ClusterSectors * BENCHMARK_SECTOR_SIZE);
+	uint32_t TotalClusters;
+	uint32_t TotalSectors;
+	uint32_t RootSectors   = ((BENCHMARK_ROOT_ENTRIES * 32) / BENCHMARK_SECTOR_SIZE);
+
+	FileClusterCount = ((FileBytes + (ClusterBytes - 1)) / ClusterBytes);
+
+	if (FileFragments > FileClusterCount)
+	  return false;
+
+	/* Leave a free cluster between each fragment of the file, and some spare clusters at the end of the volume */
+	TotalClusters = (FileClusterCount + (FileFragments - 1) + 16);
+	if (TotalClusters < BENCHMARK_MIN_CLUSTERS)
+	  TotalClusters = BENCHMARK_MIN_CLUSTERS;
+	else if (TotalClusters > BENCHMARK_MAX_CLUSTERS)
+	  return false;
+
+	FATSectors      = ((((TotalClusters + 2) * 2) + (BENCHMARK_SECTOR_SIZE - 1)) / BENCHMARK_SECTOR_SIZE);
+	DataStartSector = (1 + FATSectors + RootSectors);
+	TotalSectors    = (DataStartSector + (TotalClusters * ClusterSectors));
+
+	SystemArea   = calloc(DataStartSector, BENCHMARK_SECTOR_SIZE);
+	FileClusters = calloc(FileClusterCount, sizeof(uint32_t));
+
+	if (!(SystemArea) || !(FileClusters))
+	  return false;
+
+	/* Boot sector, with a single FAT and no hidden sectors */
+	uint8_t* BootSector = SystemArea;
+
+	memcpy(&BootSector[0], "\xEB\x3C\x90" "MSDOS5.0", 11);
+	ST_WORD(&BootSector[11], BENCHMARK_SECTOR_SIZE);
+	BootSector[13] = ClusterSectors;
+	ST_WORD(&BootSector[14], 1);
+	BootSector[16] = 1;
+	ST_WORD(&BootSector[17], BENCHMARK_ROOT_ENTRIES);
+
+	if (TotalSectors < 0x10000)
+	  ST_WORD(&BootSector[19], TotalSectors);
+	else
+	  ST_DWORD(&BootSector[32], TotalSectors);
+
+	BootSector[21] = 0xF8;
+	ST_WORD(&BootSector[22], FATSectors);
+	BootSector[38] = 0x29;
+	memcpy(&BootSector[43], "NO NAME    " "FAT16   ", 19);
+	ST_WORD(&BootSector[510], 0xAA55);
+
+	/* FAT, with the file's clusters laid out in equally sized fragments separated by a free cluster */
+	uint8_t* FAT             = &SystemArea[BENCHMARK_SECTOR_SIZE];
+	uint32_t CurrentCluster  = 2;
+	uint32_t ClusterIndex    = 0;
+
+	ST_WORD(&FAT[0], 0xFFF8);
+	ST_WORD(&FAT[2], 0xFFFF);
+
+	for (uint32_t Fragment = 0; Fragment < FileFragments; Fragment++)
+	{
+		uint32_t FragmentEnd = (((uint64_t)FileClusterCount * (Fragment + 1)) / FileFragments);
+
+		while (ClusterIndex < FragmentEnd)
+		  FileClusters[ClusterIndex++] = CurrentCluster++;
+
+		CurrentCluster++;
+	}
+
+	for (ClusterIndex = 0; ClusterIndex < FileClusterCount; ClusterIndex++)
+	{
+		uint32_t NextCluster = ((ClusterIndex == (FileClusterCount - 1)) ? 0xFFFF : FileClusters[ClusterIndex + 1]);
+
+		ST_WORD(&FAT[FileClusters[ClusterIndex] * 2], NextCluster);
+	}
+
+	/* Root directory, holding only the served file */
+	uint8_t* DirectoryEntry = &SystemArea[(1 + FATSectors) * BENCHMARK_SECTOR_SIZE];
+
+	memcpy(&DirectoryEntry[0], "DATA    BIN", 11);
+	DirectoryEntry[11] = AM_ARC;
+	ST_WORD(&DirectoryEntry[26], FileClusters[0]);
+	ST_DWORD(&DirectoryEntry[28], FileBytes);
+
+	return true;
+}
+
+/** Serves the file from the synthesized volume in the same way as the HTTP server application, injecting segment
+ *  losses from a fixed pseudo-random sequence so that each transfer sees the same losses.
+ *
+ *  \param[in]  Mode        Retransmission mode of the transfer, a value from \ref RetransmitBenchmark_Modes_t
+ *  \param[out] Statistics  Pointer to the statistics structure to fill for the transfer
+ */
+static void RetransmitBenchmark_RunTransfer(const uint8_t Mode,
+                                            RetransmitBenchmark_Statistics_t* const Statistics)
+{
+	FATFS    DiskFATState;
+	FIL      FileHandle;
+	DWORD    FileLinkMap[2 + (MAX_FILE_FRAGMENTS * 2)];
+	uint32_t ACKedFilePos     = 0;
+	UINT     RexmitSlotLength = 0;
+	bool     Resend           = false;
+	uint32_t ResendStartReads = 0;
+	uint64_t ResendStartTime  = 0;
+
+	memset(Statistics, 0x00, sizeof(RetransmitBenchmark_Statistics_t));
+	ActiveStatistics = Statistics;
+	RandomState      = 1;
+
+	f_mount(0, &DiskFATState);
+
+	if (f_open(&FileHandle, BENCHMARK_FILENAME, (FA_OPEN_EXISTING | FA_READ)) != FR_OK)
+	{
+		Statistics->Errors++;
+		return;
+	}
+
+	/* The server builds a link map of every file, whether or not it also keeps segments in retransmit slots */
+	if (Mode != BENCHMARK_MODE_ChainWalk)
+	  Statistics->LinkMapResult = f_linkmap(&FileHandle, FileLinkMap, (sizeof(FileLinkMap) / sizeof(FileLinkMap[0])));
+
+	for (;;)
+	{
+		UINT SentChunkSize;
+
+		if (Resend && (Mode == BENCHMARK_MODE_RexmitSlot))
+		{
+			/* Lost segment is resent from its retransmit slot, without reading it from the disk again */
+			memcpy(SegmentBuffer, RexmitSlot, RexmitSlotLength);
+			SentChunkSize = RexmitSlotLength;
+		}
+		else if (f_read(&FileHandle, SegmentBuffer, SegmentSize, &SentChunkSize) != FR_OK)
+		{
+			/* Read the next chunk of data from the open file, as the server does for each transmitted segment */
+			Statistics->Errors++;
+			break;
+		}
+
+		if (Resend)
+		{
+			uint64_t ResendTime  = (RetransmitBenchmark_GetTimeNS() - ResendStartTime);
+			uint32_t ResendReads = (Statistics->TotalReads - ResendStartReads);
+
+			Statistics->RexmitReads       += ResendReads;
+			Statistics->RexmitNanoseconds += ResendTime;
+
+			if (ResendReads > Statistics->MaxRexmitReads)
+			  Statistics->MaxRexmitReads = ResendReads;
+
+			if (ResendTime > Statistics->MaxRexmitNanoseconds)
+			  Statistics->MaxRexmitNanoseconds = ResendTime;
+
+			Resend = false;
+		}
+		else if (Mode == BENCHMARK_MODE_RexmitSlot)
+		{
+			uint64_t CopyStartTime = RetransmitBenchmark_GetTimeNS();
+
+			/* Keep a copy of each new segment until it is ACKed, as the server does when it holds a retransmit slot */
+			memcpy(RexmitSlot, SegmentBuffer, SentChunkSize);
+			RexmitSlotLength = SentChunkSize;
+
+			Statistics->CopyNanoseconds += (RetransmitBenchmark_GetTimeNS() - CopyStartTime);
+		}
+
+		Statistics->Segments++;
+
+		if ((RetransmitBenchmark_Random() % 100) < LossPercent)
+		{
+			ResendStartReads = Statistics->TotalReads;
+			ResendStartTime  = RetransmitBenchmark_GetTimeNS();
+
+			/* Segment was lost - return file pointer to the last ACKed position for the retransmission, unless the
+			 * segment was kept in a retransmit slot */
+			if (Mode != BENCHMARK_MODE_RexmitSlot)
+			  f_lseek(&FileHandle, ACKedFilePos);
+
+			Statistics->Retransmissions++;
+			Resend = true;
+			continue;
+		}
+
+		if (!(RetransmitBenchmark_CheckSegment(SegmentBuffer, ACKedFilePos, SentChunkSize)))
+		  Statistics->Errors++;
+
+		ACKedFilePos      += SentChunkSize;
+		Statistics->Bytes += SentChunkSize;
+
+		/* A short chunk is the last chunk of the file */
+		if (SentChunkSize != SegmentSize)
+		  break;
+	}
+
+	if (Statistics->Bytes != FileBytes)
+	  Statistics->Errors++;
+
+	f_close(&FileHandle);
+	f_mount(0, NULL);
+}
+
+/** Generates the contents of a data area byte of the synthesized volume, which depends on both the sector and
+ *  the offset within it so that data read from the wrong sector is detected.
+ *
+ *  \param[in] Sector  Sector address of the byte
+ *  \param[in] Offset  Offset of the byte within the sector
+ *
+ *  \return Contents of the requested byte
+ */
+static uint8_t RetransmitBenchmark_GetDataByte(const uint32_t Sector,
+                                               const uint16_t Offset)
+{
+	return (((Sector ^ (Sector >> 8) ^ (Sector >> 16)) * 31) + Offset + (Offset >> 8));
+}
+
+/** Checks the contents of a segment read from the served file against the contents of the file.
+ *
+ *  \param[in] Segment       Pointer to the segment contents
+ *  \param[in] FilePosition  Position of the start of the segment within the file
+ *  \param[in] Length        Length of the segment, in bytes
+ *
+ *  \return Boolean \c true if the segment contents are correct, \c false otherwise
+ */
+static bool RetransmitBenchmark_CheckSegment(const uint8_t* const Segment,
+                                             const uint32_t FilePosition,
+                                             const uint16_t Length)
+{
+	uint32_t ClusterBytes = ((uint32_t)ClusterSectors * BENCHMARK_SECTOR_SIZE);
+
+	for (uint16_t ByteIndex = 0; ByteIndex < Length; ByteIndex++)
+	{
+		uint32_t Position = (FilePosition + ByteIndex);
+		uint32_t Sector   = (DataStartSector + ((FileClusters[Position / ClusterBytes] - 2) * ClusterSectors) +
+		                     ((Position % ClusterBytes) / BENCHMARK_SECTOR_SIZE));
+
+		if (Segment[ByteIndex] != RetransmitBenchmark_GetDataByte(Sector, (Position % BENCHMARK_SECTOR_SIZE)))
+		  return false;
+	}
+
+	return true;
+}
+
+/** Prints the statistics gathered for a transfer of the served file.
+ *
+ *  \param[in] Name        Name of the transfer's seek mode
+ *  \param[in] Statistics  Pointer to the statistics of the transfer
+ */
+static void RetransmitBenchmark_PrintStatistics(const char* const Name,
+                                                const RetransmitBenchmark_Statistics_t* const Statistics)
+{
+	uint32_t Retransmissions = (Statistics->Retransmissions ? Statistics->Retransmissions : 1);
+
+	printf("%-18s %8lu %8lu %6lu %10lu %10lu %12lu %9lu %10.2f %9.2f %9.2f\n", Name,
+	       (unsigned long)Statistics->Segments, (unsigned long)Statistics->Retransmissions,
+	       (unsigned long)Statistics->Errors, (unsigned long)Statistics->TotalReads,
+	       (unsigned long)Statistics->TableReads, (unsigned long)Statistics->RexmitReads,
+	       (unsigned long)Statistics->MaxRexmitReads, ((Statistics->RexmitNanoseconds / 1000.0) / Retransmissions),
+	       (Statistics->MaxRexmitNanoseconds / 1000.0), (Statistics->CopyNanoseconds / 1000000.0));
+}
+
+/** Generates the next pseudo-random number in a fixed sequence, using a 32-bit xorshift generator.
+ *
+ *  \return Next pseudo-random number in the sequence
+ */
+static uint32_t RetransmitBenchmark_Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Retrieves the current build machine monotonic time, for timing seeks.
+ *
+ *  \return Current time in nanoseconds
+ */
+static uint64_t RetransmitBenchmark_GetTimeNS(void)
+{
+	struct timespec CurrentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &CurrentTime);
+
+	return (((uint64_t)CurrentTime.tv_sec * 1000000000ULL) + CurrentTime.tv_nsec);
+}
+
+/** FatFs disk initialization function, for the synthesized volume.
+ *
+ *  \param[in] drv  Physical drive number
+ *
+ *  \return Drive status
+ */
+DSTATUS disk_initialize(BYTE drv)
+{
+	return 0;
+}
+
+/** FatFs disk status function, for the synthesized volume.
+ *
+ *  \param[in] drv  Physical drive number
+ *
+ *  \return Drive status
+ */
+DSTATUS disk_status(BYTE drv)
+{
+	return 0;
+}
+
+/** FatFs disk read function, which reads sectors from the synthesized volume and records the reads in the
+ *  statistics of the transfer in progress.
+ *
+ *  \param[in]  drv     Physical drive number
+ *  \param[out] buff    Buffer to store the read sector data into
+ *  \param[in]  sector  Address of the first sector to read
+ *  \param[in]  count   Number of sectors to read
+ *
+ *  \return Result of the read operation
+ */
+DRESULT disk_read(BYTE drv, BYTE* buff, DWORD sector, BYTE count)
+{
+	while (count--)
+	{
+		if (sector < DataStartSector)
+		{
+			memcpy(buff, &SystemArea[sector * BENCHMARK_SECTOR_SIZE], BENCHMARK_SECTOR_SIZE);
+
+			if (sector && (sector <= FATSectors))
+			  ActiveStatistics->TableReads++;
+		}
+		else
+		{
+			for (uint16_t ByteIndex = 0; ByteIndex < BENCHMARK_SECTOR_SIZE; ByteIndex++)
+			  buff[ByteIndex] = RetransmitBenchmark_GetDataByte(sector, ByteIndex);
+		}
+
+		ActiveStatistics->TotalReads++;
+
+		buff += BENCHMARK_SECTOR_SIZE;
+		sector++;
+	}
+
+	return RES_OK;
+}
@@ -0,0 +1,130 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for RetransmitBenchmark.c.
+ */
+
+#ifndef _RETRANSMIT_BENCHMARK_H_
+#define _RETRANSMIT_BENCHMARK_H_
+
+	/* Includes: */
+		#include <stdbool.h>
+		#include <stdint.h>
+		#include <stdio.h>
+		#include <stdlib.h>
+		#include <string.h>
+		#include <time.h>
+		#include <unistd.h>
+
+		#include "Config/AppConfig.h"
+
+		#include "FATFs/ff.h"
+		#include "FATFs/diskio.h"
+
+	/* Defines: */
+		/** Size of each sector of the synthesized volume, in bytes. */
+		#define BENCHMARK_SECTOR_SIZE               512
+
+		/** Number of root directory entries of the synthesized volume. */
+		#define BENCHMARK_ROOT_ENTRIES              512
+
+		/** Minimum number of clusters of the synthesized volume, so that it is always formatted as FAT16. */
+		#define BENCHMARK_MIN_CLUSTERS              4200
+
+		/** Maximum number of clusters of a FAT16 volume. */
+		#define BENCHMARK_MAX_CLUSTERS              65524
+
+		/** Default size of the served file, in kilobytes. */
+		#define BENCHMARK_DEFAULT_FILE_KB           4096
+
+		/** Default number of sectors in each cluster of the synthesized volume. */
+		#define BENCHMARK_DEFAULT_CLUSTER_SECTORS   4
+
+		/** Default percentage of transmitted segments which are lost and must be retransmitted. */
+		#define BENCHMARK_DEFAULT_LOSS_PERCENT      5
+
+		/** Default TCP maximum segment size, matching the uIP buffer size of the webserver. */
+		#define BENCHMARK_DEFAULT_MSS               (UIP_CONF_BUFFER_SIZE - 14 - 40)
+
+		/** Largest supported TCP maximum segment size. */
+		#define BENCHMARK_MAX_MSS                   8192
+
+		/** Name of the file served from the synthesized volume. */
+		#define BENCHMARK_FILENAME                  "DATA.BIN"
+
+	/* Enums: */
+		/** Retransmission modes of the served file transfers. */
+		enum RetransmitBenchmark_Modes_t
+		{
+			BENCHMARK_MODE_ChainWalk, /**< Lost segments are read again, seeking by following the FAT cluster chain */
+			BENCHMARK_MODE_LinkMap, /**< Lost segments are read again, seeking with a cluster link map of the file */
+			BENCHMARK_MODE_RexmitSlot, /**< Lost segments are resent from a copy kept in a retransmit slot */
+		};
+
+	/* Type Defines: */
+		/** Type define for the statistics gathered for each transfer of the served file. */
+		typedef struct
+		{
+			FRESULT  LinkMapResult; /**< Result of the link map creation, or \c FR_OK if no link map was used. */
+			uint32_t Segments; /**< Number of segments transmitted, including retransmissions. */
+			uint32_t Retransmissions; /**< Number of segments retransmitted after an injected loss. */
+			uint32_t Bytes; /**< Number of file bytes ACKed by the receiver. */
+			uint32_t Errors; /**< Number of ACKed segments whose contents did not match the file. */
+			uint32_t TotalReads; /**< Number of sectors read from the disk for the whole transfer. */
+			uint32_t TableReads; /**< Number of sectors read from the allocation table for the whole transfer. */
+			uint32_t RexmitReads; /**< Number of sectors read from the disk to retransmit lost segments. */
+			uint32_t MaxRexmitReads; /**< Largest number of sectors read from the disk to retransmit a single segment. */
+			uint64_t RexmitNanoseconds; /**< Build machine time spent seeking and reading to retransmit lost segments. */
+			uint64_t MaxRexmitNanoseconds; /**< Longest build machine time spent to retransmit a single segment. */
+			uint64_t CopyNanoseconds; /**< Build machine time spent copying new segments into the retransmit slot. */
+		} RetransmitBenchmark_Statistics_t;
+
+	/* Function Prototypes: */
+		int main(int argc, char** argv);
+
+		#if defined(INCLUDE_FROM_RETRANSMITBENCHMARK_C)
+			static bool RetransmitBenchmark_CreateVolume(void);
+			static void RetransmitBenchmark_RunTransfer(const uint8_t Mode,
+			                                            RetransmitBenchmark_Statistics_t* const Statistics);
+			static uint8_t RetransmitBenchmark_GetDataByte(const uint32_t Sector,
+			                                               const uint16_t Offset);
+			static bool RetransmitBenchmark_CheckSegment(const uint8_t* const Segment,
+			                                             const uint32_t FilePosition,
+			                                             const uint16_t Length);
+			static void RetransmitBenchmark_PrintStatistics(const char* const Name,
+			                                                const RetransmitBenchmark_Statistics_t* const Statistics);
+			static uint32_t RetransmitBenchmark_Random(void);
+			static uint64_t RetransmitBenchmark_GetTimeNS(void);
+		#endif
+
+#endif
+
@@ -0,0 +1,533 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host-native stand-in for the webserver's USB RNDIS link, used to measure the network throughput of the uIP
+ *  management code, the uIP stack, the HTTP, TELNET and DHCP server applications and FatFs on the build machine.
+ *  These are built natively for the simulated architecture, with the RNDIS class driver packet functions bound to a
+ *  Linux TAP interface in place of the USB stack, so that clients on the build machine can connect to the server at
+ *  its configured IP address. Files are served from the asset bundle and from an optional FAT disk image.
+ *
+ *  The USB bus itself is modelled by busy waiting for the given number of nanoseconds for each byte of every frame
+ *  read or sent (including its RNDIS packet message header), and for each main loop pass to stand in for the USB
+ *  management tasks. Like the OUT endpoint of the RNDIS interface, only one received frame is held waiting to be
+ *  read at a time. A SIGUSR1 signal prints the main loop pass rate since the last report, and SIGINT or SIGTERM stop
+ *  the server and print its statistics.
+ *
+ *  Creating the TAP interface requires the CAP_NET_ADMIN capability, i.e. running as root.
+ *
+ *  Usage: TAPServer [-i interface] [-d disk_image] [-b bus_ns_per_byte] [-p bus_ns_per_pass]
+ */
+
+#define  INCLUDE_FROM_TAPSERVER_C
+#include "TAPServer.h"
+
+/** Stand-in for the USB stack's current mode, fixed to device mode as the server takes the RNDIS device role. */
+volatile uint8_t USB_CurrentMode = USB_MODE_Device;
+
+/** Stand-in for the USB stack's device state, fixed to configured so that the network is always managed. */
+volatile uint8_t USB_DeviceState = DEVICE_STATE_Configured;
+
+/** Stand-in for the USB stack's host state, unused as the server never takes the RNDIS host role. */
+volatile uint8_t USB_HostState   = HOST_STATE_Unattached;
+
+/** RNDIS device interface stand-in, passed by the uIP management code to the RNDIS device packet functions. */
+USB_ClassInfo_RNDIS_Device_t Ethernet_RNDIS_Interface_Device;
+
+/** RNDIS host interface stand-in, passed by the uIP management code to the RNDIS host packet functions. */
+USB_ClassInfo_RNDIS_Host_t   Ethernet_RNDIS_Interface_Host;
+
+/** File descriptor of the TAP interface the server's Ethernet frames are exchanged through. */
+static int       TAPFileDescriptor   = -1;
+
+/** Received frame waiting to be read, standing in for the OUT endpoint bank of the RNDIS interface. */
+static uint8_t   PendingFrame[UIP_CONF_BUFFER_SIZE + 2];
+
+/** Length of the received frame waiting to be read, or zero if none is waiting. */
+static uint16_t  PendingFrameLength;
+
+/** Contents of the disk image the FatFs volume is read from, or \c NULL if no disk image was given. */
+static uint8_t*  DiskImage;
+
+/** Number of sectors in the disk image. */
+static uint32_t  DiskImageSectors;
+
+/** Modelled USB bus time for each byte of every frame read or sent, in nanoseconds. */
+static uint32_t  BusNanosecondsPerByte;
+
+/** Modelled USB management task time for each main loop pass, in nanoseconds. */
+static uint32_t  BusNanosecondsPerPass;
+
+/** Build machine time when the uIP clock was initialized, in nanoseconds. */
+static uint64_t  ClockStartTime;
+
+/** Build machine time of the last sent frame, in nanoseconds, or zero if no frame has been sent yet. */
+static uint64_t  LastSendTime;
+
+/** Number of frames read in the current main loop pass. */
+static uint32_t  FramesThisPass;
+
+/** Statistics gathered while the server runs. */
+static TAPServer_Statistics_t Statistics;
+
+/** Flag set by the signal handler when the server should stop. */
+static volatile sig_atomic_t StopRequested;
+
+/** Flag set by the signal handler when the main loop pass rate should be reported. */
+static volatile sig_atomic_t ReportRequested;
+
+
+/** Main program entry point. This routine creates the TAP interface and opens the disk image, and then runs the
+ *  webserver's network management as the main loop of the device would until a stop signal is received.
+ */
+int main(int argc, char** argv)
+{
+	const char* InterfaceName = TAP_DEFAULT_INTERFACE_NAME;
+	const char* DiskImageName = NULL;
+	uint64_t    LastReportTime;
+	uint64_t    LastReportPasses = 0;
+	int         Option;
+
+	while ((Option = getopt(argc, argv, "i:d:b:p:")) != -1)
+	{
+		switch (Option)
+		{
+			case 'i':
+				InterfaceName         = optarg;
+				break;
+			case 'd':
+				DiskImageName         = optarg;
+				break;
+			case 'b':
+				BusNanosecondsPerByte = strtoul(optarg, NULL, 0);
+				break;
+			case 'p':
+				BusNanosecondsPerPass = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-i interface] [-d disk_image] [-b bus_ns_per_byte] [-p bus_ns_per_pass]\n",
+				        argv[0]);
+				return 1;
+		}
+	}
+
+	if (DiskImageName && !(TAPServer_OpenDiskImage(DiskImageName)))
+	{
+		fprintf(stderr, "Unable to open the disk image \"%s\".\n", DiskImageName);
+		return 1;
+	}
+
+	if (!(TAPServer_OpenInterface(InterfaceName)))
+	{
+		fprintf(stderr, "Unable to create the TAP interface \"%s\", which requires root privileges.\n", InterfaceName);
+		return 1;
+	}
+
+	signal(SIGINT,  TAPServer_SignalHandler);
+	signal(SIGTERM, TAPServer_SignalHandler);
+	signal(SIGUSR1, TAPServer_SignalHandler);
+
+	uIPManagement_Init();
+
+	/* The webserver's Ethernet address has the group bit set, which the build machine will not accept as the source
+	 * of a unicast frame, so a locally administered unicast address is used in its place */
+	MACAddress.addr[0] = ((MACAddress.addr[0] & ~0x01) | 0x02);
+	uip_setethaddr(MACAddress);
+
+	printf("Serving %u.%u.%u.%u on TAP interface \"%s\" (%s)\n",
+	       DEVICE_IP_ADDRESS[0], DEVICE_IP_ADDRESS[1], DEVICE_IP_ADDRESS[2], DEVICE_IP_ADDRESS[3], InterfaceName,
+	       (DiskImage ? DiskImageName : "no disk image"));
+	fflush(stdout);
+
+	LastReportTime = TAPServer_GetTimeNS();
+
+	while (!(StopRequested))
+	{
+		FramesThisPass = 0;
+
+		uIPManagement_ManageNetwork();
+
+		if (FramesThisPass > Statistics.MaxFramesPerPass)
+		  Statistics.MaxFramesPerPass = FramesThisPass;
+
+		/* Stand in for the USB management tasks run on each pass of the device's main loop */
+		TAPServer_ModelBusTransfer(0);
+		Statistics.Passes++;
+
+		if (ReportRequested)
+		{
+			uint64_t CurrentTime = TAPServer_GetTimeNS();
+
+			ReportRequested = false;
+
+			printf("%.0f main loop passes/s\n",
+			       ((Statistics.Passes - LastReportPasses) / ((CurrentTime - LastReportTime) / 1e9)));
+			fflush(stdout);
+
+			LastReportTime   = CurrentTime;
+			LastReportPasses = Statistics.Passes;
+		}
+	}
+
+	TAPServer_PrintStatistics();
+
+	close(TAPFileDescriptor);
+
+	return 0;
+}
+
+/** Creates the TAP interface the server's Ethernet frames are exchanged through, and configures the build machine's
+ *  end of it with the gateway address and netmask of the webserver's network settings.
+ *
+ *  \param[in] InterfaceName  Name of the TAP interface to create.
+ *
+ *  \return Boolean \c true if the interface was created and configured, \c false otherwise
+ */
+static bool TAPServer_OpenInterface(const char* const InterfaceName)
+{
+	struct ifreq InterfaceRequest;
+	int          ConfigSocket;
+	bool         Success;
+
+	if ((TAPFileDescriptor = open("/dev/net/tun", O_RDWR | O_NONBLOCK)) < 0)
+	  return false;
+
+	memset(&InterfaceRequest, 0, sizeof(InterfaceRequest));
+	InterfaceRequest.ifr_flags = (IFF_TAP | IFF_NO_PI);
+	strncpy(InterfaceRequest.ifr_name, InterfaceName, (IFNAMSIZ - 1));
+
+	if (ioctl(TAPFileDescriptor, TUNSETIFF, &InterfaceRequest) < 0)
+	  return false;
+
+	if ((ConfigSocket = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
+	  return false;
+
+	/* Give the build machine's end of the interface the address of the webserver's gateway */
+	struct sockaddr_in* InterfaceAddress = (struct sockaddr_in*)&InterfaceRequest.ifr_addr;
+	InterfaceAddress->sin_family = AF_INET;
+
+	memcpy(&InterfaceAddress->sin_addr, DEVICE_GATEWAY, sizeof(InterfaceAddress->sin_addr));
+	Success  = (ioctl(ConfigSocket, SIOCSIFADDR, &InterfaceRequest) == 0);
+
+	memcpy(&InterfaceAddress->sin_addr, DEVICE_NETMASK, sizeof(InterfaceAddress->sin_addr));
+	Success &= (ioctl(ConfigSocket, SIOCSIFNETMASK, &InterfaceRequest) == 0);
+
+	/* Bring the interface up, so that frames can be exchanged through it */
+	Success &= (ioctl(ConfigSocket, SIOCGIFFLAGS, &InterfaceRequest) == 0);
+	InterfaceRequest.ifr_flags |= (IFF_UP | IFF_RUNNING);
+	Success &= (ioctl(ConfigSocket, SIOCSIFFLAGS, &InterfaceRequest) == 0);
+
+	close(ConfigSocket);
+
+	return Success;
+}
+
+/** Maps the given disk image into memory, so that the FatFs volume can be read from it.
+ *
+ *  \param[in] FileName  Name of the disk image file to open.
+ *
+ *  \return Boolean \c true if the disk image was opened, \c false otherwise
+ */
+static bool TAPServer_OpenDiskImage(const char* const FileName)
+{
+	struct stat FileStatus;
+	int         FileDescriptor;
+
+	if ((FileDescriptor = open(FileName, O_RDONLY)) < 0)
+	  return false;
+
+	if ((fstat(FileDescriptor, &FileStatus) < 0) || (FileStatus.st_size < TAP_SECTOR_SIZE))
+	{
+		close(FileDescriptor);
+		return false;
+	}
+
+	DiskImage        = mmap(NULL, FileStatus.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+	DiskImageSectors = (FileStatus.st_size / TAP_SECTOR_SIZE);
+
+	close(FileDescriptor);
+
+	if (DiskImage == MAP_FAILED)
+	{
+		DiskImage = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/** Models a transfer over the USB bus by busy waiting, as the device's main loop blocks while its endpoints are
+ *  read and written.
+ *
+ *  \param[in] Bytes  Number of bytes of Ethernet frame transferred, or zero for the per-pass USB management time.
+ */
+static void TAPServer_ModelBusTransfer(const uint16_t Bytes)
+{
+	uint64_t Duration;
+
+	if (Bytes)
+	  Duration = ((uint64_t)(Bytes + TAP_RNDIS_HEADER_SIZE) * BusNanosecondsPerByte);
+	else
+	  Duration = BusNanosecondsPerPass;
+
+	if (!(Duration))
+	  return;
+
+	uint64_t EndTime = (TAPServer_GetTimeNS() + Duration);
+	while (TAPServer_GetTimeNS() < EndTime);
+
+	Statistics.BusNanoseconds += Duration;
+}
+
+/** Prints the statistics gathered while the server ran. */
+static void TAPServer_PrintStatistics(void)
+{
+	printf("Frames received: %lu, sent: %lu, most received in one pass: %lu\n",
+	       (unsigned long)Statistics.ReceivedFrames, (unsigned long)Statistics.SentFrames,
+	       (unsigned long)Statistics.MaxFramesPerPass);
+	printf("Main loop passes: %llu, modelled USB bus time: %.2fs\n",
+	       (unsigned long long)Statistics.Passes, (Statistics.BusNanoseconds / 1e9));
+
+	printf("Time between sent frames (0.5ms bins):");
+	for (uint8_t Bin = 0; Bin < TAP_SEND_GAP_BINS; Bin++)
+	  printf(" %lu", (unsigned long)Statistics.SendGaps[Bin]);
+	printf("\n");
+}
+
+/** Signal handler, requesting a stop of the server or a report of its main loop pass rate.
+ *
+ *  \param[in] Signal  Number of the received signal.
+ */
+static void TAPServer_SignalHandler(int Signal)
+{
+	if (Signal == SIGUSR1)
+	  ReportRequested = true;
+	else
+	  StopRequested   = true;
+}
+
+/** Retrieves the current time of the build machine's monotonic clock.
+ *
+ *  \return Current monotonic time, in nanoseconds
+ */
+static uint64_t TAPServer_GetTimeNS(void)
+{
+	struct timespec CurrentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &CurrentTime);
+
+	return (((uint64_t)CurrentTime.tv_sec * 1000000000ULL) + CurrentTime.tv_nsec);
+}
+
+/** Stand-in for the RNDIS device class driver, indicating if a frame received from the TAP interface is waiting.
+ *
+ *  \param[in,out] RNDISInterfaceInfo  Unused RNDIS device interface stand-in.
+ *
+ *  \return Boolean \c true if a frame is waiting to be read, \c false otherwise
+ */
+bool RNDIS_Device_IsPacketReceived(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	if (!(PendingFrameLength))
+	{
+		ssize_t FrameLength = read(TAPFileDescriptor, PendingFrame, sizeof(PendingFrame));
+
+		if (FrameLength > 0)
+		  PendingFrameLength = FrameLength;
+	}
+
+	return (PendingFrameLength != 0);
+}
+
+/** Stand-in for the RNDIS device class driver, reading the waiting frame received from the TAP interface.
+ *
+ *  \param[in,out] RNDISInterfaceInfo  Unused RNDIS device interface stand-in.
+ *  \param[out]    Buffer              Buffer the frame is read into.
+ *  \param[in]     BufferSize          Size of the buffer, in bytes.
+ *  \param[out]    PacketLength        Length of the frame read, or zero if no frame was waiting.
+ *
+ *  \return A value from the \ref Endpoint_Stream_RW_ErrorCodes_t enum
+ */
+uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                void* Buffer,
+                                const uint16_t BufferSize,
+                                uint16_t* PacketLength)
+{
+	*PacketLength = 0;
+
+	if (!(RNDIS_Device_IsPacketReceived(RNDISInterfaceInfo)))
+	  return ENDPOINT_RWSTREAM_NoError;
+
+	TAPServer_ModelBusTransfer(PendingFrameLength);
+
+	*PacketLength = MIN(PendingFrameLength, BufferSize);
+	memcpy(Buffer, PendingFrame, *PacketLength);
+
+	PendingFrameLength = 0;
+	Statistics.ReceivedFrames++;
+	FramesThisPass++;
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+/** Stand-in for the RNDIS device class driver, sending a frame to the TAP interface.
+ *
+ *  \param[in,out] RNDISInterfaceInfo  Unused RNDIS device interface stand-in.
+ *  \param[in]     Buffer              Buffer holding the frame to send.
+ *  \param[in]     PacketLength        Length of the frame to send, in bytes.
+ *
+ *  \return A value from the \ref Endpoint_Stream_RW_ErrorCodes_t enum
+ */
+uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                void* Buffer,
+                                const uint16_t PacketLength)
+{
+	TAPServer_ModelBusTransfer(PacketLength);
+
+	if (write(TAPFileDescriptor, Buffer, PacketLength) != PacketLength)
+	  perror("TAP interface write");
+
+	uint64_t CurrentTime = TAPServer_GetTimeNS();
+
+	if (LastSendTime)
+	{
+		uint64_t GapBin = ((CurrentTime - LastSendTime) / 500000);
+		Statistics.SendGaps[MIN(GapBin, (TAP_SEND_GAP_BINS - 1))]++;
+	}
+
+	LastSendTime = CurrentTime;
+	Statistics.SentFrames++;
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+/** Stand-in for the RNDIS host class driver, which is never used as the server takes the RNDIS device role.
+ *
+ *  \param[in,out] RNDISInterfaceInfo  Unused RNDIS host interface stand-in.
+ *
+ *  \return Boolean \c false, as no frames are received in the RNDIS host role
+ */
+bool RNDIS_Host_IsPacketReceived(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo)
+{
+	return false;
+}
+
+/** Stand-in for the RNDIS host class driver, which is never used as the server takes the RNDIS device role.
+ *
+ *  \param[in,out] RNDISInterfaceInfo  Unused RNDIS host interface stand-in.
+ *  \param[out]    Buffer              Unused frame buffer.
+ *  \param[in]     BufferSize          Unused frame buffer size.
+ *  \param[out]    PacketLength        Length of the frame read, always zero.
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum
+ */
+uint8_t RNDIS_Host_ReadPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+                              void* Buffer,
+                              const uint16_t BufferSize,
+                              uint16_t* const PacketLength)
+{
+	*PacketLength = 0;
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+/** Stand-in for the RNDIS host class driver, which is never used as the server takes the RNDIS device role.
+ *
+ *  \param[in,out] RNDISInterfaceInfo  Unused RNDIS host interface stand-in.
+ *  \param[in]     Buffer              Unused frame buffer.
+ *  \param[in]     PacketLength        Unused frame length.
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum
+ */
+uint8_t RNDIS_Host_SendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+                              void* Buffer,
+                              const uint16_t PacketLength)
+{
+	return PIPE_RWSTREAM_NoError;
+}
+
+/** Stand-in for the uIP clock driver, starting the uIP clock at the current build machine time. */
+void clock_init(void)
+{
+	ClockStartTime = TAPServer_GetTimeNS();
+}
+
+/** Stand-in for the uIP clock driver, retrieving the uIP clock time from the build machine's monotonic clock.
+ *
+ *  \return Number of uIP clock ticks since the clock was initialized
+ */
+clock_time_t clock_time(void)
+{
+	return ((TAPServer_GetTimeNS() - ClockStartTime) / (1000000000ULL / CLOCK_SECOND));
+}
+
+/** Stand-in for the FatFs disk driver, initializing the disk image.
+ *
+ *  \param[in] drv  Physical drive number.
+ *
+ *  \return \c STA_NOINIT if no disk image was given, zero otherwise
+ */
+DSTATUS disk_initialize(BYTE drv)
+{
+	return (DiskImage ? 0 : STA_NOINIT);
+}
+
+/** Stand-in for the FatFs disk driver, retrieving the status of the disk image.
+ *
+ *  \param[in] drv  Physical drive number.
+ *
+ *  \return \c STA_NOINIT if no disk image was given, zero otherwise
+ */
+DSTATUS disk_status(BYTE drv)
+{
+	return (DiskImage ? 0 : STA_NOINIT);
+}
+
+/** Stand-in for the FatFs disk driver, reading sectors from the disk image.
+ *
+ *  \param[in]  drv     Physical drive number.
+ *  \param[out] buff    Buffer the sectors are read into.
+ *  \param[in]  sector  Address of the first sector to read.
+ *  \param[in]  count   Number of sectors to read.
+ *
+ *  \return \c RES_OK if the sectors were read, \c RES_PARERR if they lie outside the disk image
+ */
+DRESULT disk_read(BYTE drv,
+                  BYTE* buff,
+                  DWORD sector,
+                  BYTE count)
+{
+	if (!(DiskImage) || ((sector + count) > DiskImageSectors))
+	  return RES_PARERR;
+
+	memcpy(buff, &DiskImage[sector * TAP_SECTOR_SIZE], (count * TAP_SECTOR_SIZE));
+
+	return RES_OK;
+}
@@ -0,0 +1,101 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2021.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2021  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for TAPServer.c.
+ */
+
+#ifndef _TAP_SERVER_H_
+#define _TAP_SERVER_H_
+
+	/* Includes: */
+		#include <fcntl.h>
+		#include <signal.h>
+		#include <stdbool.h>
+		#include <stdint.h>
+		#include <stdio.h>
+		#include <stdlib.h>
+		#include <string.h>
+		#include <time.h>
+		#include <unistd.h>
+		#include <arpa/inet.h>
+		#include <net/if.h>
+		#include <netinet/in.h>
+		#include <sys/ioctl.h>
+		#include <sys/mman.h>
+		#include <sys/socket.h>
+		#include <sys/stat.h>
+		#include <linux/if_tun.h>
+
+		#include "Config/AppConfig.h"
+
+		#include "uIPManagement.h"
+		#include "FATFs/diskio.h"
+
+	/* Defines: */
+		/** Default name of the TAP interface created for the server. */
+		#define TAP_DEFAULT_INTERFACE_NAME    "lufatap"
+
+		/** Size of each sector of the disk image, in bytes. */
+		#define TAP_SECTOR_SIZE               512
+
+		/** Number of bytes of RNDIS packet message header sent over the modelled USB bus with each Ethernet frame. */
+		#define TAP_RNDIS_HEADER_SIZE         44
+
+		/** Number of half millisecond bins of the histogram of the time between sent frames. */
+		#define TAP_SEND_GAP_BINS             8
+
+	/* Type Defines: */
+		/** Type define for the statistics gathered while the server runs. */
+		typedef struct
+		{
+			uint32_t ReceivedFrames; /**< Number of Ethernet frames read from the TAP interface by uIP. */
+			uint32_t SentFrames; /**< Number of Ethernet frames sent by uIP to the TAP interface. */
+			uint32_t MaxFramesPerPass; /**< Largest number of frames read in a single main loop pass. */
+			uint64_t Passes; /**< Number of main loop passes made. */
+			uint64_t BusNanoseconds; /**< Time spent waiting for the modelled USB bus transfers. */
+			uint32_t SendGaps[TAP_SEND_GAP_BINS]; /**< Histogram of the time between sent frames, in half millisecond bins. */
+		} TAPServer_Statistics_t;
+
+	/* Function Prototypes: */
+		int main(int argc, char** argv);
+
+		#if defined(INCLUDE_FROM_TAPSERVER_C)
+			static bool TAPServer_OpenInterface(const char* const InterfaceName);
+			static bool TAPServer_OpenDiskImage(const char* const FileName);
+			static void TAPServer_ModelBusTransfer(const uint16_t Bytes);
+			static void TAPServer_PrintStatistics(void);
+			static void TAPServer_SignalHandler(int Signal);
+			static uint64_t TAPServer_GetTimeNS(void);
+		#endif
+
+#endif
+
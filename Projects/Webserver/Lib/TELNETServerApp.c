@@ -36,6 +36,7 @@
 
 #define  INCLUDE_FROM_TELNETSERVERAPP_C
 #include "TELNETServerApp.h"
+#include "uIPManagement.h"
 
 #if defined(ENABLE_TELNET_SERVER) || defined(__DOXYGEN__)
 
@@ -107,6 +108,9 @@ void TELNETServerApp_Callback(void)
 				AppState->TELNETServer.IssuedCommand = AppData[0];
 
 				AppState->TELNETServer.CurrentState  = TELNET_STATE_SendResponse;
+
+				/* The command response is sent when the connection is next polled */
+				uIPManagement_RequestPoll();
 				break;
 			case TELNET_STATE_SendResponse:
 				/* Determine which command was issued, perform command processing */
@@ -46,6 +46,31 @@ static struct timer ARPTimer;
 /** MAC address of the RNDIS device, when enumerated. */
 struct uip_eth_addr MACAddress;
 
+/** Pool of Ethernet frame buffers. The first \ref RX_QUEUE_FRAMES frames form the queue of frames received from
+ *  the RNDIS interface waiting to be processed by uIP, while the last frame is used to build the outgoing packets
+ *  generated when the uIP connections are polled. With no separate receive queue, the single frame of the queue is
+ *  also the transmit frame, and is only used to receive frames while no outgoing packet is being built.
+ */
+static uint8_t FramePool[TX_FRAME_INDEX + 1][UIP_BUFSIZE + 2];
+
+/** Lengths of the received frames held in the receive queue, indexed by frame pool entry. */
+static uint16_t RxFrameLength[RX_QUEUE_FRAMES];
+
+/** Frame pool index of the oldest received frame in the receive queue. */
+static uint8_t RxQueueHead;
+
+/** Number of received frames in the receive queue waiting to be processed. */
+static uint8_t RxQueueCount;
+
+/** uIP packet buffer pointer, pointed at the frame pool entry uIP is currently processing. */
+u8_t* uip_buf = FramePool[TX_FRAME_INDEX];
+
+/** Flags for each TCP connection, indicating that its application has more data to send and has asked to be polled. */
+static bool ConnectionPollPending[UIP_CONNS];
+
+/** Number of TCP connections with a pending poll request, so that the connections are only scanned when there are any. */
+static uint8_t PendingPollCount;
+
 
 /** Configures the uIP stack ready for network traffic processing. */
 void uIPManagement_Init(void)
@@ -55,6 +80,15 @@ void uIPManagement_Init(void)
 	timer_set(&ConnectionTimer, CLOCK_SECOND / 2);
 	timer_set(&ARPTimer, CLOCK_SECOND * 10);
 
+	/* Receive Queue Initialization */
+	RxQueueHead  = 0;
+	RxQueueCount = 0;
+	uip_buf      = FramePool[TX_FRAME_INDEX];
+
+	/* Connection Poll Request Initialization */
+	memset(ConnectionPollPending, false, sizeof(ConnectionPollPending));
+	PendingPollCount = 0;
+
 	/* uIP Stack Initialization */
 	uip_init();
 	uip_arp_init();
@@ -161,36 +195,80 @@ void uIPManagement_UDPCallback(void)
 	}
 }
 
-/** Processes Incoming packets to the server from the connected RNDIS device, creating responses as needed. */
-static void uIPManagement_ProcessIncomingPacket(void)
+/** Requests that the TCP connection currently being processed by uIP be polled for more data on the next call to
+ *  \ref uIPManagement_ManageNetwork(). TCP applications must call this from their uIP callback when they have data to
+ *  send which could not be sent in response to the current event; connections with no pending poll request are only
+ *  polled by the periodic connection management, every half second.
+ */
+void uIPManagement_RequestPoll(void)
 {
-	/* Determine which USB mode the system is currently initialized in */
-	if (USB_CurrentMode == USB_MODE_Device)
-	{
-		/* If no packet received, exit processing routine */
-		if (!(RNDIS_Device_IsPacketReceived(&Ethernet_RNDIS_Interface_Device)))
-		  return;
+	uint8_t ConnectionIndex = (uip_conn - uip_conns);
 
-		LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-
-		/* Read the Incoming packet straight into the UIP packet buffer */
-		RNDIS_Device_ReadPacket(&Ethernet_RNDIS_Interface_Device, uip_buf, UIP_BUFSIZE, &uip_len);
+	if (!(ConnectionPollPending[ConnectionIndex]))
+	{
+		ConnectionPollPending[ConnectionIndex] = true;
+		PendingPollCount++;
 	}
-	else
+}
+
+/** Reads the frames received from the connected RNDIS device into the free entries of the receive queue, so that the
+ *  RNDIS interface can accept further frames while the queued frames wait to be processed by uIP.
+ */
+static void uIPManagement_ReceiveFrames(void)
+{
+	while (RxQueueCount < RX_QUEUE_FRAMES)
 	{
-		/* If no packet received, exit processing routine */
-		if (!(RNDIS_Host_IsPacketReceived(&Ethernet_RNDIS_Interface_Host)))
-		  return;
+		uint8_t FrameIndex = ((RxQueueHead + RxQueueCount) % RX_QUEUE_FRAMES);
 
-		LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
+		/* Determine which USB mode the system is currently initialized in */
+		if (USB_CurrentMode == USB_MODE_Device)
+		{
+			/* If no packet received, exit processing routine */
+			if (!(RNDIS_Device_IsPacketReceived(&Ethernet_RNDIS_Interface_Device)))
+			  return;
+
+			LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
+
+			/* Read the Incoming packet straight into the free frame at the end of the receive queue */
+			RNDIS_Device_ReadPacket(&Ethernet_RNDIS_Interface_Device, FramePool[FrameIndex], UIP_BUFSIZE, &RxFrameLength[FrameIndex]);
+		}
+		else
+		{
+			/* If no packet received, exit processing routine */
+			if (!(RNDIS_Host_IsPacketReceived(&Ethernet_RNDIS_Interface_Host)))
+			  return;
 
-		/* Read the Incoming packet straight into the UIP packet buffer */
-		RNDIS_Host_ReadPacket(&Ethernet_RNDIS_Interface_Host, uip_buf, UIP_BUFSIZE, &uip_len);
+			LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
+
+			/* Read the Incoming packet straight into the free frame at the end of the receive queue */
+			RNDIS_Host_ReadPacket(&Ethernet_RNDIS_Interface_Host, FramePool[FrameIndex], UIP_BUFSIZE, &RxFrameLength[FrameIndex]);
+		}
+
+		/* Stop reading if the packet did not contain an Ethernet frame, otherwise queue it for processing */
+		if (!(RxFrameLength[FrameIndex]))
+		  return;
+
+		RxQueueCount++;
 	}
+}
 
-	/* If the packet contains an Ethernet frame, process it */
-	if (uip_len > 0)
+/** Processes Incoming packets to the server from the connected RNDIS device, creating responses as needed. */
+static void uIPManagement_ProcessIncomingPacket(void)
+{
+	/* Process at most a full receive queue of frames per call, so that the USB management tasks are not starved */
+	for (uint8_t FramesProcessed = 0; FramesProcessed < RX_QUEUE_FRAMES; FramesProcessed++)
 	{
+		/* Move any newly received frames into the free entries of the receive queue */
+		uIPManagement_ReceiveFrames();
+
+		/* If no frames are waiting to be processed, exit processing routine */
+		if (!(RxQueueCount))
+		  break;
+
+		/* Hand the oldest queued frame to uIP in place, so that any response is built over it */
+		uip_buf = FramePool[RxQueueHead];
+		uip_len = RxFrameLength[RxQueueHead];
+
 		switch (((struct uip_eth_hdr*)uip_buf)->type)
 		{
 			case HTONS(UIP_ETHTYPE_IP):
@@ -220,17 +298,31 @@ static void uIPManagement_ProcessIncomingPacket(void)
 
 				break;
 		}
+
+		/* Release the processed frame from the head of the receive queue */
+		RxQueueHead = ((RxQueueHead + 1) % RX_QUEUE_FRAMES);
+		RxQueueCount--;
+
+		LEDs_SetAllLEDs(LEDMASK_USB_READY);
 	}
 
-	LEDs_SetAllLEDs(LEDMASK_USB_READY);
+	/* Point uIP back at the transmit frame, which is never used by a separate receive queue */
+	uip_buf = FramePool[TX_FRAME_INDEX];
 }
 
 /** Manages the currently open network connections, including TCP and (if enabled) UDP. */
 static void uIPManagement_ManageConnections(void)
 {
-	/* Poll TCP connections for more data to send back to the host */
-	for (uint8_t i = 0; i < UIP_CONNS; i++)
+	/* Poll the TCP connections which have requested it for more data to send back to the host */
+	for (uint8_t i = 0; (i < UIP_CONNS) && PendingPollCount; i++)
 	{
+		if (!(ConnectionPollPending[i]))
+		  continue;
+
+		/* Clear the request before polling, so that the application may request another poll while being polled */
+		ConnectionPollPending[i] = false;
+		PendingPollCount--;
+
 		uip_poll_conn(&uip_conns[i]);
 
 		/* If a response was generated, send it */
@@ -241,6 +333,11 @@ static void uIPManagement_ManageConnections(void)
 
 			/* Split and send the outgoing packet */
 			uip_split_output();
+
+			/* Accept any frames the RNDIS interface received while the packet was being built and sent */
+			#if (RNDIS_RX_QUEUE_LENGTH > 0)
+			uIPManagement_ReceiveFrames();
+			#endif
 		}
 	}
 
@@ -51,6 +51,25 @@
 		#include "HTTPServerApp.h"
 		#include "TELNETServerApp.h"
 
+	/* Preprocessor Checks: */
+		#if (RNDIS_RX_QUEUE_LENGTH < 0)
+			#error RNDIS_RX_QUEUE_LENGTH must not be negative.
+		#endif
+
+	/* Macros: */
+		#if defined(INCLUDE_FROM_UIPMANAGEMENT_C)
+			#if (RNDIS_RX_QUEUE_LENGTH > 0)
+				/** Number of frames in the receive queue of the frame pool. */
+				#define RX_QUEUE_FRAMES         RNDIS_RX_QUEUE_LENGTH
+
+				/** Index of the frame pool entry used to build outgoing packets, following the receive queue. */
+				#define TX_FRAME_INDEX          RNDIS_RX_QUEUE_LENGTH
+			#else
+				#define RX_QUEUE_FRAMES         1
+				#define TX_FRAME_INDEX          0
+			#endif
+		#endif
+
 	/* External Variables: */
 		extern struct uip_eth_addr MACAddress;
 
@@ -59,8 +78,10 @@
 		void uIPManagement_ManageNetwork(void);
 		void uIPManagement_TCPCallback(void);
 		void uIPManagement_UDPCallback(void);
+		void uIPManagement_RequestPoll(void);
 
 		#if defined(INCLUDE_FROM_UIPMANAGEMENT_C)
+			static void uIPManagement_ReceiveFrames(void);
 			static void uIPManagement_ProcessIncomingPacket(void);
 			static void uIPManagement_ManageConnections(void);
 		#endif
@@ -1925,7 +1925,9 @@ void
 uip_send(const void *data, int len)
 {
   int copylen;
+#if !defined(MIN)
 #define MIN(a,b) ((a) < (b)? (a): (b))
+#endif
   copylen = MIN(len, UIP_BUFSIZE - UIP_LLH_LEN - UIP_TCPIP_HLEN -
 		(int)((char *)uip_sappdata - (char *)&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN]));
   if(copylen > 0) {
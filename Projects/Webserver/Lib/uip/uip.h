@@ -472,8 +472,17 @@ void uip_reass_over(void);
  }
  }
  \endcode
+ *
+ * When UIP_CONF_EXTERNAL_BUFFER is defined, uip_buf is instead a
+ * pointer supplied by the device driver, which must point it to a
+ * buffer of at least UIP_BUFSIZE + 2 bytes holding the packet to be
+ * processed before calling into uIP.
 */
+#ifdef UIP_CONF_EXTERNAL_BUFFER
+extern u8_t *uip_buf;
+#else /* UIP_CONF_EXTERNAL_BUFFER */
 extern u8_t uip_buf[UIP_BUFSIZE+2];
+#endif /* UIP_CONF_EXTERNAL_BUFFER */
 
 
 
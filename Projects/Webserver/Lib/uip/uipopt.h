@@ -629,6 +629,7 @@ void uip_log(char *msg);
 #include <stdint.h>
 
 #include "timer.h"
+#include "../AssetBundle.h"
 
 typedef uint8_t u8_t;
 typedef uint16_t u16_t;
@@ -690,14 +691,30 @@ typedef union
 {
 	struct
 	{
-		uint8_t  CurrentState;
-		uint8_t  NextState;
-
-		char     FileName[MAX_URI_LENGTH];
-		FIL      FileHandle;
-		bool     FileOpen;
-		uint32_t ACKedFilePos;
-		uint16_t SentChunkSize;
+		uint8_t      CurrentState;
+		uint8_t      NextState;
+
+		char         FileName[MAX_URI_LENGTH];
+		FIL          FileHandle;
+		DWORD        FileLinkMap[2 + (MAX_FILE_FRAGMENTS * 2)];
+		bool         FileOpen;
+		const AssetBundle_Variant_t* Asset;
+		bool         RequestReady;
+		bool         KeepAlive;
+		bool         AcceptGzip;
+		uint32_t     IfNoneMatch;
+		uint32_t     ACKedFilePos;
+		UINT         SentChunkSize;
+		uint8_t      RexmitSlot;
+		struct timer IdleTimer;
+
+		uint8_t      ParseState;
+		uint8_t      ParseHeader;
+		uint8_t      ParseIndex;
+		char         NextFileName[MAX_URI_LENGTH];
+		bool         NextKeepAlive;
+		bool         NextAcceptGzip;
+		uint32_t     NextIfNoneMatch;
 	} HTTPServer;
 
 	struct
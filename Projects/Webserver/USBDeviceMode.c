@@ -98,6 +98,20 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 			},
 	};
 
+/** SCSI logical unit of the Mass Storage interface, mapped to the board Dataflash. This table is passed to the library
+ *  SCSI command engine, which dispatches each SCSI command to its logical unit.
+ */
+static const MS_SCSI_LUN_t Disk_LUNs[] =
+	{
+		{
+			.Backend     = &DataflashManager_SCSIBackend,
+			.InquiryData = &DataflashManager_InquiryData,
+			.TotalBlocks = VIRTUAL_MEMORY_BLOCKS,
+			.BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE,
+			.ReadOnly    = DISK_READ_ONLY,
+		},
+	};
+
 
 /** USB device mode management task. This function manages the Mass Storage Device class driver when the device is
  *  initialized in USB device mode.
@@ -111,6 +125,7 @@ void USBDeviceMode_USBTask(void)
 
 	RNDIS_Device_USBTask(&Ethernet_RNDIS_Interface_Device);
 	MS_Device_USBTask(&Disk_MS_Interface);
+	DataflashManager_CacheTask();
 }
 
 /** Event handler for the library USB Connection event. */
@@ -157,7 +172,7 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo, Disk_LUNs);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
 	return CommandSuccess;
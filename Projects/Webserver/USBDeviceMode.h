@@ -42,7 +42,7 @@
 		#include "Webserver.h"
 		#include "Descriptors.h"
 		#include "Lib/uIPManagement.h"
-		#include "Lib/SCSI.h"
+		#include "Lib/DataflashManager.h"
 		#include "Config/AppConfig.h"
 
 	/* External Variables: */